@@ -132,6 +132,7 @@ public:
         sail_io.flush          = wrapped_flush;
         sail_io.close          = wrapped_close;
         sail_io.eof            = wrapped_eof;
+        sail_io.contents       = nullptr;
     }
 
     sail::abstract_io &abstract_io;
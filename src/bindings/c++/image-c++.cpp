@@ -73,7 +73,7 @@ public:
     std::vector<sail::meta_data> meta_data;
     sail::iccp iccp;
     sail::source_image source_image;
-    unsigned pixels_size;
+    std::size_t pixels_size;
     bool shallow_pixels;
 };
 
@@ -98,7 +98,7 @@ image::image(void *pixels, SailPixelFormat pixel_format, unsigned width, unsigne
         .with_shallow_pixels(pixels);
 }
 
-image::image(void *pixels, SailPixelFormat pixel_format, unsigned width, unsigned height, unsigned bytes_per_line)
+image::image(void *pixels, SailPixelFormat pixel_format, unsigned width, unsigned height, std::size_t bytes_per_line)
     : image()
 {
     with_width(width)
@@ -180,7 +180,7 @@ unsigned image::height() const
     return d->sail_image->height;
 }
 
-unsigned image::bytes_per_line() const
+std::size_t image::bytes_per_line() const
 {
     return d->sail_image->bytes_per_line;
 }
@@ -240,7 +240,7 @@ const void* image::pixels() const
     return d->sail_image->pixels;
 }
 
-unsigned image::pixels_size() const
+std::size_t image::pixels_size() const
 {
     return d->pixels_size;
 }
@@ -257,7 +257,7 @@ image& image::with_height(unsigned height)
     return *this;
 }
 
-image& image::with_bytes_per_line(unsigned bytes_per_line)
+image& image::with_bytes_per_line(std::size_t bytes_per_line)
 {
     d->sail_image->bytes_per_line = bytes_per_line;
     return *this;
@@ -265,7 +265,7 @@ image& image::with_bytes_per_line(unsigned bytes_per_line)
 
 image& image::with_bytes_per_line_auto()
 {
-    unsigned bytes_per_line = 0;
+    std::size_t bytes_per_line = 0;
     image::bytes_per_line(d->sail_image->width, d->sail_image->pixel_format, &bytes_per_line);
 
     return with_bytes_per_line(bytes_per_line);
@@ -315,12 +315,12 @@ image& image::with_meta_data(const sail::meta_data &meta_data)
 
 image& image::with_pixels(const void *pixels)
 {
-    with_pixels(pixels, height() * bytes_per_line());
+    with_pixels(pixels, static_cast<std::size_t>(height()) * bytes_per_line());
 
     return *this;
 }
 
-image& image::with_pixels(const void *pixels, unsigned pixels_size)
+image& image::with_pixels(const void *pixels, std::size_t pixels_size)
 {
     d->reset_pixels();
 
@@ -328,7 +328,7 @@ image& image::with_pixels(const void *pixels, unsigned pixels_size)
         return *this;
     }
 
-    SAIL_TRY_OR_EXECUTE(sail_malloc(pixels_size, &d->sail_image->pixels),
+    SAIL_TRY_OR_EXECUTE(sail_malloc_pixels(pixels_size, &d->sail_image->pixels),
                         /* on error */ return *this);
 
     memcpy(d->sail_image->pixels, pixels, pixels_size);
@@ -340,12 +340,12 @@ image& image::with_pixels(const void *pixels, unsigned pixels_size)
 
 image& image::with_shallow_pixels(void *pixels)
 {
-    with_shallow_pixels(pixels, height() * bytes_per_line());
+    with_shallow_pixels(pixels, static_cast<std::size_t>(height()) * bytes_per_line());
 
     return *this;
 }
 
-image& image::with_shallow_pixels(void *pixels, unsigned pixels_size)
+image& image::with_shallow_pixels(void *pixels, std::size_t pixels_size)
 {
     d->reset_pixels();
 
@@ -454,7 +454,7 @@ sail_status_t image::convert(SailPixelFormat pixel_format, const conversion_opti
     d->sail_image->bytes_per_line = sail_image_output->bytes_per_line;
     d->sail_image->pixel_format   = sail_image_output->pixel_format;
     d->sail_image->pixels         = sail_image_output->pixels;
-    d->pixels_size                = sail_image_output->height * sail_image_output->bytes_per_line;
+    d->pixels_size                = static_cast<std::size_t>(sail_image_output->height) * sail_image_output->bytes_per_line;
     d->shallow_pixels             = false;
 
     sail_image_output->pixels = nullptr;
@@ -630,7 +630,7 @@ sail_status_t image::bits_per_pixel(SailPixelFormat pixel_format, unsigned *resu
     return SAIL_OK;
 }
 
-sail_status_t image::bytes_per_line(unsigned width, SailPixelFormat pixel_format, unsigned *result)
+sail_status_t image::bytes_per_line(unsigned width, SailPixelFormat pixel_format, std::size_t *result)
 {
     SAIL_CHECK_PTR(result);
 
@@ -731,8 +731,11 @@ sail_status_t image::transfer_pixels_pointer(const sail_image *sail_image)
         return SAIL_OK;
     }
 
+    std::size_t pixels_size;
+    SAIL_TRY(sail_bytes_per_image(sail_image, &pixels_size));
+
     d->sail_image->pixels = sail_image->pixels;
-    d->pixels_size        = sail_image->height * sail_image->bytes_per_line;
+    d->pixels_size        = pixels_size;
 
     return SAIL_OK;
 }
@@ -26,6 +26,7 @@
 #ifndef SAIL_IMAGE_CPP_H
 #define SAIL_IMAGE_CPP_H
 
+#include <cstddef>
 #include <memory>
 #include <string_view>
 #include <vector>
@@ -88,7 +89,7 @@ public:
      * Constructs a new image out of the specified image properties and the shallow pixels.
      * The pixels must remain valid as long as the image exists.
      */
-    image(void *pixels, SailPixelFormat pixel_format, unsigned width, unsigned height, unsigned bytes_per_line);
+    image(void *pixels, SailPixelFormat pixel_format, unsigned width, unsigned height, std::size_t bytes_per_line);
 
     /*
      * Makes a deep copy of the image.
@@ -159,7 +160,7 @@ public:
      * WRITE: Must be set by a caller to a positive number of bytes per line. A caller could set
      *        it with bytes_per_line_auto() if scan lines are not padded to a certain boundary.
      */
-    unsigned bytes_per_line() const;
+    std::size_t bytes_per_line() const;
 
     /*
      * Returns the image resolution.
@@ -266,7 +267,7 @@ public:
     /*
      * Returns the size of the deep copied pixel data in bytes.
      */
-    unsigned pixels_size() const;
+    std::size_t pixels_size() const;
 
     /*
      * Sets a new width.
@@ -281,7 +282,7 @@ public:
     /*
      * Sets a new bytes-per-line value.
      */
-    image& with_bytes_per_line(unsigned bytes_per_line);
+    image& with_bytes_per_line(std::size_t bytes_per_line);
 
     /*
      * Calculates bytes-per-line automatically based on the image width
@@ -335,7 +336,7 @@ public:
      * Deep copies the specified pixel data and stores its size. The data can be accessed later with pixels().
      * The deep copied data is deleted upon image destruction.
      */
-    image& with_pixels(const void *pixels, unsigned pixels_size);
+    image& with_pixels(const void *pixels, std::size_t pixels_size);
 
     /*
      * Stores the pointer to the external pixel data. Frees the previously stored deep-copied pixel data.
@@ -352,7 +353,7 @@ public:
      * deep-copied pixel data. The pixel data must remain valid until the image exists. The shallow data
      * is not deleted upon image destruction.
      */
-    image& with_shallow_pixels(void *pixels, unsigned pixels_size);
+    image& with_shallow_pixels(void *pixels, std::size_t pixels_size);
 
     /*
      * Sets a new ICC profile.
@@ -652,7 +653,7 @@ public:
      *
      * Returns SAIL_OK on success.
      */
-    static sail_status_t bytes_per_line(unsigned width, SailPixelFormat pixel_format, unsigned *result);
+    static sail_status_t bytes_per_line(unsigned width, SailPixelFormat pixel_format, std::size_t *result);
 
     /*
      * Returns true if the specified pixel format is indexed with palette.
@@ -253,6 +253,20 @@ image image_input::next_frame()
     return image;
 }
 
+sail_status_t image_input::skip_frame()
+{
+    SAIL_TRY(sail_skip_next_frame(d->state));
+
+    return SAIL_OK;
+}
+
+sail_status_t image_input::seek_to_frame(unsigned frame)
+{
+    SAIL_TRY(sail_seek_to_frame(d->state, frame));
+
+    return SAIL_OK;
+}
+
 sail_status_t image_input::stop()
 {
     sail_status_t saved_status = SAIL_OK;
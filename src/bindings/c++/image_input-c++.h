@@ -287,6 +287,24 @@ public:
      */
     image next_frame();
 
+    /*
+     * Skips the next frame of the source started by the previous call to start().
+     * See sail_skip_next_frame().
+     *
+     * Returns SAIL_OK on success.
+     * Returns SAIL_ERROR_NO_MORE_FRAMES when no more frames are available.
+     */
+    sail_status_t skip_frame();
+
+    /*
+     * Seeks to the specified zero-based frame of the source started by the previous call to start().
+     * The next call to next_frame() reads the specified frame. See sail_seek_to_frame().
+     *
+     * Returns SAIL_OK on success.
+     * Returns SAIL_ERROR_NO_MORE_FRAMES when the frame doesn't exist. See sail_seek_to_frame() for details.
+     */
+    sail_status_t seek_to_frame(unsigned frame);
+
     /*
      * Stops reading the source started by the previous call to start(). Does nothing
      * if no reading was started.
@@ -177,7 +177,7 @@ sail_status_t palette::copy(SailPixelFormat pixel_format, const void *data, unsi
 {
     SAIL_CHECK_PTR(data);
 
-    unsigned palette_size;
+    std::size_t palette_size;
     SAIL_TRY(sail_bytes_per_line(color_count, pixel_format, &palette_size));
 
     d->data.resize(palette_size);
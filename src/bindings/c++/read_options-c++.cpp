@@ -62,7 +62,15 @@ read_options::read_options(const read_options &ro)
 
 read_options& read_options::operator=(const sail::read_options &read_options)
 {
-    with_io_options(read_options.io_options());
+    with_io_options(read_options.io_options())
+        .with_cancel_flag(read_options.cancel_flag())
+        .with_deadline(read_options.deadline())
+        .with_progress(read_options.progress(), read_options.progress_user_data())
+        .with_preview(read_options.preview(), read_options.preview_user_data())
+        .with_limits(read_options.limits())
+        .with_decode_quality(read_options.decode_quality())
+        .with_threads(read_options.threads());
+
     return *this;
 }
 
@@ -87,12 +95,101 @@ int read_options::io_options() const
     return d->sail_read_options->io_options;
 }
 
+const volatile int* read_options::cancel_flag() const
+{
+    return d->sail_read_options->cancel_flag;
+}
+
+std::uint64_t read_options::deadline() const
+{
+    return d->sail_read_options->deadline;
+}
+
+sail_progress_t read_options::progress() const
+{
+    return d->sail_read_options->progress;
+}
+
+void* read_options::progress_user_data() const
+{
+    return d->sail_read_options->progress_user_data;
+}
+
+sail_preview_t read_options::preview() const
+{
+    return d->sail_read_options->preview;
+}
+
+void* read_options::preview_user_data() const
+{
+    return d->sail_read_options->preview_user_data;
+}
+
+sail_read_limits read_options::limits() const
+{
+    return d->sail_read_options->limits;
+}
+
+SailDecodeQuality read_options::decode_quality() const
+{
+    return d->sail_read_options->decode_quality;
+}
+
+unsigned read_options::threads() const
+{
+    return d->sail_read_options->threads;
+}
+
 read_options& read_options::with_io_options(int io_options)
 {
     d->sail_read_options->io_options = io_options;
     return *this;
 }
 
+read_options& read_options::with_cancel_flag(const volatile int *cancel_flag)
+{
+    d->sail_read_options->cancel_flag = cancel_flag;
+    return *this;
+}
+
+read_options& read_options::with_deadline(std::uint64_t deadline)
+{
+    d->sail_read_options->deadline = deadline;
+    return *this;
+}
+
+read_options& read_options::with_progress(sail_progress_t progress, void *progress_user_data)
+{
+    d->sail_read_options->progress           = progress;
+    d->sail_read_options->progress_user_data = progress_user_data;
+    return *this;
+}
+
+read_options& read_options::with_preview(sail_preview_t preview, void *preview_user_data)
+{
+    d->sail_read_options->preview           = preview;
+    d->sail_read_options->preview_user_data = preview_user_data;
+    return *this;
+}
+
+read_options& read_options::with_limits(const sail_read_limits &limits)
+{
+    d->sail_read_options->limits = limits;
+    return *this;
+}
+
+read_options& read_options::with_decode_quality(SailDecodeQuality decode_quality)
+{
+    d->sail_read_options->decode_quality = decode_quality;
+    return *this;
+}
+
+read_options& read_options::with_threads(unsigned threads)
+{
+    d->sail_read_options->threads = threads;
+    return *this;
+}
+
 read_options::read_options(const sail_read_options *ro)
     : read_options()
 {
@@ -101,7 +198,14 @@ read_options::read_options(const sail_read_options *ro)
         return;
     }
 
-    with_io_options(ro->io_options);
+    with_io_options(ro->io_options)
+        .with_cancel_flag(ro->cancel_flag)
+        .with_deadline(ro->deadline)
+        .with_progress(ro->progress, ro->progress_user_data)
+        .with_preview(ro->preview, ro->preview_user_data)
+        .with_limits(ro->limits)
+        .with_decode_quality(ro->decode_quality)
+        .with_threads(ro->threads);
 }
 
 sail_status_t read_options::to_sail_read_options(sail_read_options *read_options) const
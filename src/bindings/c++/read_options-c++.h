@@ -26,15 +26,20 @@
 #ifndef SAIL_READ_OPTIONS_CPP_H
 #define SAIL_READ_OPTIONS_CPP_H
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 #ifdef SAIL_BUILD
+    #include "common.h"
     #include "error.h"
     #include "export.h"
+    #include "read_limits.h"
 #else
+    #include <sail-common/common.h>
     #include <sail-common/error.h>
     #include <sail-common/export.h>
+    #include <sail-common/read_limits.h>
 #endif
 
 struct sail_read_options;
@@ -86,11 +91,97 @@ public:
      */
     int io_options() const;
 
+    /*
+     * Returns the cancellation flag or nullptr. See with_cancel_flag().
+     */
+    const volatile int* cancel_flag() const;
+
+    /*
+     * Returns the reading deadline in milliseconds as returned by sail_now(). 0 means no deadline.
+     */
+    std::uint64_t deadline() const;
+
+    /*
+     * Returns the progress callback or nullptr. See sail_progress_t.
+     */
+    sail_progress_t progress() const;
+
+    /*
+     * Returns the user data passed to the progress callback.
+     */
+    void* progress_user_data() const;
+
+    /*
+     * Returns the preview callback or nullptr. See sail_preview_t.
+     */
+    sail_preview_t preview() const;
+
+    /*
+     * Returns the user data passed to the preview callback.
+     */
+    void* preview_user_data() const;
+
+    /*
+     * Returns the resource limits for reading operations. See sail_read_limits.
+     */
+    sail_read_limits limits() const;
+
+    /*
+     * Returns the decoding speed and quality trade-off. See SailDecodeQuality.
+     */
+    SailDecodeQuality decode_quality() const;
+
+    /*
+     * Returns the maximum number of threads a codec may use to decode a single frame.
+     */
+    unsigned threads() const;
+
     /*
      * Sets new or-ed I/O manipulation options for reading operations. See SailIoOption.
      */
     read_options& with_io_options(int io_options);
 
+    /*
+     * Sets a new cancellation flag. When the flag becomes non-zero, a codec stops reading
+     * at the next scan line and returns SAIL_ERROR_CANCELLED. The flag must outlive the reading
+     * operation. Pass nullptr to disable cancellation.
+     */
+    read_options& with_cancel_flag(const volatile int *cancel_flag);
+
+    /*
+     * Sets a new reading deadline in milliseconds as returned by sail_now(). When the deadline passes,
+     * a codec stops reading at the next scan line and returns SAIL_ERROR_CANCELLED. Pass 0 to disable it.
+     */
+    read_options& with_deadline(std::uint64_t deadline);
+
+    /*
+     * Sets a new progress callback and the user data passed to it. Pass nullptr to disable progress reporting.
+     */
+    read_options& with_progress(sail_progress_t progress, void *progress_user_data = nullptr);
+
+    /*
+     * Sets a new preview callback and the user data passed to it. Pass nullptr to disable previews
+     * of progressive images.
+     */
+    read_options& with_preview(sail_preview_t preview, void *preview_user_data = nullptr);
+
+    /*
+     * Sets new resource limits for reading operations. Global limits set with sail_set_global_read_limits()
+     * are applied too. See sail_read_limits.
+     */
+    read_options& with_limits(const sail_read_limits &limits);
+
+    /*
+     * Sets a new decoding speed and quality trade-off. See SailDecodeQuality.
+     */
+    read_options& with_decode_quality(SailDecodeQuality decode_quality);
+
+    /*
+     * Sets a new maximum number of threads a codec may use to decode a single frame.
+     * 0 and 1 mean decoding in the calling thread.
+     */
+    read_options& with_threads(unsigned threads);
+
 private:
     /*
      * Makes a deep copy of the specified read options and stores the pointer for further use.
@@ -66,7 +66,8 @@ source_image& source_image::operator=(const source_image &si)
     with_pixel_format(si.pixel_format())
         .with_chroma_subsampling(si.chroma_subsampling())
         .with_properties(si.properties())
-        .with_compression(si.compression());
+        .with_compression(si.compression())
+        .with_orientation(si.orientation());
 
     return *this;
 }
@@ -112,6 +113,11 @@ SailCompression source_image::compression() const
     return d->sail_source_image->compression;
 }
 
+SailOrientation source_image::orientation() const
+{
+    return d->sail_source_image->orientation;
+}
+
 source_image::source_image(const sail_source_image *si)
     : source_image()
 {
@@ -123,7 +129,8 @@ source_image::source_image(const sail_source_image *si)
     with_pixel_format(si->pixel_format)
         .with_chroma_subsampling(si->chroma_subsampling)
         .with_properties(si->properties)
-        .with_compression(si->compression);
+        .with_compression(si->compression)
+        .with_orientation(si->orientation);
 }
 
 sail_status_t source_image::to_sail_source_image(sail_source_image **source_image) const
@@ -161,5 +168,11 @@ source_image& source_image::with_compression(SailCompression compression)
     return *this;
 }
 
+source_image& source_image::with_orientation(SailOrientation orientation)
+{
+    d->sail_source_image->orientation = orientation;
+    return *this;
+}
+
 
 }
@@ -119,6 +119,14 @@ public:
      */
     SailCompression compression() const;
 
+    /*
+     * Returns the source image orientation. See SailOrientation.
+     *
+     * READ:  Set by SAIL to the orientation from the image EXIF data or to SAIL_ORIENTATION_NORMAL.
+     * WRITE: Ignored.
+     */
+    SailOrientation orientation() const;
+
 private:
     /*
      * Makes a deep copy of the specified source image.
@@ -131,6 +139,7 @@ private:
     source_image& with_chroma_subsampling(SailChromaSubsampling chroma_subsampling);
     source_image& with_properties(int properties);
     source_image& with_compression(SailCompression compression);
+    source_image& with_orientation(SailOrientation orientation);
 
 private:
     class pimpl;
@@ -64,7 +64,24 @@ write_options& write_options::operator=(const sail::write_options &write_options
 {
     with_io_options(write_options.io_options())
         .with_compression(write_options.compression())
-        .with_compression_level(write_options.compression_level());
+        .with_compression_level(write_options.compression_level())
+        .with_cancel_flag(write_options.cancel_flag())
+        .with_deadline(write_options.deadline())
+        .with_progress(write_options.progress(), write_options.progress_user_data())
+        .with_lossless_transform(write_options.lossless_transform())
+        .with_crop(write_options.crop_x(), write_options.crop_y(), write_options.crop_width(), write_options.crop_height())
+        .with_chroma_subsampling(write_options.chroma_subsampling())
+        .with_optimize_coding(write_options.optimize_coding())
+        .with_progressive(write_options.progressive())
+        .with_restart_interval(write_options.restart_interval())
+        .with_dct_method(write_options.dct_method())
+        .with_arithmetic_coding(write_options.arithmetic_coding())
+        .with_threads(write_options.threads())
+        .with_encode_preset(write_options.encode_preset())
+        .with_row_filters(write_options.row_filters())
+        .with_zlib_strategy(write_options.zlib_strategy())
+        .with_zlib_window_bits(write_options.zlib_window_bits())
+        .with_zlib_mem_level(write_options.zlib_mem_level());
 
     return *this;
 }
@@ -100,6 +117,111 @@ double write_options::compression_level() const
     return d->sail_write_options->compression_level;
 }
 
+const volatile int* write_options::cancel_flag() const
+{
+    return d->sail_write_options->cancel_flag;
+}
+
+std::uint64_t write_options::deadline() const
+{
+    return d->sail_write_options->deadline;
+}
+
+sail_progress_t write_options::progress() const
+{
+    return d->sail_write_options->progress;
+}
+
+void* write_options::progress_user_data() const
+{
+    return d->sail_write_options->progress_user_data;
+}
+
+SailLosslessTransform write_options::lossless_transform() const
+{
+    return d->sail_write_options->lossless_transform;
+}
+
+unsigned write_options::crop_x() const
+{
+    return d->sail_write_options->crop_x;
+}
+
+unsigned write_options::crop_y() const
+{
+    return d->sail_write_options->crop_y;
+}
+
+unsigned write_options::crop_width() const
+{
+    return d->sail_write_options->crop_width;
+}
+
+unsigned write_options::crop_height() const
+{
+    return d->sail_write_options->crop_height;
+}
+
+SailChromaSubsampling write_options::chroma_subsampling() const
+{
+    return d->sail_write_options->chroma_subsampling;
+}
+
+bool write_options::optimize_coding() const
+{
+    return d->sail_write_options->optimize_coding;
+}
+
+bool write_options::progressive() const
+{
+    return d->sail_write_options->progressive;
+}
+
+unsigned write_options::restart_interval() const
+{
+    return d->sail_write_options->restart_interval;
+}
+
+SailDctMethod write_options::dct_method() const
+{
+    return d->sail_write_options->dct_method;
+}
+
+bool write_options::arithmetic_coding() const
+{
+    return d->sail_write_options->arithmetic_coding;
+}
+
+unsigned write_options::threads() const
+{
+    return d->sail_write_options->threads;
+}
+
+SailEncodePreset write_options::encode_preset() const
+{
+    return d->sail_write_options->encode_preset;
+}
+
+int write_options::row_filters() const
+{
+    return d->sail_write_options->row_filters;
+}
+
+SailZlibStrategy write_options::zlib_strategy() const
+{
+    return d->sail_write_options->zlib_strategy;
+}
+
+unsigned write_options::zlib_window_bits() const
+{
+    return d->sail_write_options->zlib_window_bits;
+}
+
+unsigned write_options::zlib_mem_level() const
+{
+    return d->sail_write_options->zlib_mem_level;
+}
+
 write_options& write_options::with_io_options(int io_options)
 {
     d->sail_write_options->io_options = io_options;
@@ -118,6 +240,112 @@ write_options& write_options::with_compression_level(double compression_level)
     return *this;
 }
 
+write_options& write_options::with_cancel_flag(const volatile int *cancel_flag)
+{
+    d->sail_write_options->cancel_flag = cancel_flag;
+    return *this;
+}
+
+write_options& write_options::with_deadline(std::uint64_t deadline)
+{
+    d->sail_write_options->deadline = deadline;
+    return *this;
+}
+
+write_options& write_options::with_progress(sail_progress_t progress, void *progress_user_data)
+{
+    d->sail_write_options->progress           = progress;
+    d->sail_write_options->progress_user_data = progress_user_data;
+    return *this;
+}
+
+write_options& write_options::with_lossless_transform(SailLosslessTransform lossless_transform)
+{
+    d->sail_write_options->lossless_transform = lossless_transform;
+    return *this;
+}
+
+write_options& write_options::with_crop(unsigned x, unsigned y, unsigned width, unsigned height)
+{
+    d->sail_write_options->crop_x      = x;
+    d->sail_write_options->crop_y      = y;
+    d->sail_write_options->crop_width  = width;
+    d->sail_write_options->crop_height = height;
+    return *this;
+}
+
+write_options& write_options::with_chroma_subsampling(SailChromaSubsampling chroma_subsampling)
+{
+    d->sail_write_options->chroma_subsampling = chroma_subsampling;
+    return *this;
+}
+
+write_options& write_options::with_optimize_coding(bool optimize_coding)
+{
+    d->sail_write_options->optimize_coding = optimize_coding;
+    return *this;
+}
+
+write_options& write_options::with_progressive(bool progressive)
+{
+    d->sail_write_options->progressive = progressive;
+    return *this;
+}
+
+write_options& write_options::with_restart_interval(unsigned restart_interval)
+{
+    d->sail_write_options->restart_interval = restart_interval;
+    return *this;
+}
+
+write_options& write_options::with_dct_method(SailDctMethod dct_method)
+{
+    d->sail_write_options->dct_method = dct_method;
+    return *this;
+}
+
+write_options& write_options::with_arithmetic_coding(bool arithmetic_coding)
+{
+    d->sail_write_options->arithmetic_coding = arithmetic_coding;
+    return *this;
+}
+
+write_options& write_options::with_threads(unsigned threads)
+{
+    d->sail_write_options->threads = threads;
+    return *this;
+}
+
+write_options& write_options::with_encode_preset(SailEncodePreset encode_preset)
+{
+    d->sail_write_options->encode_preset = encode_preset;
+    return *this;
+}
+
+write_options& write_options::with_row_filters(int row_filters)
+{
+    d->sail_write_options->row_filters = row_filters;
+    return *this;
+}
+
+write_options& write_options::with_zlib_strategy(SailZlibStrategy zlib_strategy)
+{
+    d->sail_write_options->zlib_strategy = zlib_strategy;
+    return *this;
+}
+
+write_options& write_options::with_zlib_window_bits(unsigned zlib_window_bits)
+{
+    d->sail_write_options->zlib_window_bits = zlib_window_bits;
+    return *this;
+}
+
+write_options& write_options::with_zlib_mem_level(unsigned zlib_mem_level)
+{
+    d->sail_write_options->zlib_mem_level = zlib_mem_level;
+    return *this;
+}
+
 write_options::write_options(const sail_write_options *wo)
     : write_options()
 {
@@ -128,16 +356,31 @@ write_options::write_options(const sail_write_options *wo)
 
     with_io_options(wo->io_options)
         .with_compression(wo->compression)
-        .with_compression_level(wo->compression_level);
+        .with_compression_level(wo->compression_level)
+        .with_cancel_flag(wo->cancel_flag)
+        .with_deadline(wo->deadline)
+        .with_progress(wo->progress, wo->progress_user_data)
+        .with_lossless_transform(wo->lossless_transform)
+        .with_crop(wo->crop_x, wo->crop_y, wo->crop_width, wo->crop_height)
+        .with_chroma_subsampling(wo->chroma_subsampling)
+        .with_optimize_coding(wo->optimize_coding)
+        .with_progressive(wo->progressive)
+        .with_restart_interval(wo->restart_interval)
+        .with_dct_method(wo->dct_method)
+        .with_arithmetic_coding(wo->arithmetic_coding)
+        .with_threads(wo->threads)
+        .with_encode_preset(wo->encode_preset)
+        .with_row_filters(wo->row_filters)
+        .with_zlib_strategy(wo->zlib_strategy)
+        .with_zlib_window_bits(wo->zlib_window_bits)
+        .with_zlib_mem_level(wo->zlib_mem_level);
 }
 
 sail_status_t write_options::to_sail_write_options(sail_write_options *write_options) const
 {
     SAIL_CHECK_PTR(write_options);
 
-    write_options->io_options        = d->sail_write_options->io_options;
-    write_options->compression       = d->sail_write_options->compression;
-    write_options->compression_level = d->sail_write_options->compression_level;
+    *write_options = *d->sail_write_options;
 
     return SAIL_OK;
 }
@@ -26,13 +26,16 @@
 #ifndef SAIL_WRITE_OPTIONS_CPP_H
 #define SAIL_WRITE_OPTIONS_CPP_H
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 #ifdef SAIL_BUILD
+    #include "common.h"
     #include "error.h"
     #include "export.h"
 #else
+    #include <sail-common/common.h>
     #include <sail-common/error.h>
     #include <sail-common/export.h>
 #endif
@@ -108,6 +111,101 @@ public:
      */
     double compression_level() const;
 
+    /*
+     * Returns the cancellation flag or nullptr. See with_cancel_flag().
+     */
+    const volatile int* cancel_flag() const;
+
+    /*
+     * Returns the writing deadline in milliseconds as returned by sail_now(). 0 means no deadline.
+     */
+    std::uint64_t deadline() const;
+
+    /*
+     * Returns the progress callback or nullptr. See sail_progress_t.
+     */
+    sail_progress_t progress() const;
+
+    /*
+     * Returns the user data passed to the progress callback.
+     */
+    void* progress_user_data() const;
+
+    /*
+     * Returns the lossless transformation applied to the original compressed data. See SailLosslessTransform.
+     */
+    SailLosslessTransform lossless_transform() const;
+
+    /*
+     * Returns the crop rectangle for SAIL_LOSSLESS_TRANSFORM_CROP.
+     */
+    unsigned crop_x() const;
+    unsigned crop_y() const;
+    unsigned crop_width() const;
+    unsigned crop_height() const;
+
+    /*
+     * Returns the chroma subsampling of the encoded image. SAIL_CHROMA_SUBSAMPLING_UNKNOWN means
+     * the codec default. See SailChromaSubsampling.
+     */
+    SailChromaSubsampling chroma_subsampling() const;
+
+    /*
+     * Returns true if optimal Huffman tables are computed instead of using the standard ones.
+     */
+    bool optimize_coding() const;
+
+    /*
+     * Returns true if a progressive image is written.
+     */
+    bool progressive() const;
+
+    /*
+     * Returns the restart interval in rows of MCU blocks. 0 means no restart markers.
+     */
+    unsigned restart_interval() const;
+
+    /*
+     * Returns the forward DCT method. See SailDctMethod.
+     */
+    SailDctMethod dct_method() const;
+
+    /*
+     * Returns true if arithmetic coding is used instead of Huffman coding.
+     */
+    bool arithmetic_coding() const;
+
+    /*
+     * Returns the maximum number of threads a codec may use to encode a single frame.
+     * 0 and 1 mean encoding in the calling thread.
+     */
+    unsigned threads() const;
+
+    /*
+     * Returns the encoding speed and size trade-off. See SailEncodePreset.
+     */
+    SailEncodePreset encode_preset() const;
+
+    /*
+     * Returns or-ed filters applied to scan lines. 0 means the codec default. See SailRowFilter.
+     */
+    int row_filters() const;
+
+    /*
+     * Returns the zlib strategy. See SailZlibStrategy.
+     */
+    SailZlibStrategy zlib_strategy() const;
+
+    /*
+     * Returns the base two logarithm of the deflate window size. 0 means the codec default.
+     */
+    unsigned zlib_window_bits() const;
+
+    /*
+     * Returns the zlib memory level. 0 means the codec default.
+     */
+    unsigned zlib_mem_level() const;
+
     /*
      * Sets new or-ed I/O manipulation options for writing operations. See SailIoOption.
      */
@@ -123,6 +221,95 @@ public:
      */
     write_options& with_compression_level(double compression_level);
 
+    /*
+     * Sets a new cancellation flag. When the flag becomes non-zero, a codec stops writing
+     * at the next scan line and returns SAIL_ERROR_CANCELLED. The flag must outlive the writing
+     * operation. Pass nullptr to disable cancellation.
+     */
+    write_options& with_cancel_flag(const volatile int *cancel_flag);
+
+    /*
+     * Sets a new writing deadline in milliseconds as returned by sail_now(). When the deadline passes,
+     * a codec stops writing at the next scan line and returns SAIL_ERROR_CANCELLED. Pass 0 to disable it.
+     */
+    write_options& with_deadline(std::uint64_t deadline);
+
+    /*
+     * Sets a new progress callback and the user data passed to it. Pass nullptr to disable progress reporting.
+     */
+    write_options& with_progress(sail_progress_t progress, void *progress_user_data = nullptr);
+
+    /*
+     * Sets a new lossless transformation applied to the original compressed data instead of encoding
+     * the pixels. Requires SAIL_IO_OPTION_SOURCE_DATA. See sail_write_options.
+     */
+    write_options& with_lossless_transform(SailLosslessTransform lossless_transform);
+
+    /*
+     * Sets a new crop rectangle for SAIL_LOSSLESS_TRANSFORM_CROP.
+     */
+    write_options& with_crop(unsigned x, unsigned y, unsigned width, unsigned height);
+
+    /*
+     * Sets a new chroma subsampling of the encoded image. See sail_write_options.
+     */
+    write_options& with_chroma_subsampling(SailChromaSubsampling chroma_subsampling);
+
+    /*
+     * Enables or disables computing optimal Huffman tables.
+     */
+    write_options& with_optimize_coding(bool optimize_coding);
+
+    /*
+     * Enables or disables writing progressive images.
+     */
+    write_options& with_progressive(bool progressive);
+
+    /*
+     * Sets a new restart interval in rows of MCU blocks. Pass 0 to write no restart markers.
+     */
+    write_options& with_restart_interval(unsigned restart_interval);
+
+    /*
+     * Sets a new forward DCT method. See SailDctMethod.
+     */
+    write_options& with_dct_method(SailDctMethod dct_method);
+
+    /*
+     * Enables or disables arithmetic coding. See sail_write_options.
+     */
+    write_options& with_arithmetic_coding(bool arithmetic_coding);
+
+    /*
+     * Sets a new maximum number of threads a codec may use to encode a single frame. See sail_write_options.
+     */
+    write_options& with_threads(unsigned threads);
+
+    /*
+     * Sets a new encoding speed and size trade-off. See SailEncodePreset.
+     */
+    write_options& with_encode_preset(SailEncodePreset encode_preset);
+
+    /*
+     * Sets new or-ed filters applied to scan lines. Pass 0 to use the codec default. See SailRowFilter.
+     */
+    write_options& with_row_filters(int row_filters);
+
+    /*
+     * Sets a new zlib strategy. See SailZlibStrategy.
+     */
+    write_options& with_zlib_strategy(SailZlibStrategy zlib_strategy);
+
+    /*
+     * Sets a new base two logarithm of the deflate window size in the range 8-15. Pass 0 to use the codec default.
+     */
+    write_options& with_zlib_window_bits(unsigned zlib_window_bits);
+
+    /*
+     * Sets a new zlib memory level in the range 1-9. Pass 0 to use the codec default.
+     */
+    write_options& with_zlib_mem_level(unsigned zlib_mem_level);
+
 private:
     /*
      * Makes a deep copy of the specified write options and stores the pointer for further use.
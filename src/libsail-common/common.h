@@ -211,6 +211,37 @@ enum SailImageProperty {
     SAIL_IMAGE_PROPERTY_INTERLACED           = 1 << 3,
 };
 
+/*
+ * Image orientation. The values match the EXIF Orientation tag. Every orientation names
+ * the operation that turns the stored pixels into the displayed image.
+ */
+enum SailOrientation {
+
+    /* The stored pixels are displayed as is. */
+    SAIL_ORIENTATION_NORMAL            = 1,
+
+    /* The image is flipped horizontally. */
+    SAIL_ORIENTATION_FLIP_HORIZONTALLY = 2,
+
+    /* The image is rotated by 180 degrees. */
+    SAIL_ORIENTATION_ROTATE_180        = 3,
+
+    /* The image is flipped vertically. */
+    SAIL_ORIENTATION_FLIP_VERTICALLY   = 4,
+
+    /* The image is transposed, i.e. flipped across the top-left to bottom-right diagonal. */
+    SAIL_ORIENTATION_TRANSPOSE         = 5,
+
+    /* The image is rotated by 90 degrees clockwise. */
+    SAIL_ORIENTATION_ROTATE_90         = 6,
+
+    /* The image is transversed, i.e. flipped across the top-right to bottom-left diagonal. */
+    SAIL_ORIENTATION_TRANSVERSE        = 7,
+
+    /* The image is rotated by 270 degrees clockwise. */
+    SAIL_ORIENTATION_ROTATE_270        = 8,
+};
+
 /* Pixels compression types. */
 enum SailCompression {
 
@@ -337,19 +368,212 @@ enum SailCodecFeature {
 
     /* Can read or write embedded ICC profiles. */
     SAIL_CODEC_FEATURE_ICCP        = 1 << 6,
+
+    /* Can skip frames without decoding them. Used in reading operations only. */
+    SAIL_CODEC_FEATURE_SKIP_FRAMES = 1 << 7,
+
+    /*
+     * Can decode frames scan line by scan line into a row buffer for sail_scan_line_converter.
+     * Used in reading operations only.
+     */
+    SAIL_CODEC_FEATURE_SCAN_LINES  = 1 << 8,
+
+    /*
+     * Can write the original compressed data kept in sail_source_image unchanged and replace
+     * only its meta data. Used in writing operations only.
+     */
+    SAIL_CODEC_FEATURE_SOURCE_DATA = 1 << 9,
+
+    /*
+     * Can apply a lossless transformation to the original compressed data kept in sail_source_image
+     * without decoding it. See SailLosslessTransform. Used in writing operations only.
+     */
+    SAIL_CODEC_FEATURE_LOSSLESS_TRANSFORM = 1 << 10,
 };
 
 /* Read or write options. */
 enum SailIoOption {
 
     /* Instruction to read or write image meta data like JPEG comments or EXIF. */
-    SAIL_IO_OPTION_META_DATA  = 1 << 0,
+    SAIL_IO_OPTION_META_DATA         = 1 << 0,
 
     /* Instruction to write interlaced images. Specifying this option for reading operations has no effect. */
-    SAIL_IO_OPTION_INTERLACED = 1 << 1,
+    SAIL_IO_OPTION_INTERLACED        = 1 << 1,
 
     /* Instruction to read or write embedded ICC profile. */
-    SAIL_IO_OPTION_ICCP       = 1 << 2,
+    SAIL_IO_OPTION_ICCP              = 1 << 2,
+
+    /*
+     * Instruction to keep the original compressed data of the first frame in sail_source_image when reading,
+     * or to write the kept data unchanged instead of encoding pixels when writing. See sail_source_image.
+     */
+    SAIL_IO_OPTION_SOURCE_DATA       = 1 << 3,
+
+    /*
+     * Instruction to apply the EXIF orientation while decoding, so frames are returned as they must be displayed.
+     * Rotated frames have their width and height swapped. See sail_source_image.orientation.
+     * Scan lines are placed into the oriented frame as soon as they're decoded, so frames are never decoded
+     * in parallel with this option. Specifying this option for writing operations has no effect.
+     */
+    SAIL_IO_OPTION_APPLY_ORIENTATION = 1 << 4,
+
+    /*
+     * Instruction to return frames with their auxiliary data (resolution, palette, meta data, ICC profile,
+     * and source image) compacted into a single memory block like sail_compact_image() does. Destroying
+     * and copying such frames takes one allocation instead of one per object. The compacted data must be
+     * treated as read-only. Specifying this option for writing operations has no effect.
+     */
+    SAIL_IO_OPTION_COMPACT           = 1 << 5,
+};
+
+/*
+ * Decoding speed and quality trade-off. Codecs map it to the knobs of their underlying libraries.
+ * Codecs without such knobs decode with the best quality regardless of the option.
+ */
+enum SailDecodeQuality {
+
+    /* Library defaults. Decode with the best quality. */
+    SAIL_DECODE_QUALITY_BEST,
+
+    /*
+     * Skip work that rarely affects the result visibly, like the accurate JPEG DCT
+     * or checksums of ancillary PNG chunks.
+     */
+    SAIL_DECODE_QUALITY_BALANCED,
+
+    /*
+     * Decode as fast as possible for previews. Disables smooth chroma upsampling, in-loop filtering,
+     * and all checksum verification. JPEG 2000 decodes the first quality layer only.
+     */
+    SAIL_DECODE_QUALITY_FASTEST,
 };
 
+/*
+ * Lossless transformations of the original compressed data. JPEG transforms DCT coefficients
+ * like jpegtran does, so the result is not re-compressed.
+ */
+enum SailLosslessTransform {
+
+    /* No transformation. */
+    SAIL_LOSSLESS_TRANSFORM_NONE,
+
+    /* Mirror the image horizontally. */
+    SAIL_LOSSLESS_TRANSFORM_FLIP_HORIZONTALLY,
+
+    /* Mirror the image vertically. */
+    SAIL_LOSSLESS_TRANSFORM_FLIP_VERTICALLY,
+
+    /* Transpose the image across the upper-left to lower-right axis. */
+    SAIL_LOSSLESS_TRANSFORM_TRANSPOSE,
+
+    /* Rotate the image clockwise. */
+    SAIL_LOSSLESS_TRANSFORM_ROTATE_90,
+    SAIL_LOSSLESS_TRANSFORM_ROTATE_180,
+    SAIL_LOSSLESS_TRANSFORM_ROTATE_270,
+
+    /* Crop the image to the rectangle specified in the write options. */
+    SAIL_LOSSLESS_TRANSFORM_CROP,
+};
+
+/*
+ * Forward DCT methods used by codecs that encode DCT blocks, like JPEG.
+ */
+enum SailDctMethod {
+
+    /* Codec default. JPEG uses SAIL_DCT_METHOD_ISLOW. */
+    SAIL_DCT_METHOD_DEFAULT,
+
+    /* Accurate integer DCT. */
+    SAIL_DCT_METHOD_ISLOW,
+
+    /* Fast integer DCT. Less accurate, mostly at high quality levels. */
+    SAIL_DCT_METHOD_IFAST,
+
+    /* Floating-point DCT. Accurate, but its results depend on the machine. */
+    SAIL_DCT_METHOD_FLOAT,
+};
+
+/*
+ * Filters applied to scan lines before compressing them, like PNG filters. Or-ed filters
+ * are chosen adaptively for every scan line.
+ */
+enum SailRowFilter {
+
+    /* Scan lines are compressed unchanged. */
+    SAIL_ROW_FILTER_NONE    = 1 << 0,
+
+    /* Difference from the left pixel. */
+    SAIL_ROW_FILTER_SUB     = 1 << 1,
+
+    /* Difference from the pixel above. */
+    SAIL_ROW_FILTER_UP      = 1 << 2,
+
+    /* Difference from the average of the left pixel and the pixel above. */
+    SAIL_ROW_FILTER_AVERAGE = 1 << 3,
+
+    /* Difference from the Paeth predictor of the left, upper, and upper left pixels. */
+    SAIL_ROW_FILTER_PAETH   = 1 << 4,
+
+    /* All the filters chosen adaptively. */
+    SAIL_ROW_FILTER_ALL     = SAIL_ROW_FILTER_NONE | SAIL_ROW_FILTER_SUB | SAIL_ROW_FILTER_UP |
+                                SAIL_ROW_FILTER_AVERAGE | SAIL_ROW_FILTER_PAETH,
+};
+
+/*
+ * Strategies of codecs that compress with zlib, like PNG.
+ */
+enum SailZlibStrategy {
+
+    /* Codec default. PNG uses SAIL_ZLIB_STRATEGY_FILTERED for filtered images. */
+    SAIL_ZLIB_STRATEGY_DEFAULT,
+
+    /* zlib default strategy. Best for unfiltered data. */
+    SAIL_ZLIB_STRATEGY_GENERIC,
+
+    /* Prefer Huffman coding of small differences produced by filters. */
+    SAIL_ZLIB_STRATEGY_FILTERED,
+
+    /* Huffman coding only, no string matching. */
+    SAIL_ZLIB_STRATEGY_HUFFMAN_ONLY,
+
+    /* Match runs of repeated bytes only. Nearly as fast as SAIL_ZLIB_STRATEGY_HUFFMAN_ONLY, but compresses flat areas well. */
+    SAIL_ZLIB_STRATEGY_RLE,
+
+    /* Use fixed Huffman codes. */
+    SAIL_ZLIB_STRATEGY_FIXED,
+};
+
+/*
+ * Encoding speed and size trade-off. Codecs map it to the knobs of their underlying libraries
+ * and ignore the compression level. Codecs without such knobs ignore the preset.
+ */
+enum SailEncodePreset {
+
+    /* Use the compression level and the codec defaults. */
+    SAIL_ENCODE_PRESET_DEFAULT,
+
+    /*
+     * Encode as fast as possible. PNG writes unfiltered scan lines with the fastest zlib level.
+     * Indexed images are compressed with run-length matching.
+     */
+    SAIL_ENCODE_PRESET_FASTEST,
+
+    /* Good compression at a moderate speed. PNG uses cheap filters and a medium zlib level. */
+    SAIL_ENCODE_PRESET_BALANCED,
+
+    /*
+     * Make files as small as possible regardless of the speed. PNG compresses frames with several filter
+     * heuristics and keeps the smallest result.
+     */
+    SAIL_ENCODE_PRESET_SMALLEST,
+};
+
+/*
+ * Progress callback for reading and writing operations. Codecs call it after every processed scan line
+ * or, when the underlying library reports progress on its own (like libjpeg), with an estimated number
+ * of scan lines. 'rows_done' never exceeds 'rows_total'. 'user_data' is the pointer set in the read
+ * or write options.
+ */
+typedef void (*sail_progress_t)(void *user_data, unsigned rows_done, unsigned rows_total);
+
 #endif
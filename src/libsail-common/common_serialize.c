@@ -448,6 +448,10 @@ const char* sail_codec_feature_to_string(enum SailCodecFeature codec_feature) {
         case SAIL_CODEC_FEATURE_META_DATA:   return "META-DATA";
         case SAIL_CODEC_FEATURE_INTERLACED:  return "INTERLACED";
         case SAIL_CODEC_FEATURE_ICCP:        return "ICCP";
+        case SAIL_CODEC_FEATURE_SKIP_FRAMES: return "SKIP-FRAMES";
+        case SAIL_CODEC_FEATURE_SCAN_LINES:  return "SCAN-LINES";
+        case SAIL_CODEC_FEATURE_SOURCE_DATA: return "SOURCE-DATA";
+        case SAIL_CODEC_FEATURE_LOSSLESS_TRANSFORM: return "LOSSLESS-TRANSFORM";
     }
 
     return NULL;
@@ -467,6 +471,10 @@ enum SailCodecFeature sail_codec_feature_from_string(const char *str) {
         case UINT64_C(249851542786072787):   return SAIL_CODEC_FEATURE_META_DATA;
         case UINT64_C(8244927930303708800):  return SAIL_CODEC_FEATURE_INTERLACED;
         case UINT64_C(6384139556):           return SAIL_CODEC_FEATURE_ICCP;
+        case UINT64_C(13843366173797148903): return SAIL_CODEC_FEATURE_SKIP_FRAMES;
+        case UINT64_C(8245375775078012786):  return SAIL_CODEC_FEATURE_SCAN_LINES;
+        case UINT64_C(13843568810204437629): return SAIL_CODEC_FEATURE_SOURCE_DATA;
+        case UINT64_C(13247132481540787334): return SAIL_CODEC_FEATURE_LOSSLESS_TRANSFORM;
     }
 
     return SAIL_CODEC_FEATURE_UNKNOWN;
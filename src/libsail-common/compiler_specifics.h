@@ -49,4 +49,17 @@
     #define SAIL_UNLIKELY(x) (x)
 #endif
 
+/* Atomic increment and decrement of unsigned long counters. Evaluate to the new value. */
+#if defined __GNUC__
+    #define SAIL_ATOMIC_INCREMENT(ptr) __atomic_add_fetch((ptr), 1, __ATOMIC_ACQ_REL)
+    #define SAIL_ATOMIC_DECREMENT(ptr) __atomic_sub_fetch((ptr), 1, __ATOMIC_ACQ_REL)
+#elif defined _MSC_VER
+    #include <intrin.h>
+    #define SAIL_ATOMIC_INCREMENT(ptr) ((unsigned long)_InterlockedIncrement((volatile long *)(ptr)))
+    #define SAIL_ATOMIC_DECREMENT(ptr) ((unsigned long)_InterlockedDecrement((volatile long *)(ptr)))
+#else
+    /* Syntax error. */
+    Do not know how to define atomic operations for this compiler.
+#endif
+
 #endif
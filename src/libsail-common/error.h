@@ -87,6 +87,8 @@ enum SailStatus {
     SAIL_ERROR_MISSING_PALETTE,
     SAIL_ERROR_UNSUPPORTED_FORMAT,
     SAIL_ERROR_BROKEN_IMAGE,
+    SAIL_ERROR_LIMIT_EXCEEDED,
+    SAIL_ERROR_THUMBNAIL_NOT_FOUND,
 
     /*
      * Codecs-specific errors.
@@ -106,6 +108,7 @@ enum SailStatus {
     SAIL_ERROR_CONTEXT_UNINITIALIZED,
     SAIL_ERROR_GET_DLL_PATH,
     SAIL_ERROR_CONFLICTING_OPERATION,
+    SAIL_ERROR_CANCELLED,
 };
 
 typedef enum SailStatus sail_status_t;
@@ -0,0 +1,276 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "sail-common.h"
+
+/* EXIF tags. */
+#define TAG_ORIENTATION                    0x0112
+#define TAG_JPEG_INTERCHANGE_FORMAT        0x0201
+#define TAG_JPEG_INTERCHANGE_FORMAT_LENGTH 0x0202
+
+/* EXIF field types. */
+#define TYPE_SHORT 3
+#define TYPE_LONG  4
+
+/* Size of an IFD entry: tag, type, count, and value or offset. */
+#define IFD_ENTRY_SIZE 12
+
+/* TIFF structure within the EXIF data. */
+struct tiff {
+
+    const unsigned char *data;
+    size_t size;
+    bool little_endian;
+};
+
+/*
+ * Private functions.
+ */
+
+static unsigned read16(const struct tiff *tiff, size_t offset) {
+
+    const unsigned char *p = tiff->data + offset;
+
+    return tiff->little_endian ? (unsigned)(p[0] | (p[1] << 8)) : (unsigned)((p[0] << 8) | p[1]);
+}
+
+static uint32_t read32(const struct tiff *tiff, size_t offset) {
+
+    const unsigned char *p = tiff->data + offset;
+
+    return tiff->little_endian
+            ? (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24)
+            : ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static bool open_tiff(const void *exif, size_t exif_size, struct tiff *tiff) {
+
+    static const unsigned char EXIF_HEADER[] = { 'E', 'x', 'i', 'f', 0, 0 };
+
+    const unsigned char *data = exif;
+
+    if (exif_size >= sizeof(EXIF_HEADER) && memcmp(data, EXIF_HEADER, sizeof(EXIF_HEADER)) == 0) {
+        data      += sizeof(EXIF_HEADER);
+        exif_size -= sizeof(EXIF_HEADER);
+    }
+
+    if (exif_size < 8) {
+        return false;
+    }
+
+    if (data[0] == 'I' && data[1] == 'I') {
+        tiff->little_endian = true;
+    } else if (data[0] == 'M' && data[1] == 'M') {
+        tiff->little_endian = false;
+    } else {
+        return false;
+    }
+
+    tiff->data = data;
+    tiff->size = exif_size;
+
+    return read16(tiff, 2) == 42;
+}
+
+/* Returns the number of entries in the IFD at the offset or false if the IFD is out of the data. */
+static bool ifd_entries(const struct tiff *tiff, uint32_t ifd_offset, unsigned *entries) {
+
+    if (ifd_offset < 8 || ifd_offset > tiff->size - 2) {
+        return false;
+    }
+
+    *entries = read16(tiff, ifd_offset);
+
+    return (size_t)*entries * IFD_ENTRY_SIZE + 4 <= tiff->size - ifd_offset - 2;
+}
+
+static bool next_ifd(const struct tiff *tiff, uint32_t ifd_offset, uint32_t *next_ifd_offset) {
+
+    unsigned entries;
+    if (!ifd_entries(tiff, ifd_offset, &entries)) {
+        return false;
+    }
+
+    *next_ifd_offset = read32(tiff, ifd_offset + 2 + entries * IFD_ENTRY_SIZE);
+
+    return *next_ifd_offset != 0;
+}
+
+/* Finds the entry of the tag with a single value in the IFD and returns its offset. */
+static bool find_entry(const struct tiff *tiff, uint32_t ifd_offset, unsigned tag, size_t *entry_offset) {
+
+    unsigned entries;
+    if (!ifd_entries(tiff, ifd_offset, &entries)) {
+        return false;
+    }
+
+    for (unsigned i = 0; i < entries; i++) {
+        const size_t offset = ifd_offset + 2 + (size_t)i * IFD_ENTRY_SIZE;
+
+        if (read16(tiff, offset) != tag) {
+            continue;
+        }
+
+        if (read32(tiff, offset + 4) != 1) {
+            return false;
+        }
+
+        *entry_offset = offset;
+
+        return true;
+    }
+
+    return false;
+}
+
+/* Finds the value of a SHORT or LONG tag with a single value in the IFD. */
+static bool find_tag(const struct tiff *tiff, uint32_t ifd_offset, unsigned tag, uint32_t *value) {
+
+    size_t entry_offset;
+    if (!find_entry(tiff, ifd_offset, tag, &entry_offset)) {
+        return false;
+    }
+
+    /* Values that fit into four bytes are stored in place and left-justified. */
+    switch (read16(tiff, entry_offset + 2)) {
+        case TYPE_SHORT: *value = read16(tiff, entry_offset + 8); return true;
+        case TYPE_LONG:  *value = read32(tiff, entry_offset + 8); return true;
+        default:         return false;
+    }
+}
+
+/*
+ * Public functions.
+ */
+
+bool sail_exif_thumbnail(const void *exif, size_t exif_size, const void **thumbnail, size_t *thumbnail_size) {
+
+    if (exif == NULL || thumbnail == NULL || thumbnail_size == NULL) {
+        return false;
+    }
+
+    struct tiff tiff;
+    if (!open_tiff(exif, exif_size, &tiff)) {
+        return false;
+    }
+
+    uint32_t ifd1_offset;
+    if (!next_ifd(&tiff, read32(&tiff, 4), &ifd1_offset)) {
+        return false;
+    }
+
+    uint32_t offset;
+    uint32_t length;
+    if (!find_tag(&tiff, ifd1_offset, TAG_JPEG_INTERCHANGE_FORMAT, &offset) ||
+            !find_tag(&tiff, ifd1_offset, TAG_JPEG_INTERCHANGE_FORMAT_LENGTH, &length)) {
+        return false;
+    }
+
+    if (length == 0 || offset > tiff.size || length > tiff.size - offset) {
+        return false;
+    }
+
+    *thumbnail      = tiff.data + offset;
+    *thumbnail_size = length;
+
+    return true;
+}
+
+bool sail_exif_orientation(const void *exif, size_t exif_size, enum SailOrientation *orientation) {
+
+    if (exif == NULL || orientation == NULL) {
+        return false;
+    }
+
+    struct tiff tiff;
+    if (!open_tiff(exif, exif_size, &tiff)) {
+        return false;
+    }
+
+    uint32_t value;
+    if (!find_tag(&tiff, read32(&tiff, 4), TAG_ORIENTATION, &value)) {
+        return false;
+    }
+
+    if (value < SAIL_ORIENTATION_NORMAL || value > SAIL_ORIENTATION_ROTATE_270) {
+        return false;
+    }
+
+    *orientation = (enum SailOrientation)value;
+
+    return true;
+}
+
+bool sail_exif_reset_orientation(void *exif, size_t exif_size) {
+
+    if (exif == NULL) {
+        return false;
+    }
+
+    struct tiff tiff;
+    if (!open_tiff(exif, exif_size, &tiff)) {
+        return false;
+    }
+
+    size_t entry_offset;
+    if (!find_entry(&tiff, read32(&tiff, 4), TAG_ORIENTATION, &entry_offset)
+            || read16(&tiff, entry_offset + 2) != TYPE_SHORT) {
+        return false;
+    }
+
+    /* The TIFF structure points into the EXIF data passed by the caller. */
+    unsigned char *value = (unsigned char *)tiff.data + entry_offset + 8;
+
+    value[0] = tiff.little_endian ? SAIL_ORIENTATION_NORMAL : 0;
+    value[1] = tiff.little_endian ? 0 : SAIL_ORIENTATION_NORMAL;
+
+    return true;
+}
+
+int sail_orientation_flip_properties(enum SailOrientation orientation) {
+
+    switch (orientation) {
+        case SAIL_ORIENTATION_FLIP_HORIZONTALLY: return SAIL_IMAGE_PROPERTY_FLIPPED_HORIZONTALLY;
+        case SAIL_ORIENTATION_FLIP_VERTICALLY:   return SAIL_IMAGE_PROPERTY_FLIPPED_VERTICALLY;
+        case SAIL_ORIENTATION_ROTATE_180:        return SAIL_IMAGE_PROPERTY_FLIPPED_HORIZONTALLY | SAIL_IMAGE_PROPERTY_FLIPPED_VERTICALLY;
+        default:                                 return 0;
+    }
+}
+
+void sail_set_source_orientation(struct sail_image *image, enum SailOrientation orientation) {
+
+    if (image == NULL || image->source_image == NULL || orientation == SAIL_ORIENTATION_NORMAL) {
+        return;
+    }
+
+    const int flip_properties = sail_orientation_flip_properties(orientation);
+
+    image->source_image->orientation  = orientation;
+    image->source_image->properties  |= flip_properties;
+    image->properties                |= flip_properties;
+}
@@ -0,0 +1,97 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_EXIF_H
+#define SAIL_EXIF_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef SAIL_BUILD
+    #include "common.h"
+    #include "export.h"
+#else
+    #include <sail-common/common.h>
+    #include <sail-common/export.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_image;
+
+/*
+ * Minimal EXIF parser. EXIF data is a TIFF structure with a list of image file
+ * directories (IFD). IFD0 describes the main image, IFD1 describes the embedded thumbnail.
+ * The EXIF data may or may not start with "Exif\0\0" like in SAIL_META_DATA_EXIF.
+ *
+ * The functions never access memory outside of the EXIF data and return false on broken data.
+ */
+
+/*
+ * Finds the JPEG thumbnail referenced by IFD1 of the EXIF data. On success, sets 'thumbnail'
+ * to point into the EXIF data.
+ *
+ * Returns true if the thumbnail has been found.
+ */
+SAIL_EXPORT bool sail_exif_thumbnail(const void *exif, size_t exif_size, const void **thumbnail, size_t *thumbnail_size);
+
+/*
+ * Finds the orientation of the main image in IFD0 of the EXIF data. Invalid orientation values
+ * are treated as missing.
+ *
+ * Returns true if the orientation has been found.
+ */
+SAIL_EXPORT bool sail_exif_orientation(const void *exif, size_t exif_size, enum SailOrientation *orientation);
+
+/*
+ * Sets the orientation of the main image in IFD0 of the EXIF data to SAIL_ORIENTATION_NORMAL in place.
+ * Codecs call this function when they transform images losslessly and keep the original EXIF data.
+ *
+ * Returns true if the orientation has been found and reset.
+ */
+SAIL_EXPORT bool sail_exif_reset_orientation(void *exif, size_t exif_size);
+
+/*
+ * Returns the or-ed SAIL_IMAGE_PROPERTY_FLIPPED_* properties of the orientation which only flips the image,
+ * or 0 if the orientation is normal or rotates the image. Codecs set these properties in frames
+ * decoded in the source orientation.
+ */
+SAIL_EXPORT int sail_orientation_flip_properties(enum SailOrientation orientation);
+
+/*
+ * Sets the orientation of the source image and the flip properties of the frame and its source image.
+ * Does nothing if the orientation is normal. The frame MUST have the source image allocated.
+ * Codecs call this function when they decode frames in the source orientation.
+ */
+SAIL_EXPORT void sail_set_source_orientation(struct sail_image *image, enum SailOrientation orientation);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -23,85 +23,247 @@
     SOFTWARE.
 */
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "sail-common.h"
 
-sail_status_t sail_alloc_image(struct sail_image **image) {
+/*
+ * Private functions.
+ */
 
-    SAIL_CHECK_PTR(image);
+/* Every object in an image arena starts at this boundary. */
+#define SAIL_IMAGE_ARENA_ALIGNMENT 16
 
-    void *ptr;
-    SAIL_TRY(sail_malloc(sizeof(struct sail_image), &ptr));
-    *image = ptr;
+#define SAIL_IMAGE_ARENA_ALIGN(size) (((size) + SAIL_IMAGE_ARENA_ALIGNMENT - 1) & ~(size_t)(SAIL_IMAGE_ARENA_ALIGNMENT - 1))
+
+/* Arena header. Used to tell compacted objects from objects assigned to the image later. */
+struct image_arena {
+    size_t size;
+};
+
+static bool arena_owns(const void *arena, const void *ptr) {
 
-    (*image)->pixels                  = NULL;
-    (*image)->width                   = 0;
-    (*image)->height                  = 0;
-    (*image)->bytes_per_line          = 0;
-    (*image)->resolution              = NULL;
-    (*image)->pixel_format            = SAIL_PIXEL_FORMAT_UNKNOWN;
-    (*image)->gamma                   = 1;
-    (*image)->delay                   = -1;
-    (*image)->palette                 = NULL;
-    (*image)->meta_data_node          = NULL;
-    (*image)->iccp                    = NULL;
-    (*image)->properties              = 0;
-    (*image)->source_image            = NULL;
+    if (arena == NULL || ptr == NULL) {
+        return false;
+    }
+
+    const uintptr_t begin = (uintptr_t)arena;
+    const uintptr_t end   = begin + ((const struct image_arena *)arena)->size;
+
+    return (uintptr_t)ptr >= begin && (uintptr_t)ptr < end;
+}
+
+static void *arena_take(unsigned char **cursor, size_t size) {
+
+    void *ptr = *cursor;
+    *cursor += SAIL_IMAGE_ARENA_ALIGN(size);
+
+    return ptr;
+}
+
+static sail_status_t palette_data_size(const struct sail_palette *palette, size_t *size) {
+
+    unsigned bits_per_pixel;
+    SAIL_TRY(sail_bits_per_pixel(palette->pixel_format, &bits_per_pixel));
+
+    *size = (size_t)palette->color_count * bits_per_pixel / 8;
 
     return SAIL_OK;
 }
 
-void sail_destroy_image(struct sail_image *image) {
+static sail_status_t arena_size(const struct sail_image *source, bool with_palette, size_t *size) {
 
-    if (image == NULL) {
-        return;
+    size_t size_local = SAIL_IMAGE_ARENA_ALIGN(sizeof(struct image_arena));
+
+    if (source->resolution != NULL) {
+        size_local += SAIL_IMAGE_ARENA_ALIGN(sizeof(struct sail_resolution));
     }
 
-    sail_free(image->pixels);
+    if (with_palette && source->palette != NULL) {
+        SAIL_CHECK_PTR(source->palette->data);
 
-    sail_destroy_resolution(image->resolution);
-    sail_destroy_palette(image->palette);
-    sail_destroy_meta_data_node_chain(image->meta_data_node);
-    sail_destroy_iccp(image->iccp);
-    sail_destroy_source_image(image->source_image);
+        size_t data_size;
+        SAIL_TRY(palette_data_size(source->palette, &data_size));
 
-    sail_free(image);
+        size_local += SAIL_IMAGE_ARENA_ALIGN(sizeof(struct sail_palette)) + SAIL_IMAGE_ARENA_ALIGN(data_size);
+    }
+
+    size_t nodes = 0;
+
+    for (const struct sail_meta_data_node *node = source->meta_data_node; node != NULL; node = node->next) {
+        SAIL_CHECK_PTR(node->meta_data);
+        SAIL_CHECK_PTR(node->meta_data->value);
+
+        if (node->meta_data->key_unknown != NULL) {
+            size_local += SAIL_IMAGE_ARENA_ALIGN(strlen(node->meta_data->key_unknown) + 1);
+        }
+
+        size_local += SAIL_IMAGE_ARENA_ALIGN(node->meta_data->value_length);
+        nodes++;
+    }
+
+    if (nodes > 0) {
+        size_local += SAIL_IMAGE_ARENA_ALIGN(nodes * sizeof(struct sail_meta_data_node));
+        size_local += SAIL_IMAGE_ARENA_ALIGN(nodes * sizeof(struct sail_meta_data));
+    }
+
+    if (source->iccp != NULL) {
+        SAIL_CHECK_PTR(source->iccp->data);
+
+        size_local += SAIL_IMAGE_ARENA_ALIGN(sizeof(struct sail_iccp)) + SAIL_IMAGE_ARENA_ALIGN(source->iccp->data_length);
+    }
+
+    if (source->source_image != NULL) {
+        size_local += SAIL_IMAGE_ARENA_ALIGN(sizeof(struct sail_source_image)) + SAIL_IMAGE_ARENA_ALIGN(source->source_image->data_size);
+    }
+
+    *size = size_local;
+
+    return SAIL_OK;
 }
 
-sail_status_t sail_copy_image(const struct sail_image *source, struct sail_image **target) {
+/*
+ * Copies the auxiliary data of the source image into a newly allocated arena and points
+ * the target fields to the copies. The target auxiliary fields must be empty.
+ */
+static sail_status_t copy_aux_data_to_arena(const struct sail_image *source, bool with_palette, struct sail_image *target) {
 
-    SAIL_CHECK_PTR(source);
-    SAIL_CHECK_PTR(target);
+    size_t size;
+    SAIL_TRY(arena_size(source, with_palette, &size));
 
-    struct sail_image *image_local;
-    SAIL_TRY(sail_copy_image_skeleton(source, &image_local));
+    void *ptr;
+    SAIL_TRY(sail_malloc(size, &ptr));
 
-    /* Pixels. */
-    if (source->pixels != NULL) {
-        const unsigned pixels_size = source->height * source->bytes_per_line;
+    ((struct image_arena *)ptr)->size = size;
 
-        SAIL_TRY_OR_CLEANUP(sail_malloc(pixels_size, &image_local->pixels),
-                            /* cleanup */ sail_destroy_image(image_local));
+    unsigned char *cursor = ptr;
+    arena_take(&cursor, sizeof(struct image_arena));
 
-        memcpy(image_local->pixels, source->pixels, pixels_size);
+    if (source->resolution != NULL) {
+        target->resolution = arena_take(&cursor, sizeof(struct sail_resolution));
+        *target->resolution = *source->resolution;
     }
 
-    /* Palette. */
-    if (source->palette != NULL) {
-        SAIL_TRY_OR_CLEANUP(sail_copy_palette(source->palette, &image_local->palette),
-                            /* cleanup */ sail_destroy_image(image_local));
+    if (with_palette && source->palette != NULL) {
+        size_t data_size;
+        SAIL_TRY_OR_CLEANUP(palette_data_size(source->palette, &data_size),
+                            /* cleanup */ sail_free(ptr));
 
+        target->palette = arena_take(&cursor, sizeof(struct sail_palette));
+        *target->palette = *source->palette;
+        target->palette->data = arena_take(&cursor, data_size);
+        memcpy(target->palette->data, source->palette->data, data_size);
     }
 
-    *target = image_local;
+    size_t nodes = 0;
+
+    for (const struct sail_meta_data_node *node = source->meta_data_node; node != NULL; node = node->next) {
+        nodes++;
+    }
+
+    if (nodes > 0) {
+        struct sail_meta_data_node *target_nodes = arena_take(&cursor, nodes * sizeof(struct sail_meta_data_node));
+        struct sail_meta_data *target_meta_data  = arena_take(&cursor, nodes * sizeof(struct sail_meta_data));
+
+        const struct sail_meta_data_node *node = source->meta_data_node;
+
+        for (size_t i = 0; i < nodes; i++, node = node->next) {
+            struct sail_meta_data *meta_data = &target_meta_data[i];
+            *meta_data = *node->meta_data;
+
+            if (node->meta_data->key_unknown != NULL) {
+                const size_t key_size = strlen(node->meta_data->key_unknown) + 1;
+
+                meta_data->key_unknown = arena_take(&cursor, key_size);
+                memcpy(meta_data->key_unknown, node->meta_data->key_unknown, key_size);
+            }
+
+            meta_data->value = arena_take(&cursor, node->meta_data->value_length);
+            memcpy(meta_data->value, node->meta_data->value, node->meta_data->value_length);
+
+            target_nodes[i].meta_data = meta_data;
+            target_nodes[i].next      = (i + 1 < nodes) ? &target_nodes[i + 1] : NULL;
+        }
+
+        target->meta_data_node = target_nodes;
+    }
+
+    if (source->iccp != NULL) {
+        target->iccp = arena_take(&cursor, sizeof(struct sail_iccp));
+        target->iccp->data_length = source->iccp->data_length;
+        target->iccp->data = arena_take(&cursor, source->iccp->data_length);
+        memcpy(target->iccp->data, source->iccp->data, source->iccp->data_length);
+    }
+
+    if (source->source_image != NULL) {
+        target->source_image = arena_take(&cursor, sizeof(struct sail_source_image));
+        *target->source_image = *source->source_image;
+
+        /* The original compressed data is owned by the source image, so it's copied too. */
+        if (source->source_image->data != NULL) {
+            target->source_image->data = arena_take(&cursor, source->source_image->data_size);
+            memcpy(target->source_image->data, source->source_image->data, source->source_image->data_size);
+        }
+    }
+
+    target->arena = ptr;
 
     return SAIL_OK;
 }
 
-sail_status_t sail_copy_image_skeleton(const struct sail_image *source, struct sail_image **target) {
+/*
+ * Destroys the auxiliary image data. Objects that live in the image arena are released
+ * with the arena. Objects assigned to the image after compacting are destroyed one by one.
+ */
+static void destroy_aux_data(struct sail_image *image) {
+
+    if (image->arena == NULL) {
+        sail_destroy_resolution(image->resolution);
+        sail_destroy_palette(image->palette);
+        sail_destroy_meta_data_node_chain(image->meta_data_node);
+        sail_destroy_iccp(image->iccp);
+        sail_destroy_source_image(image->source_image);
+        return;
+    }
+
+    if (!arena_owns(image->arena, image->resolution)) {
+        sail_destroy_resolution(image->resolution);
+    }
+    if (!arena_owns(image->arena, image->palette)) {
+        sail_destroy_palette(image->palette);
+    }
+
+    for (struct sail_meta_data_node *node = image->meta_data_node; node != NULL;) {
+        struct sail_meta_data_node *node_next = node->next;
+
+        if (!arena_owns(image->arena, node)) {
+            sail_destroy_meta_data_node(node);
+        } else if (!arena_owns(image->arena, node->meta_data)) {
+            sail_destroy_meta_data(node->meta_data);
+        }
+
+        node = node_next;
+    }
+
+    if (!arena_owns(image->arena, image->iccp)) {
+        sail_destroy_iccp(image->iccp);
+    }
+    if (!arena_owns(image->arena, image->source_image)) {
+        sail_destroy_source_image(image->source_image);
+    }
+
+    sail_free(image->arena);
+}
+
+/*
+ * Copies the image without pixels. Compacted images produce compacted copies with a single
+ * allocation. The palette is copied into the arena of such copies if with_palette is true.
+ */
+static sail_status_t copy_image_skeleton(const struct sail_image *source, bool with_palette, struct sail_image **target) {
 
     SAIL_CHECK_PTR(source);
     SAIL_CHECK_PTR(target);
@@ -112,6 +274,19 @@ sail_status_t sail_copy_image_skeleton(const struct sail_image *source, struct s
     image_local->width                = source->width;
     image_local->height               = source->height;
     image_local->bytes_per_line       = source->bytes_per_line;
+    image_local->pixel_format         = source->pixel_format;
+    image_local->gamma                = source->gamma;
+    image_local->delay                = source->delay;
+    image_local->properties           = source->properties;
+
+    if (source->arena != NULL) {
+        SAIL_TRY_OR_CLEANUP(copy_aux_data_to_arena(source, with_palette, image_local),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        *target = image_local;
+
+        return SAIL_OK;
+    }
 
     if (source->resolution != NULL) {
         SAIL_TRY_OR_CLEANUP(sail_copy_resolution(source->resolution, &image_local->resolution),
@@ -119,10 +294,6 @@ sail_status_t sail_copy_image_skeleton(const struct sail_image *source, struct s
 
     }
 
-    image_local->pixel_format = source->pixel_format;
-    image_local->gamma        = source->gamma;
-    image_local->delay        = source->delay;
-
     SAIL_TRY_OR_CLEANUP(sail_copy_meta_data_node_chain(source->meta_data_node, &image_local->meta_data_node),
                         /* cleanup */ sail_destroy_image(image_local));
 
@@ -131,8 +302,6 @@ sail_status_t sail_copy_image_skeleton(const struct sail_image *source, struct s
                             /* cleanup */ sail_destroy_image(image_local));
     }
 
-    image_local->properties = source->properties;
-
     if (source->source_image != NULL) {
         SAIL_TRY_OR_CLEANUP(sail_copy_source_image(source->source_image, &image_local->source_image),
                             /* cleanup */ sail_destroy_image(image_local));
@@ -143,6 +312,194 @@ sail_status_t sail_copy_image_skeleton(const struct sail_image *source, struct s
     return SAIL_OK;
 }
 
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_alloc_image(struct sail_image **image) {
+
+    SAIL_CHECK_PTR(image);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sail_image), &ptr));
+    *image = ptr;
+
+    (*image)->pixels                   = NULL;
+    (*image)->width                    = 0;
+    (*image)->height                   = 0;
+    (*image)->bytes_per_line           = 0;
+    (*image)->resolution               = NULL;
+    (*image)->pixel_format             = SAIL_PIXEL_FORMAT_UNKNOWN;
+    (*image)->gamma                    = 1;
+    (*image)->delay                    = -1;
+    (*image)->palette                  = NULL;
+    (*image)->meta_data_node           = NULL;
+    (*image)->iccp                     = NULL;
+    (*image)->properties               = 0;
+    (*image)->source_image             = NULL;
+    (*image)->arena                    = NULL;
+    (*image)->parent                   = NULL;
+    (*image)->references               = 1;
+    (*image)->release_pixels           = NULL;
+    (*image)->release_pixels_user_data = NULL;
+
+    return SAIL_OK;
+}
+
+void sail_destroy_image(struct sail_image *image) {
+
+    if (image == NULL) {
+        return;
+    }
+
+    if (SAIL_ATOMIC_DECREMENT(&image->references) > 0) {
+        return;
+    }
+
+    /* Views don't own their pixels. */
+    if (image->parent != NULL) {
+        sail_destroy_image(image->parent);
+    } else if (image->release_pixels != NULL) {
+        image->release_pixels(image->release_pixels_user_data, image->pixels, (size_t)image->bytes_per_line * image->height);
+    } else {
+        sail_free(image->pixels);
+    }
+
+    destroy_aux_data(image);
+
+    sail_free(image);
+}
+
+sail_status_t sail_image_ref(struct sail_image *image) {
+
+    SAIL_CHECK_PTR(image);
+
+    SAIL_ATOMIC_INCREMENT(&image->references);
+
+    return SAIL_OK;
+}
+
+void sail_image_unref(struct sail_image *image) {
+
+    sail_destroy_image(image);
+}
+
+sail_status_t sail_image_view(struct sail_image *source, unsigned x, unsigned y, unsigned width, unsigned height,
+                              struct sail_image **view) {
+
+    SAIL_TRY(sail_check_image_valid(source));
+    SAIL_CHECK_PTR(view);
+
+    if (width == 0 || height == 0 || x > source->width || width > source->width - x || y > source->height || height > source->height - y) {
+        SAIL_LOG_ERROR("View %ux%u at %u,%u doesn't fit into the image %ux%u", width, height, x, y, source->width, source->height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    unsigned bits_per_pixel;
+    SAIL_TRY(sail_bits_per_pixel(source->pixel_format, &bits_per_pixel));
+
+    if ((size_t)x * bits_per_pixel % 8 != 0) {
+        SAIL_LOG_ERROR("View of %s pixels at column %u doesn't start at a byte boundary", sail_pixel_format_to_string(source->pixel_format), x);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct sail_image *image_local;
+    SAIL_TRY(copy_image_skeleton(source, true, &image_local));
+
+    if (source->palette != NULL && image_local->palette == NULL) {
+        SAIL_TRY_OR_CLEANUP(sail_copy_palette(source->palette, &image_local->palette),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_image_ref(source),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    image_local->width  = width;
+    image_local->height = height;
+    image_local->pixels = (unsigned char *)source->pixels + source->bytes_per_line * y + (size_t)x * bits_per_pixel / 8;
+    image_local->parent = source;
+
+    *view = image_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_copy_image(const struct sail_image *source, struct sail_image **target) {
+
+    SAIL_CHECK_PTR(source);
+    SAIL_CHECK_PTR(target);
+
+    struct sail_image *image_local;
+    SAIL_TRY(copy_image_skeleton(source, true, &image_local));
+
+    /* Pixels. Views are copied row by row into tightly packed pixels. */
+    if (source->pixels != NULL && source->parent != NULL) {
+        SAIL_TRY_OR_CLEANUP(sail_bytes_per_line(source->width, source->pixel_format, &image_local->bytes_per_line),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        size_t pixels_size;
+        SAIL_TRY_OR_CLEANUP(sail_bytes_per_image(image_local, &pixels_size),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        SAIL_TRY_OR_CLEANUP(sail_malloc_pixels(pixels_size, &image_local->pixels),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        for (unsigned row = 0; row < source->height; row++) {
+            memcpy((unsigned char *)image_local->pixels + image_local->bytes_per_line * row,
+                   (const unsigned char *)source->pixels + source->bytes_per_line * row,
+                   image_local->bytes_per_line);
+        }
+    } else if (source->pixels != NULL) {
+        size_t pixels_size;
+        SAIL_TRY_OR_CLEANUP(sail_bytes_per_image(source, &pixels_size),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        SAIL_TRY_OR_CLEANUP(sail_malloc_pixels(pixels_size, &image_local->pixels),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        memcpy(image_local->pixels, source->pixels, pixels_size);
+    }
+
+    /* Palette. Compacted copies already have it. */
+    if (source->palette != NULL && image_local->palette == NULL) {
+        SAIL_TRY_OR_CLEANUP(sail_copy_palette(source->palette, &image_local->palette),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+    }
+
+    *target = image_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_copy_image_skeleton(const struct sail_image *source, struct sail_image **target) {
+
+    SAIL_TRY(copy_image_skeleton(source, false, target));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_compact_image(struct sail_image *image) {
+
+    SAIL_CHECK_PTR(image);
+
+    struct sail_image image_local = *image;
+    image_local.resolution     = NULL;
+    image_local.palette        = NULL;
+    image_local.meta_data_node = NULL;
+    image_local.iccp           = NULL;
+    image_local.source_image   = NULL;
+    image_local.arena          = NULL;
+
+    SAIL_TRY(copy_aux_data_to_arena(image, true, &image_local));
+
+    destroy_aux_data(image);
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_check_image_skeleton_valid(const struct sail_image *image)
 {
     SAIL_CHECK_PTR(image);
@@ -156,6 +513,10 @@ sail_status_t sail_check_image_skeleton_valid(const struct sail_image *image)
     if (image->bytes_per_line == 0) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_BYTES_PER_LINE);
     }
+    if (image->height > SIZE_MAX / image->bytes_per_line) {
+        SAIL_LOG_ERROR("Image size %u x %lu bytes overflows the address space", image->height, (unsigned long)image->bytes_per_line);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
 
     return SAIL_OK;
 }
@@ -179,13 +540,20 @@ sail_status_t sail_flip_vertically(struct sail_image *image) {
 
     SAIL_TRY(sail_check_image_valid(image));
 
+    /* Swap only the image pixels as views share the stride with other pixels. */
+    size_t row_size;
+    SAIL_TRY(sail_bytes_per_line(image->width, image->pixel_format, &row_size));
+
     void *line;
-    SAIL_TRY(sail_malloc(image->bytes_per_line, &line));
+    SAIL_TRY(sail_malloc(row_size, &line));
 
     for (unsigned row1 = 0, row2 = image->height - 1; row1 < row2; row1++, row2--) {
-        memcpy(line,                                                          (unsigned char *)image->pixels + image->bytes_per_line * row1, image->bytes_per_line);
-        memcpy((unsigned char *)image->pixels + image->bytes_per_line * row1, (unsigned char *)image->pixels + image->bytes_per_line * row2, image->bytes_per_line);
-        memcpy((unsigned char *)image->pixels + image->bytes_per_line * row2, line,                                                          image->bytes_per_line);
+        unsigned char *scan1 = (unsigned char *)image->pixels + image->bytes_per_line * row1;
+        unsigned char *scan2 = (unsigned char *)image->pixels + image->bytes_per_line * row2;
+
+        memcpy(line,  scan1, row_size);
+        memcpy(scan1, scan2, row_size);
+        memcpy(scan2, line,  row_size);
     }
 
     sail_free(line);
@@ -199,8 +567,15 @@ sail_status_t sail_flip_horizontally(struct sail_image *image) {
 
     SAIL_TRY(sail_check_image_valid(image));
 
-    unsigned bytes_per_pixel;
-    SAIL_TRY(sail_bits_per_pixel(image->pixel_format, &bytes_per_pixel));
+    unsigned bits_per_pixel;
+    SAIL_TRY(sail_bits_per_pixel(image->pixel_format, &bits_per_pixel));
+
+    if (bits_per_pixel % 8 != 0) {
+        SAIL_LOG_ERROR("Horizontal flipping of %s pixels is not currently supported", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    const unsigned bytes_per_pixel = bits_per_pixel / 8;
 
     void *pixel;
     SAIL_TRY(sail_malloc(bytes_per_pixel, &pixel));
@@ -208,7 +583,7 @@ sail_status_t sail_flip_horizontally(struct sail_image *image) {
     for (unsigned row = 0; row < image->height; row++) {
         unsigned char *scan = (unsigned char *)image->pixels + image->bytes_per_line * row;
 
-        for (unsigned col1 = 0, col2 = image->width - bytes_per_pixel; col1 < col2; col1 += bytes_per_pixel, col2 -= bytes_per_pixel) {
+        for (size_t col1 = 0, col2 = (size_t)(image->width - 1) * bytes_per_pixel; col1 < col2; col1 += bytes_per_pixel, col2 -= bytes_per_pixel) {
             memcpy(pixel,       scan + col1, bytes_per_pixel);
             memcpy(scan + col1, scan + col2, bytes_per_pixel);
             memcpy(scan + col2, pixel,       bytes_per_pixel);
@@ -27,6 +27,7 @@
 #define SAIL_IMAGE_H
 
 #include <stdbool.h>
+#include <stddef.h> /* size_t */
 
 #ifdef SAIL_BUILD
     #include "error.h"
@@ -46,6 +47,12 @@ struct sail_palette;
 struct sail_resolution;
 struct sail_source_image;
 
+/*
+ * Releases image pixels not allocated with sail_malloc(), e.g. memory-mapped pixels. 'user_data'
+ * is the pointer set in the image along with the function. 'pixels_size' is bytes_per_line * height.
+ */
+typedef void (*sail_release_pixels_t)(void *user_data, void *pixels, size_t pixels_size);
+
 /*
  * sail_image represents an image. Fields set by SAIL when reading images are marked with READ.
  * Fields that must be set by a caller when writing images are marked with WRITE.
@@ -83,7 +90,7 @@ struct sail_image {
      * WRITE: Must be set by a caller to a positive number of bytes per line. A caller could set
      *        it to sail_bytes_per_line() if scan lines are not padded to a certain boundary.
      */
-    unsigned bytes_per_line;
+    size_t bytes_per_line;
 
     /*
      * Image resolution.
@@ -173,6 +180,46 @@ struct sail_image {
      * WRITE: Ignored.
      */
     struct sail_source_image *source_image;
+
+    /*
+     * Single memory block holding the auxiliary image data (resolution, palette, meta data, ICC profile,
+     * and source image) when the image is compacted with sail_compact_image(). NULL otherwise.
+     * Destroyed by sail_destroy_image().
+     *
+     * READ:  Set by SAIL to NULL.
+     * WRITE: Ignored.
+     */
+    void *arena;
+
+    /*
+     * Parent image if the image is a view created with sail_image_view(). The pixels of a view point
+     * into the parent pixels, and bytes_per_line is the parent stride. The view holds a reference
+     * to the parent, so the parent pixels stay valid until the view is destroyed. NULL otherwise.
+     *
+     * READ:  Set by SAIL to NULL.
+     * WRITE: Ignored.
+     */
+    struct sail_image *parent;
+
+    /*
+     * Number of references to the image. Managed with sail_image_ref() and sail_image_unref().
+     *
+     * READ:  Set by SAIL to 1.
+     * WRITE: Ignored.
+     */
+    unsigned long references;
+
+    /*
+     * Function called by sail_destroy_image() with the last reference to release the pixels, and its user data.
+     * Set for pixels not allocated with sail_malloc(), like the pixels of shared-memory images or mapped
+     * SAIL raw files. NULL if the pixels are released with sail_free(). Views don't release the parent pixels,
+     * so the pixels stay mapped until the last view of the image is destroyed.
+     *
+     * READ:  Set by SAIL to NULL.
+     * WRITE: Ignored.
+     */
+    sail_release_pixels_t release_pixels;
+    void *release_pixels_user_data;
 };
 
 typedef struct sail_image sail_image_t;
@@ -185,13 +232,49 @@ typedef struct sail_image sail_image_t;
 SAIL_EXPORT sail_status_t sail_alloc_image(struct sail_image **image);
 
 /*
- * Destroys the specified image and all its internal allocated memory buffers. The image MUST NOT be used anymore
- * after calling this function. Does nothing if the image is NULL.
+ * Releases a reference to the specified image. When the last reference is released, destroys the image
+ * and all its internal allocated memory buffers. Views release their reference to the parent image.
+ * The caller MUST NOT use the image anymore after calling this function. Does nothing if the image is NULL.
+ *
+ * Same as sail_image_unref().
  */
 SAIL_EXPORT void sail_destroy_image(struct sail_image *image);
 
 /*
- * Makes a deep copy of the specified image. The assigned image MUST be destroyed later with sail_destroy_image().
+ * Adds a reference to the specified image. Every reference MUST be released later
+ * with sail_image_unref() or sail_destroy_image(). Reference counting is thread-safe.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_image_ref(struct sail_image *image);
+
+/*
+ * Releases a reference to the specified image. See sail_destroy_image().
+ */
+SAIL_EXPORT void sail_image_unref(struct sail_image *image);
+
+/*
+ * Creates a view of the specified rectangle of the source image without copying pixels. The view pixels
+ * point into the source pixels, and bytes_per_line is the source stride. The view copies the other
+ * image properties, and holds a reference to the source image. Changing the view pixels changes
+ * the source pixels.
+ *
+ * The rectangle must fit into the source image. For pixel formats with less than 8 bits per pixel,
+ * the rectangle must start at a byte boundary.
+ *
+ * Views are accepted by sail_copy_image(), the conversion and flip functions, and the saving functions.
+ * sail_copy_image() makes a copy with its own tightly packed pixels.
+ *
+ * The assigned view MUST be destroyed later with sail_destroy_image().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_image_view(struct sail_image *source, unsigned x, unsigned y, unsigned width, unsigned height,
+                                          struct sail_image **view);
+
+/*
+ * Makes a deep copy of the specified image. Copies of views own their pixels.
+ * The assigned image MUST be destroyed later with sail_destroy_image().
  *
  * Returns SAIL_OK on success.
  */
@@ -208,6 +291,25 @@ SAIL_EXPORT sail_status_t sail_copy_image(const struct sail_image *source, struc
  */
 SAIL_EXPORT sail_status_t sail_copy_image_skeleton(const struct sail_image *source, struct sail_image **target);
 
+/*
+ * Moves the auxiliary image data (resolution, palette, meta data, ICC profile, and source image)
+ * into a single memory block owned by the image. Meta data nodes are placed into a flat array
+ * and remain linked with their next pointers, so the existing structures keep working as views.
+ * Pixels are not touched.
+ *
+ * Compacted auxiliary data must be treated as read-only. To change it, assign a newly allocated
+ * object to the image field. The replaced compacted object is released along with the block
+ * by sail_destroy_image().
+ *
+ * Copies of compacted images made with sail_copy_image() and sail_copy_image_skeleton()
+ * are compacted as well. This reduces the number of allocations to one per copy.
+ *
+ * Reading operations return compacted frames when SAIL_IO_OPTION_COMPACT is requested in the read options.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_compact_image(struct sail_image *image);
+
 /*
  * Returns SAIL_OK if the given image has valid pixel_format, dimensions, and bytes per line.
  *
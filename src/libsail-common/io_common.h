@@ -116,16 +116,26 @@ typedef sail_status_t (*sail_io_close_t)(void *stream);
 typedef sail_status_t (*sail_io_eof_t)(void *stream, bool *result);
 
 /*
- * Well-known I/O ids used in libsail for file and memory I/O classes.
+ * Assigns the whole contents of the underlying I/O object and its size. Only I/O objects that keep
+ * their contents in memory for reading implement it. Codecs use it to decode directly from memory
+ * without copying. The data remains valid until the I/O object is closed.
+ * Returns SAIL_OK on success.
+ */
+typedef sail_status_t (*sail_io_contents_t)(void *stream, const void **data, size_t *data_size);
+
+/*
+ * Well-known I/O ids used in libsail for file, memory-mapped file, and memory I/O classes.
  *
  * You MUST use your own unique id for custom I/O classes. For example, you can use sail_hash()
  * to generate a unique id and store it in the source code.
  *
- * SAIL_FILE_IO_ID   = sail_hash("sail-file-io-id")
- * SAIL_MEMORY_IO_ID = sail_hash("sail-memory-io-id")
+ * SAIL_FILE_IO_ID        = sail_hash("sail-file-io-id")
+ * SAIL_MAPPED_FILE_IO_ID = sail_hash("sail-mapped-file-io-id")
+ * SAIL_MEMORY_IO_ID      = sail_hash("sail-memory-io-id")
  */
-static const uint64_t SAIL_FILE_IO_ID   = UINT64_C(5820790535323209114);
-static const uint64_t SAIL_MEMORY_IO_ID = UINT64_C(11955407548648566675);
+static const uint64_t SAIL_FILE_IO_ID        = UINT64_C(5820790535323209114);
+static const uint64_t SAIL_MAPPED_FILE_IO_ID = UINT64_C(7820332871179714302);
+static const uint64_t SAIL_MEMORY_IO_ID      = UINT64_C(11955407548648566675);
 
 /* I/O features. */
 enum SailIoFeature {
@@ -207,6 +217,11 @@ struct sail_io {
      * EOF callback.
      */
     sail_io_eof_t eof;
+
+    /*
+     * Contents callback. Optional. NULL if the I/O object doesn't keep its contents in memory.
+     */
+    sail_io_contents_t contents;
 };
 
 typedef struct sail_io sail_io_t;
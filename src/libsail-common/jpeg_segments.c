@@ -0,0 +1,77 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stddef.h>
+
+#include "sail-common.h"
+
+/* Standalone markers. */
+#define MARKER_TEM  0x01
+#define MARKER_RST0 0xD0
+#define MARKER_EOI  0xD9
+
+/*
+ * Public functions.
+ */
+
+bool sail_jpeg_next_segment(const void *data, size_t data_size, size_t position,
+                            int *marker, size_t *payload_offset, size_t *segment_size) {
+
+    const unsigned char *bytes = data;
+
+    /* Markers may be preceded by any number of fill bytes. */
+    size_t marker_position = position;
+
+    while (marker_position < data_size && bytes[marker_position] == 0xFF) {
+        marker_position++;
+    }
+
+    if (marker_position == position || marker_position + 2 >= data_size) {
+        return false;
+    }
+
+    *marker = bytes[marker_position];
+
+    /* Standalone markers are not expected before the scan data. */
+    if (*marker == MARKER_TEM || (*marker >= MARKER_RST0 && *marker <= MARKER_EOI)) {
+        return false;
+    }
+
+    const size_t length = ((size_t)bytes[marker_position + 1] << 8) | bytes[marker_position + 2];
+
+    if (length < 2 || length > data_size - marker_position - 1) {
+        return false;
+    }
+
+    *payload_offset = marker_position + 3;
+    *segment_size   = marker_position + 1 + length - position;
+
+    return true;
+}
+
+bool sail_jpeg_is_sof_marker(int marker) {
+
+    return marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+}
@@ -0,0 +1,71 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_JPEG_SEGMENTS_H
+#define SAIL_JPEG_SEGMENTS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef SAIL_BUILD
+    #include "export.h"
+#else
+    #include <sail-common/export.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Minimal JPEG marker segment walker shared by the JPEG codec and libsail. It's used to find
+ * segments preceding the scan data like frame headers, EXIF, and JFIF thumbnails without
+ * decoding the image.
+ *
+ * The functions never access memory outside of the JPEG data and return false on broken data.
+ */
+
+/*
+ * Finds the marker segment at the specified position in the JPEG data. The segment spans
+ * from the position to position + segment_size, its payload starts at payload_offset.
+ * Fill bytes preceding the marker belong to the segment.
+ *
+ * Returns false if the data is broken or truncated, or if the position holds a standalone
+ * marker which is not expected before the scan data.
+ */
+SAIL_EXPORT bool sail_jpeg_next_segment(const void *data, size_t data_size, size_t position,
+                                        int *marker, size_t *payload_offset, size_t *segment_size);
+
+/*
+ * Returns true if the marker starts a frame (SOFn).
+ */
+SAIL_EXPORT bool sail_jpeg_is_sof_marker(int marker);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -25,15 +25,140 @@
 
 #include "config.h"
 
+#include <stdbool.h>
 #include <stdlib.h>
 
 #include "sail-common.h"
 
+/*
+ * Private functions.
+ */
+
+static void *default_malloc(void *user_data, size_t size) {
+
+    (void)user_data;
+
+    return malloc(size);
+}
+
+static void *default_realloc(void *user_data, void *ptr, size_t size) {
+
+    (void)user_data;
+
+    return realloc(ptr, size);
+}
+
+static void *default_calloc(void *user_data, size_t nmemb, size_t size) {
+
+    (void)user_data;
+
+    return calloc(nmemb, size);
+}
+
+static void default_free(void *user_data, void *ptr) {
+
+    (void)user_data;
+
+    free(ptr);
+}
+
+static void *default_aligned_alloc(void *user_data, size_t alignment, size_t size) {
+
+    (void)user_data;
+
+#ifdef SAIL_WIN32
+    /* _aligned_malloc() memory cannot be released with free(), so the alignment is not guaranteed. */
+    (void)alignment;
+
+    return malloc(size);
+#else
+    /* posix_memalign() requires the alignment to be a multiple of sizeof(void *). */
+    if (alignment < sizeof(void *)) {
+        alignment = sizeof(void *);
+    }
+
+    void *ptr;
+
+    if (posix_memalign(&ptr, alignment, size) != 0) {
+        return NULL;
+    }
+
+    return ptr;
+#endif
+}
+
+static sail_memory_malloc_t        malloc_function        = default_malloc;
+static sail_memory_realloc_t       realloc_function       = default_realloc;
+static sail_memory_calloc_t        calloc_function        = default_calloc;
+static sail_memory_free_t          free_function          = default_free;
+static sail_memory_aligned_alloc_t aligned_alloc_function = default_aligned_alloc;
+static void                       *memory_user_data       = NULL;
+
+static size_t pixels_alignment = SAIL_DEFAULT_PIXELS_ALIGNMENT;
+
+static bool is_power_of_two(size_t value) {
+
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_set_memory_functions(sail_memory_malloc_t malloc_function_new,
+                                        sail_memory_realloc_t realloc_function_new,
+                                        sail_memory_calloc_t calloc_function_new,
+                                        sail_memory_free_t free_function_new,
+                                        sail_memory_aligned_alloc_t aligned_alloc_function_new,
+                                        void *user_data) {
+
+    SAIL_CHECK_PTR(malloc_function_new);
+    SAIL_CHECK_PTR(realloc_function_new);
+    SAIL_CHECK_PTR(calloc_function_new);
+    SAIL_CHECK_PTR(free_function_new);
+
+    malloc_function        = malloc_function_new;
+    realloc_function       = realloc_function_new;
+    calloc_function        = calloc_function_new;
+    free_function          = free_function_new;
+    aligned_alloc_function = aligned_alloc_function_new;
+    memory_user_data       = user_data;
+
+    return SAIL_OK;
+}
+
+void sail_reset_memory_functions(void) {
+
+    malloc_function        = default_malloc;
+    realloc_function       = default_realloc;
+    calloc_function        = default_calloc;
+    free_function          = default_free;
+    aligned_alloc_function = default_aligned_alloc;
+    memory_user_data       = NULL;
+}
+
+sail_status_t sail_set_pixels_alignment(size_t alignment) {
+
+    if (!is_power_of_two(alignment)) {
+        SAIL_LOG_ERROR("Pixels alignment must be a power of two, but got %lu", (unsigned long)alignment);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    pixels_alignment = alignment;
+
+    return SAIL_OK;
+}
+
+size_t sail_pixels_alignment(void) {
+
+    return pixels_alignment;
+}
+
 sail_status_t sail_malloc(size_t size, void **ptr) {
 
     SAIL_CHECK_PTR(ptr);
 
-    void *ptr_local = malloc(size);
+    void *ptr_local = malloc_function(memory_user_data, size);
 
     if (ptr_local == NULL) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
@@ -48,7 +173,7 @@ sail_status_t sail_realloc(size_t size, void **ptr) {
 
     SAIL_CHECK_PTR(ptr);
 
-    void *ptr_local = realloc(*ptr, size);
+    void *ptr_local = realloc_function(memory_user_data, *ptr, size);
 
     if (ptr_local == NULL) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
@@ -63,7 +188,29 @@ sail_status_t sail_calloc(size_t nmemb, size_t size, void **ptr) {
 
     SAIL_CHECK_PTR(ptr);
 
-    void *ptr_local = calloc(nmemb, size);
+    void *ptr_local = calloc_function(memory_user_data, nmemb, size);
+
+    if (ptr_local == NULL) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    *ptr = ptr_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_aligned_alloc(size_t alignment, size_t size, void **ptr) {
+
+    SAIL_CHECK_PTR(ptr);
+
+    if (!is_power_of_two(alignment)) {
+        SAIL_LOG_ERROR("Alignment must be a power of two, but got %lu", (unsigned long)alignment);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    void *ptr_local = (aligned_alloc_function == NULL)
+                        ? malloc_function(memory_user_data, size)
+                        : aligned_alloc_function(memory_user_data, alignment, size);
 
     if (ptr_local == NULL) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
@@ -74,7 +221,18 @@ sail_status_t sail_calloc(size_t nmemb, size_t size, void **ptr) {
     return SAIL_OK;
 }
 
+sail_status_t sail_malloc_pixels(size_t size, void **ptr) {
+
+    SAIL_TRY(sail_aligned_alloc(pixels_alignment, size, ptr));
+
+    return SAIL_OK;
+}
+
 void sail_free(void *ptr) {
 
-    free(ptr);
+    if (ptr == NULL) {
+        return;
+    }
+
+    free_function(memory_user_data, ptr);
 }
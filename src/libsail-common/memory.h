@@ -34,10 +34,70 @@
     #include <sail-common/export.h>
 #endif
 
+#include <stddef.h> /* size_t */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*
+ * Default alignment of pixel buffers allocated with sail_malloc_pixels(). 64 bytes is enough
+ * for aligned AVX-512 loads and matches the cache line size on most CPUs.
+ */
+#define SAIL_DEFAULT_PIXELS_ALIGNMENT 64
+
+/*
+ * Custom memory allocation functions. See sail_set_memory_functions(). 'user_data' is the pointer
+ * passed to sail_set_memory_functions().
+ */
+typedef void *(*sail_memory_malloc_t)(void *user_data, size_t size);
+typedef void *(*sail_memory_realloc_t)(void *user_data, void *ptr, size_t size);
+typedef void *(*sail_memory_calloc_t)(void *user_data, size_t nmemb, size_t size);
+typedef void  (*sail_memory_free_t)(void *user_data, void *ptr);
+typedef void *(*sail_memory_aligned_alloc_t)(void *user_data, size_t alignment, size_t size);
+
+/*
+ * Replaces the memory allocation functions used by SAIL, its codecs, and underlying codec libraries
+ * that support custom allocators (like libpng). 'aligned_alloc_function' and 'user_data' can be NULL.
+ * When 'aligned_alloc_function' is NULL, sail_aligned_alloc() falls back to 'malloc_function'
+ * and the alignment is not guaranteed.
+ *
+ * Memory allocated with 'aligned_alloc_function' MUST be releasable with 'free_function'.
+ *
+ * This function is not thread-safe. It MUST be called before any other SAIL function
+ * as memory allocated with the previous functions is released with the new ones.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_set_memory_functions(sail_memory_malloc_t malloc_function,
+                                                    sail_memory_realloc_t realloc_function,
+                                                    sail_memory_calloc_t calloc_function,
+                                                    sail_memory_free_t free_function,
+                                                    sail_memory_aligned_alloc_t aligned_alloc_function,
+                                                    void *user_data);
+
+/*
+ * Restores the default memory allocation functions based on libc.
+ *
+ * This function is not thread-safe. The same restrictions as for sail_set_memory_functions() apply.
+ */
+SAIL_EXPORT void sail_reset_memory_functions(void);
+
+/*
+ * Sets the alignment of pixel buffers allocated with sail_malloc_pixels(). The alignment must be
+ * a power of two. SAIL_DEFAULT_PIXELS_ALIGNMENT is used by default.
+ *
+ * This function is not thread-safe.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_set_pixels_alignment(size_t alignment);
+
+/*
+ * Returns the current alignment of pixel buffers allocated with sail_malloc_pixels().
+ */
+SAIL_EXPORT size_t sail_pixels_alignment(void);
+
 /*
  * Interface to malloc().
  *
@@ -59,6 +119,25 @@ SAIL_EXPORT sail_status_t sail_realloc(size_t size, void **ptr);
  */
 SAIL_EXPORT sail_status_t sail_calloc(size_t nmemb, size_t size, void **ptr);
 
+/*
+ * Interface to aligned_alloc(). The alignment must be a power of two. The allocated memory
+ * MUST be destroyed later with sail_free().
+ *
+ * Note: on Windows, the default allocator doesn't guarantee the alignment as memory allocated
+ * with _aligned_malloc() cannot be released with free().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_aligned_alloc(size_t alignment, size_t size, void **ptr);
+
+/*
+ * Allocates a pixel buffer aligned to sail_pixels_alignment(). The allocated memory
+ * MUST be destroyed later with sail_free().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_malloc_pixels(size_t size, void **ptr);
+
 /*
  * Interface to free().
  *
@@ -91,7 +91,7 @@ sail_status_t sail_alloc_palette_for_data(enum SailPixelFormat pixel_format, uns
     palette_local->pixel_format = pixel_format;
     palette_local->color_count = color_count;
 
-    unsigned palette_size;
+    size_t palette_size;
     SAIL_TRY_OR_CLEANUP(sail_bytes_per_line(color_count, pixel_format, &palette_size),
                         /* cleanup */ sail_destroy_palette(palette_local));
 
@@ -112,7 +112,7 @@ sail_status_t sail_alloc_palette_from_data(enum SailPixelFormat pixel_format, co
     struct sail_palette *palette_local;
     SAIL_TRY(sail_alloc_palette_for_data(pixel_format, color_count, &palette_local));
 
-    unsigned palette_size;
+    size_t palette_size;
     SAIL_TRY_OR_CLEANUP(sail_bytes_per_line(color_count, pixel_format, &palette_size),
                         /* cleanup */ sail_destroy_palette(palette_local));
 
@@ -0,0 +1,649 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "config.h"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sail-common.h"
+
+/* Byte order mark. Reads as a different number on machines with a different byte order. */
+#define RAW_IMAGE_BYTE_ORDER UINT32_C(0x01020304)
+
+/* Size of the fixed header. Must match the layout in raw_header_to_buffer(). */
+#define RAW_IMAGE_HEADER_SIZE 184
+
+/* Size of the fixed part of a meta data entry: key, value type, key length, and value length. */
+#define RAW_IMAGE_META_DATA_ENTRY_SIZE 24
+
+struct raw_header {
+
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t header_size;
+
+    uint32_t width;
+    uint32_t height;
+    uint32_t pixel_format;
+    int32_t properties;
+    int32_t delay;
+    double gamma;
+    uint64_t bytes_per_line;
+    uint64_t pixels_offset;
+    uint64_t pixels_size;
+
+    uint32_t has_resolution;
+    uint32_t resolution_unit;
+    double resolution_x;
+    double resolution_y;
+
+    uint32_t has_source_image;
+    uint32_t source_pixel_format;
+    uint32_t source_chroma_subsampling;
+    int32_t source_properties;
+    uint32_t source_compression;
+
+    uint32_t palette_pixel_format;
+    uint32_t palette_color_count;
+    uint64_t palette_offset;
+    uint64_t palette_size;
+
+    uint64_t iccp_offset;
+    uint64_t iccp_size;
+
+    uint32_t meta_data_count;
+    uint64_t meta_data_offset;
+    uint64_t meta_data_size;
+};
+
+/*
+ * Private functions.
+ */
+
+static void put_value(unsigned char *buffer, size_t *pos, const void *value, size_t size) {
+
+    memcpy(buffer + *pos, value, size);
+    *pos += size;
+}
+
+static void get_value(const unsigned char *buffer, size_t *pos, void *value, size_t size) {
+
+    memcpy(value, buffer + *pos, size);
+    *pos += size;
+}
+
+static void raw_header_to_buffer(const struct raw_header *header, unsigned char *buffer) {
+
+    const uint32_t reserved = 0;
+    size_t pos = 0;
+
+    put_value(buffer, &pos, SAIL_RAW_IMAGE_MAGIC, 8);
+    put_value(buffer, &pos, &header->version,                   sizeof(uint32_t));
+    put_value(buffer, &pos, &header->byte_order,                sizeof(uint32_t));
+    put_value(buffer, &pos, &header->header_size,               sizeof(uint32_t));
+    put_value(buffer, &pos, &header->width,                     sizeof(uint32_t));
+    put_value(buffer, &pos, &header->height,                    sizeof(uint32_t));
+    put_value(buffer, &pos, &header->pixel_format,              sizeof(uint32_t));
+    put_value(buffer, &pos, &header->properties,                sizeof(int32_t));
+    put_value(buffer, &pos, &header->delay,                     sizeof(int32_t));
+    put_value(buffer, &pos, &header->gamma,                     sizeof(double));
+    put_value(buffer, &pos, &header->bytes_per_line,            sizeof(uint64_t));
+    put_value(buffer, &pos, &header->pixels_offset,             sizeof(uint64_t));
+    put_value(buffer, &pos, &header->pixels_size,               sizeof(uint64_t));
+    put_value(buffer, &pos, &header->has_resolution,            sizeof(uint32_t));
+    put_value(buffer, &pos, &header->resolution_unit,           sizeof(uint32_t));
+    put_value(buffer, &pos, &header->resolution_x,              sizeof(double));
+    put_value(buffer, &pos, &header->resolution_y,              sizeof(double));
+    put_value(buffer, &pos, &header->has_source_image,          sizeof(uint32_t));
+    put_value(buffer, &pos, &header->source_pixel_format,       sizeof(uint32_t));
+    put_value(buffer, &pos, &header->source_chroma_subsampling, sizeof(uint32_t));
+    put_value(buffer, &pos, &header->source_properties,         sizeof(int32_t));
+    put_value(buffer, &pos, &header->source_compression,        sizeof(uint32_t));
+    put_value(buffer, &pos, &reserved,                          sizeof(uint32_t));
+    put_value(buffer, &pos, &header->palette_pixel_format,      sizeof(uint32_t));
+    put_value(buffer, &pos, &header->palette_color_count,       sizeof(uint32_t));
+    put_value(buffer, &pos, &header->palette_offset,            sizeof(uint64_t));
+    put_value(buffer, &pos, &header->palette_size,              sizeof(uint64_t));
+    put_value(buffer, &pos, &header->iccp_offset,               sizeof(uint64_t));
+    put_value(buffer, &pos, &header->iccp_size,                 sizeof(uint64_t));
+    put_value(buffer, &pos, &header->meta_data_count,           sizeof(uint32_t));
+    put_value(buffer, &pos, &reserved,                          sizeof(uint32_t));
+    put_value(buffer, &pos, &header->meta_data_offset,          sizeof(uint64_t));
+    put_value(buffer, &pos, &header->meta_data_size,            sizeof(uint64_t));
+}
+
+static void raw_header_from_buffer(const unsigned char *buffer, struct raw_header *header) {
+
+    uint32_t reserved;
+    size_t pos = 8; /* Skip the magic. */
+
+    get_value(buffer, &pos, &header->version,                   sizeof(uint32_t));
+    get_value(buffer, &pos, &header->byte_order,                sizeof(uint32_t));
+    get_value(buffer, &pos, &header->header_size,               sizeof(uint32_t));
+    get_value(buffer, &pos, &header->width,                     sizeof(uint32_t));
+    get_value(buffer, &pos, &header->height,                    sizeof(uint32_t));
+    get_value(buffer, &pos, &header->pixel_format,              sizeof(uint32_t));
+    get_value(buffer, &pos, &header->properties,                sizeof(int32_t));
+    get_value(buffer, &pos, &header->delay,                     sizeof(int32_t));
+    get_value(buffer, &pos, &header->gamma,                     sizeof(double));
+    get_value(buffer, &pos, &header->bytes_per_line,            sizeof(uint64_t));
+    get_value(buffer, &pos, &header->pixels_offset,             sizeof(uint64_t));
+    get_value(buffer, &pos, &header->pixels_size,               sizeof(uint64_t));
+    get_value(buffer, &pos, &header->has_resolution,            sizeof(uint32_t));
+    get_value(buffer, &pos, &header->resolution_unit,           sizeof(uint32_t));
+    get_value(buffer, &pos, &header->resolution_x,              sizeof(double));
+    get_value(buffer, &pos, &header->resolution_y,              sizeof(double));
+    get_value(buffer, &pos, &header->has_source_image,          sizeof(uint32_t));
+    get_value(buffer, &pos, &header->source_pixel_format,       sizeof(uint32_t));
+    get_value(buffer, &pos, &header->source_chroma_subsampling, sizeof(uint32_t));
+    get_value(buffer, &pos, &header->source_properties,         sizeof(int32_t));
+    get_value(buffer, &pos, &header->source_compression,        sizeof(uint32_t));
+    get_value(buffer, &pos, &reserved,                          sizeof(uint32_t));
+    get_value(buffer, &pos, &header->palette_pixel_format,      sizeof(uint32_t));
+    get_value(buffer, &pos, &header->palette_color_count,       sizeof(uint32_t));
+    get_value(buffer, &pos, &header->palette_offset,            sizeof(uint64_t));
+    get_value(buffer, &pos, &header->palette_size,              sizeof(uint64_t));
+    get_value(buffer, &pos, &header->iccp_offset,               sizeof(uint64_t));
+    get_value(buffer, &pos, &header->iccp_size,                 sizeof(uint64_t));
+    get_value(buffer, &pos, &header->meta_data_count,           sizeof(uint32_t));
+    get_value(buffer, &pos, &reserved,                          sizeof(uint32_t));
+    get_value(buffer, &pos, &header->meta_data_offset,          sizeof(uint64_t));
+    get_value(buffer, &pos, &header->meta_data_size,            sizeof(uint64_t));
+}
+
+static size_t key_unknown_length(const struct sail_meta_data *meta_data) {
+
+    return meta_data->key_unknown == NULL ? 0 : strlen(meta_data->key_unknown) + 1;
+}
+
+static sail_status_t write_zeros(struct sail_io *io, size_t size) {
+
+    static const unsigned char zeros[256] = { 0 };
+
+    while (size > 0) {
+        const size_t size_to_write = size > sizeof(zeros) ? sizeof(zeros) : size;
+
+        SAIL_TRY(io->strict_write(io->stream, zeros, size_to_write));
+        size -= size_to_write;
+    }
+
+    return SAIL_OK;
+}
+
+/* Reads and discards the data up to the specified offset. Works with non-seekable I/O objects. */
+static sail_status_t skip_to_offset(struct sail_io *io, size_t *pos, uint64_t offset) {
+
+    if (offset < *pos) {
+        SAIL_LOG_ERROR("RAW: Section offset %lu overlaps the previous section", (unsigned long)offset);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    unsigned char buffer[256];
+
+    while (*pos < offset) {
+        const size_t size_to_read = (offset - *pos) > sizeof(buffer) ? sizeof(buffer) : (size_t)(offset - *pos);
+
+        SAIL_TRY(io->strict_read(io->stream, buffer, size_to_read));
+        *pos += size_to_read;
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_meta_data_entry(struct sail_io *io, size_t *pos, uint64_t section_end, struct sail_meta_data **meta_data) {
+
+    if (section_end - *pos < RAW_IMAGE_META_DATA_ENTRY_SIZE) {
+        SAIL_LOG_ERROR("RAW: Meta data section is truncated");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    unsigned char buffer[RAW_IMAGE_META_DATA_ENTRY_SIZE];
+    SAIL_TRY(io->strict_read(io->stream, buffer, sizeof(buffer)));
+    *pos += sizeof(buffer);
+
+    uint32_t key;
+    uint32_t value_type;
+    uint64_t key_length;
+    uint64_t value_length;
+    size_t buffer_pos = 0;
+
+    get_value(buffer, &buffer_pos, &key,          sizeof(uint32_t));
+    get_value(buffer, &buffer_pos, &value_type,   sizeof(uint32_t));
+    get_value(buffer, &buffer_pos, &key_length,   sizeof(uint64_t));
+    get_value(buffer, &buffer_pos, &value_length, sizeof(uint64_t));
+
+    if (key_length > section_end - *pos || value_length > section_end - *pos - key_length) {
+        SAIL_LOG_ERROR("RAW: Meta data entry exceeds the meta data section");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    if (value_type != SAIL_META_DATA_TYPE_STRING && value_type != SAIL_META_DATA_TYPE_DATA) {
+        SAIL_LOG_ERROR("RAW: Unsupported meta data value type %u", value_type);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    struct sail_meta_data *meta_data_local;
+    SAIL_TRY(sail_alloc_meta_data(&meta_data_local));
+
+    meta_data_local->key          = (enum SailMetaData)key;
+    meta_data_local->value_type   = (enum SailMetaDataType)value_type;
+    meta_data_local->value_length = (size_t)value_length;
+
+    void *ptr;
+
+    if (key_length > 0) {
+        SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)key_length, &ptr),
+                            /* cleanup */ sail_destroy_meta_data(meta_data_local));
+        meta_data_local->key_unknown = ptr;
+
+        SAIL_TRY_OR_CLEANUP(io->strict_read(io->stream, meta_data_local->key_unknown, (size_t)key_length),
+                            /* cleanup */ sail_destroy_meta_data(meta_data_local));
+        meta_data_local->key_unknown[key_length - 1] = '\0';
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(value_length == 0 ? 1 : (size_t)value_length, &ptr),
+                        /* cleanup */ sail_destroy_meta_data(meta_data_local));
+    meta_data_local->value = ptr;
+
+    SAIL_TRY_OR_CLEANUP(io->strict_read(io->stream, meta_data_local->value, (size_t)value_length),
+                        /* cleanup */ sail_destroy_meta_data(meta_data_local));
+
+    if (meta_data_local->value_type == SAIL_META_DATA_TYPE_STRING && value_length > 0) {
+        ((char *)meta_data_local->value)[value_length - 1] = '\0';
+    }
+
+    *pos += (size_t)(key_length + value_length);
+
+    *meta_data = meta_data_local;
+
+    return SAIL_OK;
+}
+
+static sail_status_t check_raw_header(const struct raw_header *header) {
+
+    if (header->byte_order != RAW_IMAGE_BYTE_ORDER) {
+        SAIL_LOG_ERROR("RAW: The file was written on a machine with a different byte order");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_FORMAT);
+    }
+
+    if (header->version != SAIL_RAW_IMAGE_VERSION) {
+        SAIL_LOG_ERROR("RAW: Unsupported version %u", header->version);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_FORMAT);
+    }
+
+    if (header->header_size != RAW_IMAGE_HEADER_SIZE) {
+        SAIL_LOG_ERROR("RAW: Invalid header size %u", header->header_size);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    const enum SailPixelFormat pixel_format = (enum SailPixelFormat)header->pixel_format;
+
+    if (pixel_format == SAIL_PIXEL_FORMAT_UNKNOWN || sail_pixel_format_to_string(pixel_format) == NULL) {
+        SAIL_LOG_ERROR("RAW: Invalid pixel format %u", header->pixel_format);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    if (header->width == 0 || header->height == 0) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    size_t bytes_per_line;
+    SAIL_TRY(sail_bytes_per_line(header->width, pixel_format, &bytes_per_line));
+
+    if (header->bytes_per_line < bytes_per_line || header->bytes_per_line > SIZE_MAX) {
+        SAIL_LOG_ERROR("RAW: Invalid bytes per line %lu", (unsigned long)header->bytes_per_line);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_BYTES_PER_LINE);
+    }
+
+    size_t pixels_size;
+    SAIL_TRY(sail_multiply_sizes((size_t)header->bytes_per_line, header->height, &pixels_size));
+
+    if (header->pixels_size != pixels_size) {
+        SAIL_LOG_ERROR("RAW: Pixels size %lu doesn't match the image dimensions", (unsigned long)header->pixels_size);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    if (header->pixels_offset % SAIL_RAW_IMAGE_PIXELS_ALIGNMENT != 0 || header->pixels_offset > SIZE_MAX - pixels_size) {
+        SAIL_LOG_ERROR("RAW: Invalid pixels offset %lu", (unsigned long)header->pixels_offset);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    /* Sections go one after another in this order: palette, ICC profile, meta data, pixels. */
+    if (header->palette_size > UINT64_MAX - header->palette_offset
+            || header->palette_offset + header->palette_size > header->iccp_offset
+            || header->iccp_size > UINT64_MAX - header->iccp_offset
+            || header->iccp_offset + header->iccp_size > header->meta_data_offset
+            || header->meta_data_size > UINT64_MAX - header->meta_data_offset
+            || header->meta_data_offset + header->meta_data_size > header->pixels_offset
+            || header->palette_offset < RAW_IMAGE_HEADER_SIZE) {
+        SAIL_LOG_ERROR("RAW: Invalid section offsets");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    if (header->iccp_size > UINT_MAX) {
+        SAIL_LOG_ERROR("RAW: ICC profile is too large");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_sections(struct sail_io *io, const struct sail_read_options *read_options,
+                                    const struct raw_header *header, size_t *pos, struct sail_image *image) {
+
+    /* Resolution. */
+    if (header->has_resolution) {
+        SAIL_TRY(sail_alloc_resolution_from_data((enum SailResolutionUnit)header->resolution_unit,
+                                                    header->resolution_x, header->resolution_y,
+                                                    &image->resolution));
+    }
+
+    /* Source image. */
+    if (header->has_source_image) {
+        SAIL_TRY(sail_alloc_source_image(&image->source_image));
+
+        image->source_image->pixel_format       = (enum SailPixelFormat)header->source_pixel_format;
+        image->source_image->chroma_subsampling = (enum SailChromaSubsampling)header->source_chroma_subsampling;
+        image->source_image->properties         = header->source_properties;
+        image->source_image->compression        = (enum SailCompression)header->source_compression;
+    }
+
+    /* Palette. */
+    SAIL_TRY(skip_to_offset(io, pos, header->palette_offset));
+
+    if (header->palette_size > 0) {
+        const enum SailPixelFormat palette_pixel_format = (enum SailPixelFormat)header->palette_pixel_format;
+
+        size_t palette_size;
+        SAIL_TRY(sail_bytes_per_line(header->palette_color_count, palette_pixel_format, &palette_size));
+
+        if (header->palette_color_count == 0 || header->palette_size != palette_size) {
+            SAIL_LOG_ERROR("RAW: Invalid palette");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+        }
+
+        SAIL_TRY(sail_alloc_palette_for_data(palette_pixel_format, header->palette_color_count, &image->palette));
+        SAIL_TRY(io->strict_read(io->stream, image->palette->data, palette_size));
+        *pos += palette_size;
+    }
+
+    SAIL_TRY(sail_check_read_limits(read_options, 0, 0, (size_t)(header->iccp_size + header->meta_data_size)));
+
+    /* ICC profile. */
+    SAIL_TRY(skip_to_offset(io, pos, header->iccp_offset));
+
+    if (header->iccp_size > 0) {
+        void *data;
+        SAIL_TRY(sail_malloc((size_t)header->iccp_size, &data));
+        SAIL_TRY_OR_CLEANUP(io->strict_read(io->stream, data, (size_t)header->iccp_size),
+                            /* cleanup */ sail_free(data));
+        SAIL_TRY_OR_CLEANUP(sail_alloc_iccp_move_data(data, (unsigned)header->iccp_size, &image->iccp),
+                            /* cleanup */ sail_free(data));
+        *pos += (size_t)header->iccp_size;
+    }
+
+    /* Meta data. */
+    SAIL_TRY(skip_to_offset(io, pos, header->meta_data_offset));
+
+    const uint64_t meta_data_end = header->meta_data_offset + header->meta_data_size;
+    struct sail_meta_data_node **last_meta_data_node = &image->meta_data_node;
+
+    for (uint32_t i = 0; i < header->meta_data_count; i++) {
+        struct sail_meta_data *meta_data;
+        SAIL_TRY(read_meta_data_entry(io, pos, meta_data_end, &meta_data));
+
+        struct sail_meta_data_node *meta_data_node;
+        SAIL_TRY_OR_CLEANUP(sail_alloc_meta_data_node(&meta_data_node),
+                            /* cleanup */ sail_destroy_meta_data(meta_data));
+        meta_data_node->meta_data = meta_data;
+
+        *last_meta_data_node = meta_data_node;
+        last_meta_data_node = &meta_data_node->next;
+    }
+
+    /* Position the I/O object at the pixels. */
+    SAIL_TRY(skip_to_offset(io, pos, header->pixels_offset));
+
+    return SAIL_OK;
+}
+
+/* Fills the header and computes the file layout of the specified image. */
+static sail_status_t build_raw_header(const struct sail_image *image, size_t pixels_alignment, struct raw_header *header) {
+
+    if (pixels_alignment == 0 || pixels_alignment % SAIL_RAW_IMAGE_PIXELS_ALIGNMENT != 0) {
+        SAIL_LOG_ERROR("RAW: Pixels alignment %lu is not a multiple of %d", (unsigned long)pixels_alignment, SAIL_RAW_IMAGE_PIXELS_ALIGNMENT);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    memset(header, 0, sizeof(*header));
+
+    header->version        = SAIL_RAW_IMAGE_VERSION;
+    header->byte_order     = RAW_IMAGE_BYTE_ORDER;
+    header->header_size    = RAW_IMAGE_HEADER_SIZE;
+    header->width          = image->width;
+    header->height         = image->height;
+    header->pixel_format   = image->pixel_format;
+    header->properties     = image->properties;
+    header->delay          = image->delay;
+    header->gamma          = image->gamma;
+    header->bytes_per_line = image->bytes_per_line;
+
+    /* Views are written with tightly packed pixels. */
+    if (image->parent != NULL) {
+        size_t bytes_per_line;
+        SAIL_TRY(sail_bytes_per_line(image->width, image->pixel_format, &bytes_per_line));
+        header->bytes_per_line = bytes_per_line;
+    }
+
+    header->pixels_size = header->bytes_per_line * image->height;
+
+    if (image->resolution != NULL) {
+        header->has_resolution  = 1;
+        header->resolution_unit = image->resolution->unit;
+        header->resolution_x    = image->resolution->x;
+        header->resolution_y    = image->resolution->y;
+    }
+
+    if (image->source_image != NULL) {
+        header->has_source_image          = 1;
+        header->source_pixel_format       = image->source_image->pixel_format;
+        header->source_chroma_subsampling = image->source_image->chroma_subsampling;
+        header->source_properties         = image->source_image->properties;
+        header->source_compression        = image->source_image->compression;
+    }
+
+    /* Compute the section layout. */
+    header->palette_offset = RAW_IMAGE_HEADER_SIZE;
+
+    if (image->palette != NULL && image->palette->data != NULL) {
+        size_t palette_size;
+        SAIL_TRY(sail_bytes_per_line(image->palette->color_count, image->palette->pixel_format, &palette_size));
+
+        header->palette_pixel_format = image->palette->pixel_format;
+        header->palette_color_count  = image->palette->color_count;
+        header->palette_size         = palette_size;
+    }
+
+    header->iccp_offset = header->palette_offset + header->palette_size;
+
+    if (image->iccp != NULL && image->iccp->data != NULL) {
+        header->iccp_size = image->iccp->data_length;
+    }
+
+    header->meta_data_offset = header->iccp_offset + header->iccp_size;
+
+    for (const struct sail_meta_data_node *node = image->meta_data_node; node != NULL; node = node->next) {
+        header->meta_data_count++;
+        header->meta_data_size += RAW_IMAGE_META_DATA_ENTRY_SIZE + key_unknown_length(node->meta_data) + node->meta_data->value_length;
+    }
+
+    const uint64_t sections_end = header->meta_data_offset + header->meta_data_size;
+    header->pixels_offset = (sections_end + pixels_alignment - 1) / pixels_alignment * pixels_alignment;
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_raw_image_pixels_offset(const struct sail_image *image, size_t pixels_alignment, size_t *pixels_offset) {
+
+    SAIL_TRY(sail_check_image_skeleton_valid(image));
+    SAIL_CHECK_PTR(pixels_offset);
+
+    struct raw_header header;
+    SAIL_TRY(build_raw_header(image, pixels_alignment, &header));
+
+    *pixels_offset = (size_t)header.pixels_offset;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_write_raw_image_skeleton(struct sail_io *io, const struct sail_image *image, size_t pixels_alignment) {
+
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_TRY(sail_check_image_skeleton_valid(image));
+
+    struct raw_header header;
+    SAIL_TRY(build_raw_header(image, pixels_alignment, &header));
+
+    /* Header. */
+    unsigned char buffer[RAW_IMAGE_HEADER_SIZE];
+    raw_header_to_buffer(&header, buffer);
+    SAIL_TRY(io->strict_write(io->stream, buffer, sizeof(buffer)));
+
+    /* Palette. */
+    if (header.palette_size > 0) {
+        SAIL_TRY(io->strict_write(io->stream, image->palette->data, (size_t)header.palette_size));
+    }
+
+    /* ICC profile. */
+    if (header.iccp_size > 0) {
+        SAIL_TRY(io->strict_write(io->stream, image->iccp->data, (size_t)header.iccp_size));
+    }
+
+    /* Meta data. */
+    for (const struct sail_meta_data_node *node = image->meta_data_node; node != NULL; node = node->next) {
+        const struct sail_meta_data *meta_data = node->meta_data;
+
+        const uint32_t key          = meta_data->key;
+        const uint32_t value_type   = meta_data->value_type;
+        const uint64_t key_length   = key_unknown_length(meta_data);
+        const uint64_t value_length = meta_data->value_length;
+
+        unsigned char entry[RAW_IMAGE_META_DATA_ENTRY_SIZE];
+        size_t entry_pos = 0;
+
+        put_value(entry, &entry_pos, &key,          sizeof(uint32_t));
+        put_value(entry, &entry_pos, &value_type,   sizeof(uint32_t));
+        put_value(entry, &entry_pos, &key_length,   sizeof(uint64_t));
+        put_value(entry, &entry_pos, &value_length, sizeof(uint64_t));
+
+        SAIL_TRY(io->strict_write(io->stream, entry, sizeof(entry)));
+
+        if (key_length > 0) {
+            SAIL_TRY(io->strict_write(io->stream, meta_data->key_unknown, (size_t)key_length));
+        }
+        if (value_length > 0) {
+            SAIL_TRY(io->strict_write(io->stream, meta_data->value, (size_t)value_length));
+        }
+    }
+
+    /* Pad to the aligned pixels offset. */
+    SAIL_TRY(write_zeros(io, (size_t)(header.pixels_offset - header.meta_data_offset - header.meta_data_size)));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_write_raw_image(struct sail_io *io, const struct sail_image *image) {
+
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_TRY(sail_check_image_valid(image));
+
+    SAIL_TRY(sail_write_raw_image_skeleton(io, image, SAIL_RAW_IMAGE_PIXELS_ALIGNMENT));
+
+    if (image->parent != NULL) {
+        size_t bytes_per_line;
+        SAIL_TRY(sail_bytes_per_line(image->width, image->pixel_format, &bytes_per_line));
+
+        for (unsigned row = 0; row < image->height; row++) {
+            SAIL_TRY(io->strict_write(io->stream, (const unsigned char *)image->pixels + image->bytes_per_line * row, bytes_per_line));
+        }
+    } else {
+        size_t pixels_size;
+        SAIL_TRY(sail_bytes_per_image(image, &pixels_size));
+
+        SAIL_TRY(io->strict_write(io->stream, image->pixels, pixels_size));
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_read_raw_image_skeleton(struct sail_io *io, const struct sail_read_options *read_options,
+                                            struct sail_image **image, size_t *pixels_offset) {
+
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_CHECK_PTR(image);
+    SAIL_CHECK_PTR(pixels_offset);
+
+    unsigned char buffer[RAW_IMAGE_HEADER_SIZE];
+    SAIL_TRY(io->strict_read(io->stream, buffer, sizeof(buffer)));
+
+    if (memcmp(buffer, SAIL_RAW_IMAGE_MAGIC, 8) != 0) {
+        SAIL_LOG_ERROR("RAW: Invalid magic number");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_FORMAT);
+    }
+
+    struct raw_header header;
+    raw_header_from_buffer(buffer, &header);
+
+    SAIL_TRY(check_raw_header(&header));
+    SAIL_TRY(sail_check_read_limits(read_options, header.width, header.height, (size_t)header.pixels_size));
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_alloc_image(&image_local));
+
+    image_local->width          = header.width;
+    image_local->height         = header.height;
+    image_local->bytes_per_line = (size_t)header.bytes_per_line;
+    image_local->pixel_format   = (enum SailPixelFormat)header.pixel_format;
+    image_local->properties     = header.properties;
+    image_local->delay          = header.delay;
+    image_local->gamma          = header.gamma;
+
+    size_t pos = RAW_IMAGE_HEADER_SIZE;
+    SAIL_TRY_OR_CLEANUP(read_sections(io, read_options, &header, &pos, image_local),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    *image = image_local;
+    *pixels_offset = (size_t)header.pixels_offset;
+
+    return SAIL_OK;
+}
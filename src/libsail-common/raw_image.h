@@ -0,0 +1,119 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_RAW_IMAGE_H
+#define SAIL_RAW_IMAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef SAIL_BUILD
+    #include "error.h"
+    #include "export.h"
+#else
+    #include <sail-common/error.h>
+    #include <sail-common/export.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_image;
+struct sail_io;
+struct sail_read_options;
+
+/*
+ * SAIL raw is a native container for decoded images. It's intended to cache decoded images
+ * on a local disk and load them back without decoding.
+ *
+ * A SAIL raw file consists of a fixed-size header, variable-size sections with the palette,
+ * the ICC profile, and the meta data, and the pixels. The header stores the image properties
+ * and the offsets and sizes of all the sections. The pixels are stored exactly as in memory,
+ * including the scan line padding, at an offset aligned to SAIL_RAW_IMAGE_PIXELS_ALIGNMENT bytes.
+ * This way the pixels of a memory-mapped file are directly usable. See sail_map_raw_file().
+ *
+ * All numbers are stored in the native byte order of the machine that wrote the file.
+ * Files written on machines with a different byte order are rejected.
+ */
+
+/* SAIL raw file magic. */
+#define SAIL_RAW_IMAGE_MAGIC "SAILRAW"
+
+/* Current SAIL raw file format version. */
+#define SAIL_RAW_IMAGE_VERSION 1
+
+/* Alignment of the pixels offset in SAIL raw files. Matches the most common memory page size. */
+#define SAIL_RAW_IMAGE_PIXELS_ALIGNMENT 4096
+
+/*
+ * Writes the specified image into the I/O object in the SAIL raw format. The image must be valid,
+ * i.e. it must have pixels. The I/O object doesn't need to be seekable.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_write_raw_image(struct sail_io *io, const struct sail_image *image);
+
+/*
+ * Writes everything preceding the pixels in the SAIL raw format: the header, the sections, and
+ * the padding. The pixels offset is aligned to the specified alignment which must be a multiple of
+ * SAIL_RAW_IMAGE_PIXELS_ALIGNMENT. The image skeleton must be valid. Pixels are not required.
+ *
+ * Use it to lay out the pixels separately. For example, in a shared-memory object.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_write_raw_image_skeleton(struct sail_io *io, const struct sail_image *image, size_t pixels_alignment);
+
+/*
+ * Assigns the offset of the pixels in the SAIL raw format written with sail_write_raw_image_skeleton()
+ * and the same alignment.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_raw_image_pixels_offset(const struct sail_image *image, size_t pixels_alignment, size_t *pixels_offset);
+
+/*
+ * Reads a SAIL raw image header and all the sections preceding the pixels from the I/O object.
+ * Assigns the image skeleton without pixels and the absolute offset of the pixels in the file.
+ * On success, the I/O object is positioned at the beginning of the pixels. The I/O object doesn't
+ * need to be seekable. The number of bytes of the pixels is image->bytes_per_line * image->height.
+ *
+ * The image is checked against the read limits from the read options before allocating any data.
+ * The read options can be NULL. In this case, only the global read limits are checked.
+ *
+ * The assigned image MUST be destroyed later with sail_destroy_image().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_read_raw_image_skeleton(struct sail_io *io, const struct sail_read_options *read_options,
+                                                        struct sail_image **image, size_t *pixels_offset);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
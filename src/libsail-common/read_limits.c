@@ -0,0 +1,128 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "config.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sail-common.h"
+
+/* No limits by default. */
+static struct sail_read_limits global_read_limits = { 0, 0, 0, 0, 0, 0 };
+
+/*
+ * Private functions.
+ */
+
+/* Returns the stricter limit. 0 means no limit. */
+static uint64_t stricter_limit(uint64_t limit1, uint64_t limit2) {
+
+    if (limit1 == 0) {
+        return limit2;
+    }
+    if (limit2 == 0) {
+        return limit1;
+    }
+
+    return limit1 < limit2 ? limit1 : limit2;
+}
+
+/*
+ * Public functions.
+ */
+
+void sail_set_global_read_limits(const struct sail_read_limits *read_limits) {
+
+    if (read_limits == NULL) {
+        memset(&global_read_limits, 0, sizeof(global_read_limits));
+    } else {
+        global_read_limits = *read_limits;
+    }
+}
+
+sail_status_t sail_global_read_limits(struct sail_read_limits *read_limits) {
+
+    SAIL_CHECK_PTR(read_limits);
+
+    *read_limits = global_read_limits;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_effective_read_limits(const struct sail_read_options *read_options, struct sail_read_limits *read_limits) {
+
+    SAIL_CHECK_PTR(read_limits);
+
+    *read_limits = global_read_limits;
+
+    if (read_options == NULL) {
+        return SAIL_OK;
+    }
+
+    const struct sail_read_limits *local = &read_options->limits;
+
+    read_limits->max_width           = (unsigned)stricter_limit(read_limits->max_width,           local->max_width);
+    read_limits->max_height          = (unsigned)stricter_limit(read_limits->max_height,          local->max_height);
+    read_limits->max_pixels          =           stricter_limit(read_limits->max_pixels,          local->max_pixels);
+    read_limits->max_bytes           = (size_t)  stricter_limit(read_limits->max_bytes,           local->max_bytes);
+    read_limits->max_frames          = (unsigned)stricter_limit(read_limits->max_frames,          local->max_frames);
+    read_limits->max_meta_data_bytes = (size_t)  stricter_limit(read_limits->max_meta_data_bytes, local->max_meta_data_bytes);
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_check_read_limits(const struct sail_read_options *read_options, unsigned width, unsigned height, size_t bytes) {
+
+    struct sail_read_limits read_limits;
+    SAIL_TRY(sail_effective_read_limits(read_options, &read_limits));
+
+    if (read_limits.max_width > 0 && width > read_limits.max_width) {
+        SAIL_LOG_ERROR("Image width %u exceeds the limit of %u pixels", width, read_limits.max_width);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    if (read_limits.max_height > 0 && height > read_limits.max_height) {
+        SAIL_LOG_ERROR("Image height %u exceeds the limit of %u pixels", height, read_limits.max_height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    const uint64_t pixels = (uint64_t)width * height;
+
+    if (read_limits.max_pixels > 0 && pixels > read_limits.max_pixels) {
+        SAIL_LOG_ERROR("Number of pixels %llu exceeds the limit of %llu pixels",
+                        (unsigned long long)pixels, (unsigned long long)read_limits.max_pixels);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    if (read_limits.max_bytes > 0 && bytes > read_limits.max_bytes) {
+        SAIL_LOG_ERROR("Allocation of %lu bytes exceeds the limit of %lu bytes",
+                        (unsigned long)bytes, (unsigned long)read_limits.max_bytes);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    return SAIL_OK;
+}
@@ -0,0 +1,121 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_READ_LIMITS_H
+#define SAIL_READ_LIMITS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef SAIL_BUILD
+    #include "error.h"
+    #include "export.h"
+#else
+    #include <sail-common/error.h>
+    #include <sail-common/export.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_read_options;
+
+/*
+ * sail_read_limits represents resource limits for reading operations. They protect against
+ * malicious images (decompression bombs) that declare huge dimensions in a tiny file. Limits are
+ * checked right after an image header is parsed and before any pixel memory is allocated.
+ *
+ * Decoding buffers allocated by the underlying codec libraries, like JPEG coefficient buffers, are not
+ * counted against max_bytes. Only the dimension limits bound them, and only in codecs that check
+ * the header dimensions before decoding, like JPEG and QOI.
+ *
+ * Zero value in any field means no limit.
+ */
+struct sail_read_limits {
+
+    /* Maximum image width in pixels. */
+    unsigned max_width;
+
+    /* Maximum image height in pixels. */
+    unsigned max_height;
+
+    /* Maximum number of pixels in a single frame, i.e. width * height. */
+    uint64_t max_pixels;
+
+    /*
+     * Maximum number of bytes a single allocation driven by image contents may take. For example,
+     * a frame pixel buffer, or the whole file contents for codecs that cache it.
+     */
+    size_t max_bytes;
+
+    /* Maximum number of frames to read. */
+    unsigned max_frames;
+
+    /* Maximum total size in bytes of the meta data and the ICC profile of a single frame. */
+    size_t max_meta_data_bytes;
+};
+
+typedef struct sail_read_limits sail_read_limits_t;
+
+/*
+ * Sets global read limits applied to all reading operations. Pass NULL to remove the global limits.
+ * When both global limits and the limits in read options are set, the stricter limit wins.
+ *
+ * This function is not thread-safe. It must be called before starting any reading operations.
+ */
+SAIL_EXPORT void sail_set_global_read_limits(const struct sail_read_limits *read_limits);
+
+/*
+ * Returns the global read limits. By default, there are no global limits.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_global_read_limits(struct sail_read_limits *read_limits);
+
+/*
+ * Combines the global read limits with the limits from the specified read options. The read options
+ * can be NULL. In this case, the global limits are returned.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_effective_read_limits(const struct sail_read_options *read_options, struct sail_read_limits *read_limits);
+
+/*
+ * Checks the image dimensions and the number of bytes to allocate against the effective read limits.
+ * Pass 0 for the values that must not be checked. Codecs call this function before allocating memory
+ * for image data declared in image headers.
+ *
+ * Returns SAIL_OK if the limits are not exceeded.
+ * Returns SAIL_ERROR_LIMIT_EXCEEDED otherwise.
+ */
+SAIL_EXPORT sail_status_t sail_check_read_limits(const struct sail_read_options *read_options, unsigned width, unsigned height, size_t bytes);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -37,7 +37,19 @@ sail_status_t sail_alloc_read_options(struct sail_read_options **read_options) {
     SAIL_TRY(sail_malloc(sizeof(struct sail_read_options), &ptr));
     *read_options = ptr;
 
-    (*read_options)->io_options = 0;
+    (*read_options)->io_options         = 0;
+    (*read_options)->cancel_flag        = NULL;
+    (*read_options)->deadline           = 0;
+    (*read_options)->progress           = NULL;
+    (*read_options)->progress_user_data = NULL;
+    (*read_options)->preview            = NULL;
+    (*read_options)->preview_user_data  = NULL;
+
+    memset(&(*read_options)->limits, 0, sizeof((*read_options)->limits));
+
+    (*read_options)->scan_line_converter = NULL;
+    (*read_options)->decode_quality      = SAIL_DECODE_QUALITY_BEST;
+    (*read_options)->threads             = 1;
 
     return SAIL_OK;
 }
@@ -96,3 +108,90 @@ sail_status_t sail_copy_read_options(const struct sail_read_options *source, str
 
     return SAIL_OK;
 }
+
+sail_status_t sail_check_read_cancelled(const struct sail_read_options *read_options) {
+
+    /* Not an error. */
+    if (read_options == NULL) {
+        return SAIL_OK;
+    }
+
+    if (read_options->cancel_flag != NULL && *read_options->cancel_flag != 0) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CANCELLED);
+    }
+
+    if (read_options->deadline > 0 && sail_now() >= read_options->deadline) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CANCELLED);
+    }
+
+    return SAIL_OK;
+}
+
+void sail_report_read_progress(const struct sail_read_options *read_options, unsigned rows_done, unsigned rows_total) {
+
+    if (read_options == NULL || read_options->progress == NULL) {
+        return;
+    }
+
+    read_options->progress(read_options->progress_user_data, rows_done, rows_total);
+}
+
+void sail_report_read_preview(const struct sail_read_options *read_options, const struct sail_image *image, unsigned scan) {
+
+    if (read_options == NULL || read_options->preview == NULL) {
+        return;
+    }
+
+    read_options->preview(read_options->preview_user_data, image, scan);
+}
+
+sail_status_t sail_scan_line_buffer(const struct sail_read_options *read_options, const struct sail_image *image,
+                                    unsigned row, void **scan_line) {
+
+    SAIL_CHECK_PTR(image);
+    SAIL_CHECK_PTR(scan_line);
+
+    if (read_options == NULL || read_options->scan_line_converter == NULL) {
+        SAIL_CHECK_PTR(image->pixels);
+
+        *scan_line = (unsigned char *)image->pixels + image->bytes_per_line * row;
+    } else {
+        const struct sail_scan_line_converter *scan_line_converter = read_options->scan_line_converter;
+
+        if (scan_line_converter->scan_line == NULL || scan_line_converter->scan_line_size < image->bytes_per_line) {
+            SAIL_LOG_ERROR("Scan line buffer of %lu bytes doesn't fit %lu bytes",
+                            (unsigned long)scan_line_converter->scan_line_size, (unsigned long)image->bytes_per_line);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_CONFLICTING_OPERATION);
+        }
+
+        *scan_line = scan_line_converter->scan_line;
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_scan_line_decoded(const struct sail_read_options *read_options, const struct sail_image *image,
+                                     unsigned row, const void *scan_line) {
+
+    /* Not an error. */
+    if (read_options == NULL || read_options->scan_line_converter == NULL) {
+        return SAIL_OK;
+    }
+
+    SAIL_CHECK_PTR(image);
+    SAIL_CHECK_PTR(image->pixels);
+    SAIL_CHECK_PTR(scan_line);
+
+    const struct sail_scan_line_converter *scan_line_converter = read_options->scan_line_converter;
+
+    /* The frame pixels hold the converted frame. */
+    struct sail_image target = *image;
+    target.pixel_format   = scan_line_converter->pixel_format;
+    target.parent         = NULL;
+    target.release_pixels = NULL;
+    SAIL_TRY(sail_bytes_per_line(image->width, scan_line_converter->pixel_format, &target.bytes_per_line));
+
+    SAIL_TRY(scan_line_converter->convert(scan_line_converter->user_data, image, scan_line, row, &target));
+
+    return SAIL_OK;
+}
@@ -26,20 +26,68 @@
 #ifndef SAIL_READ_OPTIONS_H
 #define SAIL_READ_OPTIONS_H
 
+#include <stdint.h>
+
 #ifdef SAIL_BUILD
+    #include "common.h"
     #include "error.h"
     #include "export.h"
+    #include "read_limits.h"
 #else
+    #include <sail-common/common.h>
     #include <sail-common/error.h>
     #include <sail-common/export.h>
+    #include <sail-common/read_limits.h>
 #endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+struct sail_image;
 struct sail_read_features;
 
+/*
+ * Converts a decoded scan line of the source frame into the specified row of the target frame.
+ * The source image has the native frame properties. The target image has the converted pixel format
+ * and bytes per line, and its pixels point to the converted frame.
+ */
+typedef sail_status_t (*sail_convert_scan_line_t)(void *user_data, const struct sail_image *source, const void *scan_line,
+                                                  unsigned row, struct sail_image *target);
+
+/*
+ * sail_scan_line_converter represents a conversion applied to every scan line as soon as it's decoded.
+ * Use sail_alloc_scan_line_converter() from libsail-manip to create a converter into one of the pixel
+ * formats supported by sail_convert_image().
+ */
+struct sail_scan_line_converter {
+
+    /* Pixel format of the converted frames. */
+    enum SailPixelFormat pixel_format;
+
+    /* Conversion function. */
+    sail_convert_scan_line_t convert;
+
+    /* User data passed to the conversion function. */
+    void *user_data;
+
+    /* Row buffer to decode native scan lines into. Managed by SAIL. */
+    void *scan_line;
+
+    /* Size of the row buffer in bytes. Managed by SAIL. */
+    size_t scan_line_size;
+};
+
+typedef struct sail_scan_line_converter sail_scan_line_converter_t;
+
+/*
+ * Preview callback for reading operations. Codecs decoding progressive images call it with the frame
+ * refined by the scans decoded so far. 'scan' is the number of the scans decoded. The frame has the final
+ * pixel format and dimensions, and its pixels are partially refined. The frame is valid only during
+ * the call and MUST NOT be modified. 'user_data' is the pointer set in the read options.
+ */
+typedef void (*sail_preview_t)(void *user_data, const struct sail_image *image, unsigned scan);
+
 /*
  * sail_read_options represents options to modify reading operations.
  */
@@ -47,6 +95,63 @@ struct sail_read_options {
 
     /* Or-ed I/O manipulation options for reading operations. See SailIoOption. */
     int io_options;
+
+    /*
+     * Cancellation flag owned by a caller or NULL. When another thread sets the flag to a non-zero value,
+     * codecs stop decoding between scan lines and return SAIL_ERROR_CANCELLED.
+     */
+    const volatile int *cancel_flag;
+
+    /*
+     * Deadline in milliseconds as returned by sail_now() or 0 if there is no deadline. When the deadline
+     * is reached, codecs stop decoding between scan lines and return SAIL_ERROR_CANCELLED.
+     */
+    uint64_t deadline;
+
+    /* Progress callback or NULL. See sail_progress_t. */
+    sail_progress_t progress;
+
+    /* User data passed to the progress callback. */
+    void *progress_user_data;
+
+    /*
+     * Preview callback or NULL. See sail_preview_t. The JPEG codec decodes progressive images
+     * in buffered-image mode when it's set, and outputs the whole frame after every scan but the last one.
+     * Every preview costs an extra output pass.
+     */
+    sail_preview_t preview;
+
+    /* User data passed to the preview callback. */
+    void *preview_user_data;
+
+    /*
+     * Resource limits for this reading operation. Zero fields mean no limit. Global limits
+     * set with sail_set_global_read_limits() are applied too. See sail_read_limits.
+     */
+    struct sail_read_limits limits;
+
+    /*
+     * Scan line converter or NULL. When set, sail_read_next_frame() returns frames in the converter pixel format.
+     * Codecs with the SAIL_CODEC_FEATURE_SCAN_LINES read feature decode every scan line into a row buffer
+     * and convert it right away, so the native frame is never allocated. Other codecs decode the native
+     * frame first.
+     *
+     * Reading operations copy the converter when they start and use their own row buffers, so one
+     * converter may be shared by any number of reading operations, including concurrent ones. The conversion
+     * function is called with the same user data from all of them, so it MUST NOT modify the user data.
+     * The user data MUST stay valid until the last reading operation using the converter is finished.
+     */
+    struct sail_scan_line_converter *scan_line_converter;
+
+    /* Decoding speed and quality trade-off. SAIL_DECODE_QUALITY_BEST by default. See SailDecodeQuality. */
+    enum SailDecodeQuality decode_quality;
+
+    /*
+     * Maximum number of threads a codec may use to decode a single frame. 0 and 1 mean decoding
+     * in the calling thread. Codecs without parallel decoding ignore it. The JPEG codec decodes
+     * images with restart markers in parallel when there is no scan line converter.
+     */
+    unsigned threads;
 };
 
 typedef struct sail_read_options sail_read_options_t;
@@ -88,6 +193,47 @@ SAIL_EXPORT sail_status_t sail_alloc_read_options_from_features(const struct sai
  */
 SAIL_EXPORT sail_status_t sail_copy_read_options(const struct sail_read_options *source, struct sail_read_options **target);
 
+/*
+ * Checks if the reading operation must be stopped because the cancellation flag is set
+ * or the deadline is reached. Codecs call this function in their decoding loops.
+ * Does nothing if the read options is NULL.
+ *
+ * Returns SAIL_OK if the reading operation may continue.
+ * Returns SAIL_ERROR_CANCELLED if the reading operation must be stopped.
+ */
+SAIL_EXPORT sail_status_t sail_check_read_cancelled(const struct sail_read_options *read_options);
+
+/*
+ * Calls the progress callback from the read options if it is set. Codecs call this function
+ * after every decoded scan line. Does nothing if the read options is NULL.
+ */
+SAIL_EXPORT void sail_report_read_progress(const struct sail_read_options *read_options, unsigned rows_done, unsigned rows_total);
+
+/*
+ * Calls the preview callback from the read options if it is set. Codecs call this function
+ * after every output pass of a progressive image but the last one. Does nothing if the read options is NULL.
+ */
+SAIL_EXPORT void sail_report_read_preview(const struct sail_read_options *read_options, const struct sail_image *image, unsigned scan);
+
+/*
+ * Assigns the buffer to decode the specified scan line into. It's the scan line in the frame pixels
+ * or, if the read options have a scan line converter, its row buffer. Codecs with the SAIL_CODEC_FEATURE_SCAN_LINES
+ * read feature MUST decode every scan line into this buffer and then call sail_scan_line_decoded().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_scan_line_buffer(const struct sail_read_options *read_options, const struct sail_image *image,
+                                                unsigned row, void **scan_line);
+
+/*
+ * Converts the decoded scan line into the specified row of the frame pixels if the read options
+ * have a scan line converter. Does nothing otherwise.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_scan_line_decoded(const struct sail_read_options *read_options, const struct sail_image *image,
+                                                 unsigned row, const void *scan_line);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
@@ -35,20 +35,25 @@
     #include "common_serialize.h"
     #include "compiler_specifics.h"
     #include "error.h"
+    #include "exif.h"
     #include "export.h"
     #include "iccp.h"
     #include "image.h"
     #include "io_common.h"
+    #include "jpeg_segments.h"
     #include "log.h"
     #include "memory.h"
     #include "meta_data.h"
     #include "meta_data_node.h"
     #include "palette.h"
     #include "pixel.h"
+    #include "raw_image.h"
     #include "read_features.h"
+    #include "read_limits.h"
     #include "read_options.h"
     #include "resolution.h"
     #include "source_image.h"
+    #include "thread.h"
     #include "utils.h"
     #include "write_features.h"
     #include "write_options.h"
@@ -59,20 +64,25 @@
     #include <sail-common/common_serialize.h>
     #include <sail-common/compiler_specifics.h>
     #include <sail-common/error.h>
+    #include <sail-common/exif.h>
     #include <sail-common/export.h>
     #include <sail-common/iccp.h>
     #include <sail-common/image.h>
     #include <sail-common/io_common.h>
+    #include <sail-common/jpeg_segments.h>
     #include <sail-common/log.h>
     #include <sail-common/memory.h>
     #include <sail-common/meta_data.h>
     #include <sail-common/meta_data_node.h>
     #include <sail-common/palette.h>
     #include <sail-common/pixel.h>
+    #include <sail-common/raw_image.h>
     #include <sail-common/read_features.h>
+    #include <sail-common/read_limits.h>
     #include <sail-common/read_options.h>
     #include <sail-common/resolution.h>
     #include <sail-common/source_image.h>
+    #include <sail-common/thread.h>
     #include <sail-common/utils.h>
     #include <sail-common/write_features.h>
     #include <sail-common/write_options.h>
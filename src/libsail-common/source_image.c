@@ -41,6 +41,9 @@ sail_status_t sail_alloc_source_image(struct sail_source_image **source_image) {
     (*source_image)->chroma_subsampling = SAIL_CHROMA_SUBSAMPLING_UNKNOWN;
     (*source_image)->properties         = 0;
     (*source_image)->compression        = SAIL_COMPRESSION_UNSUPPORTED;
+    (*source_image)->orientation        = SAIL_ORIENTATION_NORMAL;
+    (*source_image)->data               = NULL;
+    (*source_image)->data_size          = 0;
 
     return SAIL_OK;
 }
@@ -51,6 +54,7 @@ void sail_destroy_source_image(struct sail_source_image *source_image) {
         return;
     }
 
+    sail_free(source_image->data);
     sail_free(source_image);
 }
 
@@ -65,6 +69,14 @@ sail_status_t sail_copy_source_image(const struct sail_source_image *source, str
     (*target)->chroma_subsampling = source->chroma_subsampling;
     (*target)->properties         = source->properties;
     (*target)->compression        = source->compression;
+    (*target)->orientation        = source->orientation;
+
+    if (source->data != NULL) {
+        SAIL_TRY_OR_CLEANUP(sail_malloc(source->data_size, &(*target)->data),
+                            /* cleanup */ sail_destroy_source_image(*target));
+        memcpy((*target)->data, source->data, source->data_size);
+        (*target)->data_size = source->data_size;
+    }
 
     return SAIL_OK;
 }
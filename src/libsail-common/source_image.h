@@ -27,6 +27,7 @@
 #define SAIL_SOURCE_IMAGE_H
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifdef SAIL_BUILD
     #include "error.h"
@@ -44,7 +45,7 @@ extern "C" {
  * sail_source_image represents source image properties. The structure is used in reading
  * operations only to preserve the source image properties which are usually lost during decoding.
  * For example, one might want to know the source image pixel format.
- * It's ignored in writing operations.
+ * It's ignored in writing operations except the original compressed data.
  */
 struct sail_source_image {
 
@@ -80,6 +81,33 @@ struct sail_source_image {
      * WRITE: Ignored.
      */
     enum SailCompression compression;
+
+    /*
+     * Source image orientation from the EXIF data. See SailOrientation. Flipping orientations also set
+     * the corresponding SAIL_IMAGE_PROPERTY_FLIPPED_* properties.
+     *
+     * READ:  Set by SAIL to the orientation of the original image or to SAIL_ORIENTATION_NORMAL.
+     *        Frames are decoded in this orientation unless SAIL_IO_OPTION_APPLY_ORIENTATION is requested.
+     * WRITE: Ignored.
+     */
+    enum SailOrientation orientation;
+
+    /*
+     * Original compressed image data. It's the whole image file or memory buffer the image has been
+     * read from. Frames other than the first one never have it.
+     *
+     * READ:  Set by SAIL to a copy of the original data when SAIL_IO_OPTION_SOURCE_DATA is requested
+     *        in the read options. NULL otherwise.
+     * WRITE: When SAIL_IO_OPTION_SOURCE_DATA is requested in the write options and the codec supports
+     *        the SOURCE-DATA write feature, the data is written unchanged instead of encoding the pixels.
+     *        Only meta data and ICC profiles are replaced according to the write options. Codecs encode
+     *        the pixels as usual when the data is not in their format or its dimensions don't match
+     *        the image. The pixels MUST NOT be modified in this case as they are not written.
+     */
+    void *data;
+
+    /* The size of the original compressed data. */
+    size_t data_size;
 };
 
 typedef struct sail_source_image sail_source_image_t;
@@ -0,0 +1,109 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "config.h"
+
+#include <errno.h>
+
+#ifdef SAIL_WIN32
+    #include <windows.h>
+#endif
+
+#include "sail-common.h"
+
+/*
+ * Private functions.
+ */
+
+#ifdef SAIL_WIN32
+static DWORD WINAPI thread_handler(LPVOID arg) {
+
+    const struct sail_thread *thread = arg;
+
+    thread->routine(thread->arg);
+
+    return 0;
+}
+#else
+static void *thread_handler(void *arg) {
+
+    const struct sail_thread *thread = arg;
+
+    thread->routine(thread->arg);
+
+    return NULL;
+}
+#endif
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_create_thread(struct sail_thread *thread, sail_thread_routine_t routine, void *arg) {
+
+    SAIL_CHECK_PTR(thread);
+    SAIL_CHECK_PTR(routine);
+
+    thread->routine = routine;
+    thread->arg     = arg;
+
+#ifdef SAIL_WIN32
+    thread->handle = CreateThread(NULL, 0, thread_handler, thread, 0, NULL);
+
+    if (thread->handle == NULL) {
+        SAIL_LOG_ERROR("Failed to create thread. Error: 0x%X", GetLastError());
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+#else
+    if ((errno = pthread_create(&thread->thread, NULL, thread_handler, thread)) != 0) {
+        SAIL_TRY(sail_print_errno("Failed to create thread: %s"));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+#endif
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_join_thread(struct sail_thread *thread) {
+
+    SAIL_CHECK_PTR(thread);
+
+#ifdef SAIL_WIN32
+    const DWORD result = WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+
+    if (result != WAIT_OBJECT_0) {
+        SAIL_LOG_ERROR("Failed to join thread. Error: 0x%X", GetLastError());
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+#else
+    if ((errno = pthread_join(thread->thread, NULL)) != 0) {
+        SAIL_TRY(sail_print_errno("Failed to join thread: %s"));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+#endif
+
+    return SAIL_OK;
+}
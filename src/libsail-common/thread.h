@@ -0,0 +1,87 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_THREAD_H
+#define SAIL_THREAD_H
+
+#ifdef SAIL_BUILD
+    #include "error.h"
+    #include "export.h"
+#else
+    #include <sail-common/error.h>
+    #include <sail-common/export.h>
+#endif
+
+#ifndef SAIL_WIN32
+    #include <pthread.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Minimal portable threads used by libsail and codecs to split work between threads.
+ * Based on CreateThread() on Windows and POSIX threads elsewhere.
+ */
+
+typedef void (*sail_thread_routine_t)(void *arg);
+
+struct sail_thread {
+
+#ifdef SAIL_WIN32
+    /* Thread HANDLE. */
+    void *handle;
+#else
+    pthread_t thread;
+#endif
+
+    sail_thread_routine_t routine;
+    void *arg;
+};
+
+typedef struct sail_thread sail_thread_t;
+
+/*
+ * Starts a new thread that calls the routine with the argument. The thread structure MUST stay
+ * valid until sail_join_thread() returns.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_create_thread(struct sail_thread *thread, sail_thread_routine_t routine, void *arg);
+
+/*
+ * Waits for the thread started by sail_create_thread() to finish.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_join_thread(struct sail_thread *thread);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -423,7 +423,7 @@ sail_status_t sail_greater_bits_per_pixel(enum SailPixelFormat pixel_format1, en
     return SAIL_OK;
 }
 
-sail_status_t sail_bytes_per_line(unsigned width, enum SailPixelFormat pixel_format, unsigned *result) {
+sail_status_t sail_bytes_per_line(unsigned width, enum SailPixelFormat pixel_format, size_t *result) {
 
     if (width == 0) {
         SAIL_LOG_ERROR("Line width is 0");
@@ -435,7 +435,38 @@ sail_status_t sail_bytes_per_line(unsigned width, enum SailPixelFormat pixel_for
     unsigned bits_per_pixel;
     SAIL_TRY(sail_bits_per_pixel(pixel_format, &bits_per_pixel));
 
-    *result = (unsigned)(((double)width * bits_per_pixel + 7) / 8);
+    /* Cannot overflow: the maximum is (2^32 - 1) * 128 bits. */
+    const uint64_t bytes_per_line = ((uint64_t)width * bits_per_pixel + 7) / 8;
+
+    if (bytes_per_line > SIZE_MAX) {
+        SAIL_LOG_ERROR("Line of %u pixels doesn't fit into the address space", width);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    *result = (size_t)bytes_per_line;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_bytes_per_image(const struct sail_image *image, size_t *result) {
+
+    SAIL_CHECK_PTR(image);
+
+    SAIL_TRY(sail_multiply_sizes(image->height, image->bytes_per_line, result));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_multiply_sizes(size_t size1, size_t size2, size_t *result) {
+
+    SAIL_CHECK_PTR(result);
+
+    if (size1 != 0 && size2 > SIZE_MAX / size1) {
+        SAIL_LOG_ERROR("Size %lu x %lu overflows the address space", (unsigned long)size1, (unsigned long)size2);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    *result = size1 * size2;
 
     return SAIL_OK;
 }
@@ -163,7 +163,23 @@ SAIL_EXPORT sail_status_t sail_greater_bits_per_pixel(enum SailPixelFormat pixel
  *
  * Returns SAIL_OK on success.
  */
-SAIL_EXPORT sail_status_t sail_bytes_per_line(unsigned width, enum SailPixelFormat pixel_format, unsigned *result);
+SAIL_EXPORT sail_status_t sail_bytes_per_line(unsigned width, enum SailPixelFormat pixel_format, size_t *result);
+
+/*
+ * Calculates the number of bytes needed to hold the image pixels, i.e. height * bytes_per_line.
+ * Fails with SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS when the size doesn't fit into size_t.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_bytes_per_image(const struct sail_image *image, size_t *result);
+
+/*
+ * Multiplies two sizes. Fails with SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS when the result
+ * doesn't fit into size_t.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_multiply_sizes(size_t size1, size_t size2, size_t *result);
 
 /*
  * Returns true if the given pixel format is indexed and assumes having a palette.
@@ -37,9 +37,30 @@ sail_status_t sail_alloc_write_options(struct sail_write_options **write_options
     SAIL_TRY(sail_malloc(sizeof(struct sail_write_options), &ptr));
     *write_options = ptr;
 
-    (*write_options)->io_options        = 0;
-    (*write_options)->compression       = SAIL_COMPRESSION_UNSUPPORTED;
-    (*write_options)->compression_level = 0;
+    (*write_options)->io_options         = 0;
+    (*write_options)->compression        = SAIL_COMPRESSION_UNSUPPORTED;
+    (*write_options)->compression_level  = 0;
+    (*write_options)->cancel_flag        = NULL;
+    (*write_options)->deadline           = 0;
+    (*write_options)->progress           = NULL;
+    (*write_options)->progress_user_data = NULL;
+    (*write_options)->lossless_transform = SAIL_LOSSLESS_TRANSFORM_NONE;
+    (*write_options)->crop_x             = 0;
+    (*write_options)->crop_y             = 0;
+    (*write_options)->crop_width         = 0;
+    (*write_options)->crop_height        = 0;
+    (*write_options)->chroma_subsampling = SAIL_CHROMA_SUBSAMPLING_UNKNOWN;
+    (*write_options)->optimize_coding    = false;
+    (*write_options)->progressive        = false;
+    (*write_options)->restart_interval   = 0;
+    (*write_options)->dct_method         = SAIL_DCT_METHOD_DEFAULT;
+    (*write_options)->arithmetic_coding  = false;
+    (*write_options)->threads            = 0;
+    (*write_options)->encode_preset      = SAIL_ENCODE_PRESET_DEFAULT;
+    (*write_options)->row_filters        = 0;
+    (*write_options)->zlib_strategy      = SAIL_ZLIB_STRATEGY_DEFAULT;
+    (*write_options)->zlib_window_bits   = 0;
+    (*write_options)->zlib_mem_level     = 0;
 
     return SAIL_OK;
 }
@@ -99,3 +120,30 @@ sail_status_t sail_copy_write_options(const struct sail_write_options *write_opt
 
     return SAIL_OK;
 }
+
+sail_status_t sail_check_write_cancelled(const struct sail_write_options *write_options) {
+
+    /* Not an error. */
+    if (write_options == NULL) {
+        return SAIL_OK;
+    }
+
+    if (write_options->cancel_flag != NULL && *write_options->cancel_flag != 0) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CANCELLED);
+    }
+
+    if (write_options->deadline > 0 && sail_now() >= write_options->deadline) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CANCELLED);
+    }
+
+    return SAIL_OK;
+}
+
+void sail_report_write_progress(const struct sail_write_options *write_options, unsigned rows_done, unsigned rows_total) {
+
+    if (write_options == NULL || write_options->progress == NULL) {
+        return;
+    }
+
+    write_options->progress(write_options->progress_user_data, rows_done, rows_total);
+}
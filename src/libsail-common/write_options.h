@@ -26,10 +26,15 @@
 #ifndef SAIL_WRITE_OPTIONS_H
 #define SAIL_WRITE_OPTIONS_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #ifdef SAIL_BUILD
+    #include "common.h"
     #include "error.h"
     #include "export.h"
 #else
+    #include <sail-common/common.h>
     #include <sail-common/error.h>
     #include <sail-common/export.h>
 #endif
@@ -66,6 +71,104 @@ struct sail_write_options {
      * in sail_write_features. If compression_level < compression_level_min, compression_level_default will be used.
      */
     double compression_level;
+
+    /*
+     * Cancellation flag owned by a caller or NULL. When another thread sets the flag to a non-zero value,
+     * codecs stop encoding between scan lines and return SAIL_ERROR_CANCELLED.
+     */
+    const volatile int *cancel_flag;
+
+    /*
+     * Deadline in milliseconds as returned by sail_now() or 0 if there is no deadline. When the deadline
+     * is reached, codecs stop encoding between scan lines and return SAIL_ERROR_CANCELLED.
+     */
+    uint64_t deadline;
+
+    /* Progress callback or NULL. See sail_progress_t. */
+    sail_progress_t progress;
+
+    /* User data passed to the progress callback. */
+    void *progress_user_data;
+
+    /*
+     * Lossless transformation applied to the original compressed data instead of encoding the pixels.
+     * Requires SAIL_IO_OPTION_SOURCE_DATA and the LOSSLESS-TRANSFORM write feature. See SailLosslessTransform
+     * and sail_transform_io_lossless().
+     */
+    enum SailLosslessTransform lossless_transform;
+
+    /*
+     * Crop rectangle for SAIL_LOSSLESS_TRANSFORM_CROP. Codecs align the left and top edges down
+     * to their block size, for example to 8 or 16 pixels in JPEG, and grow the rectangle accordingly.
+     * The rectangle is clipped to the image.
+     */
+    unsigned crop_x;
+    unsigned crop_y;
+    unsigned crop_width;
+    unsigned crop_height;
+
+    /*
+     * Chroma subsampling of the encoded image or SAIL_CHROMA_SUBSAMPLING_UNKNOWN to use the codec default.
+     * JPEG supports SAIL_CHROMA_SUBSAMPLING_444, SAIL_CHROMA_SUBSAMPLING_422, and SAIL_CHROMA_SUBSAMPLING_420
+     * for YCbCr images. 4:2:0 is the default and the fastest one.
+     */
+    enum SailChromaSubsampling chroma_subsampling;
+
+    /*
+     * Compute optimal Huffman tables instead of using the standard ones. Makes files smaller
+     * at the cost of an extra pass over the compressed data.
+     */
+    bool optimize_coding;
+
+    /*
+     * Write a progressive image that is refined in several scans. Implies optimize_coding in JPEG.
+     * Progressive images are usually smaller, but slower to encode and decode.
+     */
+    bool progressive;
+
+    /*
+     * Restart interval in rows of MCU blocks or 0 to write no restart markers. Restart markers let decoders
+     * resynchronize after corrupted data and decode restart intervals in parallel.
+     */
+    unsigned restart_interval;
+
+    /* Forward DCT method. See SailDctMethod. */
+    enum SailDctMethod dct_method;
+
+    /*
+     * Use arithmetic coding instead of Huffman coding. Makes files smaller, but many decoders
+     * don't support arithmetic coding. Codecs return SAIL_ERROR_UNSUPPORTED_COMPRESSION
+     * when the underlying library is built without it.
+     */
+    bool arithmetic_coding;
+
+    /*
+     * Maximum number of threads a codec may use to encode a single frame. 0 and 1 mean encoding
+     * in the calling thread. Codecs without parallel encoding ignore it. The PNG codec compresses
+     * big non-interlaced frames in parallel.
+     */
+    unsigned threads;
+
+    /*
+     * Encoding speed and size trade-off. See SailEncodePreset. Presets replace compression_level.
+     * The options below override the preset when they are set.
+     */
+    enum SailEncodePreset encode_preset;
+
+    /* Or-ed filters applied to scan lines or 0 to use the codec default. See SailRowFilter. */
+    int row_filters;
+
+    /* Deflate strategy. See SailZlibStrategy. */
+    enum SailZlibStrategy zlib_strategy;
+
+    /* Base two logarithm of the deflate window size in the range 8-15 or 0 to use the codec default. */
+    unsigned zlib_window_bits;
+
+    /*
+     * Amount of memory zlib uses for its internal state in the range 1-9 or 0 to use the codec default.
+     * Higher levels are faster and compress better.
+     */
+    unsigned zlib_mem_level;
 };
 
 typedef struct sail_write_options sail_write_options_t;
@@ -108,6 +211,22 @@ SAIL_EXPORT sail_status_t sail_alloc_write_options_from_features(const struct sa
  */
 SAIL_EXPORT sail_status_t sail_copy_write_options(const struct sail_write_options *write_options_source, struct sail_write_options **write_options_target);
 
+/*
+ * Checks if the writing operation must be stopped because the cancellation flag is set
+ * or the deadline is reached. Codecs call this function in their encoding loops.
+ * Does nothing if the write options is NULL.
+ *
+ * Returns SAIL_OK if the writing operation may continue.
+ * Returns SAIL_ERROR_CANCELLED if the writing operation must be stopped.
+ */
+SAIL_EXPORT sail_status_t sail_check_write_cancelled(const struct sail_write_options *write_options);
+
+/*
+ * Calls the progress callback from the write options if it is set. Codecs call this function
+ * after every encoded scan line. Does nothing if the write options is NULL.
+ */
+SAIL_EXPORT void sail_report_write_progress(const struct sail_write_options *write_options, unsigned rows_done, unsigned rows_total);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
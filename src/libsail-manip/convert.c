@@ -50,7 +50,7 @@ typedef void (*pixel_consumer_t)(const struct output_context *output_context, un
 
 static void pixel_consumer_gray8(const struct output_context *output_context, unsigned row, unsigned column, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
 
-    uint8_t *scan = (uint8_t *)output_context->image->pixels + output_context->image->bytes_per_line * row + column;
+    uint8_t *scan = (uint8_t *)output_context->image->pixels + output_context->image->bytes_per_line * row + (size_t)column;
 
     if (rgba32 != NULL) {
         fill_gray8_pixel_from_uint8_values(rgba32, scan, output_context->options);
@@ -61,7 +61,7 @@ static void pixel_consumer_gray8(const struct output_context *output_context, un
 
 static void pixel_consumer_gray16(const struct output_context *output_context, unsigned row, unsigned column, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
 
-    uint16_t *scan = (uint16_t *)((uint8_t *)output_context->image->pixels + output_context->image->bytes_per_line * row + column * 2);
+    uint16_t *scan = (uint16_t *)((uint8_t *)output_context->image->pixels + output_context->image->bytes_per_line * row + (size_t)column * 2);
 
     if (rgba32 != NULL) {
         fill_gray16_pixel_from_uint8_values(rgba32, scan, output_context->options);
@@ -72,7 +72,7 @@ static void pixel_consumer_gray16(const struct output_context *output_context, u
 
 static void pixel_consumer_rgb24_kind(const struct output_context *output_context, unsigned row, unsigned column, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
 
-    uint8_t *scan = (uint8_t *)output_context->image->pixels + output_context->image->bytes_per_line * row + column * 3;
+    uint8_t *scan = (uint8_t *)output_context->image->pixels + output_context->image->bytes_per_line * row + (size_t)column * 3;
 
     if (rgba32 != NULL) {
         fill_rgb24_pixel_from_uint8_values(rgba32, scan, output_context->r, output_context->g, output_context->b, output_context->options);
@@ -83,7 +83,7 @@ static void pixel_consumer_rgb24_kind(const struct output_context *output_contex
 
 static void pixel_consumer_rgb48_kind(const struct output_context *output_context, unsigned row, unsigned column, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
 
-    uint16_t *scan = (uint16_t *)((uint8_t *)output_context->image->pixels + output_context->image->bytes_per_line * row + column * 6);
+    uint16_t *scan = (uint16_t *)((uint8_t *)output_context->image->pixels + output_context->image->bytes_per_line * row + (size_t)column * 6);
 
     if (rgba32 != NULL) {
         fill_rgb48_pixel_from_uint8_values(rgba32, scan, output_context->r, output_context->g, output_context->b, output_context->options);
@@ -94,7 +94,7 @@ static void pixel_consumer_rgb48_kind(const struct output_context *output_contex
 
 static void pixel_consumer_rgba32_kind(const struct output_context *output_context, unsigned row, unsigned column, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
 
-    uint8_t *scan = (uint8_t *)output_context->image->pixels + output_context->image->bytes_per_line * row + column * 4;
+    uint8_t *scan = (uint8_t *)output_context->image->pixels + output_context->image->bytes_per_line * row + (size_t)column * 4;
 
     if (rgba32 != NULL) {
         fill_rgba32_pixel_from_uint8_values(rgba32, scan, output_context->r, output_context->g, output_context->b, output_context->a, output_context->options);
@@ -105,7 +105,7 @@ static void pixel_consumer_rgba32_kind(const struct output_context *output_conte
 
 static void pixel_consumer_rgba64_kind(const struct output_context *output_context, unsigned row, unsigned column, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
 
-    uint16_t *scan = (uint16_t *)((uint8_t *)output_context->image->pixels + output_context->image->bytes_per_line * row + column * 8);
+    uint16_t *scan = (uint16_t *)((uint8_t *)output_context->image->pixels + output_context->image->bytes_per_line * row + (size_t)column * 8);
 
     if (rgba32 != NULL) {
         fill_rgba64_pixel_from_uint8_values(rgba32, scan, output_context->r, output_context->g, output_context->b, output_context->a, output_context->options);
@@ -116,7 +116,7 @@ static void pixel_consumer_rgba64_kind(const struct output_context *output_conte
 
 static void pixel_consumer_ycbcr(const struct output_context *output_context, unsigned row, unsigned column, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
 
-    uint8_t *scan = (uint8_t *)output_context->image->pixels + output_context->image->bytes_per_line * row + column * 3;
+    uint8_t *scan = (uint8_t *)output_context->image->pixels + output_context->image->bytes_per_line * row + (size_t)column * 3;
 
     if (rgba32 != NULL) {
         fill_ycbcr_pixel_from_uint8_values(rgba32, scan, output_context->options);
@@ -699,6 +699,46 @@ static sail_status_t conversion_impl(
     return SAIL_OK;
 }
 
+/* State of a scan line converter allocated with sail_alloc_scan_line_converter(). */
+struct scan_line_conversion {
+    pixel_consumer_t pixel_consumer;
+    int r;
+    int g;
+    int b;
+    int a;
+    bool with_options;
+    struct sail_conversion_options options;
+};
+
+static sail_status_t convert_scan_line(void *user_data, const struct sail_image *source, const void *scan_line,
+                                       unsigned row, struct sail_image *target) {
+
+    SAIL_CHECK_PTR(user_data);
+    SAIL_CHECK_PTR(source);
+    SAIL_CHECK_PTR(scan_line);
+    SAIL_CHECK_PTR(target);
+
+    const struct scan_line_conversion *scan_line_conversion = user_data;
+
+    /* Convert a single-row image. */
+    struct sail_image source_row = *source;
+    source_row.pixels         = (void *)scan_line;
+    source_row.height         = 1;
+    source_row.parent         = NULL;
+    source_row.release_pixels = NULL;
+
+    struct sail_image target_row = *target;
+    target_row.pixels = (unsigned char *)target->pixels + target->bytes_per_line * row;
+    target_row.height = 1;
+
+    SAIL_TRY(conversion_impl(&source_row, &target_row,
+                                scan_line_conversion->pixel_consumer,
+                                scan_line_conversion->r, scan_line_conversion->g, scan_line_conversion->b, scan_line_conversion->a,
+                                scan_line_conversion->with_options ? &scan_line_conversion->options : NULL));
+
+    return SAIL_OK;
+}
+
 /*
  * Public functions.
  */
@@ -732,8 +772,10 @@ sail_status_t sail_convert_image_with_options(const struct sail_image *image,
     SAIL_TRY_OR_CLEANUP(sail_bytes_per_line(image_local->width, image_local->pixel_format, &image_local->bytes_per_line),
                         /* cleanup */ sail_destroy_image(image_local));
 
-    const size_t pixels_size = (size_t)image_local->height * image_local->bytes_per_line;
-    SAIL_TRY_OR_CLEANUP(sail_malloc(pixels_size, &image_local->pixels),
+    size_t pixels_size;
+    SAIL_TRY_OR_CLEANUP(sail_bytes_per_image(image_local, &pixels_size),
+                        /* cleanup */ sail_destroy_image(image_local));
+    SAIL_TRY_OR_CLEANUP(sail_malloc_pixels(pixels_size, &image_local->pixels),
                         /* cleanup */ sail_destroy_image(image_local));
 
     SAIL_TRY_OR_CLEANUP(conversion_impl(image, image_local, pixel_consumer, r, g, b, a, options),
@@ -982,3 +1024,49 @@ sail_status_t sail_convert_image_for_saving_with_options(const struct sail_image
 
     return SAIL_OK;
 }
+
+sail_status_t sail_alloc_scan_line_converter(enum SailPixelFormat output_pixel_format,
+                                             const struct sail_conversion_options *options,
+                                             struct sail_scan_line_converter **scan_line_converter) {
+
+    SAIL_CHECK_PTR(scan_line_converter);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct scan_line_conversion), &ptr));
+    struct scan_line_conversion *scan_line_conversion = ptr;
+
+    SAIL_TRY_OR_CLEANUP(verify_and_construct_rgba_indexes_verbose(output_pixel_format, &scan_line_conversion->pixel_consumer,
+                                                                    &scan_line_conversion->r, &scan_line_conversion->g,
+                                                                    &scan_line_conversion->b, &scan_line_conversion->a),
+                        /* cleanup */ sail_free(scan_line_conversion));
+
+    scan_line_conversion->with_options = options != NULL;
+
+    if (options != NULL) {
+        scan_line_conversion->options = *options;
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct sail_scan_line_converter), &ptr),
+                        /* cleanup */ sail_free(scan_line_conversion));
+    struct sail_scan_line_converter *scan_line_converter_local = ptr;
+
+    scan_line_converter_local->pixel_format   = output_pixel_format;
+    scan_line_converter_local->convert        = convert_scan_line;
+    scan_line_converter_local->user_data      = scan_line_conversion;
+    scan_line_converter_local->scan_line      = NULL;
+    scan_line_converter_local->scan_line_size = 0;
+
+    *scan_line_converter = scan_line_converter_local;
+
+    return SAIL_OK;
+}
+
+void sail_destroy_scan_line_converter(struct sail_scan_line_converter *scan_line_converter) {
+
+    if (scan_line_converter == NULL) {
+        return;
+    }
+
+    sail_free(scan_line_converter->user_data);
+    sail_free(scan_line_converter);
+}
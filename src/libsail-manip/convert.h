@@ -44,6 +44,7 @@ extern "C" {
 
 struct sail_conversion_options;
 struct sail_image;
+struct sail_scan_line_converter;
 struct sail_write_features;
 
 /*
@@ -319,6 +320,29 @@ SAIL_EXPORT sail_status_t sail_convert_image_for_saving_with_options(const struc
                                                                      const struct sail_conversion_options *options,
                                                                      struct sail_image **image_output);
 
+/*
+ * Allocates a scan line converter into the output pixel format to convert frames while reading them.
+ * Set it to sail_read_options.scan_line_converter. Every scan line is converted as soon as it's decoded,
+ * so sail_read_next_frame() returns frames in the output pixel format without a separate conversion pass.
+ * The result is the same as of sail_convert_image_with_options().
+ *
+ * Options (which may be NULL) control the conversion behavior. They are copied.
+ *
+ * The converter doesn't change while converting, so it may be shared by several reading operations,
+ * including concurrent ones. It MUST NOT be destroyed until the last reading operation using it is finished.
+ * The assigned converter MUST be destroyed later with sail_destroy_scan_line_converter().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_scan_line_converter(enum SailPixelFormat output_pixel_format,
+                                                         const struct sail_conversion_options *options,
+                                                         struct sail_scan_line_converter **scan_line_converter);
+
+/*
+ * Destroys the specified scan line converter. Does nothing if the converter is NULL.
+ */
+SAIL_EXPORT void sail_destroy_scan_line_converter(struct sail_scan_line_converter *scan_line_converter);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
@@ -0,0 +1,281 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "config.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#ifndef SAIL_WIN32
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <stdio.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <time.h>
+    #include <unistd.h>
+#endif
+
+#include "sail.h"
+
+#ifndef SAIL_WIN32
+
+/* Number of attempts to pick a unique shared-memory object name. */
+#define SHM_NAME_ATTEMPTS 16
+
+/*
+ * Private functions.
+ */
+
+static size_t page_aligned_size(size_t size, size_t page_size) {
+
+    return (size + page_size - 1) / page_size * page_size;
+}
+
+static size_t pixels_alignment(void) {
+
+    const long page_size = sysconf(_SC_PAGESIZE);
+
+    if (page_size <= SAIL_RAW_IMAGE_PIXELS_ALIGNMENT || page_size % SAIL_RAW_IMAGE_PIXELS_ALIGNMENT != 0) {
+        return SAIL_RAW_IMAGE_PIXELS_ALIGNMENT;
+    }
+
+    return (size_t)page_size;
+}
+
+/* Creates a new shared-memory object and immediately unlinks it so it's freed with the last descriptor. */
+static sail_status_t create_anonymous_shm(int *fd) {
+
+    static unsigned counter;
+
+    for (unsigned attempt = 0; attempt < SHM_NAME_ATTEMPTS; attempt++) {
+        char name[64];
+        snprintf(name, sizeof(name), "/sail-shm-%ld-%u-%lx", (long)getpid(), counter++, (unsigned long)clock());
+
+        const int fd_local = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+
+        if (fd_local >= 0) {
+            shm_unlink(name);
+            *fd = fd_local;
+            return SAIL_OK;
+        }
+
+        if (errno != EEXIST) {
+            SAIL_LOG_ERROR("Failed to create a shared-memory object: %s", strerror(errno));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+        }
+    }
+
+    SAIL_LOG_ERROR("Failed to pick a unique shared-memory object name");
+    SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+}
+
+static void release_shm_pixels(void *user_data, void *pixels, size_t pixels_size) {
+
+    (void)user_data;
+
+    if (pixels != NULL) {
+        munmap(pixels, pixels_size);
+    }
+}
+
+/*
+ * Reads the image skeleton from the mapped shared-memory object, and keeps only the pixels mapped.
+ * The mapping is consumed in any case.
+ */
+static sail_status_t image_from_mapping(void *base, size_t length, size_t page_size, struct sail_image **image) {
+
+    struct sail_io *io;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_io_read_memory(base, length, &io),
+                        /* cleanup */ munmap(base, length));
+
+    struct sail_image *image_local;
+    size_t pixels_offset;
+    SAIL_TRY_OR_CLEANUP(sail_read_raw_image_skeleton(io, NULL, &image_local, &pixels_offset),
+                        /* cleanup */ sail_destroy_io(io),
+                                      munmap(base, length));
+    sail_destroy_io(io);
+
+    size_t pixels_size;
+    SAIL_TRY_OR_CLEANUP(sail_bytes_per_image(image_local, &pixels_size),
+                        /* cleanup */ sail_destroy_image(image_local),
+                                      munmap(base, length));
+
+    if (pixels_offset % page_size != 0 || pixels_offset > length || pixels_size > length - pixels_offset) {
+        SAIL_LOG_ERROR("Shared-memory object of %lu bytes has invalid pixels at offset %lu of %lu bytes",
+                        (unsigned long)length, (unsigned long)pixels_offset, (unsigned long)pixels_size);
+        sail_destroy_image(image_local);
+        munmap(base, length);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    /* Unmap the header and sections, and the pages behind the pixels. */
+    if (pixels_offset > 0) {
+        munmap(base, pixels_offset);
+    }
+
+    const size_t pixels_end = pixels_offset + page_aligned_size(pixels_size, page_size);
+
+    if (pixels_end < length) {
+        munmap((char *)base + pixels_end, length - pixels_end);
+    }
+
+    image_local->pixels         = (char *)base + pixels_offset;
+    image_local->release_pixels = release_shm_pixels;
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+#endif
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_alloc_image_shm(const struct sail_image *source, struct sail_image **image, int *fd) {
+
+    SAIL_TRY(sail_check_image_skeleton_valid(source));
+    SAIL_CHECK_PTR(image);
+    SAIL_CHECK_PTR(fd);
+
+#ifdef SAIL_WIN32
+    SAIL_LOG_ERROR("Shared-memory images are not implemented on Windows");
+    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+#else
+    const size_t alignment = pixels_alignment();
+
+    size_t pixels_offset;
+    SAIL_TRY(sail_raw_image_pixels_offset(source, alignment, &pixels_offset));
+
+    /* Views are stored with tightly packed pixels. */
+    size_t bytes_per_line = source->bytes_per_line;
+
+    if (source->parent != NULL) {
+        SAIL_TRY(sail_bytes_per_line(source->width, source->pixel_format, &bytes_per_line));
+    }
+
+    size_t pixels_size;
+    SAIL_TRY(sail_multiply_sizes(bytes_per_line, source->height, &pixels_size));
+
+    if (pixels_size > (size_t)-1 - pixels_offset) {
+        SAIL_LOG_ERROR("Image of %lu bytes is too large for a shared-memory object", (unsigned long)pixels_size);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    const size_t length = pixels_offset + pixels_size;
+
+    int fd_local;
+    SAIL_TRY(create_anonymous_shm(&fd_local));
+
+    if (ftruncate(fd_local, (off_t)length) != 0) {
+        SAIL_LOG_ERROR("Failed to resize the shared-memory object to %lu bytes: %s", (unsigned long)length, strerror(errno));
+        close(fd_local);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    void *base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_local, 0);
+
+    if (base == MAP_FAILED) {
+        SAIL_LOG_ERROR("Failed to map the shared-memory object: %s", strerror(errno));
+        close(fd_local);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    struct sail_io *io;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_io_read_write_memory(base, length, &io),
+                        /* cleanup */ munmap(base, length),
+                                      close(fd_local));
+    SAIL_TRY_OR_CLEANUP(sail_write_raw_image_skeleton(io, source, alignment),
+                        /* cleanup */ sail_destroy_io(io),
+                                      munmap(base, length),
+                                      close(fd_local));
+    sail_destroy_io(io);
+
+    struct sail_image *image_local;
+    SAIL_TRY_OR_CLEANUP(image_from_mapping(base, length, alignment, &image_local),
+                        /* cleanup */ close(fd_local));
+
+    if (source->pixels != NULL && source->parent != NULL) {
+        for (unsigned row = 0; row < source->height; row++) {
+            memcpy((unsigned char *)image_local->pixels + bytes_per_line * row,
+                   (const unsigned char *)source->pixels + source->bytes_per_line * row,
+                   bytes_per_line);
+        }
+    } else if (source->pixels != NULL) {
+        memcpy(image_local->pixels, source->pixels, pixels_size);
+    }
+
+    *image = image_local;
+    *fd = fd_local;
+
+    return SAIL_OK;
+#endif
+}
+
+sail_status_t sail_map_image_shm(int fd, struct sail_image **image) {
+
+    SAIL_CHECK_PTR(image);
+
+#ifdef SAIL_WIN32
+    (void)fd;
+
+    SAIL_LOG_ERROR("Shared-memory images are not implemented on Windows");
+    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+#else
+    struct stat st;
+
+    if (fstat(fd, &st) != 0) {
+        SAIL_LOG_ERROR("Failed to get the size of the shared-memory object: %s", strerror(errno));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+    }
+
+    if (st.st_size <= 0 || (unsigned long long)st.st_size > (size_t)-1) {
+        SAIL_LOG_ERROR("Invalid shared-memory object size");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    const size_t length = (size_t)st.st_size;
+
+    void *base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (base == MAP_FAILED) {
+        SAIL_LOG_ERROR("Failed to map the shared-memory object: %s", strerror(errno));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+    }
+
+    const long page_size = sysconf(_SC_PAGESIZE);
+
+    SAIL_TRY(image_from_mapping(base, length, (page_size > 0) ? (size_t)page_size : SAIL_RAW_IMAGE_PIXELS_ALIGNMENT, image));
+
+    return SAIL_OK;
+#endif
+}
+
+void sail_destroy_image_shm(struct sail_image *image) {
+
+    sail_destroy_image(image);
+}
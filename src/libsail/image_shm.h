@@ -0,0 +1,91 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_IMAGE_SHM_H
+#define SAIL_IMAGE_SHM_H
+
+#ifdef SAIL_BUILD
+    #include "error.h"
+    #include "export.h"
+#else
+    #include <sail-common/error.h>
+    #include <sail-common/export.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_image;
+
+/*
+ * Allocates a new image in an anonymous POSIX shared-memory object to pass it to another process
+ * without copying the pixels. The object contains the image in the SAIL raw format: the header,
+ * the palette, the ICC profile, and the meta data are followed by the pixels at a page-aligned offset.
+ *
+ * Copies the image properties and the pixels, if any, from the source image. The source pixels
+ * may be NULL. In this case, the pixels are left zeroed for the caller to fill.
+ *
+ * Assigns the file descriptor of the shared-memory object. Pass it to another process with
+ * a UNIX domain socket or fork() and reconstruct the image with sail_map_image_shm().
+ * The caller owns the file descriptor and MUST close it when it's not needed anymore.
+ * The image stays valid after closing the descriptor.
+ *
+ * The assigned image MUST be destroyed later with sail_destroy_image_shm().
+ *
+ * Not implemented on Windows.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_image_shm(const struct sail_image *source, struct sail_image **image, int *fd);
+
+/*
+ * Maps the shared-memory object allocated with sail_alloc_image_shm() and reconstructs the image.
+ * The image pixels point directly into the shared memory and are visible to all the processes
+ * which mapped the object. No pixels are copied. The file descriptor is not closed.
+ *
+ * The assigned image MUST be destroyed later with sail_destroy_image_shm().
+ *
+ * Not implemented on Windows.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_map_image_shm(int fd, struct sail_image **image);
+
+/*
+ * Releases a reference to the image allocated with sail_alloc_image_shm() or sail_map_image_shm().
+ * The shared pixels are unmapped with the last reference, so views of the image keep them mapped.
+ * Does nothing if the image is NULL.
+ *
+ * Same as sail_destroy_image().
+ */
+SAIL_EXPORT void sail_destroy_image_shm(struct sail_image *image);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,323 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "config.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef SAIL_WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "sail.h"
+
+struct mapped_file_stream {
+
+    /* Mapped file contents or NULL for empty files. */
+    const void *data;
+
+    /* File size. */
+    size_t length;
+
+    /* Current stream position. */
+    size_t pos;
+
+#ifdef SAIL_WIN32
+    HANDLE mapping;
+#endif
+};
+
+/*
+ * Private functions.
+ */
+
+static sail_status_t io_mapped_file_tolerant_read(void *stream, void *buf, size_t size_to_read, size_t *read_size) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(buf);
+    SAIL_CHECK_PTR(read_size);
+
+    struct mapped_file_stream *mapped_file_stream = (struct mapped_file_stream *)stream;
+
+    *read_size = 0;
+
+    if (mapped_file_stream->pos >= mapped_file_stream->length) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_EOF);
+    }
+
+    const size_t actual_size_to_read = (size_to_read > mapped_file_stream->length - mapped_file_stream->pos)
+                                        ? mapped_file_stream->length - mapped_file_stream->pos
+                                        : size_to_read;
+
+    memcpy(buf, (const char *)mapped_file_stream->data + mapped_file_stream->pos, actual_size_to_read);
+    mapped_file_stream->pos += actual_size_to_read;
+
+    *read_size = actual_size_to_read;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mapped_file_strict_read(void *stream, void *buf, size_t size_to_read) {
+
+    size_t read_size;
+
+    SAIL_TRY(io_mapped_file_tolerant_read(stream, buf, size_to_read, &read_size));
+
+    if (read_size != size_to_read) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mapped_file_seek(void *stream, long offset, int whence) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct mapped_file_stream *mapped_file_stream = (struct mapped_file_stream *)stream;
+
+    size_t base;
+
+    switch (whence) {
+        case SEEK_SET: base = 0;                          break;
+        case SEEK_CUR: base = mapped_file_stream->pos;    break;
+        case SEEK_END: base = mapped_file_stream->length; break;
+
+        default: {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_SEEK_WHENCE);
+        }
+    }
+
+    if ((offset < 0 && (size_t)(-offset) > base) || (offset > 0 && (size_t)offset > mapped_file_stream->length - base)) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_SEEK_IO);
+    }
+
+    mapped_file_stream->pos = base + offset;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mapped_file_tell(void *stream, size_t *offset) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(offset);
+
+    const struct mapped_file_stream *mapped_file_stream = (struct mapped_file_stream *)stream;
+
+    *offset = mapped_file_stream->pos;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mapped_file_close(void *stream) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct mapped_file_stream *mapped_file_stream = (struct mapped_file_stream *)stream;
+
+    if (mapped_file_stream->data != NULL) {
+#ifdef SAIL_WIN32
+        UnmapViewOfFile(mapped_file_stream->data);
+        CloseHandle(mapped_file_stream->mapping);
+#else
+        munmap((void *)mapped_file_stream->data, mapped_file_stream->length);
+#endif
+    }
+
+    sail_free(mapped_file_stream);
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mapped_file_eof(void *stream, bool *result) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(result);
+
+    const struct mapped_file_stream *mapped_file_stream = (struct mapped_file_stream *)stream;
+
+    *result = mapped_file_stream->pos >= mapped_file_stream->length;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mapped_file_contents(void *stream, const void **data, size_t *data_size) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(data_size);
+
+    const struct mapped_file_stream *mapped_file_stream = (struct mapped_file_stream *)stream;
+
+    *data      = mapped_file_stream->data;
+    *data_size = mapped_file_stream->length;
+
+    return SAIL_OK;
+}
+
+static sail_status_t map_file(const char *path, struct mapped_file_stream *mapped_file_stream) {
+
+#ifdef SAIL_WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        SAIL_LOG_ERROR("Failed to open the specified file: %s. Error: 0x%X", path, GetLastError());
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+    }
+
+    LARGE_INTEGER file_size;
+
+    if (!GetFileSizeEx(file, &file_size) || (unsigned long long)file_size.QuadPart > SIZE_MAX) {
+        SAIL_LOG_ERROR("Failed to get the size of the file: %s. Error: 0x%X", path, GetLastError());
+        CloseHandle(file);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
+    }
+
+    mapped_file_stream->length = (size_t)file_size.QuadPart;
+
+    if (mapped_file_stream->length > 0) {
+        mapped_file_stream->mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+        if (mapped_file_stream->mapping == NULL) {
+            SAIL_LOG_ERROR("Failed to map the file: %s. Error: 0x%X", path, GetLastError());
+            CloseHandle(file);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+        }
+
+        mapped_file_stream->data = MapViewOfFile(mapped_file_stream->mapping, FILE_MAP_READ, 0, 0, 0);
+
+        if (mapped_file_stream->data == NULL) {
+            SAIL_LOG_ERROR("Failed to map the file: %s. Error: 0x%X", path, GetLastError());
+            CloseHandle(mapped_file_stream->mapping);
+            CloseHandle(file);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+        }
+    }
+
+    /* The mapping keeps the file open. */
+    CloseHandle(file);
+#else
+    const int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        sail_print_errno("Failed to open the specified file: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+    }
+
+    struct stat st;
+
+    if (fstat(fd, &st) != 0 || (unsigned long long)st.st_size > SIZE_MAX) {
+        sail_print_errno("Failed to get the file size: %s");
+        close(fd);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
+    }
+
+    mapped_file_stream->length = (size_t)st.st_size;
+
+    if (mapped_file_stream->length > 0) {
+        void *data = mmap(NULL, mapped_file_stream->length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data == MAP_FAILED) {
+            sail_print_errno("Failed to map the file: %s");
+            close(fd);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+        }
+
+        mapped_file_stream->data = data;
+    }
+
+    /* The mapping keeps the file open. */
+    close(fd);
+#endif
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_alloc_io_read_mapped_file(const char *path, struct sail_io **io) {
+
+    SAIL_CHECK_PTR(path);
+    SAIL_CHECK_PTR(io);
+
+    SAIL_LOG_DEBUG("Mapping file '%s' for reading", path);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct mapped_file_stream), &ptr));
+    struct mapped_file_stream *mapped_file_stream = ptr;
+
+    memset(mapped_file_stream, 0, sizeof(struct mapped_file_stream));
+
+    SAIL_TRY_OR_CLEANUP(map_file(path, mapped_file_stream),
+                        /* cleanup */ sail_free(mapped_file_stream));
+
+    struct sail_io *io_local;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_io(&io_local),
+                        /* cleanup */ io_mapped_file_close(mapped_file_stream));
+
+    io_local->id             = SAIL_MAPPED_FILE_IO_ID;
+    io_local->features       = SAIL_IO_FEATURE_SEEKABLE;
+    io_local->stream         = mapped_file_stream;
+    io_local->tolerant_read  = io_mapped_file_tolerant_read;
+    io_local->strict_read    = io_mapped_file_strict_read;
+    io_local->tolerant_write = sail_io_noop_tolerant_write;
+    io_local->strict_write   = sail_io_noop_strict_write;
+    io_local->seek           = io_mapped_file_seek;
+    io_local->tell           = io_mapped_file_tell;
+    io_local->flush          = sail_io_noop_flush;
+    io_local->close          = io_mapped_file_close;
+    io_local->eof            = io_mapped_file_eof;
+    io_local->contents       = io_mapped_file_contents;
+
+    *io = io_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_mapped_file_data(const struct sail_io *io, const void **data, size_t *data_size) {
+
+    SAIL_CHECK_PTR(io);
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(data_size);
+
+    if (io->id != SAIL_MAPPED_FILE_IO_ID) {
+        SAIL_LOG_ERROR("The I/O object is not a mapped file");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_IO);
+    }
+
+    SAIL_TRY(io_mapped_file_contents(io->stream, data, data_size));
+
+    return SAIL_OK;
+}
@@ -238,6 +238,20 @@ static sail_status_t io_memory_eof(void *stream, bool *result) {
     return SAIL_OK;
 }
 
+static sail_status_t io_memory_contents(void *stream, const void **data, size_t *data_size) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(data_size);
+
+    const struct mem_io_read_stream *mem_io_read_stream = (struct mem_io_read_stream *)stream;
+
+    *data      = mem_io_read_stream->buffer;
+    *data_size = mem_io_read_stream->mem_io_buffer_info.accessible_length;
+
+    return SAIL_OK;
+}
+
 /*
  * Public functions.
  */
@@ -273,6 +287,7 @@ sail_status_t sail_alloc_io_read_memory(const void *buffer, size_t length, struc
     io_local->flush          = sail_io_noop_flush;
     io_local->close          = io_memory_close;
     io_local->eof            = io_memory_eof;
+    io_local->contents       = io_memory_contents;
 
     *io = io_local;
 
@@ -115,13 +115,17 @@ sail_status_t SAIL_CONSTRUCT_CODEC_FUNC(sail_codec_read_seek_next_frame_v6)(void
  *   - The state is valid and points to the state allocated by sail_codec_read_init_vx().
  *   - The IO is valid and open.
  *   - The image points to the image allocated by sail_codec_read_seek_next_frame_vx().
- *   - The image pixels are allocated.
+ *   - The image pixels are allocated unless the frame is skipped (see below).
  *
  * This function MUST:
  *   - Read the image pixels into sail_image.pixels.
  *   - Output pixels with the origin in the top left corner (i.e. not flipped).
  *   - Output pixels in format as close to the source as possible.
  *
+ * Codecs with the SKIP-FRAMES read feature MUST also accept images with NULL pixels.
+ * In this case, the frame is skipped with sail_skip_next_frame(). Such codecs MUST NOT decode
+ * the frame and MUST just prepare to seek to the next frame.
+ *
  * Returns SAIL_OK on success.
  */
 sail_status_t SAIL_CONSTRUCT_CODEC_FUNC(sail_codec_read_frame_v6)(void *state, struct sail_io *io, struct sail_image *image);
@@ -42,8 +42,10 @@
     #include "codec_priority.h"
     #include "context.h"
     #include "context_private.h"
+    #include "image_shm.h"
     #include "ini.h"
     #include "io_file.h"
+    #include "io_mapped_file.h"
     #include "io_memory.h"
     #include "io_noop.h"
     #include "sail_advanced.h"
@@ -63,7 +65,9 @@
     #include <sail/codec_info.h>
     #include <sail/codec_priority.h>
     #include <sail/context.h>
+    #include <sail/image_shm.h>
     #include <sail/io_file.h>
+    #include <sail/io_mapped_file.h>
     #include <sail/io_memory.h>
     #include <sail/io_noop.h>
     #include <sail/sail_advanced.h>
@@ -26,11 +26,259 @@
 #include "config.h"
 
 #include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
 
 #include "sail-common.h"
 #include "sail.h"
 
+/* State of a SAIL raw file mapped with sail_map_raw_file(). */
+struct raw_mapping {
+
+    struct sail_io *io;
+    struct sail_image *image;
+};
+
+/*
+ * Private functions.
+ */
+
+/* Unmaps the file mapped with sail_map_raw_file() with the last reference to the mapped image. */
+static void release_raw_mapping(void *user_data, void *pixels, size_t pixels_size) {
+
+    (void)pixels;
+    (void)pixels_size;
+
+    struct raw_mapping *raw_mapping = user_data;
+
+    sail_destroy_io(raw_mapping->io);
+    sail_free(raw_mapping);
+}
+
+static size_t meta_data_size(const struct sail_image *image) {
+
+    size_t size = (image->iccp == NULL) ? 0 : image->iccp->data_length;
+
+    for (const struct sail_meta_data_node *node = image->meta_data_node; node != NULL; node = node->next) {
+        size += node->meta_data->value_length;
+    }
+
+    return size;
+}
+
+/* Checks the image skeleton against the read limits before allocating pixels. */
+static sail_status_t check_read_limits(const struct hidden_state *state_of_mind, const struct sail_image *image) {
+
+    size_t pixels_size;
+    SAIL_TRY(sail_bytes_per_image(image, &pixels_size));
+
+    SAIL_TRY(sail_check_read_limits(state_of_mind->read_options, image->width, image->height, pixels_size));
+
+    struct sail_read_limits read_limits;
+    SAIL_TRY(sail_effective_read_limits(state_of_mind->read_options, &read_limits));
+
+    if (read_limits.max_meta_data_bytes > 0) {
+        const size_t size = meta_data_size(image);
+
+        if (size > read_limits.max_meta_data_bytes) {
+            SAIL_LOG_ERROR("Meta data size %lu exceeds the limit of %lu bytes",
+                            (unsigned long)size, (unsigned long)read_limits.max_meta_data_bytes);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t seek_next_frame(struct hidden_state *state_of_mind, struct sail_image **image) {
+
+    SAIL_TRY(sail_check_io_valid(state_of_mind->io));
+    SAIL_CHECK_PTR(state_of_mind->state);
+    SAIL_CHECK_PTR(state_of_mind->codec);
+
+    struct sail_read_limits read_limits;
+    SAIL_TRY(sail_effective_read_limits(state_of_mind->read_options, &read_limits));
+
+    if (read_limits.max_frames > 0 && state_of_mind->frame_number >= read_limits.max_frames) {
+        SAIL_LOG_ERROR("Number of frames exceeds the limit of %u frames", read_limits.max_frames);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    struct sail_image *image_local;
+    SAIL_TRY(state_of_mind->codec->v6->read_seek_next_frame(state_of_mind->state, state_of_mind->io, &image_local));
+
+    if (image_local->pixels != NULL) {
+        SAIL_LOG_ERROR("Internal error in %s codec: codecs must not allocate pixels", state_of_mind->codec_info->name);
+        sail_destroy_image(image_local);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CONFLICTING_OPERATION);
+    }
+
+    SAIL_TRY_OR_CLEANUP(check_read_limits(state_of_mind, image_local),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+/* Decodes the native frame and converts it with the scan line converter afterwards. */
+static sail_status_t read_and_convert_frame(struct hidden_state *state_of_mind, struct sail_image *image) {
+
+    size_t pixels_size;
+    SAIL_TRY(sail_bytes_per_image(image, &pixels_size));
+
+    void *pixels;
+    SAIL_TRY(sail_malloc_pixels(pixels_size, &pixels));
+
+    void *converted_pixels = image->pixels;
+    image->pixels = pixels;
+
+    SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v6->read_frame(state_of_mind->state, state_of_mind->io, image),
+                        /* cleanup */ image->pixels = converted_pixels,
+                                      sail_free(pixels));
+
+    image->pixels = converted_pixels;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        SAIL_TRY_OR_CLEANUP(sail_scan_line_decoded(state_of_mind->read_options, image, row, (unsigned char *)pixels + image->bytes_per_line * row),
+                            /* cleanup */ sail_free(pixels));
+    }
+
+    sail_free(pixels);
+
+    return SAIL_OK;
+}
+
+/*
+ * Allocates the frame pixels and decodes the frame. With a scan line converter, frames are converted
+ * into its pixel format. With SAIL_IO_OPTION_APPLY_ORIENTATION, frames are also oriented.
+ * Assigns the size of the allocated pixels.
+ */
+static sail_status_t read_frame_pixels(struct hidden_state *state_of_mind, struct sail_image *image, size_t *pixels_size) {
+
+    struct sail_scan_line_converter *scan_line_converter = state_of_mind->read_options->scan_line_converter;
+
+    state_of_mind->preview.override_geometry = false;
+
+    if (scan_line_converter == NULL) {
+        SAIL_TRY(sail_bytes_per_image(image, pixels_size));
+        SAIL_TRY(alloc_frame_pixels(state_of_mind, *pixels_size, &image->pixels));
+
+        SAIL_TRY(state_of_mind->codec->v6->read_frame(state_of_mind->state, state_of_mind->io, image));
+
+        return SAIL_OK;
+    }
+
+    /* The frame pixels hold the converted and oriented frame. */
+    const bool orient = state_of_mind->read_options->io_options & SAIL_IO_OPTION_APPLY_ORIENTATION;
+    unsigned width    = image->width;
+    unsigned height   = image->height;
+
+    if (orient) {
+        SAIL_TRY(begin_oriented_frame(state_of_mind, image));
+
+        width  = state_of_mind->orientation.width;
+        height = state_of_mind->orientation.height;
+    }
+
+    size_t bytes_per_line;
+    SAIL_TRY(sail_bytes_per_line(width, scan_line_converter->pixel_format, &bytes_per_line));
+    SAIL_TRY(sail_multiply_sizes(bytes_per_line, height, pixels_size));
+    SAIL_TRY(alloc_frame_pixels(state_of_mind, *pixels_size, &image->pixels));
+
+    const bool keep_palette = orient && !state_of_mind->orientation.convert;
+
+    if (state_of_mind->codec_info->read_features->features & SAIL_CODEC_FEATURE_SCAN_LINES) {
+        /* Codecs report previews of the native frame while the frame pixels hold the converted one. */
+        state_of_mind->preview.override_geometry = true;
+        state_of_mind->preview.width             = width;
+        state_of_mind->preview.height            = height;
+        state_of_mind->preview.pixel_format      = scan_line_converter->pixel_format;
+        state_of_mind->preview.bytes_per_line    = bytes_per_line;
+        state_of_mind->preview.keep_palette      = keep_palette;
+
+        if (scan_line_converter->scan_line_size < image->bytes_per_line) {
+            sail_free(scan_line_converter->scan_line);
+            scan_line_converter->scan_line      = NULL;
+            scan_line_converter->scan_line_size = 0;
+
+            SAIL_TRY(sail_malloc(image->bytes_per_line, &scan_line_converter->scan_line));
+            scan_line_converter->scan_line_size = image->bytes_per_line;
+        }
+
+        SAIL_TRY(state_of_mind->codec->v6->read_frame(state_of_mind->state, state_of_mind->io, image));
+    } else {
+        SAIL_TRY(read_and_convert_frame(state_of_mind, image));
+    }
+
+    image->width          = width;
+    image->height         = height;
+    image->pixel_format   = scan_line_converter->pixel_format;
+    image->bytes_per_line = bytes_per_line;
+
+    /* Oriented frames are not flipped anymore. */
+    if (orient) {
+        image->properties &= ~sail_orientation_flip_properties(state_of_mind->orientation.orientation);
+    }
+
+    /* Converted frames are never indexed. */
+    if (!keep_palette) {
+        sail_destroy_palette(image->palette);
+        image->palette = NULL;
+    }
+
+    return SAIL_OK;
+}
+
+/* Keeps a copy of the whole original image data in the source image. */
+static sail_status_t fetch_source_data(struct hidden_state *state_of_mind, struct sail_image *image) {
+
+    /* Not an error. */
+    if (image->source_image == NULL) {
+        return SAIL_OK;
+    }
+
+    struct sail_io *io = state_of_mind->io;
+
+    size_t saved_position;
+    SAIL_TRY(io->tell(io->stream, &saved_position));
+    SAIL_TRY(io->seek(io->stream, 0, SEEK_SET));
+
+    void *data;
+    size_t data_size;
+    SAIL_TRY_OR_CLEANUP(sail_io_contents_to_data(io, &data, &data_size),
+                        /* cleanup */ io->seek(io->stream, (long)saved_position, SEEK_SET));
+
+    SAIL_TRY_OR_CLEANUP(io->seek(io->stream, (long)saved_position, SEEK_SET),
+                        /* cleanup */ sail_free(data));
+
+    sail_free(image->source_image->data);
+    image->source_image->data      = data;
+    image->source_image->data_size = data_size;
+
+    return SAIL_OK;
+}
+
+/* Restarts decoding from the first frame. */
+static sail_status_t restart_reading(struct hidden_state *state_of_mind) {
+
+    SAIL_TRY(sail_check_io_valid(state_of_mind->io));
+    SAIL_CHECK_PTR(state_of_mind->codec);
+
+    SAIL_TRY(state_of_mind->codec->v6->read_finish(&state_of_mind->state, state_of_mind->io));
+
+    SAIL_TRY(state_of_mind->io->seek(state_of_mind->io->stream, (long)state_of_mind->io_offset, SEEK_SET));
+    SAIL_TRY(state_of_mind->codec->v6->read_init(state_of_mind->io, state_of_mind->read_options, &state_of_mind->state));
+
+    state_of_mind->frame_number = 0;
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
 sail_status_t sail_probe_io(struct sail_io *io, struct sail_image **image, const struct sail_codec_info **codec_info) {
 
     SAIL_CHECK_PTR(io);
@@ -101,32 +349,99 @@ sail_status_t sail_read_next_frame(void *state, struct sail_image **image) {
 
     struct hidden_state *state_of_mind = (struct hidden_state *)state;
 
-    SAIL_TRY(sail_check_io_valid(state_of_mind->io));
-    SAIL_CHECK_PTR(state_of_mind->state);
-    SAIL_CHECK_PTR(state_of_mind->codec);
-
     struct sail_image *image_local;
-    SAIL_TRY(state_of_mind->codec->v6->read_seek_next_frame(state_of_mind->state, state_of_mind->io, &image_local));
+    SAIL_TRY(seek_next_frame(state_of_mind, &image_local));
 
-    if (image_local->pixels != NULL) {
-        SAIL_LOG_ERROR("Internal error in %s codec: codecs must not allocate pixels", state_of_mind->codec_info->name);
-        sail_destroy_image(image_local);
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_CONFLICTING_OPERATION);
+    size_t pixels_size;
+    SAIL_TRY_OR_CLEANUP(read_frame_pixels(state_of_mind, image_local, &pixels_size),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    if (state_of_mind->frame_number == 0 && state_of_mind->read_options->io_options & SAIL_IO_OPTION_SOURCE_DATA) {
+        SAIL_TRY_OR_CLEANUP(fetch_source_data(state_of_mind, image_local),
+                            /* cleanup */ sail_destroy_image(image_local));
     }
 
-    /* Allocate pixels. */
-    const size_t pixels_size = (size_t)image_local->height * image_local->bytes_per_line;
-    SAIL_TRY_OR_CLEANUP(sail_malloc(pixels_size, &image_local->pixels),
-                        /* cleanup */ sail_destroy_image(image_local));
+    if (state_of_mind->read_options->io_options & SAIL_IO_OPTION_COMPACT) {
+        SAIL_TRY_OR_CLEANUP(sail_compact_image(image_local),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
 
-    SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v6->read_frame(state_of_mind->state, state_of_mind->io, image_local),
-                        /* cleanup */ sail_destroy_image(image_local));
+    state_of_mind->frame_number++;
 
     *image = image_local;
 
     return SAIL_OK;
 }
 
+sail_status_t sail_skip_next_frame(void *state) {
+
+    SAIL_CHECK_PTR(state);
+
+    struct hidden_state *state_of_mind = (struct hidden_state *)state;
+
+    struct sail_image *image_local;
+    SAIL_TRY(seek_next_frame(state_of_mind, &image_local));
+
+    if (state_of_mind->codec_info->read_features->features & SAIL_CODEC_FEATURE_SKIP_FRAMES) {
+        SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v6->read_frame(state_of_mind->state, state_of_mind->io, image_local),
+                            /* cleanup */ sail_destroy_image(image_local));
+    } else {
+        /* The codec needs to decode the frame anyway. Decode it into a pooled buffer. */
+        size_t pixels_size;
+        SAIL_TRY_OR_CLEANUP(read_frame_pixels(state_of_mind, image_local, &pixels_size),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        release_frame_pixels(state_of_mind, image_local->pixels, pixels_size);
+        image_local->pixels = NULL;
+    }
+
+    sail_destroy_image(image_local);
+
+    state_of_mind->frame_number++;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_seek_to_frame(void *state, unsigned frame) {
+
+    SAIL_CHECK_PTR(state);
+
+    struct hidden_state *state_of_mind = (struct hidden_state *)state;
+
+    /* Codecs can only move forward. */
+    if (frame < state_of_mind->frame_number) {
+        SAIL_TRY(restart_reading(state_of_mind));
+    }
+
+    while (state_of_mind->frame_number < frame) {
+        SAIL_TRY(sail_skip_next_frame(state));
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_release_frame(void *state, struct sail_image *image) {
+
+    SAIL_CHECK_PTR(state);
+
+    /* Not an error. */
+    if (image == NULL) {
+        return SAIL_OK;
+    }
+
+    struct hidden_state *state_of_mind = (struct hidden_state *)state;
+
+    /* Pixels referenced by views are released with the last reference. */
+    if (image->parent == NULL && image->release_pixels == NULL && image->references == 1) {
+        release_frame_pixels(state_of_mind, image->pixels, (size_t)image->height * image->bytes_per_line);
+        image->pixels = NULL;
+    }
+
+    sail_destroy_image(image);
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_stop_reading(void *state) {
 
     /* Not an error. */
@@ -150,6 +465,69 @@ sail_status_t sail_stop_reading(void *state) {
     return SAIL_OK;
 }
 
+sail_status_t sail_map_raw_file(const char *path, const struct sail_image **image, void **state) {
+
+    SAIL_CHECK_PTR(path);
+    SAIL_CHECK_PTR(image);
+    SAIL_CHECK_PTR(state);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct raw_mapping), &ptr));
+    struct raw_mapping *raw_mapping = ptr;
+
+    raw_mapping->io    = NULL;
+    raw_mapping->image = NULL;
+
+    SAIL_TRY_OR_CLEANUP(sail_alloc_io_read_mapped_file(path, &raw_mapping->io),
+                        /* cleanup */ sail_unmap_raw_file(raw_mapping));
+
+    size_t pixels_offset;
+    SAIL_TRY_OR_CLEANUP(sail_read_raw_image_skeleton(raw_mapping->io, NULL, &raw_mapping->image, &pixels_offset),
+                        /* cleanup */ sail_unmap_raw_file(raw_mapping));
+
+    const void *data;
+    size_t data_size;
+    SAIL_TRY_OR_CLEANUP(sail_mapped_file_data(raw_mapping->io, &data, &data_size),
+                        /* cleanup */ sail_unmap_raw_file(raw_mapping));
+
+    const size_t pixels_size = raw_mapping->image->bytes_per_line * raw_mapping->image->height;
+
+    if (pixels_offset > data_size || pixels_size > data_size - pixels_offset) {
+        SAIL_LOG_ERROR("RAW: File is truncated");
+        sail_unmap_raw_file(raw_mapping);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    /* The mapping is read-only. The image is exposed as const to prevent modifications. */
+    raw_mapping->image->pixels                   = (void *)((const unsigned char *)data + pixels_offset);
+    raw_mapping->image->release_pixels           = release_raw_mapping;
+    raw_mapping->image->release_pixels_user_data = raw_mapping;
+
+    *image = raw_mapping->image;
+    *state = raw_mapping;
+
+    return SAIL_OK;
+}
+
+void sail_unmap_raw_file(void *state) {
+
+    if (state == NULL) {
+        return;
+    }
+
+    struct raw_mapping *raw_mapping = state;
+
+    /* The mapping is released with the last reference to the image. */
+    if (raw_mapping->image != NULL && raw_mapping->image->release_pixels != NULL) {
+        sail_destroy_image(raw_mapping->image);
+        return;
+    }
+
+    sail_destroy_image(raw_mapping->image);
+    sail_destroy_io(raw_mapping->io);
+    sail_free(raw_mapping);
+}
+
 sail_status_t sail_start_writing_file(const char *path, const struct sail_codec_info *codec_info, void **state) {
 
     SAIL_TRY(sail_start_writing_file_with_options(path, codec_info, NULL, state));
@@ -180,7 +558,7 @@ sail_status_t sail_write_next_frame(void *state, const struct sail_image *image)
     SAIL_TRY(allowed_write_output_pixel_format(state_of_mind->codec_info->write_features,
                                                 image->pixel_format));
 
-    unsigned bytes_per_line;
+    size_t bytes_per_line;
     SAIL_TRY(sail_bytes_per_line(image->width, image->pixel_format, &bytes_per_line));
 
     SAIL_TRY(state_of_mind->codec->v6->write_seek_next_frame(state_of_mind->state, state_of_mind->io, image));
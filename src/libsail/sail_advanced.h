@@ -109,11 +109,66 @@ SAIL_EXPORT sail_status_t sail_start_reading_memory(const void *buffer, size_t b
  * Continues reading the file started by sail_start_reading_file() and brothers. The assigned image
  * MUST be destroyed later with sail_image_destroy().
  *
+ * If the read options have a scan line converter (see sail_alloc_scan_line_converter() in libsail-manip),
+ * the image is returned in the converter pixel format. Codecs with the SAIL_CODEC_FEATURE_SCAN_LINES read
+ * feature (JPEG, PNG) convert every scan line as soon as it's decoded, so the native frame is never allocated.
+ *
  * Returns SAIL_OK on success.
  * Returns SAIL_ERROR_NO_MORE_FRAMES when no more frames are available.
  */
 SAIL_EXPORT sail_status_t sail_read_next_frame(void *state, struct sail_image **image);
 
+/*
+ * Skips the next frame of the file started by sail_start_reading_file() and brothers.
+ *
+ * Codecs with the SAIL_CODEC_FEATURE_SKIP_FRAMES read feature (TIFF, ICO, WAL etc.) skip frames
+ * without decoding them. Other codecs decode the skipped frame into a reusable internal buffer.
+ * For example, frames of animated GIF and WebP images depend on previous frames, so they must be decoded
+ * to render subsequent frames correctly.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_NO_MORE_FRAMES when no more frames are available.
+ */
+SAIL_EXPORT sail_status_t sail_skip_next_frame(void *state);
+
+/*
+ * Seeks to the specified zero-based frame of the file started by sail_start_reading_file() and brothers.
+ * The next call to sail_read_next_frame() reads the specified frame.
+ *
+ * Seeking forward skips frames with sail_skip_next_frame(). Seeking backward restarts reading
+ * from the beginning of the I/O stream, so the stream must be seekable.
+ *
+ * Typical usage: sail_start_reading_file() ->
+ *                sail_seek_to_frame()      ->
+ *                sail_read_next_frame()    ->
+ *                sail_stop_reading().
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_NO_MORE_FRAMES when the frame doesn't exist. If the specified frame
+ * is the first non-existing frame, the next call to sail_read_next_frame() returns it instead.
+ */
+SAIL_EXPORT sail_status_t sail_seek_to_frame(void *state, unsigned frame);
+
+/*
+ * Destroys the specified image read with sail_read_next_frame() and returns its pixel buffer
+ * to the reading state. Subsequent sail_read_next_frame() calls reuse returned pixel buffers
+ * instead of allocating new ones. This is useful to play animations where all the frames
+ * have the same size. Does nothing if the image is NULL.
+ *
+ * The image MUST be read with the same state. The image MUST NOT be used anymore after calling
+ * this function. Pixel buffers kept by the state are destroyed in sail_stop_reading().
+ *
+ * Typical usage: sail_start_reading_file() ->
+ *                sail_read_next_frame()    ->
+ *                sail_release_frame()      ->
+ *                sail_read_next_frame()    ->
+ *                sail_release_frame()      ->
+ *                sail_stop_reading().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_release_frame(void *state, struct sail_image *image);
+
 /*
  * Stops reading the file started by sail_start_reading_file() and brothers.
  * Does nothing if the state is NULL.
@@ -125,6 +180,32 @@ SAIL_EXPORT sail_status_t sail_read_next_frame(void *state, struct sail_image **
  */
 SAIL_EXPORT sail_status_t sail_stop_reading(void *state);
 
+/*
+ * Maps the specified SAIL raw image file into memory and assigns an image whose pixels point
+ * directly into the mapping. No decoding and no pixel copying is involved, so it's the fastest way
+ * to load images cached with the SAILRAW codec. Meta data and the ICC profile are loaded as well.
+ *
+ * The image is owned by the mapping. It's read-only and valid until sail_unmap_raw_file() is called.
+ * DO NOT destroy it with sail_destroy_image(). Use sail_copy_image() to get an independent copy.
+ * Views of the image created with sail_image_view() keep the file mapped until they're destroyed.
+ *
+ * STATE explanation: Pass the address of a local void* pointer. SAIL will store the mapping
+ * in it and destroy it in sail_unmap_raw_file().
+ *
+ * Typical usage: sail_map_raw_file()   ->
+ *                use the image         ->
+ *                sail_unmap_raw_file().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_map_raw_file(const char *path, const struct sail_image **image, void **state);
+
+/*
+ * Releases the image mapped with sail_map_raw_file(). The file is unmapped with the last reference
+ * to the image, i.e. immediately or when the last view of the image is destroyed. Does nothing if the state is NULL.
+ */
+SAIL_EXPORT void sail_unmap_raw_file(void *state);
+
 /*
  * Starts writing into the specified image file. Pass codec info if you'd like to start writing
  * with a specific codec. If not, just pass NULL.
@@ -171,6 +252,11 @@ SAIL_EXPORT sail_status_t sail_start_writing_memory(void *buffer, size_t buffer_
  * Consider converting the image into a supported image format beforehand with functions
  * from sail-manip.
  *
+ * If SAIL_IO_OPTION_SOURCE_DATA is requested in the write options and the image keeps its original
+ * compressed data (see sail_source_image), codecs with the SAIL_CODEC_FEATURE_SOURCE_DATA write feature
+ * (JPEG, PNG) write the data unchanged and replace only meta data and ICC profiles. The pixels are not
+ * encoded in this case.
+ *
  * Returns SAIL_OK on success.
  */
 SAIL_EXPORT sail_status_t sail_write_next_frame(void *state, const struct sail_image *image);
@@ -25,6 +25,7 @@
 
 #include "config.h"
 
+#include <stdbool.h>
 #include <stdlib.h>
 
 #include "sail-common.h"
@@ -47,6 +48,130 @@ static sail_status_t probe_file_with_io(const char *path, struct sail_image **im
     return SAIL_OK;
 }
 
+/* Frames shared between the threads started by sail_load_all_frames_parallel(). */
+struct parallel_reading {
+
+    const char *path;
+    const struct sail_codec_info *codec_info;
+    unsigned threads;
+
+    sail_mutex_t mutex;
+
+    /* Frames are stored by their indexes. Guarded by the mutex. */
+    struct sail_image **frames;
+    size_t frames_capacity;
+    size_t frames_count;
+
+    /* The first error reported by a thread. Guarded by the mutex. */
+    sail_status_t status;
+};
+
+struct parallel_reading_thread {
+
+    struct parallel_reading *parallel_reading;
+    unsigned index;
+    sail_thread_t thread;
+};
+
+static sail_status_t store_frame(struct parallel_reading *parallel_reading, size_t frame, struct sail_image *image) {
+
+    SAIL_TRY(threading_lock_mutex(&parallel_reading->mutex));
+
+    if (frame >= parallel_reading->frames_capacity) {
+        size_t frames_capacity = parallel_reading->frames_capacity * 2;
+
+        if (frames_capacity <= frame) {
+            frames_capacity = frame + 1;
+        }
+
+        void *ptr = parallel_reading->frames;
+        SAIL_TRY_OR_CLEANUP(sail_realloc(sizeof(struct sail_image *) * frames_capacity, &ptr),
+                            /* cleanup */ threading_unlock_mutex(&parallel_reading->mutex));
+        parallel_reading->frames = ptr;
+
+        for (size_t i = parallel_reading->frames_capacity; i < frames_capacity; i++) {
+            parallel_reading->frames[i] = NULL;
+        }
+
+        parallel_reading->frames_capacity = frames_capacity;
+    }
+
+    parallel_reading->frames[frame] = image;
+    parallel_reading->frames_count++;
+
+    SAIL_TRY(threading_unlock_mutex(&parallel_reading->mutex));
+
+    return SAIL_OK;
+}
+
+static bool parallel_reading_failed(struct parallel_reading *parallel_reading) {
+
+    bool failed = true;
+
+    if (threading_lock_mutex(&parallel_reading->mutex) == SAIL_OK) {
+        failed = parallel_reading->status != SAIL_OK;
+        threading_unlock_mutex(&parallel_reading->mutex);
+    }
+
+    return failed;
+}
+
+static void set_parallel_reading_status(struct parallel_reading *parallel_reading, sail_status_t status) {
+
+    if (threading_lock_mutex(&parallel_reading->mutex) == SAIL_OK) {
+        if (parallel_reading->status == SAIL_OK) {
+            parallel_reading->status = status;
+        }
+
+        threading_unlock_mutex(&parallel_reading->mutex);
+    }
+}
+
+/* Reads every N-th frame with its own reading state where N is the number of threads. */
+static sail_status_t read_frames_interleaved(struct parallel_reading *parallel_reading, unsigned index) {
+
+    void *state = NULL;
+
+    SAIL_TRY_OR_CLEANUP(sail_start_reading_file(parallel_reading->path, parallel_reading->codec_info, &state),
+                        /* cleanup */ sail_stop_reading(state));
+
+    for (size_t frame = index; !parallel_reading_failed(parallel_reading); frame += parallel_reading->threads) {
+        struct sail_image *image;
+        sail_status_t status = SAIL_OK;
+
+        SAIL_TRY_OR_EXECUTE(sail_seek_to_frame(state, (unsigned)frame),
+                            /* on error */ status = __sail_error_result);
+
+        if (status == SAIL_OK) {
+            SAIL_TRY_OR_EXECUTE(sail_read_next_frame(state, &image),
+                                /* on error */ status = __sail_error_result);
+        }
+
+        if (status == SAIL_ERROR_NO_MORE_FRAMES) {
+            break;
+        }
+
+        SAIL_TRY_OR_CLEANUP(status,
+                            /* cleanup */ sail_stop_reading(state));
+
+        SAIL_TRY_OR_CLEANUP(store_frame(parallel_reading, frame, image),
+                            /* cleanup */ sail_destroy_image(image),
+                                          sail_stop_reading(state));
+    }
+
+    SAIL_TRY(sail_stop_reading(state));
+
+    return SAIL_OK;
+}
+
+static void parallel_reading_thread_routine(void *arg) {
+
+    struct parallel_reading_thread *parallel_reading_thread = arg;
+
+    SAIL_TRY_OR_EXECUTE(read_frames_interleaved(parallel_reading_thread->parallel_reading, parallel_reading_thread->index),
+                        /* on error */ set_parallel_reading_status(parallel_reading_thread->parallel_reading, __sail_error_result));
+}
+
 /*
  * Public functions.
  */
@@ -138,6 +263,36 @@ sail_status_t sail_load_image_from_memory(const void *buffer, size_t buffer_leng
     return SAIL_OK;
 }
 
+sail_status_t sail_load_embedded_thumbnail_from_file(const char *path, struct sail_image **image) {
+
+    SAIL_CHECK_PTR(path);
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_file(path, &io));
+
+    SAIL_TRY_OR_CLEANUP(sail_load_embedded_thumbnail_from_io(io, image),
+                        /* cleanup */ sail_destroy_io(io));
+
+    sail_destroy_io(io);
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_load_embedded_thumbnail_from_memory(const void *buffer, size_t buffer_length, struct sail_image **image) {
+
+    SAIL_CHECK_PTR(buffer);
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_memory(buffer, buffer_length, &io));
+
+    SAIL_TRY_OR_CLEANUP(sail_load_embedded_thumbnail_from_io(io, image),
+                        /* cleanup */ sail_destroy_io(io));
+
+    sail_destroy_io(io);
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_save_image_into_file(const char *path, const struct sail_image *image) {
 
     SAIL_CHECK_PTR(path);
@@ -177,3 +332,77 @@ sail_status_t sail_save_image_into_memory(void *buffer, size_t buffer_length, co
 
     return SAIL_OK;
 }
+
+sail_status_t sail_load_all_frames_parallel(const char *path, unsigned threads, struct sail_image ***frames, size_t *frames_count) {
+
+    SAIL_CHECK_PTR(path);
+    SAIL_CHECK_PTR(frames);
+    SAIL_CHECK_PTR(frames_count);
+
+    if (threads == 0) {
+        SAIL_LOG_ERROR("The number of threads must be positive");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct parallel_reading parallel_reading;
+
+    parallel_reading.path            = path;
+    parallel_reading.frames          = NULL;
+    parallel_reading.frames_capacity = 0;
+    parallel_reading.frames_count    = 0;
+    parallel_reading.status          = SAIL_OK;
+
+    SAIL_TRY(sail_codec_info_from_path(path, &parallel_reading.codec_info));
+
+    /* Threads skip the frames read by other threads. This is cheap only when codecs don't decode skipped frames. */
+    parallel_reading.threads = (parallel_reading.codec_info->read_features->features & SAIL_CODEC_FEATURE_SKIP_FRAMES) ? threads : 1;
+
+    SAIL_TRY(threading_init_mutex(&parallel_reading.mutex));
+
+    void *ptr;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct parallel_reading_thread) * parallel_reading.threads, &ptr),
+                        /* cleanup */ threading_destroy_mutex(&parallel_reading.mutex));
+    struct parallel_reading_thread *parallel_reading_threads = ptr;
+
+    /* The calling thread reads the first share of frames itself. */
+    unsigned started_threads = 1;
+
+    for (; started_threads < parallel_reading.threads; started_threads++) {
+        parallel_reading_threads[started_threads].parallel_reading = &parallel_reading;
+        parallel_reading_threads[started_threads].index            = started_threads;
+
+        SAIL_TRY_OR_EXECUTE(sail_create_thread(&parallel_reading_threads[started_threads].thread,
+                                               parallel_reading_thread_routine,
+                                               &parallel_reading_threads[started_threads]),
+                            /* on error */ set_parallel_reading_status(&parallel_reading, __sail_error_result);
+                                           break);
+    }
+
+    parallel_reading_threads[0].parallel_reading = &parallel_reading;
+    parallel_reading_threads[0].index            = 0;
+    parallel_reading_thread_routine(&parallel_reading_threads[0]);
+
+    for (unsigned i = 1; i < started_threads; i++) {
+        SAIL_TRY_OR_EXECUTE(sail_join_thread(&parallel_reading_threads[i].thread),
+                            /* on error */ set_parallel_reading_status(&parallel_reading, __sail_error_result));
+    }
+
+    sail_free(parallel_reading_threads);
+    threading_destroy_mutex(&parallel_reading.mutex);
+
+    if (parallel_reading.status != SAIL_OK) {
+        for (size_t i = 0; i < parallel_reading.frames_capacity; i++) {
+            sail_destroy_image(parallel_reading.frames[i]);
+        }
+
+        sail_free(parallel_reading.frames);
+
+        /* Already logged by the failed thread. */
+        return parallel_reading.status;
+    }
+
+    *frames       = parallel_reading.frames;
+    *frames_count = parallel_reading.frames_count;
+
+    return SAIL_OK;
+}
@@ -75,6 +75,47 @@ SAIL_EXPORT sail_status_t sail_load_image_from_file(const char *path, struct sai
  */
 SAIL_EXPORT sail_status_t sail_load_image_from_memory(const void *buffer, size_t buffer_length, struct sail_image **image);
 
+/*
+ * Loads the thumbnail embedded into the specified image file without decoding the image.
+ * See sail_load_embedded_thumbnail_from_io() for the supported thumbnails. The assigned image
+ * MUST be destroyed later with sail_destroy_image().
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_THUMBNAIL_NOT_FOUND if the image has no embedded thumbnail.
+ */
+SAIL_EXPORT sail_status_t sail_load_embedded_thumbnail_from_file(const char *path, struct sail_image **image);
+
+/*
+ * Loads the thumbnail embedded into the image in the specified memory buffer without decoding the image.
+ * See sail_load_embedded_thumbnail_from_io() for the supported thumbnails. The assigned image
+ * MUST be destroyed later with sail_destroy_image().
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_THUMBNAIL_NOT_FOUND if the image has no embedded thumbnail.
+ */
+SAIL_EXPORT sail_status_t sail_load_embedded_thumbnail_from_memory(const void *buffer, size_t buffer_length, struct sail_image **image);
+
+/*
+ * Loads all the frames of the specified image file using the specified number of threads.
+ * Every thread reads its share of frames with its own reading state and file stream.
+ * The assigned array of frames MUST be destroyed later with sail_destroy_image() applied
+ * to every frame and then with sail_free() applied to the array.
+ *
+ * Frames are read in parallel only when the codec skips frames without decoding them
+ * (see SAIL_CODEC_FEATURE_SKIP_FRAMES). This is true for TIFF, ICO, and WAL. Other codecs
+ * read all the frames in the calling thread.
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_load_all_frames_parallel(const char *path, unsigned threads,
+                                                        struct sail_image ***frames, size_t *frames_count);
+
 /*
  * Saves the specified image into the file.
  *
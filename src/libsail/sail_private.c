@@ -23,6 +23,9 @@
     SOFTWARE.
 */
 
+#include <stddef.h>
+#include <string.h>
+
 #include "sail.h"
 
 /*
@@ -74,6 +77,119 @@ static sail_status_t load_codec_by_codec_info_unsafe(const struct sail_codec_inf
     return SAIL_OK;
 }
 
+static bool is_transposing_orientation(enum SailOrientation orientation) {
+
+    return orientation == SAIL_ORIENTATION_TRANSPOSE || orientation == SAIL_ORIENTATION_ROTATE_90 ||
+            orientation == SAIL_ORIENTATION_TRANSVERSE || orientation == SAIL_ORIENTATION_ROTATE_270;
+}
+
+/* Copies the scan line into the row of the frame right-to-left. */
+static void copy_reversed_scan_line(unsigned char *target, const unsigned char *scan_line, unsigned width, unsigned bytes_per_pixel) {
+
+    const unsigned char *source = scan_line + (size_t)(width - 1) * bytes_per_pixel;
+
+    for (unsigned column = 0; column < width; column++, target += bytes_per_pixel, source -= bytes_per_pixel) {
+        memcpy(target, source, bytes_per_pixel);
+    }
+}
+
+/*
+ * Places the decoded scan line into the oriented frame. Horizontal flips reverse the pixels,
+ * vertical flips reverse the row order, and transposing orientations write the scan line into a column.
+ */
+static sail_status_t convert_oriented_scan_line(void *user_data, const struct sail_image *source, const void *scan_line,
+                                                unsigned row, struct sail_image *target) {
+
+    SAIL_CHECK_PTR(user_data);
+    SAIL_CHECK_PTR(source);
+    SAIL_CHECK_PTR(scan_line);
+    SAIL_CHECK_PTR(target);
+
+    struct orientation_state *orientation_state = user_data;
+
+    const unsigned char *pixels = scan_line;
+
+    if (orientation_state->convert) {
+        struct sail_image converted_row = *target;
+        converted_row.pixels = orientation_state->converted_scan_line;
+        converted_row.width  = source->width;
+        converted_row.height = 1;
+        SAIL_TRY(sail_bytes_per_line(source->width, target->pixel_format, &converted_row.bytes_per_line));
+
+        SAIL_TRY(orientation_state->scan_line_converter.convert(orientation_state->scan_line_converter.user_data,
+                                                                source, scan_line, 0, &converted_row));
+
+        pixels = orientation_state->converted_scan_line;
+    }
+
+    unsigned char *frame = target->pixels;
+    const size_t bytes_per_line = orientation_state->bytes_per_line;
+    const unsigned bytes_per_pixel = orientation_state->bits_per_pixel / 8;
+    const unsigned width  = source->width;
+    const unsigned height = source->height;
+
+    switch (orientation_state->orientation) {
+        case SAIL_ORIENTATION_FLIP_HORIZONTALLY: {
+            copy_reversed_scan_line(frame + bytes_per_line * row, pixels, width, bytes_per_pixel);
+            break;
+        }
+        case SAIL_ORIENTATION_ROTATE_180: {
+            copy_reversed_scan_line(frame + bytes_per_line * (height - 1 - row), pixels, width, bytes_per_pixel);
+            break;
+        }
+        case SAIL_ORIENTATION_FLIP_VERTICALLY: {
+            memcpy(frame + bytes_per_line * (height - 1 - row), pixels, ((size_t)width * orientation_state->bits_per_pixel + 7) / 8);
+            break;
+        }
+        case SAIL_ORIENTATION_TRANSPOSE:
+        case SAIL_ORIENTATION_ROTATE_90:
+        case SAIL_ORIENTATION_TRANSVERSE:
+        case SAIL_ORIENTATION_ROTATE_270: {
+            const enum SailOrientation orientation = orientation_state->orientation;
+
+            /* Scan lines become columns. Left-to-right columns for transposing, right-to-left ones for rotating by 90 degrees. */
+            const unsigned column = (orientation == SAIL_ORIENTATION_TRANSPOSE || orientation == SAIL_ORIENTATION_ROTATE_270) ? row : height - 1 - row;
+            const bool top_to_bottom = orientation == SAIL_ORIENTATION_TRANSPOSE || orientation == SAIL_ORIENTATION_ROTATE_90;
+
+            unsigned char *target_pixel = frame + (size_t)column * bytes_per_pixel + (top_to_bottom ? 0 : bytes_per_line * (width - 1));
+            const ptrdiff_t step = top_to_bottom ? (ptrdiff_t)bytes_per_line : -(ptrdiff_t)bytes_per_line;
+
+            for (unsigned x = 0; x < width; x++, target_pixel += step) {
+                memcpy(target_pixel, pixels + (size_t)x * bytes_per_pixel, bytes_per_pixel);
+            }
+            break;
+        }
+        default: {
+            memcpy(frame + bytes_per_line * row, pixels, ((size_t)width * orientation_state->bits_per_pixel + 7) / 8);
+            break;
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static void report_preview(void *user_data, const struct sail_image *image, unsigned scan) {
+
+    const struct preview_state *preview_state = user_data;
+
+    if (!preview_state->override_geometry) {
+        preview_state->preview(preview_state->user_data, image, scan);
+        return;
+    }
+
+    struct sail_image preview = *image;
+    preview.width          = preview_state->width;
+    preview.height         = preview_state->height;
+    preview.pixel_format   = preview_state->pixel_format;
+    preview.bytes_per_line = preview_state->bytes_per_line;
+
+    if (!preview_state->keep_palette) {
+        preview.palette = NULL;
+    }
+
+    preview_state->preview(preview_state->user_data, &preview, scan);
+}
+
 /*
  * Public functions.
  */
@@ -93,6 +209,38 @@ sail_status_t load_codec_by_codec_info(const struct sail_codec_info *codec_info,
     return SAIL_OK;
 }
 
+sail_status_t alloc_hidden_state(struct sail_io *io, bool own_io, const struct sail_codec_info *codec_info, struct hidden_state **state) {
+
+    SAIL_CHECK_PTR(state);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct hidden_state), &ptr));
+    struct hidden_state *state_local = ptr;
+
+    state_local->io            = io;
+    state_local->own_io        = own_io;
+    state_local->read_options  = NULL;
+    state_local->io_offset     = 0;
+    state_local->frame_number  = 0;
+    state_local->write_options = NULL;
+    state_local->state         = NULL;
+    state_local->codec_info    = codec_info;
+    state_local->codec         = NULL;
+
+    for (unsigned i = 0; i < SAIL_FRAME_BUFFERS_POOL_SIZE; i++) {
+        state_local->frame_buffers[i].pixels      = NULL;
+        state_local->frame_buffers[i].pixels_size = 0;
+    }
+
+    memset(&state_local->scan_line_converter, 0, sizeof(state_local->scan_line_converter));
+    memset(&state_local->orientation, 0, sizeof(state_local->orientation));
+    memset(&state_local->preview, 0, sizeof(state_local->preview));
+
+    *state = state_local;
+
+    return SAIL_OK;
+}
+
 void destroy_hidden_state(struct hidden_state *state) {
 
     if (state == NULL) {
@@ -103,6 +251,14 @@ void destroy_hidden_state(struct hidden_state *state) {
         sail_destroy_io(state->io);
     }
 
+    for (unsigned i = 0; i < SAIL_FRAME_BUFFERS_POOL_SIZE; i++) {
+        sail_free(state->frame_buffers[i].pixels);
+    }
+
+    sail_free(state->scan_line_converter.scan_line);
+    sail_free(state->orientation.converted_scan_line);
+
+    sail_destroy_read_options(state->read_options);
     sail_destroy_write_options(state->write_options);
 
     /* This state must be freed and zeroed by codecs. We free it just in case to avoid memory leaks. */
@@ -111,6 +267,58 @@ void destroy_hidden_state(struct hidden_state *state) {
     sail_free(state);
 }
 
+sail_status_t alloc_frame_pixels(struct hidden_state *state, size_t pixels_size, void **pixels) {
+
+    SAIL_CHECK_PTR(state);
+    SAIL_CHECK_PTR(pixels);
+
+    /* Find the smallest pooled buffer that fits. */
+    struct frame_buffer *best_frame_buffer = NULL;
+
+    for (unsigned i = 0; i < SAIL_FRAME_BUFFERS_POOL_SIZE; i++) {
+        struct frame_buffer *frame_buffer = &state->frame_buffers[i];
+
+        if (frame_buffer->pixels != NULL && frame_buffer->pixels_size >= pixels_size) {
+            if (best_frame_buffer == NULL || frame_buffer->pixels_size < best_frame_buffer->pixels_size) {
+                best_frame_buffer = frame_buffer;
+            }
+        }
+    }
+
+    if (best_frame_buffer != NULL) {
+        *pixels = best_frame_buffer->pixels;
+
+        best_frame_buffer->pixels      = NULL;
+        best_frame_buffer->pixels_size = 0;
+
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(sail_malloc_pixels(pixels_size, pixels));
+
+    return SAIL_OK;
+}
+
+void release_frame_pixels(struct hidden_state *state, void *pixels, size_t pixels_size) {
+
+    if (pixels == NULL) {
+        return;
+    }
+
+    for (unsigned i = 0; i < SAIL_FRAME_BUFFERS_POOL_SIZE; i++) {
+        struct frame_buffer *frame_buffer = &state->frame_buffers[i];
+
+        if (frame_buffer->pixels == NULL) {
+            frame_buffer->pixels      = pixels;
+            frame_buffer->pixels_size = pixels_size;
+            return;
+        }
+    }
+
+    /* The pool is full. */
+    sail_free(pixels);
+}
+
 sail_status_t stop_writing(void *state, size_t *written) {
 
     if (written != NULL) {
@@ -158,3 +366,78 @@ sail_status_t allowed_write_output_pixel_format(const struct sail_write_features
     print_unsupported_write_pixel_format(pixel_format);
     SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
 }
+
+void install_orientation(struct hidden_state *state) {
+
+    struct orientation_state *orientation_state = &state->orientation;
+
+    /* The scan line converter from the read options converts scan lines before orienting them. */
+    orientation_state->convert = state->read_options->scan_line_converter != NULL;
+
+    if (orientation_state->convert) {
+        orientation_state->scan_line_converter = state->scan_line_converter;
+    }
+
+    orientation_state->orientation = SAIL_ORIENTATION_NORMAL;
+
+    memset(&state->scan_line_converter, 0, sizeof(state->scan_line_converter));
+    state->scan_line_converter.convert   = convert_oriented_scan_line;
+    state->scan_line_converter.user_data = orientation_state;
+
+    state->read_options->scan_line_converter = &state->scan_line_converter;
+}
+
+sail_status_t begin_oriented_frame(struct hidden_state *state, const struct sail_image *image) {
+
+    SAIL_CHECK_PTR(state);
+    SAIL_CHECK_PTR(image);
+
+    struct orientation_state *orientation_state = &state->orientation;
+
+    const enum SailPixelFormat pixel_format = orientation_state->convert ? orientation_state->scan_line_converter.pixel_format : image->pixel_format;
+
+    enum SailOrientation orientation = (image->source_image == NULL) ? SAIL_ORIENTATION_NORMAL : image->source_image->orientation;
+
+    unsigned bits_per_pixel;
+    SAIL_TRY(sail_bits_per_pixel(pixel_format, &bits_per_pixel));
+
+    if (orientation != SAIL_ORIENTATION_NORMAL && orientation != SAIL_ORIENTATION_FLIP_VERTICALLY && bits_per_pixel % 8 != 0) {
+        SAIL_LOG_WARNING("Orientation of %s pixels is not currently supported, the frame is not oriented", sail_pixel_format_to_string(pixel_format));
+        orientation = SAIL_ORIENTATION_NORMAL;
+    }
+
+    const bool transposing = is_transposing_orientation(orientation);
+
+    orientation_state->orientation    = orientation;
+    orientation_state->width          = transposing ? image->height : image->width;
+    orientation_state->height         = transposing ? image->width  : image->height;
+    orientation_state->bits_per_pixel = bits_per_pixel;
+    SAIL_TRY(sail_bytes_per_line(orientation_state->width, pixel_format, &orientation_state->bytes_per_line));
+
+    if (orientation_state->convert) {
+        size_t converted_scan_line_size;
+        SAIL_TRY(sail_bytes_per_line(image->width, pixel_format, &converted_scan_line_size));
+
+        if (orientation_state->converted_scan_line_size < converted_scan_line_size) {
+            sail_free(orientation_state->converted_scan_line);
+            orientation_state->converted_scan_line      = NULL;
+            orientation_state->converted_scan_line_size = 0;
+
+            SAIL_TRY(sail_malloc(converted_scan_line_size, &orientation_state->converted_scan_line));
+            orientation_state->converted_scan_line_size = converted_scan_line_size;
+        }
+    }
+
+    state->scan_line_converter.pixel_format = pixel_format;
+
+    return SAIL_OK;
+}
+
+void install_preview(struct hidden_state *state) {
+
+    state->preview.preview   = state->read_options->preview;
+    state->preview.user_data = state->read_options->preview_user_data;
+
+    state->read_options->preview           = report_preview;
+    state->read_options->preview_user_data = &state->preview;
+}
@@ -33,27 +33,112 @@
     #include "common.h"
     #include "error.h"
     #include "export.h"
+    #include "read_options.h"
 #else
     #include <sail-common/common.h>
     #include <sail-common/error.h>
     #include <sail-common/export.h>
+    #include <sail-common/read_options.h>
 #endif
 
 struct sail_codec_info;
 struct sail_codec;
+struct sail_image;
+struct sail_io;
 struct sail_write_features;
 
+/* Maximum number of pixel buffers returned with sail_release_frame() and kept for reuse. */
+#define SAIL_FRAME_BUFFERS_POOL_SIZE 4
+
+struct frame_buffer {
+
+    void *pixels;
+    size_t pixels_size;
+};
+
+/*
+ * Orientation applied to the decoded scan lines with SAIL_IO_OPTION_APPLY_ORIENTATION. The scan line
+ * converter of the read operation places every decoded scan line into the oriented frame and converts
+ * it with the scan line converter from the read options first if any.
+ */
+struct orientation_state {
+
+    /* Copy of the scan line converter from the read options. Used if 'convert' is true. */
+    struct sail_scan_line_converter scan_line_converter;
+    bool convert;
+
+    /* Row buffer to convert scan lines into. */
+    void *converted_scan_line;
+    size_t converted_scan_line_size;
+
+    /* Orientation applied to the current frame. */
+    enum SailOrientation orientation;
+
+    /* Geometry of the oriented frame. */
+    unsigned width;
+    unsigned height;
+    size_t bytes_per_line;
+    unsigned bits_per_pixel;
+};
+
+/*
+ * Preview callback from the read options. The saved read options point to a callback which reports
+ * previews with the geometry of the returned frame. It differs from the native frame decoded by codecs
+ * when a scan line converter or the orientation are applied.
+ */
+struct preview_state {
+
+    sail_preview_t preview;
+    void *user_data;
+
+    /* Geometry of the returned frame. Used if 'override_geometry' is true. */
+    bool override_geometry;
+    unsigned width;
+    unsigned height;
+    enum SailPixelFormat pixel_format;
+    size_t bytes_per_line;
+    bool keep_palette;
+};
+
 struct hidden_state {
 
     struct sail_io *io;
     bool own_io;
 
+    /*
+     * Read operations save read options and the initial stream offset to restart decoding
+     * when seeking to a previous frame.
+     */
+    struct sail_read_options *read_options;
+    size_t io_offset;
+
+    /* Number of frames read or skipped so far. */
+    unsigned frame_number;
+
     /*
      * Write operations save write options to check if the interlaced mode was requested on later stages.
      * It's also used to check if the supplied pixel format is supported.
      */
     struct sail_write_options *write_options;
 
+    /*
+     * Pixel buffers of the frames returned with sail_release_frame(). Frames of one animation
+     * usually have the same size, so read operations reuse them instead of allocating new buffers.
+     */
+    struct frame_buffer frame_buffers[SAIL_FRAME_BUFFERS_POOL_SIZE];
+
+    /*
+     * Copy of the scan line converter from the read options. The saved read options point to this copy,
+     * so codecs decode scan lines into its row buffer owned by the state.
+     */
+    struct sail_scan_line_converter scan_line_converter;
+
+    /* Orientation state of read operations with SAIL_IO_OPTION_APPLY_ORIENTATION. */
+    struct orientation_state orientation;
+
+    /* Preview state of read operations with a preview callback. */
+    struct preview_state preview;
+
     /* Local state passed to codec reading and writing functions. */
     void *state;
 
@@ -65,8 +150,20 @@ struct hidden_state {
 SAIL_HIDDEN sail_status_t load_codec_by_codec_info(const struct sail_codec_info *codec_info,
                                                     const struct sail_codec **codec);
 
+SAIL_HIDDEN sail_status_t alloc_hidden_state(struct sail_io *io, bool own_io, const struct sail_codec_info *codec_info, struct hidden_state **state);
+
 SAIL_HIDDEN void destroy_hidden_state(struct hidden_state *state);
 
+SAIL_HIDDEN sail_status_t alloc_frame_pixels(struct hidden_state *state, size_t pixels_size, void **pixels);
+
+SAIL_HIDDEN void release_frame_pixels(struct hidden_state *state, void *pixels, size_t pixels_size);
+
+SAIL_HIDDEN void install_orientation(struct hidden_state *state);
+
+SAIL_HIDDEN sail_status_t begin_oriented_frame(struct hidden_state *state, const struct sail_image *image);
+
+SAIL_HIDDEN void install_preview(struct hidden_state *state);
+
 SAIL_HIDDEN sail_status_t stop_writing(void *state, size_t *written);
 
 SAIL_HIDDEN sail_status_t allowed_write_output_pixel_format(const struct sail_write_features *write_features, enum SailPixelFormat pixel_format);
@@ -25,11 +25,248 @@
 
 #include "config.h"
 
+#include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "sail-common.h"
 #include "sail.h"
 
+/* JPEG markers used to find embedded thumbnails. */
+#define JPEG_MARKER_SOI  0xD8
+#define JPEG_MARKER_SOS  0xDA
+#define JPEG_MARKER_APP0 0xE0
+#define JPEG_MARKER_APP1 0xE1
+
+/* Maximum size of a JPEG segment with its marker and length. */
+#define JPEG_SEGMENT_SIZE_MAX (2 + 65535)
+
+/*
+ * Private functions.
+ */
+
+/*
+ * Reads the JPEG data from the current position up to the first frame or scan header. Thumbnails
+ * are stored in the leading segments, so the rest of the image is not read.
+ */
+static sail_status_t read_jpeg_header(struct sail_io *io, void **data, size_t *data_size) {
+
+    unsigned char *buffer = NULL;
+    size_t size = 0;
+    size_t position = 2;
+    bool eof = false;
+
+    for (;;) {
+        int marker;
+        size_t payload_offset;
+        size_t segment_size;
+
+        if (sail_jpeg_next_segment(buffer, size, position, &marker, &payload_offset, &segment_size)) {
+            if (marker == JPEG_MARKER_SOS || sail_jpeg_is_sof_marker(marker)) {
+                break;
+            }
+
+            position += segment_size;
+            continue;
+        }
+
+        /* The data is broken if a complete segment doesn't fit either. */
+        if (eof || (size > position && size - position > JPEG_SEGMENT_SIZE_MAX + 16)) {
+            break;
+        }
+
+        void *ptr = buffer;
+        SAIL_TRY_OR_CLEANUP(sail_realloc(size + JPEG_SEGMENT_SIZE_MAX, &ptr),
+                            /* cleanup */ sail_free(buffer));
+        buffer = ptr;
+
+        size_t read_size = 0;
+        const sail_status_t status = io->tolerant_read(io->stream, buffer + size, JPEG_SEGMENT_SIZE_MAX, &read_size);
+
+        if (status != SAIL_OK && status != SAIL_ERROR_EOF) {
+            sail_free(buffer);
+            SAIL_LOG_AND_RETURN(status);
+        }
+
+        size += read_size;
+        eof = read_size < JPEG_SEGMENT_SIZE_MAX;
+    }
+
+    *data      = buffer;
+    *data_size = size;
+
+    return SAIL_OK;
+}
+
+static sail_status_t alloc_thumbnail(unsigned width, unsigned height, enum SailPixelFormat pixel_format,
+                                     const unsigned char *pixels, struct sail_image **image) {
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_alloc_image(&image_local));
+
+    image_local->width        = width;
+    image_local->height       = height;
+    image_local->pixel_format = pixel_format;
+
+    unsigned bits_per_pixel;
+    SAIL_TRY_OR_CLEANUP(sail_bits_per_pixel(pixel_format, &bits_per_pixel),
+                        /* cleanup */ sail_destroy_image(image_local));
+    SAIL_TRY_OR_CLEANUP(sail_bytes_per_line(width, pixel_format, &image_local->bytes_per_line),
+                        /* cleanup */ sail_destroy_image(image_local));
+    SAIL_TRY_OR_CLEANUP(sail_malloc_pixels((size_t)image_local->bytes_per_line * height, &image_local->pixels),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    const size_t row_size = (size_t)width * bits_per_pixel / 8;
+
+    for (unsigned row = 0; row < height; row++) {
+        memcpy((unsigned char *)image_local->pixels + row * image_local->bytes_per_line, pixels + row * row_size, row_size);
+    }
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+/* Loads the thumbnail stored as a JPEG stream. Broken thumbnails are ignored. */
+static void load_jpeg_stream_thumbnail(const void *data, size_t data_size, const char *kind, struct sail_image **image) {
+
+    struct sail_image *image_local;
+
+    if (sail_load_image_from_memory(data, data_size, &image_local) != SAIL_OK) {
+        SAIL_LOG_WARNING("Ignoring broken %s thumbnail", kind);
+        return;
+    }
+
+    *image = image_local;
+}
+
+/*
+ * Loads the thumbnail of a JFIF APP0 segment or a JFIF extension (JFXX) APP0 segment. Leaves the image
+ * untouched if the segment has no thumbnail. Broken thumbnails are ignored.
+ */
+static sail_status_t load_jfif_thumbnail(const unsigned char *segment, size_t segment_size, struct sail_image **image) {
+
+    /* JFIF: identifier, version, units, densities, thumbnail dimensions, and RGB pixels. */
+    if (segment_size >= 14 && memcmp(segment, "JFIF", 5) == 0) {
+        const unsigned width  = segment[12];
+        const unsigned height = segment[13];
+
+        if (width > 0 && height > 0 && segment_size - 14 >= (size_t)width * height * 3) {
+            SAIL_TRY(alloc_thumbnail(width, height, SAIL_PIXEL_FORMAT_BPP24_RGB, segment + 14, image));
+        }
+
+        return SAIL_OK;
+    }
+
+    if (segment_size < 6 || memcmp(segment, "JFXX", 5) != 0) {
+        return SAIL_OK;
+    }
+
+    /* JFXX: identifier, extension code, and the thumbnail. */
+    const unsigned char extension_code = segment[5];
+
+    switch (extension_code) {
+        /* JPEG stream. */
+        case 0x10: {
+            load_jpeg_stream_thumbnail(segment + 6, segment_size - 6, "JFXX", image);
+            break;
+        }
+        /* Dimensions, 256 RGB palette entries, and one byte per pixel. */
+        case 0x11: {
+            if (segment_size < 8 + 768) {
+                break;
+            }
+
+            const unsigned width  = segment[6];
+            const unsigned height = segment[7];
+
+            if (width > 0 && height > 0 && segment_size - 8 - 768 >= (size_t)width * height) {
+                struct sail_image *image_local;
+                SAIL_TRY(alloc_thumbnail(width, height, SAIL_PIXEL_FORMAT_BPP8_INDEXED, segment + 8 + 768, &image_local));
+                SAIL_TRY_OR_CLEANUP(sail_alloc_palette_from_data(SAIL_PIXEL_FORMAT_BPP24_RGB, segment + 8, 256, &image_local->palette),
+                                    /* cleanup */ sail_destroy_image(image_local));
+                *image = image_local;
+            }
+            break;
+        }
+        /* Dimensions and RGB pixels. */
+        case 0x13: {
+            if (segment_size < 8) {
+                break;
+            }
+
+            const unsigned width  = segment[6];
+            const unsigned height = segment[7];
+
+            if (width > 0 && height > 0 && segment_size - 8 >= (size_t)width * height * 3) {
+                SAIL_TRY(alloc_thumbnail(width, height, SAIL_PIXEL_FORMAT_BPP24_RGB, segment + 8, image));
+            }
+            break;
+        }
+        default: {
+            SAIL_LOG_DEBUG("Ignoring unknown JFXX extension code 0x%02X", extension_code);
+            break;
+        }
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Walks the JPEG segments preceding the frame. EXIF thumbnails are preferred over JFIF ones.
+ * Broken EXIF thumbnails are ignored, so the JFIF thumbnail is loaded instead.
+ */
+static sail_status_t load_jpeg_thumbnail(const unsigned char *data, size_t data_size, struct sail_image **image) {
+
+    struct sail_image *jfif_thumbnail = NULL;
+    int marker;
+    size_t payload_offset;
+    size_t segment_size;
+
+    for (size_t position = 2; sail_jpeg_next_segment(data, data_size, position, &marker, &payload_offset, &segment_size); position += segment_size) {
+        /* Thumbnails are stored in the leading APPn segments. */
+        if (marker == JPEG_MARKER_SOS || sail_jpeg_is_sof_marker(marker)) {
+            break;
+        }
+
+        const unsigned char *payload = data + payload_offset;
+        const size_t payload_size = position + segment_size - payload_offset;
+
+        if (marker == JPEG_MARKER_APP1) {
+            const void *thumbnail;
+            size_t thumbnail_size;
+
+            if (sail_exif_thumbnail(payload, payload_size, &thumbnail, &thumbnail_size)) {
+                struct sail_image *exif_thumbnail = NULL;
+                load_jpeg_stream_thumbnail(thumbnail, thumbnail_size, "EXIF", &exif_thumbnail);
+
+                if (exif_thumbnail != NULL) {
+                    sail_destroy_image(jfif_thumbnail);
+                    SAIL_LOG_DEBUG("Loaded EXIF thumbnail %ux%u", exif_thumbnail->width, exif_thumbnail->height);
+                    *image = exif_thumbnail;
+                    return SAIL_OK;
+                }
+            }
+        } else if (marker == JPEG_MARKER_APP0 && jfif_thumbnail == NULL) {
+            SAIL_TRY(load_jfif_thumbnail(payload, payload_size, &jfif_thumbnail));
+        }
+    }
+
+    if (jfif_thumbnail == NULL) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_THUMBNAIL_NOT_FOUND);
+    }
+
+    SAIL_LOG_DEBUG("Loaded JFIF thumbnail %ux%u", jfif_thumbnail->width, jfif_thumbnail->height);
+    *image = jfif_thumbnail;
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
 sail_status_t sail_start_reading_io(struct sail_io *io, const struct sail_codec_info *codec_info, void **state) {
 
     SAIL_TRY(sail_start_reading_io_with_options(io, codec_info, NULL, state));
@@ -61,3 +298,91 @@ sail_status_t sail_start_writing_io_with_options(struct sail_io *io,
 
     return SAIL_OK;
 }
+
+sail_status_t sail_transform_io_lossless(struct sail_io *input, struct sail_io *output,
+                                         const struct sail_write_options *write_options) {
+
+    SAIL_TRY(sail_check_io_valid(input));
+    SAIL_TRY(sail_check_io_valid(output));
+    SAIL_CHECK_PTR(write_options);
+
+    struct sail_image *image;
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_probe_io(input, &image, &codec_info));
+
+    if (!(codec_info->write_features->features & SAIL_CODEC_FEATURE_LOSSLESS_TRANSFORM)) {
+        SAIL_LOG_ERROR("%s codec doesn't support lossless transformations", codec_info->name);
+        sail_destroy_image(image);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_CODEC_FEATURE);
+    }
+
+    /* The whole input is the source data to transform. */
+    if (image->source_image == NULL) {
+        SAIL_TRY_OR_CLEANUP(sail_alloc_source_image(&image->source_image),
+                            /* cleanup */ sail_destroy_image(image));
+    }
+
+    SAIL_TRY_OR_CLEANUP(input->seek(input->stream, 0, SEEK_SET),
+                        /* cleanup */ sail_destroy_image(image));
+    SAIL_TRY_OR_CLEANUP(sail_io_contents_to_data(input, &image->source_image->data, &image->source_image->data_size),
+                        /* cleanup */ sail_destroy_image(image));
+
+    struct sail_write_options *write_options_local;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_write_options_from_features(codec_info->write_features, &write_options_local),
+                        /* cleanup */ sail_destroy_image(image));
+
+    write_options_local->io_options        |= SAIL_IO_OPTION_SOURCE_DATA;
+    write_options_local->lossless_transform = write_options->lossless_transform;
+    write_options_local->crop_x             = write_options->crop_x;
+    write_options_local->crop_y             = write_options->crop_y;
+    write_options_local->crop_width         = write_options->crop_width;
+    write_options_local->crop_height        = write_options->crop_height;
+
+    void *state;
+    SAIL_TRY_OR_CLEANUP(start_writing_io_with_options(output, false, codec_info, write_options_local, &state),
+                        /* cleanup */ sail_destroy_write_options(write_options_local),
+                                      sail_destroy_image(image));
+
+    sail_destroy_write_options(write_options_local);
+
+    /* Bypass sail_write_next_frame() as there are no pixels to check. */
+    struct hidden_state *state_of_mind = (struct hidden_state *)state;
+
+    SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v6->write_seek_next_frame(state_of_mind->state, state_of_mind->io, image),
+                        /* cleanup */ stop_writing(state, NULL),
+                                      sail_destroy_image(image));
+    SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v6->write_frame(state_of_mind->state, state_of_mind->io, image),
+                        /* cleanup */ stop_writing(state, NULL),
+                                      sail_destroy_image(image));
+
+    sail_destroy_image(image);
+
+    SAIL_TRY(stop_writing(state, NULL));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_load_embedded_thumbnail_from_io(struct sail_io *io, struct sail_image **image) {
+
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_CHECK_PTR(image);
+
+    void *data;
+    size_t data_size;
+    SAIL_TRY(read_jpeg_header(io, &data, &data_size));
+
+    const unsigned char *bytes = data;
+
+    if (data_size < 2 || bytes[0] != 0xFF || bytes[1] != JPEG_MARKER_SOI) {
+        sail_free(data);
+        SAIL_LOG_ERROR("Embedded thumbnails are supported in JPEG images only");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_THUMBNAIL_NOT_FOUND);
+    }
+
+    SAIL_TRY_OR_CLEANUP(load_jpeg_thumbnail(bytes, data_size, image),
+                        /* cleanup */ sail_free(data));
+
+    sail_free(data);
+
+    return SAIL_OK;
+}
@@ -40,6 +40,7 @@ extern "C" {
 
 struct sail_io;
 struct sail_codec_info;
+struct sail_image;
 struct sail_read_options;
 struct sail_write_options;
 
@@ -125,6 +126,41 @@ SAIL_EXPORT sail_status_t sail_start_writing_io_with_options(struct sail_io *io,
                                                             const struct sail_codec_info *codec_info,
                                                             const struct sail_write_options *write_options, void **state);
 
+/*
+ * Applies the lossless transformation specified in the write options to the image in the input I/O stream
+ * and writes the result into the output I/O stream with the same codec. The image is not decoded,
+ * so the transformation is fast and doesn't degrade quality. For example, the JPEG codec transforms
+ * DCT coefficients like jpegtran does. Only lossless_transform and the crop rectangle are taken
+ * from the write options. See SailLosslessTransform.
+ *
+ * The input codec must support the LOSSLESS-TRANSFORM write feature.
+ *
+ * Typical usage: sail_alloc_io()                   ->
+ *                set I/O callbacks                 ->
+ *                sail_alloc_write_options()        ->
+ *                set lossless_transform            ->
+ *                sail_transform_io_lossless()      ->
+ *                sail_destroy_write_options()      ->
+ *                sail_destroy_io().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_transform_io_lossless(struct sail_io *input, struct sail_io *output,
+                                                     const struct sail_write_options *write_options);
+
+/*
+ * Loads the thumbnail embedded into the image in the specified I/O stream. The main image is not decoded.
+ * Only the segments preceding the main image are read, so it's much faster than loading the image.
+ * The assigned image MUST be destroyed later with sail_destroy_image().
+ *
+ * Supports JPEG images with EXIF thumbnails in IFD1 and JFIF thumbnails, both uncompressed and
+ * in the JFXX extension segment. EXIF thumbnails are preferred.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_THUMBNAIL_NOT_FOUND if the image has no embedded thumbnail or it's not a JPEG image.
+ */
+SAIL_EXPORT sail_status_t sail_load_embedded_thumbnail_from_io(struct sail_io *io, struct sail_image **image);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
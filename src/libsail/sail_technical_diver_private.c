@@ -72,37 +72,45 @@ sail_status_t start_reading_io_with_options(struct sail_io *io, bool own_io,
 
     *state = NULL;
 
-    void *ptr;
-    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct hidden_state), &ptr),
+    struct hidden_state *state_of_mind;
+    SAIL_TRY_OR_CLEANUP(alloc_hidden_state(io, own_io, codec_info, &state_of_mind),
                         /* cleanup */ if (own_io) sail_destroy_io(io));
-    struct hidden_state *state_of_mind = ptr;
-
-    state_of_mind->io            = io;
-    state_of_mind->own_io        = own_io;
-    state_of_mind->write_options = NULL;
-    state_of_mind->state         = NULL;
-    state_of_mind->codec_info   = codec_info;
-    state_of_mind->codec        = NULL;
 
     SAIL_TRY_OR_CLEANUP(load_codec_by_codec_info(state_of_mind->codec_info, &state_of_mind->codec),
                         /* cleanup */ destroy_hidden_state(state_of_mind));
 
     if (read_options == NULL) {
-        struct sail_read_options *read_options_local = NULL;
-
-        SAIL_TRY_OR_CLEANUP(sail_alloc_read_options_from_features(state_of_mind->codec_info->read_features, &read_options_local),
+        SAIL_TRY_OR_CLEANUP(sail_alloc_read_options_from_features(state_of_mind->codec_info->read_features, &state_of_mind->read_options),
                             /* cleanup */ destroy_hidden_state(state_of_mind));
-        SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v6->read_init(state_of_mind->io, read_options_local, &state_of_mind->state),
-                            /* cleanup */ sail_destroy_read_options(read_options_local),
-                                          state_of_mind->codec->v6->read_finish(&state_of_mind->state, state_of_mind->io),
-                                          destroy_hidden_state(state_of_mind));
-        sail_destroy_read_options(read_options_local);
     } else {
-        SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v6->read_init(state_of_mind->io, read_options, &state_of_mind->state),
-                            /* cleanup */ state_of_mind->codec->v6->read_finish(&state_of_mind->state, state_of_mind->io),
-                                          destroy_hidden_state(state_of_mind));
+        SAIL_TRY_OR_CLEANUP(sail_copy_read_options(read_options, &state_of_mind->read_options),
+                            /* cleanup */ destroy_hidden_state(state_of_mind));
+
+        /* Every reading operation needs its own scan line buffer. */
+        if (read_options->scan_line_converter != NULL) {
+            state_of_mind->scan_line_converter                = *read_options->scan_line_converter;
+            state_of_mind->scan_line_converter.scan_line      = NULL;
+            state_of_mind->scan_line_converter.scan_line_size = 0;
+
+            state_of_mind->read_options->scan_line_converter = &state_of_mind->scan_line_converter;
+        }
+
+        if (read_options->io_options & SAIL_IO_OPTION_APPLY_ORIENTATION) {
+            install_orientation(state_of_mind);
+        }
+
+        if (read_options->preview != NULL) {
+            install_preview(state_of_mind);
+        }
     }
 
+    SAIL_TRY_OR_CLEANUP(state_of_mind->io->tell(state_of_mind->io->stream, &state_of_mind->io_offset),
+                        /* cleanup */ destroy_hidden_state(state_of_mind));
+
+    SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v6->read_init(state_of_mind->io, state_of_mind->read_options, &state_of_mind->state),
+                        /* cleanup */ state_of_mind->codec->v6->read_finish(&state_of_mind->state, state_of_mind->io),
+                                      destroy_hidden_state(state_of_mind));
+
     *state = state_of_mind;
 
     return SAIL_OK;
@@ -126,17 +134,9 @@ sail_status_t start_writing_io_with_options(struct sail_io *io, bool own_io,
                             /* cleanup */ if (own_io) sail_destroy_io(io));
     }
 
-    void *ptr;
-    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct hidden_state), &ptr),
+    struct hidden_state *state_of_mind;
+    SAIL_TRY_OR_CLEANUP(alloc_hidden_state(io, own_io, codec_info, &state_of_mind),
                         /* cleanup */ if (own_io) sail_destroy_io(io));
-    struct hidden_state *state_of_mind = ptr;
-
-    state_of_mind->io            = io;
-    state_of_mind->own_io        = own_io;
-    state_of_mind->write_options = NULL;
-    state_of_mind->state         = NULL;
-    state_of_mind->codec_info    = codec_info;
-    state_of_mind->codec         = NULL;
 
     SAIL_TRY_OR_CLEANUP(load_codec_by_codec_info(state_of_mind->codec_info, &state_of_mind->codec),
                         /* cleanup */ destroy_hidden_state(state_of_mind));
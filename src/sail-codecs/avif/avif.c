@@ -171,6 +171,13 @@ SAIL_EXPORT sail_status_t sail_codec_read_seek_next_frame_v6_avif(void *state, s
     avifRGBImageSetDefaults(&avif_state->rgb_image, avif_image);
     avif_state->rgb_image.depth = avif_private_round_depth(avif_state->rgb_image.depth);
 
+#if AVIF_VERSION >= 90100
+    /* Trade chroma upsampling quality for speed. */
+    if (avif_state->read_options->decode_quality == SAIL_DECODE_QUALITY_FASTEST) {
+        avif_state->rgb_image.chromaUpsampling = AVIF_CHROMA_UPSAMPLING_FASTEST;
+    }
+#endif
+
     image_local->source_image->pixel_format =
         avif_private_sail_pixel_format(avif_image->yuvFormat, avif_image->depth, avif_image->alphaPlane != NULL);
     image_local->source_image->chroma_subsampling = avif_private_sail_chroma_subsampling(avif_image->yuvFormat);
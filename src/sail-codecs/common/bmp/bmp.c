@@ -389,6 +389,8 @@ sail_status_t bmp_private_read_frame(void *state, struct sail_io *io, struct sai
     bool skip_pad_bytes = true;
 
     for (unsigned i = image->height; i > 0; i--) {
+        SAIL_TRY(sail_check_read_cancelled(bmp_state->read_options));
+
         unsigned char *scan = (unsigned char *)image->pixels + image->bytes_per_line * (bmp_state->flipped ? (i - 1) : (image->height - i));
 
         for (unsigned pixel_index = 0; pixel_index < image->width;) {
@@ -525,6 +527,8 @@ sail_status_t bmp_private_read_frame(void *state, struct sail_io *io, struct sai
         if (skip_pad_bytes) {
             SAIL_TRY(io->seek(io->stream, bmp_state->pad_bytes, SEEK_CUR));
         }
+
+        sail_report_read_progress(bmp_state->read_options, image->height - i + 1, image->height);
     }
 
     return SAIL_OK;
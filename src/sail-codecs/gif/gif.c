@@ -156,6 +156,12 @@ SAIL_EXPORT sail_status_t sail_codec_read_init_v6_gif(struct sail_io *io, const
         memset(&gif_state->background, 0, sizeof(gif_state->background));
     }
 
+    /* The first frame buffer has the size of the logical screen. Check it before allocating. */
+    SAIL_TRY(sail_check_read_limits(gif_state->read_options,
+                                    (unsigned)gif_state->gif->SWidth,
+                                    (unsigned)gif_state->gif->SHeight,
+                                    (size_t)gif_state->gif->SWidth * gif_state->gif->SHeight * 4)); /* 4 = RGBA */
+
     void *ptr;
 
     SAIL_TRY(sail_malloc(gif_state->gif->SWidth * sizeof(GifPixelType), &ptr));
@@ -348,6 +354,7 @@ SAIL_EXPORT sail_status_t sail_codec_read_frame_v6_gif(void *state, struct sail_
 
     const int passes = (image->source_image->properties & SAIL_IMAGE_PROPERTY_INTERLACED) ? 4 : 1;
     const int last_pass = passes - 1;
+    const unsigned rows_total = image->height * (unsigned)passes;
     unsigned next_interlaced_row = 0;
 
     for (int current_pass = 0; current_pass < passes; current_pass++) {
@@ -376,6 +383,8 @@ SAIL_EXPORT sail_status_t sail_codec_read_frame_v6_gif(void *state, struct sail_
 
         /* Read lines. */
         for (unsigned cc = 0; cc < image->height; cc++) {
+            SAIL_TRY(sail_check_read_cancelled(gif_state->read_options));
+
             unsigned char *scan = (unsigned char *)image->pixels + image->width*4*cc;
 
             if (cc < gif_state->row || cc >= gif_state->row + gif_state->height) {
@@ -383,6 +392,7 @@ SAIL_EXPORT sail_status_t sail_codec_read_frame_v6_gif(void *state, struct sail_
                     memcpy(scan, gif_state->first_frame[cc], image->width * 4);
                 }
 
+                sail_report_read_progress(gif_state->read_options, (unsigned)current_pass * image->height + cc + 1, rows_total);
                 continue;
             }
 
@@ -428,6 +438,8 @@ SAIL_EXPORT sail_status_t sail_codec_read_frame_v6_gif(void *state, struct sail_
             if (current_pass == last_pass) {
                 memcpy(gif_state->first_frame[cc], scan, image->width * 4);
             }
+
+            sail_report_read_progress(gif_state->read_options, (unsigned)current_pass * image->height + cc + 1, rows_total);
         }
     }
 
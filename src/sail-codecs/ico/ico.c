@@ -99,6 +99,9 @@ SAIL_EXPORT sail_status_t sail_codec_read_init_v6_ico(struct sail_io *io, const
     SAIL_TRY(alloc_ico_state(&ico_state));
     *state = ico_state;
 
+    /* Deep copy read options. */
+    SAIL_TRY(sail_copy_read_options(read_options, &ico_state->read_options));
+
     SAIL_TRY(ico_private_read_header(io, &ico_state->ico_header));
 
     if (ico_state->ico_header.images_count == 0) {
@@ -170,7 +173,11 @@ SAIL_EXPORT sail_status_t sail_codec_read_frame_v6_ico(void *state, struct sail_
 
     struct ico_state *ico_state = (struct ico_state *)state;
 
-    SAIL_TRY(bmp_private_read_frame(ico_state->common_bmp_state, io, image));
+    /* Skip the frame. The next frame is found with the directory table. */
+    if (image->pixels != NULL) {
+        SAIL_TRY(bmp_private_read_frame(ico_state->common_bmp_state, io, image));
+    }
+
     SAIL_TRY(bmp_private_read_finish(&ico_state->common_bmp_state, io));
 
     return SAIL_OK;
@@ -48,6 +48,34 @@ void jpeg_private_my_error_exit(j_common_ptr cinfo) {
     longjmp(myerr->setjmp_buffer, 1);
 }
 
+void jpeg_private_progress_monitor(j_common_ptr cinfo) {
+    const struct jpeg_private_progress_context *progress_context = (const struct jpeg_private_progress_context *)cinfo->progress;
+    const struct jpeg_progress_mgr *jpeg_progress_mgr = cinfo->progress;
+
+    const unsigned rows_total = cinfo->is_decompressor
+                                    ? ((j_decompress_ptr)cinfo)->output_height
+                                    : ((j_compress_ptr)cinfo)->image_height;
+
+    if (rows_total == 0 || jpeg_progress_mgr->pass_limit <= 0 || jpeg_progress_mgr->total_passes <= 0) {
+        return;
+    }
+
+    /*
+     * libjpeg reports progress in passes. Progressive and multi-scan images take several passes
+     * over the image, so convert the overall completed fraction into scan lines.
+     */
+    const double done = (jpeg_progress_mgr->completed_passes + (double)jpeg_progress_mgr->pass_counter / jpeg_progress_mgr->pass_limit)
+                            / jpeg_progress_mgr->total_passes;
+
+    unsigned rows_done = (unsigned)(done * rows_total);
+
+    if (rows_done > rows_total) {
+        rows_done = rows_total;
+    }
+
+    progress_context->progress(progress_context->progress_user_data, rows_done, rows_total);
+}
+
 enum SailPixelFormat jpeg_private_color_space_to_pixel_format(J_COLOR_SPACE color_space) {
     switch (color_space) {
         case JCS_GRAYSCALE: return SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE;
@@ -96,6 +124,35 @@ J_COLOR_SPACE jpeg_private_pixel_format_to_color_space(enum SailPixelFormat pixe
     }
 }
 
+enum SailChromaSubsampling jpeg_private_chroma_subsampling(const struct jpeg_decompress_struct *decompress_context) {
+
+    if (decompress_context->num_components < 3) {
+        return SAIL_CHROMA_SUBSAMPLING_400;
+    }
+
+    const jpeg_component_info *luma   = &decompress_context->comp_info[0];
+    const jpeg_component_info *chroma = &decompress_context->comp_info[1];
+
+    if (luma->h_samp_factor % chroma->h_samp_factor != 0 || luma->v_samp_factor % chroma->v_samp_factor != 0) {
+        return SAIL_CHROMA_SUBSAMPLING_UNKNOWN;
+    }
+
+    const int h_ratio = luma->h_samp_factor / chroma->h_samp_factor;
+    const int v_ratio = luma->v_samp_factor / chroma->v_samp_factor;
+
+    switch (h_ratio * 10 + v_ratio) {
+        case 11: return SAIL_CHROMA_SUBSAMPLING_444;
+        case 21: return SAIL_CHROMA_SUBSAMPLING_422;
+        case 22: return SAIL_CHROMA_SUBSAMPLING_420;
+        case 41: return SAIL_CHROMA_SUBSAMPLING_411;
+        case 42: return SAIL_CHROMA_SUBSAMPLING_410;
+
+        default: {
+            return SAIL_CHROMA_SUBSAMPLING_UNKNOWN;
+        }
+    }
+}
+
 sail_status_t jpeg_private_fetch_meta_data(struct jpeg_decompress_struct *decompress_context, struct sail_meta_data_node **last_meta_data_node) {
 
     SAIL_CHECK_PTR(last_meta_data_node);
@@ -119,6 +176,19 @@ sail_status_t jpeg_private_fetch_meta_data(struct jpeg_decompress_struct *decomp
     return SAIL_OK;
 }
 
+void jpeg_private_fetch_orientation(struct jpeg_decompress_struct *decompress_context, struct sail_image *image) {
+
+    for (jpeg_saved_marker_ptr it = decompress_context->marker_list; it != NULL; it = it->next) {
+        enum SailOrientation orientation;
+
+        if (it->marker == JPEG_APP0 + 1 && sail_exif_orientation(it->data, it->data_length, &orientation)) {
+            SAIL_LOG_TRACE("JPEG: EXIF orientation %d", orientation);
+            sail_set_source_orientation(image, orientation);
+            return;
+        }
+    }
+}
+
 sail_status_t jpeg_private_write_meta_data(struct jpeg_compress_struct *compress_context, const struct sail_meta_data_node *meta_data_node) {
 
     while (meta_data_node != NULL) {
@@ -213,3 +283,254 @@ sail_status_t jpeg_private_write_resolution(struct jpeg_compress_struct *compres
 
     return SAIL_OK;
 }
+
+static sail_status_t write_chroma_subsampling(struct jpeg_compress_struct *compress_context, enum SailChromaSubsampling chroma_subsampling) {
+
+    /* Not an error. */
+    if (chroma_subsampling == SAIL_CHROMA_SUBSAMPLING_UNKNOWN) {
+        return SAIL_OK;
+    }
+
+    int h_samp_factor;
+    int v_samp_factor;
+
+    switch (chroma_subsampling) {
+        case SAIL_CHROMA_SUBSAMPLING_444: h_samp_factor = 1; v_samp_factor = 1; break;
+        case SAIL_CHROMA_SUBSAMPLING_422: h_samp_factor = 2; v_samp_factor = 1; break;
+        case SAIL_CHROMA_SUBSAMPLING_420: h_samp_factor = 2; v_samp_factor = 2; break;
+
+        default: {
+            SAIL_LOG_ERROR("JPEG: Only 4:4:4, 4:2:2, and 4:2:0 chroma subsampling is supported for writing");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+        }
+    }
+
+    /* Store RGB images as YCbCr to subsample chroma. */
+    switch (compress_context->jpeg_color_space) {
+        case JCS_RGB: {
+            jpeg_set_colorspace(compress_context, JCS_YCbCr);
+            break;
+        }
+        case JCS_YCbCr:
+        case JCS_YCCK: {
+            break;
+        }
+        default: {
+            SAIL_LOG_DEBUG("JPEG: Chroma subsampling is ignored for the color space %d", compress_context->jpeg_color_space);
+            return SAIL_OK;
+        }
+    }
+
+    /* Luma and the YCCK black component keep the full resolution. Chroma components are subsampled. */
+    compress_context->comp_info[0].h_samp_factor = h_samp_factor;
+    compress_context->comp_info[0].v_samp_factor = v_samp_factor;
+
+    for (int i = 1; i < compress_context->num_components; i++) {
+        compress_context->comp_info[i].h_samp_factor = 1;
+        compress_context->comp_info[i].v_samp_factor = 1;
+    }
+
+    if (compress_context->num_components == 4) {
+        compress_context->comp_info[3].h_samp_factor = h_samp_factor;
+        compress_context->comp_info[3].v_samp_factor = v_samp_factor;
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t jpeg_private_write_compression_options(struct jpeg_compress_struct *compress_context, const struct sail_write_options *write_options) {
+
+    SAIL_TRY(write_chroma_subsampling(compress_context, write_options->chroma_subsampling));
+
+    switch (write_options->dct_method) {
+        case SAIL_DCT_METHOD_ISLOW: compress_context->dct_method = JDCT_ISLOW; break;
+        case SAIL_DCT_METHOD_IFAST: compress_context->dct_method = JDCT_IFAST; break;
+        case SAIL_DCT_METHOD_FLOAT: compress_context->dct_method = JDCT_FLOAT; break;
+
+        default: {
+            break;
+        }
+    }
+
+    if (write_options->arithmetic_coding) {
+#ifdef C_ARITH_CODING_SUPPORTED
+        compress_context->arith_code = true;
+#else
+        SAIL_LOG_ERROR("JPEG: Arithmetic coding is not supported by the JPEG library");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+#endif
+    } else {
+        compress_context->optimize_coding = write_options->optimize_coding;
+    }
+
+    if (write_options->progressive) {
+        jpeg_simple_progression(compress_context);
+    }
+
+    compress_context->restart_in_rows = (int)write_options->restart_interval;
+
+    return SAIL_OK;
+}
+
+/* Maximum size of a marker segment payload. */
+#define SEGMENT_DATA_SIZE_MAX 65533
+
+/* ICC profiles are split into APP2 segments with "ICC_PROFILE\0", a sequence number, and a number of segments. */
+static const char ICC_PROFILE_ID[] = "ICC_PROFILE";
+#define ICC_PROFILE_HEADER_SIZE (sizeof(ICC_PROFILE_ID) + 2)
+
+static unsigned read_be16(const unsigned char *data) {
+
+    return ((unsigned)data[0] << 8) | data[1];
+}
+
+/*
+ * Segments dropped from the source data. Meta data and ICC profiles are written from the image instead.
+ * JFIF and Adobe segments are kept as they affect decoding.
+ */
+static bool is_meta_data_marker(int marker) {
+
+    return marker == JPEG_COM || (marker >= JPEG_APP0 + 1 && marker <= JPEG_APP0 + 15 && marker != JPEG_APP0 + 14);
+}
+
+static sail_status_t write_segment_header(struct sail_io *io, int marker, size_t data_size) {
+
+    const unsigned char header[4] = {
+        0xFF,
+        (unsigned char)marker,
+        (unsigned char)((data_size + 2) >> 8),
+        (unsigned char)((data_size + 2) & 0xFF),
+    };
+
+    SAIL_TRY(io->strict_write(io->stream, header, sizeof(header)));
+
+    return SAIL_OK;
+}
+
+static sail_status_t write_meta_data_segments(struct sail_io *io, const struct sail_image *image, int io_options) {
+
+    if (io_options & SAIL_IO_OPTION_META_DATA) {
+        for (const struct sail_meta_data_node *meta_data_node = image->meta_data_node; meta_data_node != NULL; meta_data_node = meta_data_node->next) {
+            const struct sail_meta_data *meta_data = meta_data_node->meta_data;
+
+            if (meta_data->value_type != SAIL_META_DATA_TYPE_STRING) {
+                SAIL_LOG_WARNING("JPEG: Ignoring unsupported binary key '%s'", sail_meta_data_to_string(meta_data->key));
+                continue;
+            }
+
+            const size_t value_length = meta_data->value_length - 1;
+
+            if (value_length > SEGMENT_DATA_SIZE_MAX) {
+                SAIL_LOG_WARNING("JPEG: Ignoring too long comment of %lu bytes", (unsigned long)value_length);
+                continue;
+            }
+
+            SAIL_TRY(write_segment_header(io, JPEG_COM, value_length));
+            SAIL_TRY(io->strict_write(io->stream, meta_data->value, value_length));
+        }
+    }
+
+    if (io_options & SAIL_IO_OPTION_ICCP && image->iccp != NULL) {
+        const size_t chunk_size_max = SEGMENT_DATA_SIZE_MAX - ICC_PROFILE_HEADER_SIZE;
+        const size_t chunks = (image->iccp->data_length + chunk_size_max - 1) / chunk_size_max;
+
+        if (chunks > 255) {
+            SAIL_LOG_ERROR("JPEG: ICC profile of %lu bytes is too large", (unsigned long)image->iccp->data_length);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+        }
+
+        for (size_t chunk = 0; chunk < chunks; chunk++) {
+            const size_t offset = chunk * chunk_size_max;
+            const size_t chunk_size = (image->iccp->data_length - offset < chunk_size_max) ? image->iccp->data_length - offset : chunk_size_max;
+
+            unsigned char header[ICC_PROFILE_HEADER_SIZE];
+            memcpy(header, ICC_PROFILE_ID, sizeof(ICC_PROFILE_ID));
+            header[sizeof(ICC_PROFILE_ID)]     = (unsigned char)(chunk + 1);
+            header[sizeof(ICC_PROFILE_ID) + 1] = (unsigned char)chunks;
+
+            SAIL_TRY(write_segment_header(io, JPEG_APP0 + 2, sizeof(header) + chunk_size));
+            SAIL_TRY(io->strict_write(io->stream, header, sizeof(header)));
+            SAIL_TRY(io->strict_write(io->stream, (const unsigned char *)image->iccp->data + offset, chunk_size));
+        }
+    }
+
+    return SAIL_OK;
+}
+
+bool jpeg_private_can_write_source_data(const struct sail_image *image) {
+
+    if (image->source_image == NULL || image->source_image->data == NULL) {
+        return false;
+    }
+
+    const unsigned char *data = image->source_image->data;
+    const size_t data_size = image->source_image->data_size;
+
+    if (data_size < 4 || data[0] != 0xFF || data[1] != MARKER_SOI) {
+        return false;
+    }
+
+    bool dimensions_match = false;
+    int marker;
+    size_t payload_offset;
+    size_t segment_size;
+
+    for (size_t position = 2; sail_jpeg_next_segment(data, data_size, position, &marker, &payload_offset, &segment_size); position += segment_size) {
+        if (marker == MARKER_SOS) {
+            return dimensions_match;
+        }
+
+        /* SOF payload: precision, height, width. */
+        if (sail_jpeg_is_sof_marker(marker)) {
+            if (position + segment_size - payload_offset < 5) {
+                return false;
+            }
+
+            dimensions_match = read_be16(data + payload_offset + 1) == image->height
+                                && read_be16(data + payload_offset + 3) == image->width;
+        }
+    }
+
+    return false;
+}
+
+sail_status_t jpeg_private_write_source_data(struct sail_io *io, const struct sail_image *image, int io_options) {
+
+    const unsigned char *data = image->source_image->data;
+    const size_t data_size = image->source_image->data_size;
+
+    /* SOI. */
+    SAIL_TRY(io->strict_write(io->stream, data, 2));
+
+    bool meta_data_written = false;
+    int marker = 0;
+    size_t payload_offset;
+    size_t segment_size;
+    size_t position = 2;
+
+    for (; sail_jpeg_next_segment(data, data_size, position, &marker, &payload_offset, &segment_size); position += segment_size) {
+        /* Place new meta data after the leading APPn segments like the libjpeg encoder does. */
+        if (!meta_data_written && !(marker >= JPEG_APP0 && marker <= JPEG_APP0 + 15)) {
+            SAIL_TRY(write_meta_data_segments(io, image, io_options));
+            meta_data_written = true;
+        }
+
+        if (marker == MARKER_SOS) {
+            break;
+        }
+
+        if (!is_meta_data_marker(marker)) {
+            SAIL_TRY(io->strict_write(io->stream, data + position, segment_size));
+        }
+    }
+
+    if (marker != MARKER_SOS) {
+        SAIL_LOG_ERROR("JPEG: The source data has no scan data");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    /* The scan data and everything after it is written unchanged. */
+    SAIL_TRY(io->strict_write(io->stream, data + position, data_size - position));
+
+    return SAIL_OK;
+}
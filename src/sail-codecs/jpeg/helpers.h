@@ -35,24 +35,44 @@
 #include "common.h"
 #include "export.h"
 
+/* Markers not defined in jpeglib.h. */
+#define MARKER_SOI 0xD8
+#define MARKER_SOS 0xDA
+
+struct sail_image;
+struct sail_io;
 struct sail_meta_data_node;
 struct sail_resolution;
+struct sail_write_options;
 
 struct jpeg_private_my_error_context {
     struct jpeg_error_mgr jpeg_error_mgr;
     jmp_buf setjmp_buffer;
 };
 
+struct jpeg_private_progress_context {
+    struct jpeg_progress_mgr jpeg_progress_mgr;
+    sail_progress_t progress;
+    void *progress_user_data;
+};
+
 SAIL_HIDDEN void jpeg_private_my_output_message(j_common_ptr cinfo);
 
 SAIL_HIDDEN void jpeg_private_my_error_exit(j_common_ptr cinfo);
 
+SAIL_HIDDEN void jpeg_private_progress_monitor(j_common_ptr cinfo);
+
 SAIL_HIDDEN enum SailPixelFormat jpeg_private_color_space_to_pixel_format(J_COLOR_SPACE color_space);
 
 SAIL_HIDDEN J_COLOR_SPACE jpeg_private_pixel_format_to_color_space(enum SailPixelFormat pixel_format);
 
+SAIL_HIDDEN enum SailChromaSubsampling jpeg_private_chroma_subsampling(const struct jpeg_decompress_struct *decompress_context);
+
 SAIL_HIDDEN sail_status_t jpeg_private_fetch_meta_data(struct jpeg_decompress_struct *decompress_context, struct sail_meta_data_node **last_meta_data_node);
 
+/* Sets the source orientation of the image from the saved EXIF segment if any. */
+SAIL_HIDDEN void jpeg_private_fetch_orientation(struct jpeg_decompress_struct *decompress_context, struct sail_image *image);
+
 SAIL_HIDDEN sail_status_t jpeg_private_write_meta_data(struct jpeg_compress_struct *compress_context, const struct sail_meta_data_node *meta_data_node);
 
 #ifdef SAIL_HAVE_JPEG_ICCP
@@ -63,4 +83,19 @@ SAIL_HIDDEN sail_status_t jpeg_private_fetch_resolution(struct jpeg_decompress_s
 
 SAIL_HIDDEN sail_status_t jpeg_private_write_resolution(struct jpeg_compress_struct *compress_context, const struct sail_resolution *resolution);
 
+/*
+ * Applies chroma subsampling, entropy coding, progression, restart interval, and DCT method
+ * from the write options. Must be called after the color space and quality are set.
+ */
+SAIL_HIDDEN sail_status_t jpeg_private_write_compression_options(struct jpeg_compress_struct *compress_context, const struct sail_write_options *write_options);
+
+/* Checks if the image keeps JPEG source data of the same dimensions. */
+SAIL_HIDDEN bool jpeg_private_can_write_source_data(const struct sail_image *image);
+
+/*
+ * Writes the JPEG source data of the image unchanged except meta data segments. Comments and ICC profiles
+ * are taken from the image according to the I/O options.
+ */
+SAIL_HIDDEN sail_status_t jpeg_private_write_source_data(struct sail_io *io, const struct sail_image *image, int io_options);
+
 #endif
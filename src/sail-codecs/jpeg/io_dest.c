@@ -33,7 +33,7 @@
  * Most of this file was copied from libjpeg-turbo 2.0.4 and adapted to SAIL.
  */
 
-#define OUTPUT_BUF_SIZE  4096   /* choose an efficiently fwrite'able size */
+#define OUTPUT_BUF_SIZE  65536  /* choose an efficiently fwrite'able size */
 
 /*
  * Initialize destination --- called by jpeg_start_compress
@@ -29,7 +29,10 @@
 
 #include "io_src.h"
 
-#define INPUT_BUF_SIZE  4096    /* choose an efficiently fread'able size */
+#define INPUT_BUF_SIZE  65536   /* choose an efficiently fread'able size */
+
+/* Fake EOI marker inserted at the end of memory-backed streams. */
+static const JOCTET EOI_BUFFER[2] = { (JOCTET)0xFF, (JOCTET)JPEG_EOI };
 
 /*
  * Most of this file was copied from libjpeg-turbo 2.0.4 and adapted to SAIL.
@@ -107,6 +110,22 @@ static boolean fill_input_buffer(j_decompress_ptr cinfo)
     return TRUE;
 }
 
+/*
+ * Memory-backed streams are decoded in place, so there is nothing to refill.
+ * Insert a fake EOI marker like jpeg_mem_src() does.
+ */
+static boolean fill_memory_input_buffer(j_decompress_ptr cinfo)
+{
+    struct sail_jpeg_source_mgr *src = (struct sail_jpeg_source_mgr *)cinfo->src;
+
+    WARNMS(cinfo, JWRN_JPEG_EOF);
+
+    src->pub.next_input_byte = EOI_BUFFER;
+    src->pub.bytes_in_buffer = sizeof(EOI_BUFFER);
+
+    return TRUE;
+}
+
 /*
  * Skip data --- used to skip over a potentially large amount of
  * uninteresting data (such as an APPn marker).
@@ -140,6 +159,20 @@ static void skip_input_data(j_decompress_ptr cinfo, long num_bytes)
     }
 }
 
+static void skip_memory_input_data(j_decompress_ptr cinfo, long num_bytes)
+{
+    struct jpeg_source_mgr *src = cinfo->src;
+
+    if (num_bytes > 0) {
+        if (num_bytes > (long)src->bytes_in_buffer) {
+            (void)(*src->fill_input_buffer) (cinfo);
+        } else {
+            src->next_input_byte += (size_t)num_bytes;
+            src->bytes_in_buffer -= (size_t)num_bytes;
+        }
+    }
+}
+
 /*
  * An additional method that can be provided by data source modules is the
  * resync_to_restart method for error recovery in the presence of RST markers.
@@ -158,8 +191,16 @@ static void skip_input_data(j_decompress_ptr cinfo, long num_bytes)
  */
 static void term_source(j_decompress_ptr cinfo)
 {
-    /* no work necessary here */
-    (void)cinfo;
+    struct sail_jpeg_source_mgr *src = (struct sail_jpeg_source_mgr *)cinfo->src;
+
+    /* Move the memory-backed stream past the consumed data. */
+    if (src->io != NULL && src->data != NULL) {
+        const size_t position = (src->pub.next_input_byte == EOI_BUFFER)
+                                    ? src->data_size
+                                    : (size_t)(src->pub.next_input_byte - src->data);
+
+        (void)src->io->seek(src->io->stream, (long)position, SEEK_SET);
+    }
 }
 
 /*
@@ -204,4 +245,59 @@ void jpeg_private_sail_io_src(j_decompress_ptr cinfo, struct sail_io *io) {
     src->io                    = io;
     src->pub.bytes_in_buffer   = 0;    /* forces fill_input_buffer on first read */
     src->pub.next_input_byte   = NULL; /* until buffer loaded */
+    src->data                  = NULL;
+    src->data_size             = 0;
+
+    /* Decode memory-backed streams in place without copying them into the buffer. Empty streams fail as usual. */
+    const void *data;
+    size_t data_size;
+    size_t position;
+
+    if (io->contents != NULL &&
+            io->contents(io->stream, &data, &data_size) == SAIL_OK &&
+            io->tell(io->stream, &position) == SAIL_OK &&
+            position < data_size) {
+        src->pub.fill_input_buffer = fill_memory_input_buffer;
+        src->pub.skip_input_data   = skip_memory_input_data;
+        src->data                  = data;
+        src->data_size             = data_size;
+        src->pub.next_input_byte   = src->data + position;
+        src->pub.bytes_in_buffer   = data_size - position;
+    }
+}
+
+/*
+ * Prepare for input from a memory buffer. The buffer is decoded in place,
+ * so it must stay valid until decompression is finished.
+ */
+void jpeg_private_memory_src(j_decompress_ptr cinfo, const void *data, size_t data_size) {
+
+    struct sail_jpeg_source_mgr *src;
+
+    if (data_size == 0) {
+        ERREXIT(cinfo, JERR_INPUT_EMPTY);
+    }
+
+    if (cinfo->src == NULL) {     /* first time for this JPEG object? */
+        cinfo->src = (struct jpeg_source_mgr *)(*cinfo->mem->alloc_small)((j_common_ptr)cinfo,
+                                                                            JPOOL_PERMANENT,
+                                                                            sizeof(struct sail_jpeg_source_mgr));
+        src = (struct sail_jpeg_source_mgr *)cinfo->src;
+        src->buffer = NULL;
+    } else if (cinfo->src->init_source != init_source) {
+        ERREXIT(cinfo, JERR_BUFFER_SIZE);
+    }
+
+    src = (struct sail_jpeg_source_mgr *)cinfo->src;
+
+    src->pub.init_source       = init_source;
+    src->pub.fill_input_buffer = fill_memory_input_buffer;
+    src->pub.skip_input_data   = skip_memory_input_data;
+    src->pub.resync_to_restart = jpeg_resync_to_restart; /* use default method */
+    src->pub.term_source       = term_source;
+    src->io                    = NULL;
+    src->data                  = data;
+    src->data_size             = data_size;
+    src->pub.next_input_byte   = src->data;
+    src->pub.bytes_in_buffer   = data_size;
 }
@@ -40,11 +40,15 @@ struct sail_io;
 struct sail_jpeg_source_mgr {
     struct jpeg_source_mgr pub;   /* public fields */
 
-    struct sail_io *io;           /* source stream */
+    struct sail_io *io;           /* source stream or NULL for memory buffers */
     JOCTET *buffer;               /* start of buffer */
     boolean start_of_file;        /* have we gotten any data yet? */
+    const JOCTET *data;           /* contents of memory-backed streams or NULL */
+    size_t data_size;             /* size of the contents */
 };
 
 SAIL_HIDDEN void jpeg_private_sail_io_src(j_decompress_ptr cinfo, struct sail_io *io);
 
+SAIL_HIDDEN void jpeg_private_memory_src(j_decompress_ptr cinfo, const void *data, size_t data_size);
+
 #endif
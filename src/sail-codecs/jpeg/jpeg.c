@@ -36,6 +36,8 @@
 #include "helpers.h"
 #include "io_dest.h"
 #include "io_src.h"
+#include "parallel.h"
+#include "transform.h"
 
 /*
  * Codec-specific data types.
@@ -45,6 +47,9 @@ static const double COMPRESSION_MIN     = 0;
 static const double COMPRESSION_MAX     = 100;
 static const double COMPRESSION_DEFAULT = 15;
 
+/* Maximum number of scan lines passed to libjpeg at once. */
+#define SCAN_LINES_PER_CALL_MAX 16
+
 /*
  * Codec-specific state.
  */
@@ -53,12 +58,14 @@ struct jpeg_state {
     struct jpeg_decompress_struct *decompress_context;
     struct jpeg_compress_struct *compress_context;
     struct jpeg_private_my_error_context error_context;
+    struct jpeg_private_progress_context progress_context;
     bool libjpeg_error;
     struct sail_read_options *read_options;
     struct sail_write_options *write_options;
     bool frame_read;
     bool frame_written;
     bool started_compress;
+    bool source_data_written;
 };
 
 static sail_status_t alloc_jpeg_state(struct jpeg_state **jpeg_state) {
@@ -67,14 +74,15 @@ static sail_status_t alloc_jpeg_state(struct jpeg_state **jpeg_state) {
     SAIL_TRY(sail_malloc(sizeof(struct jpeg_state), &ptr));
     *jpeg_state = ptr;
 
-    (*jpeg_state)->decompress_context = NULL;
-    (*jpeg_state)->compress_context   = NULL;
-    (*jpeg_state)->libjpeg_error      = false;
-    (*jpeg_state)->read_options       = NULL;
-    (*jpeg_state)->write_options      = NULL;
-    (*jpeg_state)->frame_read         = false;
-    (*jpeg_state)->frame_written      = false;
-    (*jpeg_state)->started_compress   = false;
+    (*jpeg_state)->decompress_context  = NULL;
+    (*jpeg_state)->compress_context    = NULL;
+    (*jpeg_state)->libjpeg_error       = false;
+    (*jpeg_state)->read_options        = NULL;
+    (*jpeg_state)->write_options       = NULL;
+    (*jpeg_state)->frame_read          = false;
+    (*jpeg_state)->frame_written       = false;
+    (*jpeg_state)->started_compress    = false;
+    (*jpeg_state)->source_data_written = false;
 
     return SAIL_OK;
 }
@@ -94,6 +102,88 @@ static void destroy_jpeg_state(struct jpeg_state *jpeg_state) {
     sail_free(jpeg_state);
 }
 
+static sail_status_t read_scan_lines(struct jpeg_state *jpeg_state, struct sail_image *image) {
+
+    /*
+     * Read as many scan lines at once as libjpeg outputs per call. The scan line converter
+     * has a single row buffer, so scan lines are read one by one in this case.
+     */
+    unsigned scan_lines_per_call = 1;
+
+    if (jpeg_state->read_options->scan_line_converter == NULL) {
+        scan_lines_per_call = (jpeg_state->decompress_context->rec_outbuf_height > SCAN_LINES_PER_CALL_MAX)
+                                ? SCAN_LINES_PER_CALL_MAX
+                                : (unsigned)jpeg_state->decompress_context->rec_outbuf_height;
+    }
+
+    JSAMPROW samprows[SCAN_LINES_PER_CALL_MAX];
+
+    for (unsigned row = 0; row < image->height;) {
+        SAIL_TRY(sail_check_read_cancelled(jpeg_state->read_options));
+
+        const unsigned scan_lines_to_read = (image->height - row < scan_lines_per_call) ? image->height - row : scan_lines_per_call;
+
+        for (unsigned i = 0; i < scan_lines_to_read; i++) {
+            void *scanline;
+            SAIL_TRY(sail_scan_line_buffer(jpeg_state->read_options, image, row + i, &scanline));
+            samprows[i] = (JSAMPROW)scanline;
+        }
+
+        const unsigned scan_lines_read = jpeg_read_scanlines(jpeg_state->decompress_context, samprows, scan_lines_to_read);
+
+        if (scan_lines_read == 0) {
+            SAIL_LOG_ERROR("JPEG: Failed to read scan lines");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        for (unsigned i = 0; i < scan_lines_read; i++) {
+            SAIL_TRY(sail_scan_line_decoded(jpeg_state->read_options, image, row + i, samprows[i]));
+        }
+
+        row += scan_lines_read;
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Decodes the progressive frame in buffered-image mode. The whole frame is output after every scan
+ * and reported as a preview. The last output pass includes all the scans and is not reported.
+ */
+static sail_status_t read_progressive_frame(struct jpeg_state *jpeg_state, struct sail_image *image) {
+
+    struct jpeg_decompress_struct *decompress_context = jpeg_state->decompress_context;
+
+    for (;;) {
+        /* Absorb the current scan and the markers up to the next scan, so the input completes with the last scan. */
+        int status;
+
+        do {
+            status = jpeg_consume_input(decompress_context);
+        } while (status != JPEG_REACHED_SOS && status != JPEG_REACHED_EOI && status != JPEG_SUSPENDED);
+
+        if (status == JPEG_SUSPENDED) {
+            SAIL_LOG_ERROR("JPEG: Failed to read the next scan");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        const bool input_complete = jpeg_input_complete(decompress_context);
+        const int scan_number = input_complete ? decompress_context->input_scan_number : decompress_context->input_scan_number - 1;
+
+        jpeg_start_output(decompress_context, scan_number);
+        SAIL_TRY(read_scan_lines(jpeg_state, image));
+        jpeg_finish_output(decompress_context);
+
+        if (input_complete) {
+            break;
+        }
+
+        sail_report_read_preview(jpeg_state->read_options, image, (unsigned)scan_number);
+    }
+
+    return SAIL_OK;
+}
+
 /*
  * Decoding functions.
  */
@@ -134,6 +224,13 @@ SAIL_EXPORT sail_status_t sail_codec_read_init_v6_jpeg(struct sail_io *io, const
     jpeg_create_decompress(jpeg_state->decompress_context);
     jpeg_private_sail_io_src(jpeg_state->decompress_context, io);
 
+    if (jpeg_state->read_options->progress != NULL) {
+        jpeg_state->progress_context.jpeg_progress_mgr.progress_monitor = jpeg_private_progress_monitor;
+        jpeg_state->progress_context.progress           = jpeg_state->read_options->progress;
+        jpeg_state->progress_context.progress_user_data = jpeg_state->read_options->progress_user_data;
+        jpeg_state->decompress_context->progress = &jpeg_state->progress_context.jpeg_progress_mgr;
+    }
+
     if (jpeg_state->read_options->io_options & SAIL_IO_OPTION_META_DATA) {
         jpeg_save_markers(jpeg_state->decompress_context, JPEG_COM, 0xffff);
     }
@@ -141,8 +238,17 @@ SAIL_EXPORT sail_status_t sail_codec_read_init_v6_jpeg(struct sail_io *io, const
         jpeg_save_markers(jpeg_state->decompress_context, JPEG_APP0 + 2, 0xFFFF);
     }
 
+    /* EXIF is needed for the image orientation. */
+    jpeg_save_markers(jpeg_state->decompress_context, JPEG_APP0 + 1, 0xFFFF);
+
     jpeg_read_header(jpeg_state->decompress_context, true);
 
+    /* jpeg_start_decompress() allocates buffers proportional to the image size. Check the header dimensions before that. */
+    SAIL_TRY(sail_check_read_limits(jpeg_state->read_options,
+                                    jpeg_state->decompress_context->image_width,
+                                    jpeg_state->decompress_context->image_height,
+                                    0));
+
     /* Handle the requested color space. */
     if (jpeg_state->decompress_context->jpeg_color_space == JCS_YCbCr) {
         jpeg_state->decompress_context->out_color_space = JCS_RGB;
@@ -153,6 +259,28 @@ SAIL_EXPORT sail_status_t sail_codec_read_init_v6_jpeg(struct sail_io *io, const
     /* We don't want colormapped output. */
     jpeg_state->decompress_context->quantize_colors = false;
 
+    /* Trade quality for speed. */
+    switch (jpeg_state->read_options->decode_quality) {
+        case SAIL_DECODE_QUALITY_BALANCED: {
+            jpeg_state->decompress_context->dct_method = JDCT_IFAST;
+            break;
+        }
+        case SAIL_DECODE_QUALITY_FASTEST: {
+            jpeg_state->decompress_context->dct_method          = JDCT_IFAST;
+            jpeg_state->decompress_context->do_fancy_upsampling = false;
+            jpeg_state->decompress_context->do_block_smoothing  = false;
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    /* Decode progressive images scan by scan to report previews. */
+    if (jpeg_state->read_options->preview != NULL && jpeg_has_multiple_scans(jpeg_state->decompress_context)) {
+        jpeg_state->decompress_context->buffered_image = true;
+    }
+
     /* Launch decompression! */
     jpeg_start_decompress(jpeg_state->decompress_context);
 
@@ -185,11 +313,12 @@ SAIL_EXPORT sail_status_t sail_codec_read_seek_next_frame_v6_jpeg(void *state, s
     }
 
     /* Image properties. */
-    image_local->width                      = jpeg_state->decompress_context->output_width;
-    image_local->height                     = jpeg_state->decompress_context->output_height;
-    image_local->pixel_format               = jpeg_private_color_space_to_pixel_format(jpeg_state->decompress_context->out_color_space);
-    image_local->source_image->pixel_format = jpeg_private_color_space_to_pixel_format(jpeg_state->decompress_context->jpeg_color_space);
-    image_local->source_image->compression  = SAIL_COMPRESSION_JPEG;
+    image_local->width                            = jpeg_state->decompress_context->output_width;
+    image_local->height                           = jpeg_state->decompress_context->output_height;
+    image_local->pixel_format                     = jpeg_private_color_space_to_pixel_format(jpeg_state->decompress_context->out_color_space);
+    image_local->source_image->pixel_format       = jpeg_private_color_space_to_pixel_format(jpeg_state->decompress_context->jpeg_color_space);
+    image_local->source_image->compression        = SAIL_COMPRESSION_JPEG;
+    image_local->source_image->chroma_subsampling = jpeg_private_chroma_subsampling(jpeg_state->decompress_context);
 
     SAIL_TRY_OR_CLEANUP(sail_bytes_per_line(image_local->width, image_local->pixel_format, &image_local->bytes_per_line),
                         /* cleanup */ sail_destroy_image(image_local));
@@ -204,6 +333,9 @@ SAIL_EXPORT sail_status_t sail_codec_read_seek_next_frame_v6_jpeg(void *state, s
     SAIL_TRY_OR_CLEANUP(jpeg_private_fetch_resolution(jpeg_state->decompress_context, &image_local->resolution),
                             /* cleanup */ sail_destroy_image(image_local));
 
+    /* Fetch orientation. */
+    jpeg_private_fetch_orientation(jpeg_state->decompress_context, image_local);
+
     /* Fetch ICC profile. */
 #ifdef SAIL_HAVE_JPEG_ICCP
     if (jpeg_state->read_options->io_options & SAIL_IO_OPTION_ICCP) {
@@ -234,13 +366,24 @@ SAIL_EXPORT sail_status_t sail_codec_read_frame_v6_jpeg(void *state, struct sail
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    for (unsigned row = 0; row < image->height; row++) {
-        unsigned char *scanline = (unsigned char *)image->pixels + row * image->bytes_per_line;
+    /* Decode restart intervals in parallel when possible. */
+    bool decoded_in_parallel;
+    SAIL_TRY(jpeg_private_read_frame_parallel(jpeg_state->decompress_context, io, jpeg_state->read_options, image, &decoded_in_parallel));
 
-        JSAMPROW samprow = (JSAMPROW)scanline;
-        (void)jpeg_read_scanlines(jpeg_state->decompress_context, &samprow, 1);
+    if (decoded_in_parallel) {
+        sail_report_read_progress(jpeg_state->read_options, image->height, image->height);
+        return SAIL_OK;
+    }
+
+    if (jpeg_state->decompress_context->buffered_image) {
+        SAIL_TRY(read_progressive_frame(jpeg_state, image));
+    } else {
+        SAIL_TRY(read_scan_lines(jpeg_state, image));
     }
 
+    /* libjpeg reports progress before reading a scan line, so report the last one explicitly. */
+    sail_report_read_progress(jpeg_state->read_options, image->height, image->height);
+
     return SAIL_OK;
 }
 
@@ -313,6 +456,13 @@ SAIL_EXPORT sail_status_t sail_codec_write_init_v6_jpeg(struct sail_io *io, cons
     jpeg_create_compress(jpeg_state->compress_context);
     jpeg_private_sail_io_dest(jpeg_state->compress_context, io);
 
+    if (jpeg_state->write_options->progress != NULL) {
+        jpeg_state->progress_context.jpeg_progress_mgr.progress_monitor = jpeg_private_progress_monitor;
+        jpeg_state->progress_context.progress           = jpeg_state->write_options->progress;
+        jpeg_state->progress_context.progress_user_data = jpeg_state->write_options->progress_user_data;
+        jpeg_state->compress_context->progress = &jpeg_state->progress_context.jpeg_progress_mgr;
+    }
+
     return SAIL_OK;
 }
 
@@ -320,7 +470,7 @@ SAIL_EXPORT sail_status_t sail_codec_write_seek_next_frame_v6_jpeg(void *state,
 
     SAIL_CHECK_PTR(state);
     SAIL_TRY(sail_check_io_valid(io));
-    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_TRY(sail_check_image_skeleton_valid(image));
 
     struct jpeg_state *jpeg_state = (struct jpeg_state *)state;
 
@@ -330,6 +480,31 @@ SAIL_EXPORT sail_status_t sail_codec_write_seek_next_frame_v6_jpeg(void *state,
 
     jpeg_state->frame_written = true;
 
+    /* Write the source data unchanged or losslessly transformed instead of compressing the pixels. */
+    const bool write_source_data = jpeg_state->write_options->io_options & SAIL_IO_OPTION_SOURCE_DATA && jpeg_private_can_write_source_data(image);
+
+    if (jpeg_state->write_options->lossless_transform != SAIL_LOSSLESS_TRANSFORM_NONE) {
+        if (!write_source_data) {
+            SAIL_LOG_ERROR("JPEG: Lossless transformations require the JPEG source data of the image");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+        }
+
+        SAIL_TRY(jpeg_private_write_transformed_source_data(io, image, jpeg_state->write_options));
+        jpeg_state->source_data_written = true;
+        SAIL_LOG_DEBUG("JPEG: Transformed source data has been written");
+        return SAIL_OK;
+    }
+
+    if (write_source_data) {
+        SAIL_TRY(jpeg_private_write_source_data(io, image, jpeg_state->write_options->io_options));
+        jpeg_state->source_data_written = true;
+        SAIL_LOG_DEBUG("JPEG: Source data has been written");
+        return SAIL_OK;
+    }
+
+    /* Compress the pixels. */
+    SAIL_TRY(sail_check_image_valid(image));
+
     /* Error handling setup. */
     if (setjmp(jpeg_state->error_context.setjmp_buffer) != 0) {
         jpeg_state->libjpeg_error = true;
@@ -367,6 +542,9 @@ SAIL_EXPORT sail_status_t sail_codec_write_seek_next_frame_v6_jpeg(void *state,
                                 : jpeg_state->write_options->compression_level;
     jpeg_set_quality(jpeg_state->compress_context, /* to quality */ (int)(COMPRESSION_MAX-compression), true);
 
+    /* Apply the rest of compression options. */
+    SAIL_TRY(jpeg_private_write_compression_options(jpeg_state->compress_context, jpeg_state->write_options));
+
     /* Start compression. */
     jpeg_start_compress(jpeg_state->compress_context, true);
     jpeg_state->started_compress = true;
@@ -392,7 +570,6 @@ SAIL_EXPORT sail_status_t sail_codec_write_frame_v6_jpeg(void *state, struct sai
 
     SAIL_CHECK_PTR(state);
     SAIL_TRY(sail_check_io_valid(io));
-    SAIL_TRY(sail_check_image_valid(image));
 
     struct jpeg_state *jpeg_state = (struct jpeg_state *)state;
 
@@ -400,14 +577,37 @@ SAIL_EXPORT sail_status_t sail_codec_write_frame_v6_jpeg(void *state, struct sai
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+    /* Not an error. */
+    if (jpeg_state->source_data_written) {
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(sail_check_image_valid(image));
+
     if (setjmp(jpeg_state->error_context.setjmp_buffer) != 0) {
         jpeg_state->libjpeg_error = true;
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    for (unsigned row = 0; row < image->height; row++) {
-        JSAMPROW samprow = (JSAMPROW)((const unsigned char *)image->pixels + row * image->bytes_per_line);
-        jpeg_write_scanlines(jpeg_state->compress_context, &samprow, 1);
+    JSAMPROW samprows[SCAN_LINES_PER_CALL_MAX];
+
+    for (unsigned row = 0; row < image->height;) {
+        SAIL_TRY(sail_check_write_cancelled(jpeg_state->write_options));
+
+        const unsigned scan_lines_to_write = (image->height - row < SCAN_LINES_PER_CALL_MAX) ? image->height - row : SCAN_LINES_PER_CALL_MAX;
+
+        for (unsigned i = 0; i < scan_lines_to_write; i++) {
+            samprows[i] = (JSAMPROW)((const unsigned char *)image->pixels + (row + i) * image->bytes_per_line);
+        }
+
+        const unsigned scan_lines_written = jpeg_write_scanlines(jpeg_state->compress_context, samprows, scan_lines_to_write);
+
+        if (scan_lines_written == 0) {
+            SAIL_LOG_ERROR("JPEG: Failed to write scan lines");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        row += scan_lines_written;
     }
 
     return SAIL_OK;
@@ -424,6 +624,7 @@ SAIL_EXPORT sail_status_t sail_codec_write_finish_v6_jpeg(void **state, struct s
     *state = NULL;
 
     if (setjmp(jpeg_state->error_context.setjmp_buffer) != 0) {
+        jpeg_destroy_compress(jpeg_state->compress_context);
         destroy_jpeg_state(jpeg_state);
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
@@ -431,6 +632,11 @@ SAIL_EXPORT sail_status_t sail_codec_write_finish_v6_jpeg(void **state, struct s
     if (jpeg_state->compress_context != NULL) {
         if (jpeg_state->started_compress) {
             jpeg_finish_compress(jpeg_state->compress_context);
+
+            /* libjpeg reports progress before writing a scan line, so report the last one explicitly. */
+            sail_report_write_progress(jpeg_state->write_options,
+                                        jpeg_state->compress_context->image_height,
+                                        jpeg_state->compress_context->image_height);
         }
 
         jpeg_destroy_compress(jpeg_state->compress_context);
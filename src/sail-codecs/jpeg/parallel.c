@@ -0,0 +1,627 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <jpeglib.h>
+#include <jerror.h>
+
+#include "sail-common.h"
+
+#include "helpers.h"
+#include "parallel.h"
+
+/* Maximum number of scan lines passed to libjpeg at once. */
+#define SCAN_LINES_PER_CALL_MAX 16
+
+/* Fake EOI marker at the end of every slice. */
+static const JOCTET EOI_BUFFER[2] = { (JOCTET)0xFF, (JOCTET)JPEG_EOI };
+
+/* RST markers renumbered from zero in every slice. */
+static const JOCTET RST_BUFFERS[8][2] = {
+    { (JOCTET)0xFF, (JOCTET)(JPEG_RST0 + 0) },
+    { (JOCTET)0xFF, (JOCTET)(JPEG_RST0 + 1) },
+    { (JOCTET)0xFF, (JOCTET)(JPEG_RST0 + 2) },
+    { (JOCTET)0xFF, (JOCTET)(JPEG_RST0 + 3) },
+    { (JOCTET)0xFF, (JOCTET)(JPEG_RST0 + 4) },
+    { (JOCTET)0xFF, (JOCTET)(JPEG_RST0 + 5) },
+    { (JOCTET)0xFF, (JOCTET)(JPEG_RST0 + 6) },
+    { (JOCTET)0xFF, (JOCTET)(JPEG_RST0 + 7) },
+};
+
+/* Continuous range of bytes fed to libjpeg. */
+struct data_chunk {
+    const JOCTET *data;
+    size_t size;
+};
+
+/* libjpeg source manager reading a list of chunks. */
+struct chunk_source_mgr {
+    struct jpeg_source_mgr pub;
+
+    const struct data_chunk *chunks;
+    size_t chunks_count;
+    size_t next_chunk;
+};
+
+/*
+ * Layout of the restart intervals in the JPEG data. Intervals are grouped into units that start
+ * at MCU rows. Slices consist of whole units, so every slice is a valid JPEG scan on its own.
+ */
+struct restart_layout {
+    const unsigned char *data;
+
+    /* Size of the segments from SOI to SOS inclusive. */
+    size_t header_size;
+
+    /* Offset of the frame height in the SOF segment. */
+    size_t sof_height_offset;
+
+    /* Entropy-coded data of every restart interval. */
+    struct data_chunk *intervals;
+    unsigned intervals_count;
+
+    unsigned unit_intervals;
+    unsigned unit_height;
+    unsigned units_count;
+
+    /* Decode one more unit around every slice to feed the vertical upsampling context. */
+    bool context_units;
+};
+
+struct slice {
+    const struct restart_layout *layout;
+    const struct jpeg_decompress_struct *decompress_context;
+    const struct sail_read_options *read_options;
+    struct sail_image *image;
+
+    /* Units written into the image. */
+    unsigned first_unit;
+    unsigned last_unit;
+
+    struct sail_thread thread;
+    bool thread_started;
+
+    sail_status_t status;
+};
+
+/*
+ * Source manager.
+ */
+
+static void init_chunk_source(j_decompress_ptr cinfo) {
+
+    (void)cinfo;
+}
+
+static boolean fill_chunk_input_buffer(j_decompress_ptr cinfo) {
+
+    struct chunk_source_mgr *src = (struct chunk_source_mgr *)cinfo->src;
+
+    while (src->next_chunk < src->chunks_count && src->chunks[src->next_chunk].size == 0) {
+        src->next_chunk++;
+    }
+
+    if (src->next_chunk == src->chunks_count) {
+        WARNMS(cinfo, JWRN_JPEG_EOF);
+
+        src->pub.next_input_byte = EOI_BUFFER;
+        src->pub.bytes_in_buffer = sizeof(EOI_BUFFER);
+
+        return TRUE;
+    }
+
+    src->pub.next_input_byte = src->chunks[src->next_chunk].data;
+    src->pub.bytes_in_buffer = src->chunks[src->next_chunk].size;
+    src->next_chunk++;
+
+    return TRUE;
+}
+
+static void skip_chunk_input_data(j_decompress_ptr cinfo, long num_bytes) {
+
+    struct jpeg_source_mgr *src = cinfo->src;
+
+    if (num_bytes <= 0) {
+        return;
+    }
+
+    while (num_bytes > (long)src->bytes_in_buffer) {
+        num_bytes -= (long)src->bytes_in_buffer;
+        (void)(*src->fill_input_buffer)(cinfo);
+    }
+
+    src->next_input_byte += (size_t)num_bytes;
+    src->bytes_in_buffer -= (size_t)num_bytes;
+}
+
+static void term_chunk_source(j_decompress_ptr cinfo) {
+
+    (void)cinfo;
+}
+
+/*
+ * Scan layout.
+ */
+
+static unsigned gcd(unsigned a, unsigned b) {
+
+    while (b != 0) {
+        const unsigned t = a % b;
+        a = b;
+        b = t;
+    }
+
+    return a;
+}
+
+/* Checks the scan parameters known to libjpeg before looking into the data. */
+static bool scan_supported(const struct jpeg_decompress_struct *decompress_context) {
+
+#if JPEG_LIB_VERSION >= 80
+    if (decompress_context->block_size != DCTSIZE) {
+        return false;
+    }
+#endif
+
+    return !decompress_context->progressive_mode
+            && !decompress_context->buffered_image
+            && decompress_context->restart_interval > 0
+            && decompress_context->comps_in_scan == decompress_context->num_components
+            && decompress_context->MCUs_per_row > 0
+            && decompress_context->output_width == decompress_context->image_width
+            && decompress_context->output_height == decompress_context->image_height;
+}
+
+/* Keeps the whole JPEG data in memory. Borrows the data when possible. */
+static sail_status_t fetch_data(struct sail_io *io, const unsigned char **data, size_t *data_size, void **data_to_free) {
+
+    *data_to_free = NULL;
+
+    const void *contents;
+
+    if (io->contents != NULL && io->contents(io->stream, &contents, data_size) == SAIL_OK) {
+        *data = contents;
+        return SAIL_OK;
+    }
+
+    size_t saved_position;
+    SAIL_TRY(io->tell(io->stream, &saved_position));
+    SAIL_TRY(io->seek(io->stream, 0, SEEK_SET));
+
+    SAIL_TRY_OR_CLEANUP(sail_io_contents_to_data(io, data_to_free, data_size),
+                        /* cleanup */ io->seek(io->stream, (long)saved_position, SEEK_SET));
+
+    SAIL_TRY_OR_CLEANUP(io->seek(io->stream, (long)saved_position, SEEK_SET),
+                        /* cleanup */ sail_free(*data_to_free));
+
+    *data = *data_to_free;
+
+    return SAIL_OK;
+}
+
+/*
+ * Finds the restart intervals in the scan data. Sets 'found' to false if the data has
+ * a different number of intervals than expected.
+ */
+static sail_status_t find_restart_layout(const struct jpeg_decompress_struct *decompress_context,
+                                         const unsigned char *data, size_t data_size,
+                                         struct restart_layout *layout, bool *found) {
+
+    *found = false;
+
+    layout->data       = data;
+    layout->intervals  = NULL;
+
+    if (data_size < 4 || data[0] != 0xFF || data[1] != MARKER_SOI) {
+        return SAIL_OK;
+    }
+
+    /* Find the frame height and the scan data. */
+    bool sof_found = false;
+    bool sos_found = false;
+    int marker;
+    size_t payload_offset;
+    size_t segment_size;
+
+    for (size_t position = 2;
+            sail_jpeg_next_segment(data, data_size, position, &marker, &payload_offset, &segment_size);
+            position += segment_size) {
+        if (sail_jpeg_is_sof_marker(marker)) {
+            /* SOF payload: precision, height, width. */
+            if (position + segment_size - payload_offset < 5) {
+                return SAIL_OK;
+            }
+
+            layout->sof_height_offset = payload_offset + 1;
+            sof_found = true;
+        } else if (marker == MARKER_SOS) {
+            layout->header_size = position + segment_size;
+            sos_found = true;
+            break;
+        }
+    }
+
+    if (!sof_found || !sos_found) {
+        return SAIL_OK;
+    }
+
+    const unsigned restart_interval = decompress_context->restart_interval;
+    const unsigned mcus_per_row     = decompress_context->MCUs_per_row;
+    const size_t mcus               = (size_t)mcus_per_row * decompress_context->MCU_rows_in_scan;
+    const size_t intervals_count    = (mcus + restart_interval - 1) / restart_interval;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct data_chunk) * intervals_count, &ptr));
+    layout->intervals = ptr;
+
+    /* Every marker except stuffed zeros and RSTn ends the scan. */
+    size_t intervals_found = 0;
+    size_t interval_start = layout->header_size;
+
+    for (size_t position = interval_start;;) {
+        const unsigned char *ff = memchr(data + position, 0xFF, data_size - position);
+
+        if (ff == NULL) {
+            return SAIL_OK;
+        }
+
+        const size_t marker_position = (size_t)(ff - data);
+        size_t marker_code_position = marker_position + 1;
+
+        /* Skip fill bytes. */
+        while (marker_code_position < data_size && data[marker_code_position] == 0xFF) {
+            marker_code_position++;
+        }
+
+        if (marker_code_position >= data_size) {
+            return SAIL_OK;
+        }
+
+        if (data[marker_code_position] == 0x00) {
+            position = marker_code_position + 1;
+            continue;
+        }
+
+        if (intervals_found == intervals_count) {
+            return SAIL_OK;
+        }
+
+        layout->intervals[intervals_found].data = data + interval_start;
+        layout->intervals[intervals_found].size = marker_position - interval_start;
+        intervals_found++;
+
+        if (data[marker_code_position] >= JPEG_RST0 && data[marker_code_position] <= JPEG_RST0 + 7) {
+            interval_start = position = marker_code_position + 1;
+        } else {
+            break;
+        }
+    }
+
+    if (intervals_found != intervals_count) {
+        return SAIL_OK;
+    }
+
+    /* A unit is the shortest run of intervals that ends at the end of an MCU row. */
+    const unsigned common_divisor = gcd(restart_interval, mcus_per_row);
+    const unsigned mcu_height = (decompress_context->comps_in_scan == 1)
+                                    ? DCTSIZE
+                                    : (unsigned)decompress_context->max_v_samp_factor * DCTSIZE;
+
+    layout->intervals_count = (unsigned)intervals_count;
+    layout->unit_intervals  = mcus_per_row / common_divisor;
+    layout->unit_height     = restart_interval / common_divisor * mcu_height;
+    layout->units_count     = (layout->intervals_count + layout->unit_intervals - 1) / layout->unit_intervals;
+    layout->context_units   = decompress_context->do_fancy_upsampling && decompress_context->max_v_samp_factor > 1;
+
+    *found = true;
+
+    return SAIL_OK;
+}
+
+/*
+ * Slice decoding.
+ */
+
+static unsigned min_unsigned(unsigned a, unsigned b) {
+
+    return a < b ? a : b;
+}
+
+/* Reads the started slice decompressor into the image rows of the slice. May jump to the error handler. */
+static sail_status_t read_slice_scan_lines(const struct slice *slice, struct jpeg_decompress_struct *decompress_context,
+                                           unsigned skip_rows, unsigned first_row, unsigned rows) {
+
+    struct sail_image *image = slice->image;
+
+    const unsigned scan_lines_per_call = min_unsigned((unsigned)decompress_context->rec_outbuf_height, SCAN_LINES_PER_CALL_MAX);
+    JSAMPROW samprows[SCAN_LINES_PER_CALL_MAX];
+
+    /* Context rows are decoded into the first row of the slice and overwritten later. */
+    for (unsigned i = 0; i < scan_lines_per_call; i++) {
+        samprows[i] = (JSAMPROW)((unsigned char *)image->pixels + image->bytes_per_line * first_row);
+    }
+
+    for (unsigned row = 0; row < skip_rows;) {
+        const unsigned scan_lines_read = jpeg_read_scanlines(decompress_context, samprows,
+                                                             min_unsigned(skip_rows - row, scan_lines_per_call));
+
+        if (scan_lines_read == 0) {
+            SAIL_LOG_ERROR("JPEG: Failed to read scan lines");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        row += scan_lines_read;
+    }
+
+    for (unsigned row = 0; row < rows;) {
+        SAIL_TRY(sail_check_read_cancelled(slice->read_options));
+
+        const unsigned scan_lines_to_read = min_unsigned(rows - row, scan_lines_per_call);
+
+        for (unsigned i = 0; i < scan_lines_to_read; i++) {
+            samprows[i] = (JSAMPROW)((unsigned char *)image->pixels + image->bytes_per_line * (first_row + row + i));
+        }
+
+        const unsigned scan_lines_read = jpeg_read_scanlines(decompress_context, samprows, scan_lines_to_read);
+
+        if (scan_lines_read == 0) {
+            SAIL_LOG_ERROR("JPEG: Failed to read scan lines");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        row += scan_lines_read;
+    }
+
+    return SAIL_OK;
+}
+
+/* Starts the slice decompressor over the chunks and reads the slice. May jump to the error handler. */
+static sail_status_t decode_slice_chunks(const struct slice *slice, struct jpeg_decompress_struct *decompress_context,
+                                         unsigned height, unsigned skip_rows, unsigned first_row, unsigned rows) {
+
+    jpeg_read_header(decompress_context, TRUE);
+
+    /* Decode exactly like the main decompressor. */
+    decompress_context->out_color_space     = slice->decompress_context->out_color_space;
+    decompress_context->quantize_colors     = FALSE;
+    decompress_context->dct_method          = slice->decompress_context->dct_method;
+    decompress_context->do_fancy_upsampling = slice->decompress_context->do_fancy_upsampling;
+    decompress_context->do_block_smoothing  = slice->decompress_context->do_block_smoothing;
+
+    jpeg_start_decompress(decompress_context);
+
+    if (decompress_context->output_width != slice->image->width
+            || decompress_context->output_height != height
+            || decompress_context->output_components != slice->decompress_context->output_components) {
+        SAIL_LOG_ERROR("JPEG: Slice layout doesn't match the image");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    SAIL_TRY(read_slice_scan_lines(slice, decompress_context, skip_rows, first_row, rows));
+
+    return SAIL_OK;
+}
+
+static sail_status_t decode_slice(const struct slice *slice) {
+
+    const struct restart_layout *layout = slice->layout;
+    const struct sail_image *image = slice->image;
+
+    /* Units decoded, including context units. */
+    const unsigned decode_first_unit = (layout->context_units && slice->first_unit > 0)
+                                        ? slice->first_unit - 1
+                                        : slice->first_unit;
+    const unsigned decode_last_unit = (layout->context_units && slice->last_unit < layout->units_count)
+                                        ? slice->last_unit + 1
+                                        : slice->last_unit;
+
+    const unsigned first_interval = decode_first_unit * layout->unit_intervals;
+    const unsigned last_interval  = min_unsigned(decode_last_unit * layout->unit_intervals, layout->intervals_count);
+
+    const unsigned decode_first_row = decode_first_unit * layout->unit_height;
+    const unsigned height           = min_unsigned(decode_last_unit * layout->unit_height, image->height) - decode_first_row;
+    const unsigned first_row        = slice->first_unit * layout->unit_height;
+    const unsigned rows             = min_unsigned(slice->last_unit * layout->unit_height, image->height) - first_row;
+
+    /* Header with the slice height. */
+    void *ptr;
+    SAIL_TRY(sail_malloc(layout->header_size, &ptr));
+    unsigned char *header = ptr;
+
+    memcpy(header, layout->data, layout->header_size);
+    header[layout->sof_height_offset]     = (unsigned char)(height >> 8);
+    header[layout->sof_height_offset + 1] = (unsigned char)(height & 0xFF);
+
+    /* Header, intervals separated with RST markers, EOI. */
+    const size_t intervals_count = last_interval - first_interval;
+    const size_t chunks_count = intervals_count * 2 + 1;
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct data_chunk) * chunks_count, &ptr),
+                        /* cleanup */ sail_free(header));
+    struct data_chunk *chunks = ptr;
+
+    size_t chunk = 0;
+    chunks[chunk].data = header;
+    chunks[chunk].size = layout->header_size;
+    chunk++;
+
+    for (size_t i = 0; i < intervals_count; i++) {
+        if (i > 0) {
+            chunks[chunk].data = RST_BUFFERS[(i - 1) % 8];
+            chunks[chunk].size = sizeof(RST_BUFFERS[0]);
+            chunk++;
+        }
+
+        chunks[chunk++] = layout->intervals[first_interval + i];
+    }
+
+    chunks[chunk].data = EOI_BUFFER;
+    chunks[chunk].size = sizeof(EOI_BUFFER);
+
+    /* Slice decompressor. */
+    struct chunk_source_mgr src;
+    src.pub.init_source       = init_chunk_source;
+    src.pub.fill_input_buffer = fill_chunk_input_buffer;
+    src.pub.skip_input_data   = skip_chunk_input_data;
+    src.pub.resync_to_restart = jpeg_resync_to_restart;
+    src.pub.term_source       = term_chunk_source;
+    src.pub.bytes_in_buffer   = 0;
+    src.pub.next_input_byte   = NULL;
+    src.chunks                = chunks;
+    src.chunks_count          = chunks_count;
+    src.next_chunk            = 0;
+
+    struct jpeg_decompress_struct decompress_context;
+    struct jpeg_private_my_error_context error_context;
+
+    decompress_context.err = jpeg_std_error(&error_context.jpeg_error_mgr);
+    error_context.jpeg_error_mgr.error_exit     = jpeg_private_my_error_exit;
+    error_context.jpeg_error_mgr.output_message = jpeg_private_my_output_message;
+
+    if (setjmp(error_context.setjmp_buffer) != 0) {
+        jpeg_destroy_decompress(&decompress_context);
+        sail_free(chunks);
+        sail_free(header);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    jpeg_create_decompress(&decompress_context);
+    decompress_context.src = &src.pub;
+
+    const sail_status_t status = decode_slice_chunks(slice, &decompress_context, height,
+                                                     first_row - decode_first_row, first_row, rows);
+
+    jpeg_destroy_decompress(&decompress_context);
+    sail_free(chunks);
+    sail_free(header);
+
+    return status;
+}
+
+/*
+ * Threads.
+ */
+
+static void slice_thread_routine(void *arg) {
+
+    struct slice *slice = arg;
+    slice->status = decode_slice(slice);
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t jpeg_private_read_frame_parallel(const struct jpeg_decompress_struct *decompress_context, struct sail_io *io,
+                                               const struct sail_read_options *read_options, struct sail_image *image,
+                                               bool *decoded) {
+
+    SAIL_CHECK_PTR(decompress_context);
+    SAIL_CHECK_PTR(read_options);
+    SAIL_CHECK_PTR(image);
+    SAIL_CHECK_PTR(decoded);
+
+    *decoded = false;
+
+    /* Not an error. */
+    if (read_options->threads < 2 || read_options->scan_line_converter != NULL || !scan_supported(decompress_context)) {
+        return SAIL_OK;
+    }
+
+    const unsigned char *data;
+    size_t data_size;
+    void *data_to_free;
+    SAIL_TRY(fetch_data(io, &data, &data_size, &data_to_free));
+
+    struct restart_layout layout;
+    bool layout_found;
+    SAIL_TRY_OR_CLEANUP(find_restart_layout(decompress_context, data, data_size, &layout, &layout_found),
+                        /* cleanup */ sail_free(layout.intervals),
+                                      sail_free(data_to_free));
+
+    const unsigned threads = layout_found ? min_unsigned(read_options->threads, layout.units_count) : 0;
+
+    /* Not an error. */
+    if (threads < 2) {
+        sail_free(layout.intervals);
+        sail_free(data_to_free);
+        return SAIL_OK;
+    }
+
+    void *ptr;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct slice) * threads, &ptr),
+                        /* cleanup */ sail_free(layout.intervals),
+                                      sail_free(data_to_free));
+    struct slice *slices = ptr;
+
+    for (unsigned i = 0; i < threads; i++) {
+        slices[i].layout             = &layout;
+        slices[i].decompress_context = decompress_context;
+        slices[i].read_options       = read_options;
+        slices[i].image              = image;
+        slices[i].first_unit         = (unsigned)((size_t)layout.units_count * i / threads);
+        slices[i].last_unit          = (unsigned)((size_t)layout.units_count * (i + 1) / threads);
+        slices[i].thread_started     = false;
+        slices[i].status             = SAIL_OK;
+    }
+
+    SAIL_LOG_TRACE("JPEG: Decoding %u restart intervals in %u threads", layout.intervals_count, threads);
+
+    /* The calling thread decodes the first slice. */
+    for (unsigned i = 1; i < threads; i++) {
+        slices[i].thread_started = sail_create_thread(&slices[i].thread, slice_thread_routine, &slices[i]) == SAIL_OK;
+    }
+
+    slices[0].status = decode_slice(&slices[0]);
+
+    sail_status_t status = slices[0].status;
+
+    for (unsigned i = 1; i < threads; i++) {
+        if (slices[i].thread_started) {
+            sail_join_thread(&slices[i].thread);
+        } else {
+            slices[i].status = decode_slice(&slices[i]);
+        }
+
+        if (status == SAIL_OK) {
+            status = slices[i].status;
+        }
+    }
+
+    sail_free(slices);
+    sail_free(layout.intervals);
+    sail_free(data_to_free);
+
+    SAIL_TRY(status);
+
+    *decoded = true;
+
+    return SAIL_OK;
+}
@@ -0,0 +1,56 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_JPEG_PARALLEL_H
+#define SAIL_JPEG_PARALLEL_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <jpeglib.h>
+
+#include "common.h"
+#include "error.h"
+#include "export.h"
+
+struct sail_image;
+struct sail_io;
+struct sail_read_options;
+
+/*
+ * Decodes the frame in parallel if the read options allow several threads and the JPEG scan has
+ * restart markers. The scan is split into slices at restart markers that start MCU rows, and every
+ * thread decodes its slice with its own decompressor. The decompress context must be started with
+ * jpeg_start_decompress(), it's used to check the scan layout and the output parameters only.
+ *
+ * Sets 'decoded' to false and leaves the image untouched if the frame must be decoded sequentially.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t jpeg_private_read_frame_parallel(const struct jpeg_decompress_struct *decompress_context, struct sail_io *io,
+                                                           const struct sail_read_options *read_options, struct sail_image *image,
+                                                           bool *decoded);
+
+#endif
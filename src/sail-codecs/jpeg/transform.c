@@ -0,0 +1,464 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <jpeglib.h>
+
+#include "sail-common.h"
+
+#include "helpers.h"
+#include "io_dest.h"
+#include "io_src.h"
+#include "transform.h"
+
+/* Decompress and compress contexts sharing one error manager. Allocated on the heap to survive longjmp(). */
+struct transform_context {
+    struct jpeg_decompress_struct decompress_context;
+    struct jpeg_compress_struct compress_context;
+    struct jpeg_private_my_error_context error_context;
+};
+
+/* Transformed area of the source image and the output dimensions, in pixels. */
+struct transform_geometry {
+    enum SailLosslessTransform transform;
+    bool transposed;
+    unsigned area_x;
+    unsigned area_y;
+    unsigned area_width;
+    unsigned area_height;
+    unsigned width;
+    unsigned height;
+};
+
+/*
+ * Private functions.
+ */
+
+static unsigned round_down(unsigned value, unsigned step) {
+
+    return value / step * step;
+}
+
+static JDIMENSION div_round_up(JDIMENSION value, JDIMENSION divisor) {
+
+    return (value + divisor - 1) / divisor;
+}
+
+static JDIMENSION round_up(JDIMENSION value, JDIMENSION step) {
+
+    return div_round_up(value, step) * step;
+}
+
+static sail_status_t compute_geometry(const struct jpeg_decompress_struct *decompress_context,
+                                      const struct sail_write_options *write_options,
+                                      struct transform_geometry *geometry) {
+
+    /* Size of an iMCU in pixels. Non-interleaved single component images consist of separate blocks. */
+    const unsigned imcu_width  = (decompress_context->num_components == 1) ? DCTSIZE : (unsigned)decompress_context->max_h_samp_factor * DCTSIZE;
+    const unsigned imcu_height = (decompress_context->num_components == 1) ? DCTSIZE : (unsigned)decompress_context->max_v_samp_factor * DCTSIZE;
+
+    const unsigned image_width  = decompress_context->image_width;
+    const unsigned image_height = decompress_context->image_height;
+
+    geometry->transform   = write_options->lossless_transform;
+    geometry->area_x      = 0;
+    geometry->area_y      = 0;
+    geometry->area_width  = image_width;
+    geometry->area_height = image_height;
+
+    /* Partial iMCUs on a mirrored edge cannot be moved to the opposite edge, so trim them. */
+    switch (write_options->lossless_transform) {
+        case SAIL_LOSSLESS_TRANSFORM_NONE:
+        case SAIL_LOSSLESS_TRANSFORM_TRANSPOSE: {
+            geometry->transposed = (write_options->lossless_transform == SAIL_LOSSLESS_TRANSFORM_TRANSPOSE);
+            break;
+        }
+        case SAIL_LOSSLESS_TRANSFORM_FLIP_HORIZONTALLY: {
+            geometry->transposed = false;
+            geometry->area_width = round_down(image_width, imcu_width);
+            break;
+        }
+        case SAIL_LOSSLESS_TRANSFORM_FLIP_VERTICALLY: {
+            geometry->transposed  = false;
+            geometry->area_height = round_down(image_height, imcu_height);
+            break;
+        }
+        case SAIL_LOSSLESS_TRANSFORM_ROTATE_90: {
+            geometry->transposed  = true;
+            geometry->area_height = round_down(image_height, imcu_height);
+            break;
+        }
+        case SAIL_LOSSLESS_TRANSFORM_ROTATE_180: {
+            geometry->transposed  = false;
+            geometry->area_width  = round_down(image_width, imcu_width);
+            geometry->area_height = round_down(image_height, imcu_height);
+            break;
+        }
+        case SAIL_LOSSLESS_TRANSFORM_ROTATE_270: {
+            geometry->transposed = true;
+            geometry->area_width = round_down(image_width, imcu_width);
+            break;
+        }
+        case SAIL_LOSSLESS_TRANSFORM_CROP: {
+            if (write_options->crop_width == 0 || write_options->crop_height == 0
+                    || write_options->crop_x >= image_width || write_options->crop_y >= image_height) {
+                SAIL_LOG_ERROR("JPEG: Crop rectangle %ux%u+%u+%u is outside of the %ux%u image",
+                                write_options->crop_width, write_options->crop_height,
+                                write_options->crop_x, write_options->crop_y, image_width, image_height);
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+            }
+
+            const unsigned right  = (write_options->crop_width > image_width - write_options->crop_x)
+                                    ? image_width : write_options->crop_x + write_options->crop_width;
+            const unsigned bottom = (write_options->crop_height > image_height - write_options->crop_y)
+                                    ? image_height : write_options->crop_y + write_options->crop_height;
+
+            geometry->transposed  = false;
+            geometry->area_x      = round_down(write_options->crop_x, imcu_width);
+            geometry->area_y      = round_down(write_options->crop_y, imcu_height);
+            geometry->area_width  = right - geometry->area_x;
+            geometry->area_height = bottom - geometry->area_y;
+            break;
+        }
+        default: {
+            SAIL_LOG_ERROR("JPEG: Unknown lossless transformation %d", write_options->lossless_transform);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+        }
+    }
+
+    if (geometry->area_width == 0 || geometry->area_height == 0) {
+        SAIL_LOG_ERROR("JPEG: The %ux%u image is smaller than a single MCU and cannot be transformed", image_width, image_height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    geometry->width  = geometry->transposed ? geometry->area_height : geometry->area_width;
+    geometry->height = geometry->transposed ? geometry->area_width  : geometry->area_height;
+
+    return SAIL_OK;
+}
+
+/*
+ * Requests coefficient arrays for the output image. It must be done before jpeg_read_coefficients()
+ * realizes the virtual arrays.
+ */
+static jvirt_barray_ptr* request_target_arrays(struct jpeg_decompress_struct *decompress_context,
+                                               const struct transform_geometry *geometry) {
+
+    jvirt_barray_ptr *target_arrays = (jvirt_barray_ptr *)(*decompress_context->mem->alloc_small)((j_common_ptr)decompress_context,
+                                                                                                  JPOOL_IMAGE,
+                                                                                                  sizeof(jvirt_barray_ptr) * decompress_context->num_components);
+
+    const int max_h_samp_factor = geometry->transposed ? decompress_context->max_v_samp_factor : decompress_context->max_h_samp_factor;
+    const int max_v_samp_factor = geometry->transposed ? decompress_context->max_h_samp_factor : decompress_context->max_v_samp_factor;
+
+    for (int ci = 0; ci < decompress_context->num_components; ci++) {
+        const jpeg_component_info *component = &decompress_context->comp_info[ci];
+
+        const int h_samp_factor = geometry->transposed ? component->v_samp_factor : component->h_samp_factor;
+        const int v_samp_factor = geometry->transposed ? component->h_samp_factor : component->v_samp_factor;
+
+        const JDIMENSION width_in_blocks  = div_round_up(geometry->width * h_samp_factor, max_h_samp_factor * DCTSIZE);
+        const JDIMENSION height_in_blocks = div_round_up(geometry->height * v_samp_factor, max_v_samp_factor * DCTSIZE);
+
+        target_arrays[ci] = (*decompress_context->mem->request_virt_barray)((j_common_ptr)decompress_context,
+                                                                            JPOOL_IMAGE,
+                                                                            /* pre-zero */ TRUE,
+                                                                            round_up(width_in_blocks, h_samp_factor),
+                                                                            round_up(height_in_blocks, v_samp_factor),
+                                                                            v_samp_factor);
+    }
+
+    return target_arrays;
+}
+
+/* Sets the output dimensions. Transposing swaps the sampling factors and the quantization tables. */
+static void adjust_target_parameters(struct jpeg_compress_struct *compress_context, const struct transform_geometry *geometry) {
+
+    compress_context->image_width  = geometry->width;
+    compress_context->image_height = geometry->height;
+#if JPEG_LIB_VERSION >= 70
+    compress_context->jpeg_width  = geometry->width;
+    compress_context->jpeg_height = geometry->height;
+#endif
+
+    if (!geometry->transposed) {
+        return;
+    }
+
+    for (int ci = 0; ci < compress_context->num_components; ci++) {
+        jpeg_component_info *component = &compress_context->comp_info[ci];
+
+        const int h_samp_factor    = component->h_samp_factor;
+        component->h_samp_factor = component->v_samp_factor;
+        component->v_samp_factor = h_samp_factor;
+    }
+
+    for (int tbl = 0; tbl < NUM_QUANT_TBLS; tbl++) {
+        JQUANT_TBL *quant_table = compress_context->quant_tbl_ptrs[tbl];
+
+        if (quant_table == NULL) {
+            continue;
+        }
+
+        for (int v = 0; v < DCTSIZE; v++) {
+            for (int u = v + 1; u < DCTSIZE; u++) {
+                const UINT16 value                   = quant_table->quantval[v * DCTSIZE + u];
+                quant_table->quantval[v * DCTSIZE + u] = quant_table->quantval[u * DCTSIZE + v];
+                quant_table->quantval[u * DCTSIZE + v] = value;
+            }
+        }
+    }
+}
+
+/*
+ * Copies APPn and COM markers. libjpeg writes its own JFIF and Adobe markers. The EXIF orientation
+ * of flipped or rotated images is reset as the transformation changes the stored orientation.
+ * Cropping keeps the stored orientation.
+ */
+static void copy_markers(const struct jpeg_decompress_struct *decompress_context, struct jpeg_compress_struct *compress_context,
+                         enum SailLosslessTransform transform) {
+
+    const bool reset_orientation = transform != SAIL_LOSSLESS_TRANSFORM_NONE && transform != SAIL_LOSSLESS_TRANSFORM_CROP;
+
+    for (jpeg_saved_marker_ptr marker = decompress_context->marker_list; marker != NULL; marker = marker->next) {
+        if (compress_context->write_JFIF_header && marker->marker == JPEG_APP0
+                && marker->data_length >= 5 && memcmp(marker->data, "JFIF", 5) == 0) {
+            continue;
+        }
+
+        if (compress_context->write_Adobe_marker && marker->marker == JPEG_APP0 + 14
+                && marker->data_length >= 5 && memcmp(marker->data, "Adobe", 5) == 0) {
+            continue;
+        }
+
+        /* Saved markers belong to the decompress context, so they're modified in place. */
+        if (reset_orientation && marker->marker == JPEG_APP0 + 1) {
+            sail_exif_reset_orientation(marker->data, marker->data_length);
+        }
+
+        jpeg_write_marker(compress_context, marker->marker, marker->data, marker->data_length);
+    }
+}
+
+/*
+ * Builds the coefficient map of a block. Transposing swaps the horizontal and vertical frequencies,
+ * mirroring negates the odd frequencies along the mirrored axis.
+ */
+static void build_coefficient_map(enum SailLosslessTransform transform, int source_index[DCTSIZE2], bool negate[DCTSIZE2]) {
+
+    for (int v = 0; v < DCTSIZE; v++) {
+        for (int u = 0; u < DCTSIZE; u++) {
+            const int index = v * DCTSIZE + u;
+
+            switch (transform) {
+                case SAIL_LOSSLESS_TRANSFORM_FLIP_HORIZONTALLY: {
+                    source_index[index] = index;
+                    negate[index]       = (u % 2 == 1);
+                    break;
+                }
+                case SAIL_LOSSLESS_TRANSFORM_FLIP_VERTICALLY: {
+                    source_index[index] = index;
+                    negate[index]       = (v % 2 == 1);
+                    break;
+                }
+                case SAIL_LOSSLESS_TRANSFORM_TRANSPOSE: {
+                    source_index[index] = u * DCTSIZE + v;
+                    negate[index]       = false;
+                    break;
+                }
+                case SAIL_LOSSLESS_TRANSFORM_ROTATE_90: {
+                    source_index[index] = u * DCTSIZE + v;
+                    negate[index]       = (u % 2 == 1);
+                    break;
+                }
+                case SAIL_LOSSLESS_TRANSFORM_ROTATE_180: {
+                    source_index[index] = index;
+                    negate[index]       = ((u + v) % 2 == 1);
+                    break;
+                }
+                case SAIL_LOSSLESS_TRANSFORM_ROTATE_270: {
+                    source_index[index] = u * DCTSIZE + v;
+                    negate[index]       = (v % 2 == 1);
+                    break;
+                }
+                default: {
+                    source_index[index] = index;
+                    negate[index]       = false;
+                }
+            }
+        }
+    }
+}
+
+/* Maps an output block to the source block in the transformed area. */
+static void map_block(enum SailLosslessTransform transform, JDIMENSION area_width, JDIMENSION area_height,
+                      JDIMENSION target_x, JDIMENSION target_y, JDIMENSION *source_x, JDIMENSION *source_y) {
+
+    switch (transform) {
+        case SAIL_LOSSLESS_TRANSFORM_FLIP_HORIZONTALLY: *source_x = area_width - 1 - target_x; *source_y = target_y;                   break;
+        case SAIL_LOSSLESS_TRANSFORM_FLIP_VERTICALLY:   *source_x = target_x;                  *source_y = area_height - 1 - target_y; break;
+        case SAIL_LOSSLESS_TRANSFORM_TRANSPOSE:         *source_x = target_y;                  *source_y = target_x;                   break;
+        case SAIL_LOSSLESS_TRANSFORM_ROTATE_90:         *source_x = target_y;                  *source_y = area_height - 1 - target_x; break;
+        case SAIL_LOSSLESS_TRANSFORM_ROTATE_180:        *source_x = area_width - 1 - target_x; *source_y = area_height - 1 - target_y; break;
+        case SAIL_LOSSLESS_TRANSFORM_ROTATE_270:        *source_x = area_width - 1 - target_y; *source_y = target_x;                   break;
+        default:                                        *source_x = target_x;                  *source_y = target_y;                   break;
+    }
+}
+
+static void transform_coefficients(struct jpeg_decompress_struct *decompress_context,
+                                   jvirt_barray_ptr *source_arrays, jvirt_barray_ptr *target_arrays,
+                                   const struct transform_geometry *geometry) {
+
+    int source_index[DCTSIZE2];
+    bool negate[DCTSIZE2];
+    build_coefficient_map(geometry->transform, source_index, negate);
+
+    const JDIMENSION max_block_width  = (JDIMENSION)decompress_context->max_h_samp_factor * DCTSIZE;
+    const JDIMENSION max_block_height = (JDIMENSION)decompress_context->max_v_samp_factor * DCTSIZE;
+
+    for (int ci = 0; ci < decompress_context->num_components; ci++) {
+        const jpeg_component_info *component = &decompress_context->comp_info[ci];
+
+        /* The transformed area in blocks of the component. */
+        const JDIMENSION area_x      = geometry->area_x * component->h_samp_factor / max_block_width;
+        const JDIMENSION area_y      = geometry->area_y * component->v_samp_factor / max_block_height;
+        const JDIMENSION area_width  = div_round_up(geometry->area_width * component->h_samp_factor, max_block_width);
+        const JDIMENSION area_height = div_round_up(geometry->area_height * component->v_samp_factor, max_block_height);
+
+        const JDIMENSION target_width  = geometry->transposed ? area_height : area_width;
+        const JDIMENSION target_height = geometry->transposed ? area_width  : area_height;
+
+        for (JDIMENSION target_y = 0; target_y < target_height; target_y++) {
+            JBLOCKARRAY target_rows = (*decompress_context->mem->access_virt_barray)((j_common_ptr)decompress_context,
+                                                                                     target_arrays[ci], target_y, 1, TRUE);
+
+            for (JDIMENSION target_x = 0; target_x < target_width; target_x++) {
+                JDIMENSION source_x;
+                JDIMENSION source_y;
+                map_block(geometry->transform, area_width, area_height, target_x, target_y, &source_x, &source_y);
+
+                source_x += area_x;
+                source_y += area_y;
+
+                if (source_x >= component->width_in_blocks || source_y >= component->height_in_blocks) {
+                    continue;
+                }
+
+                JBLOCKARRAY source_rows = (*decompress_context->mem->access_virt_barray)((j_common_ptr)decompress_context,
+                                                                                         source_arrays[ci], source_y, 1, FALSE);
+
+                const JCOEF *source_block = source_rows[0][source_x];
+                JCOEF *target_block = target_rows[0][target_x];
+
+                for (int i = 0; i < DCTSIZE2; i++) {
+                    const JCOEF coefficient = source_block[source_index[i]];
+                    target_block[i] = negate[i] ? (JCOEF)-coefficient : coefficient;
+                }
+            }
+        }
+    }
+}
+
+static sail_status_t transform(struct transform_context *context, const struct sail_source_image *source_image,
+                               struct sail_io *io, const struct sail_write_options *write_options) {
+
+    struct jpeg_decompress_struct *decompress_context = &context->decompress_context;
+    struct jpeg_compress_struct *compress_context     = &context->compress_context;
+
+    /* Error handling setup. */
+    decompress_context->err = jpeg_std_error(&context->error_context.jpeg_error_mgr);
+    compress_context->err   = &context->error_context.jpeg_error_mgr;
+    context->error_context.jpeg_error_mgr.error_exit     = jpeg_private_my_error_exit;
+    context->error_context.jpeg_error_mgr.output_message = jpeg_private_my_output_message;
+
+    if (setjmp(context->error_context.setjmp_buffer) != 0) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    jpeg_create_decompress(decompress_context);
+    jpeg_create_compress(compress_context);
+
+    jpeg_private_memory_src(decompress_context, source_image->data, source_image->data_size);
+    jpeg_private_sail_io_dest(compress_context, io);
+
+    jpeg_save_markers(decompress_context, JPEG_COM, 0xFFFF);
+    for (int i = 0; i < 16; i++) {
+        jpeg_save_markers(decompress_context, JPEG_APP0 + i, 0xFFFF);
+    }
+
+    jpeg_read_header(decompress_context, TRUE);
+
+    struct transform_geometry geometry;
+    SAIL_TRY(compute_geometry(decompress_context, write_options, &geometry));
+
+    jvirt_barray_ptr *target_arrays = request_target_arrays(decompress_context, &geometry);
+    jvirt_barray_ptr *source_arrays = jpeg_read_coefficients(decompress_context);
+
+    jpeg_copy_critical_parameters(decompress_context, compress_context);
+    adjust_target_parameters(compress_context, &geometry);
+
+    if (decompress_context->progressive_mode) {
+        jpeg_simple_progression(compress_context);
+    }
+
+    jpeg_write_coefficients(compress_context, target_arrays);
+    copy_markers(decompress_context, compress_context, geometry.transform);
+
+    transform_coefficients(decompress_context, source_arrays, target_arrays, &geometry);
+
+    jpeg_finish_compress(compress_context);
+    jpeg_finish_decompress(decompress_context);
+
+    SAIL_LOG_DEBUG("JPEG: Transformed %ux%u image into %ux%u",
+                    decompress_context->image_width, decompress_context->image_height, geometry.width, geometry.height);
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t jpeg_private_write_transformed_source_data(struct sail_io *io, const struct sail_image *image,
+                                                         const struct sail_write_options *write_options) {
+
+    void *ptr;
+    SAIL_TRY(sail_calloc(1, sizeof(struct transform_context), &ptr));
+    struct transform_context *context = ptr;
+
+    const sail_status_t status = transform(context, image->source_image, io, write_options);
+
+    /* Destroying never created contexts is a no-op. */
+    jpeg_destroy_compress(&context->compress_context);
+    jpeg_destroy_decompress(&context->decompress_context);
+
+    sail_free(context);
+
+    return status;
+}
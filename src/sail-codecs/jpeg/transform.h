@@ -0,0 +1,48 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_JPEG_TRANSFORM_H
+#define SAIL_JPEG_TRANSFORM_H
+
+#include "common.h"
+#include "error.h"
+#include "export.h"
+
+struct sail_image;
+struct sail_io;
+struct sail_write_options;
+
+/*
+ * Applies the lossless transformation from the write options to the JPEG source data of the image
+ * and writes the result. The DCT coefficients are transformed like jpegtran does, so nothing is
+ * re-compressed. Partial MCUs at the image edges that cannot be moved are trimmed away. APPn and COM
+ * markers are copied unchanged.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t jpeg_private_write_transformed_source_data(struct sail_io *io, const struct sail_image *image,
+                                                                     const struct sail_write_options *write_options);
+
+#endif
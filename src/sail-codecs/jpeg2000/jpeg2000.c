@@ -160,7 +160,10 @@ SAIL_EXPORT sail_status_t sail_codec_read_seek_next_frame_v6_jpeg2000(void *stat
     jpeg2000_state->frame_read = true;
 
     /* Get image info. */
-    jpeg2000_state->jas_image = jas_image_decode(jpeg2000_state->jas_stream, -1 /* format */, NULL /* options */);
+    /* Decode the first quality layer only when speed matters most. */
+    const char *options = (jpeg2000_state->read_options->decode_quality == SAIL_DECODE_QUALITY_FASTEST) ? "maxlyrs=1" : NULL;
+
+    jpeg2000_state->jas_image = jas_image_decode(jpeg2000_state->jas_stream, -1 /* format */, options);
 
     if (jpeg2000_state->jas_image == NULL) {
         SAIL_LOG_ERROR("JPEG2000: Failed to read image");
@@ -187,8 +187,11 @@ SAIL_EXPORT sail_status_t sail_codec_read_frame_v6_pcx(void *state, struct sail_
 
     if (pcx_state->pcx_header.encoding == SAIL_PCX_NO_ENCODING) {
         SAIL_TRY(pcx_private_read_uncompressed(io, pcx_state->pcx_header.bytes_per_line, pcx_state->pcx_header.planes, pcx_state->scanline_buffer, image));
+        sail_report_read_progress(pcx_state->read_options, image->height, image->height);
     } else {
         for (unsigned row = 0; row < image->height; row++) {
+            SAIL_TRY(sail_check_read_cancelled(pcx_state->read_options));
+
             unsigned buffer_offset = 0;
 
             /* Decode all planes of a single scan line. */
@@ -225,6 +228,8 @@ SAIL_EXPORT sail_status_t sail_codec_read_frame_v6_pcx(void *state, struct sail_
                     *(scan + column * pcx_state->pcx_header.planes + plane) = *(pcx_state->scanline_buffer + buffer_plane_offset + column);
                 }
             }
+
+            sail_report_read_progress(pcx_state->read_options, row + 1, image->height);
         }
     }
 
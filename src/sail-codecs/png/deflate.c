@@ -0,0 +1,680 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <png.h>
+#include <zlib.h>
+
+#include "sail-common.h"
+
+#include "deflate.h"
+
+/* Minimum size of the filtered data compressed by a single thread, like the pigz block size. */
+#define BLOCK_SIZE_MIN (128 * 1024)
+
+/* zlib takes sizes as uInt. Larger buffers are passed in slices of this size. */
+#define SLICE_SIZE_MAX UINT_MAX
+
+/* Filter types in the first byte of every filtered row. */
+enum filter_type {
+    FILTER_TYPE_NONE,
+    FILTER_TYPE_SUB,
+    FILTER_TYPE_UP,
+    FILTER_TYPE_AVERAGE,
+    FILTER_TYPE_PAETH,
+};
+
+/* Frame parameters shared by all the blocks. */
+struct frame {
+    const struct sail_image *image;
+    const struct sail_write_options *write_options;
+    const struct png_private_compression *compression;
+
+    /* Size of a row without the filter type byte. */
+    size_t row_size;
+    /* Distance to the corresponding byte of the previous pixel used by filters. */
+    unsigned filter_bpp;
+
+    /* Samples per pixel and bytes per sample to reorder samples in RGB order like png_set_bgr() and png_set_swap_alpha() do. */
+    unsigned samples;
+    unsigned sample_size;
+    /* Index of the source sample for every target sample or NULL if the samples are in order. */
+    const unsigned *sample_order;
+};
+
+struct block {
+    const struct frame *frame;
+
+    /* Rows compressed by this block. */
+    unsigned first_row;
+    unsigned last_row;
+    bool last;
+
+    /* Raw deflate segment. */
+    unsigned char *segment;
+    size_t segment_size;
+
+    /* Adler-32 and size of the filtered rows of the block. */
+    uLong adler;
+    size_t filtered_size;
+
+    struct sail_thread thread;
+    bool thread_started;
+
+    sail_status_t status;
+};
+
+static const unsigned BGR_ORDER[]  = { 2, 1, 0 };
+static const unsigned BGRA_ORDER[] = { 2, 1, 0, 3 };
+static const unsigned ARGB_ORDER[] = { 1, 2, 3, 0 };
+static const unsigned ABGR_ORDER[] = { 3, 2, 1, 0 };
+
+static unsigned min_unsigned(unsigned a, unsigned b) {
+
+    return a < b ? a : b;
+}
+
+static uInt slice_size(size_t size) {
+
+    return (uInt)((size < SLICE_SIZE_MAX) ? size : SLICE_SIZE_MAX);
+}
+
+static void sample_order(enum SailPixelFormat pixel_format, struct frame *frame) {
+
+    frame->sample_order = NULL;
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP24_BGR:  frame->samples = 3; frame->sample_size = 1; frame->sample_order = BGR_ORDER;  break;
+        case SAIL_PIXEL_FORMAT_BPP48_BGR:  frame->samples = 3; frame->sample_size = 2; frame->sample_order = BGR_ORDER;  break;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA: frame->samples = 4; frame->sample_size = 1; frame->sample_order = BGRA_ORDER; break;
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB: frame->samples = 4; frame->sample_size = 1; frame->sample_order = ARGB_ORDER; break;
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR: frame->samples = 4; frame->sample_size = 1; frame->sample_order = ABGR_ORDER; break;
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA: frame->samples = 4; frame->sample_size = 2; frame->sample_order = BGRA_ORDER; break;
+        case SAIL_PIXEL_FORMAT_BPP64_ARGB: frame->samples = 4; frame->sample_size = 2; frame->sample_order = ARGB_ORDER; break;
+        case SAIL_PIXEL_FORMAT_BPP64_ABGR: frame->samples = 4; frame->sample_size = 2; frame->sample_order = ABGR_ORDER; break;
+
+        default: {
+            break;
+        }
+    }
+}
+
+/* Copies the image row into the buffer with the samples in the PNG order. */
+static void fetch_row(const struct frame *frame, unsigned row, unsigned char *buffer) {
+
+    const unsigned char *scan_line = (const unsigned char *)frame->image->pixels + (size_t)row * frame->image->bytes_per_line;
+
+    if (frame->sample_order == NULL) {
+        memcpy(buffer, scan_line, frame->row_size);
+        return;
+    }
+
+    const size_t pixel_size = (size_t)frame->samples * frame->sample_size;
+
+    for (size_t offset = 0; offset < frame->row_size; offset += pixel_size) {
+        for (unsigned sample = 0; sample < frame->samples; sample++) {
+            memcpy(buffer + offset + sample * frame->sample_size,
+                   scan_line + offset + frame->sample_order[sample] * frame->sample_size,
+                   frame->sample_size);
+        }
+    }
+}
+
+static unsigned char paeth_predictor(unsigned char a, unsigned char b, unsigned char c) {
+
+    const int p  = (int)a + (int)b - (int)c;
+    const int pa = abs(p - (int)a);
+    const int pb = abs(p - (int)b);
+    const int pc = abs(p - (int)c);
+
+    if (pa <= pb && pa <= pc) {
+        return a;
+    } else if (pb <= pc) {
+        return b;
+    } else {
+        return c;
+    }
+}
+
+/* Filters the row with the specified filter type. 'previous' is the previous unfiltered row or zeros. */
+static void filter_row(enum filter_type filter_type, const unsigned char *row, const unsigned char *previous,
+                       size_t row_size, unsigned bpp, unsigned char *output) {
+
+    for (size_t i = 0; i < row_size; i++) {
+        const unsigned char left     = (i >= bpp) ? row[i - bpp] : 0;
+        const unsigned char up       = previous[i];
+        const unsigned char up_left  = (i >= bpp) ? previous[i - bpp] : 0;
+
+        unsigned char predictor;
+
+        switch (filter_type) {
+            case FILTER_TYPE_SUB:     predictor = left; break;
+            case FILTER_TYPE_UP:      predictor = up; break;
+            case FILTER_TYPE_AVERAGE: predictor = (unsigned char)(((unsigned)left + up) / 2); break;
+            case FILTER_TYPE_PAETH:   predictor = paeth_predictor(left, up, up_left); break;
+
+            default: {
+                predictor = 0;
+                break;
+            }
+        }
+
+        output[i] = (unsigned char)(row[i] - predictor);
+    }
+}
+
+/* Sum of absolute values of the filtered bytes as signed numbers. The same heuristic libpng uses. */
+static size_t filtered_sum(const unsigned char *output, size_t row_size) {
+
+    size_t sum = 0;
+
+    for (size_t i = 0; i < row_size; i++) {
+        sum += (output[i] < 128) ? output[i] : 256 - output[i];
+    }
+
+    return sum;
+}
+
+/*
+ * Writes the filter type and the filtered row into the output. Picks the filter with the minimum sum
+ * of absolute differences when several filters are allowed. 'scratch' holds a filtered row.
+ */
+static void filter_row_adaptive(const struct frame *frame, const unsigned char *row, const unsigned char *previous,
+                                unsigned char *scratch, unsigned char *output) {
+
+    static const int FILTER_MASKS[] = { PNG_FILTER_NONE, PNG_FILTER_SUB, PNG_FILTER_UP, PNG_FILTER_AVG, PNG_FILTER_PAETH };
+
+    bool found = false;
+    size_t best_sum = 0;
+
+    for (int filter_type = FILTER_TYPE_NONE; filter_type <= FILTER_TYPE_PAETH; filter_type++) {
+        if ((frame->compression->filters & FILTER_MASKS[filter_type]) == 0) {
+            continue;
+        }
+
+        filter_row((enum filter_type)filter_type, row, previous, frame->row_size, frame->filter_bpp, scratch);
+
+        const size_t sum = filtered_sum(scratch, frame->row_size);
+
+        if (!found || sum < best_sum) {
+            found    = true;
+            best_sum = sum;
+
+            output[0] = (unsigned char)filter_type;
+            memcpy(output + 1, scratch, frame->row_size);
+        }
+    }
+
+    /* No filters allowed. */
+    if (!found) {
+        output[0] = FILTER_TYPE_NONE;
+        memcpy(output + 1, row, frame->row_size);
+    }
+}
+
+/* Filters the block rows preceded by the rows to prime the deflate dictionary with. */
+static sail_status_t filter_block(struct block *block, unsigned first_row, unsigned char *filtered) {
+
+    const struct frame *frame = block->frame;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(frame->row_size * 3, &ptr));
+    unsigned char *row      = ptr;
+    unsigned char *previous = row + frame->row_size;
+    unsigned char *scratch  = previous + frame->row_size;
+
+    if (first_row > 0) {
+        fetch_row(frame, first_row - 1, previous);
+    } else {
+        memset(previous, 0, frame->row_size);
+    }
+
+    for (unsigned r = first_row; r < block->last_row; r++) {
+        SAIL_TRY_OR_CLEANUP(sail_check_write_cancelled(frame->write_options),
+                            /* cleanup */ sail_free(ptr));
+
+        fetch_row(frame, r, row);
+        filter_row_adaptive(frame, row, previous, scratch, filtered);
+
+        filtered += frame->row_size + 1;
+
+        unsigned char *temp = previous;
+        previous = row;
+        row      = temp;
+    }
+
+    sail_free(ptr);
+
+    return SAIL_OK;
+}
+
+static sail_status_t compress_block(struct block *block) {
+
+    const struct frame *frame = block->frame;
+    const size_t filtered_row_size = frame->row_size + 1;
+    const size_t window_size = (size_t)1 << frame->compression->window_bits;
+
+    /* Rows of the preceding block filtered again to prime the dictionary. */
+    unsigned dictionary_rows = (unsigned)((window_size + filtered_row_size - 1) / filtered_row_size);
+    dictionary_rows = min_unsigned(dictionary_rows, block->first_row);
+
+    const unsigned first_row = block->first_row - dictionary_rows;
+    const size_t dictionary_size = (size_t)dictionary_rows * filtered_row_size;
+    block->filtered_size = (size_t)(block->last_row - block->first_row) * filtered_row_size;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(dictionary_size + block->filtered_size, &ptr));
+    unsigned char *filtered = ptr;
+
+    SAIL_TRY_OR_CLEANUP(filter_block(block, first_row, filtered),
+                        /* cleanup */ sail_free(filtered));
+
+    const unsigned char *block_data = filtered + dictionary_size;
+    block->adler = adler32(0L, Z_NULL, 0);
+
+    for (size_t offset = 0; offset < block->filtered_size;) {
+        const uInt size = slice_size(block->filtered_size - offset);
+        block->adler = adler32(block->adler, block_data + offset, size);
+        offset += size;
+    }
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+
+    if (deflateInit2(&stream, frame->compression->level, Z_DEFLATED, -frame->compression->window_bits,
+                        frame->compression->mem_level, frame->compression->strategy) != Z_OK) {
+        sail_free(filtered);
+        SAIL_LOG_ERROR("PNG: Failed to initialize deflate");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    if (dictionary_size > 0) {
+        const size_t primed_size = (dictionary_size < window_size) ? dictionary_size : window_size;
+        deflateSetDictionary(&stream, block_data - primed_size, (uInt)primed_size);
+    }
+
+    /* Sync flush adds an empty stored block. */
+    const size_t segment_capacity = deflateBound(&stream, (uLong)block->filtered_size) + 16;
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(segment_capacity, &ptr),
+                        /* cleanup */ deflateEnd(&stream),
+                                      sail_free(filtered));
+    block->segment = ptr;
+
+    /* The last block ends the stream, others end at a byte boundary to be concatenated. */
+    const int last_flush = block->last ? Z_FINISH : Z_SYNC_FLUSH;
+
+    size_t avail_in  = block->filtered_size;
+    size_t avail_out = segment_capacity;
+    int result;
+    bool done;
+
+    stream.next_in  = (Bytef *)block_data;
+    stream.next_out = block->segment;
+
+    do {
+        const uInt slice_in  = slice_size(avail_in);
+        const uInt slice_out = slice_size(avail_out);
+        const int flush = (slice_in == avail_in) ? last_flush : Z_NO_FLUSH;
+
+        stream.avail_in  = slice_in;
+        stream.avail_out = slice_out;
+
+        result = deflate(&stream, flush);
+
+        avail_in  -= slice_in - stream.avail_in;
+        avail_out -= slice_out - stream.avail_out;
+
+        /* Z_FINISH returns Z_OK until the stream ends, Z_SYNC_FLUSH is complete when some output space is left. */
+        done = result != Z_OK || (flush == Z_SYNC_FLUSH && stream.avail_out != 0);
+    } while (!done);
+
+    block->segment_size = segment_capacity - avail_out;
+
+    deflateEnd(&stream);
+    sail_free(filtered);
+
+    if ((block->last && result != Z_STREAM_END) || (!block->last && (result != Z_OK || avail_in != 0))) {
+        SAIL_LOG_ERROR("PNG: Failed to deflate rows %u-%u", block->first_row, block->last_row);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Threads.
+ */
+
+static void block_thread_routine(void *arg) {
+
+    struct block *block = arg;
+    block->status = compress_block(block);
+}
+
+/*
+ * zlib stream.
+ */
+
+static void zlib_header(const struct png_private_compression *compression, unsigned char header[2]) {
+
+    int level_flags;
+
+    if (compression->level == 1 || compression->strategy == Z_HUFFMAN_ONLY || compression->strategy == Z_RLE) {
+        level_flags = 0;
+    } else if (compression->level >= 0 && compression->level < 6) {
+        level_flags = 1;
+    } else if (compression->level == 6 || compression->level == Z_DEFAULT_COMPRESSION) {
+        level_flags = 2;
+    } else {
+        level_flags = 3;
+    }
+
+    header[0] = (unsigned char)(((compression->window_bits - 8) << 4) | Z_DEFLATED);
+    header[1] = (unsigned char)(level_flags << 6);
+    header[1] = (unsigned char)(header[1] + 31 - ((header[0] << 8) + header[1]) % 31);
+}
+
+/* Writes the zlib header, the segments, and the Adler-32 as IDAT chunks, one chunk per segment. */
+static sail_status_t write_idat(png_structp png_ptr, const struct png_private_compression *compression,
+                                const struct block *blocks, unsigned blocks_count) {
+
+    unsigned char header[2];
+    zlib_header(compression, header);
+
+    uLong adler = blocks[0].adler;
+
+    for (unsigned i = 1; i < blocks_count; i++) {
+        adler = adler32_combine(adler, blocks[i].adler, (z_off_t)blocks[i].filtered_size);
+    }
+
+    const unsigned char trailer[4] = {
+        (unsigned char)(adler >> 24),
+        (unsigned char)(adler >> 16),
+        (unsigned char)(adler >> 8),
+        (unsigned char)adler,
+    };
+
+    for (unsigned i = 0; i < blocks_count; i++) {
+        const size_t chunk_size = blocks[i].segment_size
+                                    + ((i == 0) ? sizeof(header) : 0)
+                                    + ((i == blocks_count - 1) ? sizeof(trailer) : 0);
+
+        if (chunk_size > PNG_UINT_31_MAX) {
+            SAIL_LOG_ERROR("PNG: IDAT chunk of %lu bytes is too big", (unsigned long)chunk_size);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        png_write_chunk_start(png_ptr, (png_const_bytep)"IDAT", (png_uint_32)chunk_size);
+
+        if (i == 0) {
+            png_write_chunk_data(png_ptr, header, sizeof(header));
+        }
+
+        png_write_chunk_data(png_ptr, blocks[i].segment, blocks[i].segment_size);
+
+        if (i == blocks_count - 1) {
+            png_write_chunk_data(png_ptr, trailer, sizeof(trailer));
+        }
+
+        png_write_chunk_end(png_ptr);
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Frames.
+ */
+
+static sail_status_t init_frame(const struct sail_image *image, const struct sail_write_options *write_options,
+                                const struct png_private_compression *compression, struct frame *frame) {
+
+    unsigned bits_per_pixel;
+    SAIL_TRY(sail_bits_per_pixel(image->pixel_format, &bits_per_pixel));
+
+    frame->image         = image;
+    frame->write_options = write_options;
+    frame->compression   = compression;
+    frame->row_size      = ((size_t)image->width * bits_per_pixel + 7) / 8;
+    frame->filter_bpp    = (bits_per_pixel < 8) ? 1 : bits_per_pixel / 8;
+    sample_order(image->pixel_format, frame);
+
+    return SAIL_OK;
+}
+
+/* Number of blocks to split the frame into. Every block is compressed by its own thread. */
+static unsigned frame_blocks_count(const struct frame *frame, unsigned threads) {
+
+    const size_t filtered_size = (frame->row_size + 1) * frame->image->height;
+    const size_t blocks_max = filtered_size / BLOCK_SIZE_MIN;
+
+    return min_unsigned(min_unsigned(threads, frame->image->height),
+                        (blocks_max < UINT_MAX) ? (unsigned)blocks_max : UINT_MAX);
+}
+
+static void destroy_blocks(struct block *blocks, unsigned blocks_count) {
+
+    if (blocks == NULL) {
+        return;
+    }
+
+    for (unsigned i = 0; i < blocks_count; i++) {
+        sail_free(blocks[i].segment);
+    }
+
+    sail_free(blocks);
+}
+
+/*
+ * Compresses the frame split into blocks in parallel. Reports progress as 'rows_done' plus
+ * the compressed rows out of 'rows_total'.
+ */
+static sail_status_t compress_frame(const struct frame *frame, unsigned blocks_count,
+                                    unsigned rows_done, unsigned rows_total, struct block **blocks) {
+
+    const unsigned height = frame->image->height;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct block) * blocks_count, &ptr));
+    *blocks = ptr;
+
+    for (unsigned i = 0; i < blocks_count; i++) {
+        (*blocks)[i].frame          = frame;
+        (*blocks)[i].first_row      = (unsigned)((size_t)height * i / blocks_count);
+        (*blocks)[i].last_row       = (unsigned)((size_t)height * (i + 1) / blocks_count);
+        (*blocks)[i].last           = i == blocks_count - 1;
+        (*blocks)[i].segment        = NULL;
+        (*blocks)[i].segment_size   = 0;
+        (*blocks)[i].adler          = 0;
+        (*blocks)[i].filtered_size  = 0;
+        (*blocks)[i].thread_started = false;
+        (*blocks)[i].status         = SAIL_OK;
+    }
+
+    SAIL_LOG_TRACE("PNG: Compressing %u rows in %u threads", height, blocks_count);
+
+    /* The calling thread compresses the first block. */
+    for (unsigned i = 1; i < blocks_count; i++) {
+        (*blocks)[i].thread_started = sail_create_thread(&(*blocks)[i].thread, block_thread_routine, &(*blocks)[i]) == SAIL_OK;
+    }
+
+    (*blocks)[0].status = compress_block(&(*blocks)[0]);
+    sail_report_write_progress(frame->write_options, rows_done + (*blocks)[0].last_row, rows_total);
+
+    sail_status_t status = (*blocks)[0].status;
+
+    for (unsigned i = 1; i < blocks_count; i++) {
+        if ((*blocks)[i].thread_started) {
+            sail_join_thread(&(*blocks)[i].thread);
+        } else {
+            (*blocks)[i].status = compress_block(&(*blocks)[i]);
+        }
+
+        if (status == SAIL_OK) {
+            status = (*blocks)[i].status;
+        }
+
+        if (status == SAIL_OK) {
+            sail_report_write_progress(frame->write_options, rows_done + (*blocks)[i].last_row, rows_total);
+        }
+    }
+
+    if (status != SAIL_OK) {
+        destroy_blocks(*blocks, blocks_count);
+        *blocks = NULL;
+        SAIL_LOG_AND_RETURN(status);
+    }
+
+    return SAIL_OK;
+}
+
+static size_t compressed_size(const struct block *blocks, unsigned blocks_count) {
+
+    size_t size = 0;
+
+    for (unsigned i = 0; i < blocks_count; i++) {
+        size += blocks[i].segment_size;
+    }
+
+    return size;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t png_private_write_frame_parallel(png_structp png_ptr, const struct sail_image *image,
+                                               const struct sail_write_options *write_options,
+                                               const struct png_private_compression *compression,
+                                               bool *written) {
+
+    SAIL_CHECK_PTR(png_ptr);
+    SAIL_CHECK_PTR(image);
+    SAIL_CHECK_PTR(write_options);
+    SAIL_CHECK_PTR(compression);
+    SAIL_CHECK_PTR(written);
+
+    *written = false;
+
+    /* Not an error. */
+    if (write_options->threads < 2 || write_options->io_options & SAIL_IO_OPTION_INTERLACED) {
+        return SAIL_OK;
+    }
+
+    struct frame frame;
+    SAIL_TRY(init_frame(image, write_options, compression, &frame));
+
+    const unsigned blocks_count = frame_blocks_count(&frame, write_options->threads);
+
+    /* Not an error. */
+    if (blocks_count < 2) {
+        return SAIL_OK;
+    }
+
+    struct block *blocks;
+    SAIL_TRY(compress_frame(&frame, blocks_count, 0, image->height, &blocks));
+
+    SAIL_TRY_OR_CLEANUP(write_idat(png_ptr, compression, blocks, blocks_count),
+                        /* cleanup */ destroy_blocks(blocks, blocks_count));
+
+    destroy_blocks(blocks, blocks_count);
+
+    *written = true;
+
+    return SAIL_OK;
+}
+
+sail_status_t png_private_write_frame_smallest(png_structp png_ptr, const struct sail_image *image,
+                                               const struct sail_write_options *write_options,
+                                               const struct png_private_compression *candidates,
+                                               unsigned candidates_count, bool *written) {
+
+    SAIL_CHECK_PTR(png_ptr);
+    SAIL_CHECK_PTR(image);
+    SAIL_CHECK_PTR(write_options);
+    SAIL_CHECK_PTR(candidates);
+    SAIL_CHECK_PTR(written);
+
+    *written = false;
+
+    /* Not an error. */
+    if (candidates_count == 0 || write_options->io_options & SAIL_IO_OPTION_INTERLACED) {
+        return SAIL_OK;
+    }
+
+    const unsigned rows_total = image->height * candidates_count;
+
+    unsigned best_candidate = 0;
+    struct block *best_blocks = NULL;
+    unsigned best_blocks_count = 0;
+    size_t best_size = 0;
+
+    for (unsigned i = 0; i < candidates_count; i++) {
+        struct frame frame;
+        SAIL_TRY_OR_CLEANUP(init_frame(image, write_options, &candidates[i], &frame),
+                            /* cleanup */ destroy_blocks(best_blocks, best_blocks_count));
+
+        unsigned blocks_count = frame_blocks_count(&frame, write_options->threads);
+        blocks_count = (blocks_count == 0) ? 1 : blocks_count;
+
+        struct block *blocks;
+        SAIL_TRY_OR_CLEANUP(compress_frame(&frame, blocks_count, image->height * i, rows_total, &blocks),
+                            /* cleanup */ destroy_blocks(best_blocks, best_blocks_count));
+
+        const size_t size = compressed_size(blocks, blocks_count);
+
+        SAIL_LOG_TRACE("PNG: Candidate compression #%u: %lu bytes", i, (unsigned long)size);
+
+        if (best_blocks == NULL || size < best_size) {
+            destroy_blocks(best_blocks, best_blocks_count);
+
+            best_candidate    = i;
+            best_blocks       = blocks;
+            best_blocks_count = blocks_count;
+            best_size         = size;
+        } else {
+            destroy_blocks(blocks, blocks_count);
+        }
+    }
+
+    SAIL_LOG_TRACE("PNG: Chose candidate compression #%u", best_candidate);
+
+    SAIL_TRY_OR_CLEANUP(write_idat(png_ptr, &candidates[best_candidate], best_blocks, best_blocks_count),
+                        /* cleanup */ destroy_blocks(best_blocks, best_blocks_count));
+
+    destroy_blocks(best_blocks, best_blocks_count);
+
+    *written = true;
+
+    return SAIL_OK;
+}
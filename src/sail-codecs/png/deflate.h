@@ -0,0 +1,83 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2020 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_PNG_DEFLATE_H
+#define SAIL_PNG_DEFLATE_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <png.h>
+
+#include "common.h"
+#include "error.h"
+#include "export.h"
+
+struct sail_image;
+struct sail_write_options;
+
+/* Filtering and zlib parameters of the image data. */
+struct png_private_compression {
+    /* Or-ed PNG_FILTER_* values. Several filters are chosen adaptively for every row. */
+    int filters;
+
+    int level;
+    int strategy;
+    int window_bits;
+    int mem_level;
+};
+
+/*
+ * Compresses the frame in parallel if the write options allow several threads and the frame is big enough.
+ * The frame rows are split into blocks. Every thread filters its block and deflates it into a raw deflate
+ * segment primed with the last filtered bytes of the preceding block, and ends the segment with a sync flush
+ * like pigz does. The segments are stitched into a single zlib stream with a combined Adler-32 and written
+ * as IDAT chunks. The IHDR chunk must be already written. Interlaced frames are not supported.
+ *
+ * Sets 'written' to false and writes nothing if the frame must be compressed sequentially. Otherwise,
+ * the caller must finish the PNG with an IEND chunk instead of png_write_end().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t png_private_write_frame_parallel(png_structp png_ptr, const struct sail_image *image,
+                                                          const struct sail_write_options *write_options,
+                                                          const struct png_private_compression *compression,
+                                                          bool *written);
+
+/*
+ * Compresses the frame with every candidate compression in turn and writes the smallest result as IDAT
+ * chunks. Blocks are compressed in parallel like png_private_write_frame_parallel() does.
+ *
+ * Sets 'written' to false and writes nothing for interlaced frames. Otherwise, the caller must finish
+ * the PNG with an IEND chunk instead of png_write_end().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t png_private_write_frame_smallest(png_structp png_ptr, const struct sail_image *image,
+                                                          const struct sail_write_options *write_options,
+                                                          const struct png_private_compression *candidates,
+                                                          unsigned candidates_count, bool *written);
+
+#endif
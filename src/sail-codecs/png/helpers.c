@@ -133,6 +133,26 @@ void png_private_my_warning_fn(png_structp png_ptr, png_const_charp text) {
     SAIL_LOG_WARNING("PNG: %s", text);
 }
 
+#ifdef PNG_USER_MEM_SUPPORTED
+png_voidp png_private_my_malloc_fn(png_structp png_ptr, png_alloc_size_t size) {
+
+    (void)png_ptr;
+
+    void *ptr;
+    SAIL_TRY_OR_EXECUTE(sail_malloc(size, &ptr),
+                        /* on error */ return NULL);
+
+    return ptr;
+}
+
+void png_private_my_free_fn(png_structp png_ptr, png_voidp ptr) {
+
+    (void)png_ptr;
+
+    sail_free(ptr);
+}
+#endif
+
 enum SailPixelFormat png_private_png_color_type_to_pixel_format(int color_type, int bit_depth) {
 
     switch (color_type) {
@@ -316,6 +336,18 @@ sail_status_t png_private_fetch_meta_data(png_structp png_ptr, png_infop info_pt
     return SAIL_OK;
 }
 
+void png_private_fetch_orientation(png_structp png_ptr, png_infop info_ptr, struct sail_image *image) {
+
+    png_bytep exif;
+    png_uint_32 exif_length;
+    enum SailOrientation orientation;
+
+    if (png_get_eXIf_1(png_ptr, info_ptr, &exif_length, &exif) != 0 && sail_exif_orientation(exif, exif_length, &orientation)) {
+        SAIL_LOG_TRACE("PNG: EXIF orientation %d", orientation);
+        sail_set_source_orientation(image, orientation);
+    }
+}
+
 sail_status_t png_private_write_meta_data(png_structp png_ptr, png_infop info_ptr, const struct sail_meta_data_node *meta_data_node) {
 
     SAIL_CHECK_PTR(png_ptr);
@@ -334,9 +366,9 @@ sail_status_t png_private_write_meta_data(png_structp png_ptr, png_infop info_pt
         png_text *lines = ptr;
 
         /* Indexes in 'lines' that must be freed. 1 = free, 0 = don't free. */
-        SAIL_TRY(sail_malloc(count * sizeof(bool), &ptr));
+        SAIL_TRY(sail_malloc(count * sizeof(int), &ptr));
         int *lines_to_free = ptr;
-        memset(lines_to_free, 0, count);
+        memset(lines_to_free, 0, count * sizeof(int));
 
         unsigned index = 0;
 
@@ -540,7 +572,7 @@ sail_status_t png_private_blend_over(void *dst_raw, unsigned dst_offset, const v
     return SAIL_OK;
 }
 
-sail_status_t png_private_skip_hidden_frame(unsigned bytes_per_line, unsigned height, png_structp png_ptr, png_infop info_ptr, void **row) {
+sail_status_t png_private_skip_hidden_frame(size_t bytes_per_line, unsigned height, png_structp png_ptr, png_infop info_ptr, void **row) {
 
     SAIL_CHECK_PTR(png_ptr);
     SAIL_CHECK_PTR(info_ptr);
@@ -650,3 +682,203 @@ sail_status_t png_private_write_resolution(png_structp png_ptr, png_infop info_p
 
     return SAIL_OK;
 }
+
+/* The size of the PNG signature. */
+#define SIGNATURE_SIZE 8
+
+/* Writes the output of a temporary PNG writer to the I/O object skipping the specified number of leading bytes. */
+struct skipping_writer {
+    struct sail_io *io;
+    size_t bytes_to_skip;
+};
+
+static void skipping_write_fn(png_structp png_ptr, png_bytep bytes, png_size_t bytes_size) {
+
+    struct skipping_writer *skipping_writer = (struct skipping_writer *)png_get_io_ptr(png_ptr);
+
+    const size_t skip = (bytes_size < skipping_writer->bytes_to_skip) ? bytes_size : skipping_writer->bytes_to_skip;
+    skipping_writer->bytes_to_skip -= skip;
+
+    if (bytes_size > skip) {
+        struct sail_io *io = skipping_writer->io;
+
+        if (io->strict_write(io->stream, bytes + skip, bytes_size - skip) != SAIL_OK) {
+            png_error(png_ptr, "Failed to write to the I/O stream");
+        }
+    }
+}
+
+static void skipping_flush_fn(png_structp png_ptr) {
+
+    (void)png_ptr;
+}
+
+static png_uint_32 read_be32(const unsigned char *data) {
+
+    return ((png_uint_32)data[0] << 24) | ((png_uint_32)data[1] << 16) | ((png_uint_32)data[2] << 8) | data[3];
+}
+
+/*
+ * Finds the chunk at the specified position in the PNG data. The chunk spans from the position
+ * to position + chunk_size. Returns false if the data is broken.
+ */
+static bool next_chunk(const unsigned char *data, size_t data_size, size_t position, const char **type, size_t *chunk_size) {
+
+    /* Length, type, CRC. */
+    if (data_size - position < 12) {
+        return false;
+    }
+
+    const png_uint_32 length = read_be32(data + position);
+
+    if (length > PNG_UINT_31_MAX || length > data_size - position - 12) {
+        return false;
+    }
+
+    *type       = (const char *)data + position + 4;
+    *chunk_size = (size_t)length + 12;
+
+    return true;
+}
+
+static bool is_chunk(const char *type, const char *expected_type) {
+
+    return memcmp(type, expected_type, 4) == 0;
+}
+
+/*
+ * Writes meta data and ICC profile chunks with a temporary libpng writer. The writer gets
+ * a fake IHDR chunk which is skipped along with the signature.
+ */
+static sail_status_t write_meta_data_chunks(struct sail_io *io, const struct sail_image *image, int io_options, bool write_iccp) {
+
+    const bool write_meta_data = io_options & SAIL_IO_OPTION_META_DATA && image->meta_data_node != NULL;
+
+    /* Not an error. */
+    if (!write_meta_data && !write_iccp) {
+        return SAIL_OK;
+    }
+
+#ifdef PNG_USER_MEM_SUPPORTED
+    png_structp png_ptr = png_create_write_struct_2(PNG_LIBPNG_VER_STRING, NULL, png_private_my_error_fn, png_private_my_warning_fn,
+                                                    NULL, png_private_my_malloc_fn, png_private_my_free_fn);
+#else
+    png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, png_private_my_error_fn, png_private_my_warning_fn);
+#endif
+
+    if (png_ptr == NULL) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    png_infop info_ptr = png_create_info_struct(png_ptr);
+
+    if (info_ptr == NULL) {
+        png_destroy_write_struct(&png_ptr, NULL);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    if (setjmp(png_jmpbuf(png_ptr))) {
+        png_destroy_write_struct(&png_ptr, &info_ptr);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    /* Signature and the IHDR chunk of 13 bytes. */
+    struct skipping_writer skipping_writer = { io, SIGNATURE_SIZE + 13 + 12 };
+    png_set_write_fn(png_ptr, &skipping_writer, skipping_write_fn, skipping_flush_fn);
+
+    png_set_IHDR(png_ptr, info_ptr, 1, 1, 8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
+
+    if (write_meta_data) {
+        SAIL_TRY_OR_CLEANUP(png_private_write_meta_data(png_ptr, info_ptr, image->meta_data_node),
+                            /* cleanup */ png_destroy_write_struct(&png_ptr, &info_ptr));
+    }
+
+    if (write_iccp) {
+        png_set_iCCP(png_ptr, info_ptr, "ICC profile", PNG_COMPRESSION_TYPE_BASE, (png_const_bytep)image->iccp->data, image->iccp->data_length);
+    }
+
+    png_write_info(png_ptr, info_ptr);
+
+    png_destroy_write_struct(&png_ptr, &info_ptr);
+
+    return SAIL_OK;
+}
+
+bool png_private_can_write_source_data(const struct sail_image *image) {
+
+    if (image->source_image == NULL || image->source_image->data == NULL) {
+        return false;
+    }
+
+    const unsigned char *data = image->source_image->data;
+    const size_t data_size = image->source_image->data_size;
+
+    if (data_size < SIGNATURE_SIZE || png_sig_cmp(data, 0, SIGNATURE_SIZE) != 0) {
+        return false;
+    }
+
+    const char *type;
+    size_t chunk_size;
+    size_t position = SIGNATURE_SIZE;
+
+    /* IHDR payload: width, height. */
+    if (!next_chunk(data, data_size, position, &type, &chunk_size) || !is_chunk(type, "IHDR") || chunk_size != 13 + 12) {
+        return false;
+    }
+
+    if (read_be32(data + position + 8) != image->width || read_be32(data + position + 12) != image->height) {
+        return false;
+    }
+
+    for (; next_chunk(data, data_size, position, &type, &chunk_size); position += chunk_size) {
+        /* Animated images have more than one frame. */
+        if (is_chunk(type, "acTL")) {
+            return false;
+        }
+
+        if (is_chunk(type, "IEND")) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+sail_status_t png_private_write_source_data(struct sail_io *io, const struct sail_image *image, int io_options) {
+
+    const unsigned char *data = image->source_image->data;
+    const size_t data_size = image->source_image->data_size;
+
+    const char *type;
+    size_t chunk_size;
+    size_t position = SIGNATURE_SIZE;
+
+    if (!next_chunk(data, data_size, position, &type, &chunk_size)) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    /* Signature and IHDR. */
+    SAIL_TRY(io->strict_write(io->stream, data, position + chunk_size));
+    position += chunk_size;
+
+    const bool write_iccp = io_options & SAIL_IO_OPTION_ICCP && image->iccp != NULL;
+    SAIL_TRY(write_meta_data_chunks(io, image, io_options, write_iccp));
+
+    for (; next_chunk(data, data_size, position, &type, &chunk_size); position += chunk_size) {
+        /* Meta data and ICC profiles are replaced. sRGB must not appear along with iCCP. */
+        const bool skip = is_chunk(type, "tEXt") || is_chunk(type, "zTXt") || is_chunk(type, "iTXt") ||
+                            is_chunk(type, "eXIf") || is_chunk(type, "iCCP") ||
+                            (write_iccp && is_chunk(type, "sRGB"));
+
+        if (!skip) {
+            SAIL_TRY(io->strict_write(io->stream, data + position, chunk_size));
+        }
+
+        if (is_chunk(type, "IEND")) {
+            return SAIL_OK;
+        }
+    }
+
+    SAIL_LOG_ERROR("PNG: The source data has no IEND chunk");
+    SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+}
@@ -36,6 +36,8 @@
 #include "export.h"
 
 struct sail_iccp;
+struct sail_image;
+struct sail_io;
 struct sail_meta_data_node;
 struct sail_palette;
 struct sail_resolution;
@@ -44,6 +46,12 @@ SAIL_HIDDEN void png_private_my_error_fn(png_structp png_ptr, png_const_charp te
 
 SAIL_HIDDEN void png_private_my_warning_fn(png_structp png_ptr, png_const_charp text);
 
+#ifdef PNG_USER_MEM_SUPPORTED
+SAIL_HIDDEN png_voidp png_private_my_malloc_fn(png_structp png_ptr, png_alloc_size_t size);
+
+SAIL_HIDDEN void png_private_my_free_fn(png_structp png_ptr, png_voidp ptr);
+#endif
+
 SAIL_HIDDEN enum SailPixelFormat png_private_png_color_type_to_pixel_format(int color_type, int bit_depth);
 
 SAIL_HIDDEN sail_status_t png_private_pixel_format_to_png_color_type(enum SailPixelFormat pixel_format, int *color_type, int *bit_depth);
@@ -52,6 +60,9 @@ SAIL_HIDDEN sail_status_t png_private_fetch_meta_data(png_structp png_ptr, png_i
 
 SAIL_HIDDEN sail_status_t png_private_write_meta_data(png_structp png_ptr, png_infop info_ptr, const struct sail_meta_data_node *meta_data_node);
 
+/* Sets the source orientation of the image from the eXIf chunk if any. */
+SAIL_HIDDEN void png_private_fetch_orientation(png_structp png_ptr, png_infop info_ptr, struct sail_image *image);
+
 SAIL_HIDDEN sail_status_t png_private_fetch_iccp(png_structp png_ptr, png_infop info_ptr, struct sail_iccp **iccp);
 
 SAIL_HIDDEN sail_status_t png_private_fetch_palette(png_structp png_ptr, png_infop info_ptr, struct sail_palette **palette);
@@ -61,7 +72,7 @@ SAIL_HIDDEN sail_status_t png_private_blend_source(void *dst_raw, unsigned dst_o
 
 SAIL_HIDDEN sail_status_t png_private_blend_over(void *dst_raw, unsigned dst_offset, const void *src_raw, unsigned width, unsigned bytes_per_pixel);
 
-SAIL_HIDDEN sail_status_t png_private_skip_hidden_frame(unsigned bytes_per_line, unsigned height, png_structp png_ptr, png_infop info_ptr, void **row);
+SAIL_HIDDEN sail_status_t png_private_skip_hidden_frame(size_t bytes_per_line, unsigned height, png_structp png_ptr, png_infop info_ptr, void **row);
 
 SAIL_HIDDEN sail_status_t png_private_alloc_rows(png_bytep **A, unsigned row_length, unsigned height);
 
@@ -72,4 +83,13 @@ SAIL_HIDDEN sail_status_t png_private_fetch_resolution(png_structp png_ptr, png_
 
 SAIL_HIDDEN sail_status_t png_private_write_resolution(png_structp png_ptr, png_infop info_ptr, const struct sail_resolution *resolution);
 
+/* Checks if the image keeps non-animated PNG source data of the same dimensions. */
+SAIL_HIDDEN bool png_private_can_write_source_data(const struct sail_image *image);
+
+/*
+ * Writes the PNG source data of the image unchanged except meta data chunks. Text chunks, EXIF,
+ * and ICC profiles are taken from the image according to the I/O options.
+ */
+SAIL_HIDDEN sail_status_t png_private_write_source_data(struct sail_io *io, const struct sail_image *image, int io_options);
+
 #endif
@@ -32,17 +32,117 @@
 
 #include "io.h"
 
+/* Size of the read-ahead buffer. Bigger reads bypass the buffer. */
+#define READ_BUFFER_SIZE 65536
+
+sail_status_t png_private_init_source(struct png_private_source *source, struct sail_io *io) {
+
+    source->io            = io;
+    source->data          = NULL;
+    source->data_size     = 0;
+    source->buffer        = NULL;
+    source->buffer_length = 0;
+    source->position      = 0;
+
+    /* Read memory-backed streams in place. */
+    const void *data;
+    size_t data_size;
+    size_t position;
+
+    if (io->contents != NULL &&
+            io->contents(io->stream, &data, &data_size) == SAIL_OK &&
+            io->tell(io->stream, &position) == SAIL_OK &&
+            position <= data_size) {
+        source->data      = data;
+        source->data_size = data_size;
+        source->position  = position;
+
+        return SAIL_OK;
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(READ_BUFFER_SIZE, &ptr));
+    source->buffer = ptr;
+
+    return SAIL_OK;
+}
+
+void png_private_destroy_source(struct png_private_source *source) {
+
+    sail_free(source->buffer);
+    source->buffer = NULL;
+}
+
+sail_status_t png_private_sync_source(struct png_private_source *source) {
+
+    struct sail_io *io = source->io;
+
+    if (source->data != NULL) {
+        SAIL_TRY(io->seek(io->stream, (long)source->position, SEEK_SET));
+    } else if (source->position < source->buffer_length) {
+        /* Not an error. Non-seekable streams stay where the buffer ends. */
+        if ((io->features & SAIL_IO_FEATURE_SEEKABLE) == 0) {
+            return SAIL_OK;
+        }
+
+        SAIL_TRY(io->seek(io->stream, -(long)(source->buffer_length - source->position), SEEK_CUR));
+
+        source->buffer_length = 0;
+        source->position      = 0;
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_buffered(struct png_private_source *source, unsigned char *bytes, size_t bytes_size) {
+
+    while (bytes_size > 0) {
+        if (source->position == source->buffer_length) {
+            if (bytes_size >= READ_BUFFER_SIZE) {
+                SAIL_TRY(source->io->strict_read(source->io->stream, bytes, bytes_size));
+                return SAIL_OK;
+            }
+
+            size_t read_size;
+            SAIL_TRY(source->io->tolerant_read(source->io->stream, source->buffer, READ_BUFFER_SIZE, &read_size));
+
+            if (read_size == 0) {
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_EOF);
+            }
+
+            source->buffer_length = read_size;
+            source->position      = 0;
+        }
+
+        const size_t available  = source->buffer_length - source->position;
+        const size_t chunk_size = (bytes_size < available) ? bytes_size : available;
+
+        memcpy(bytes, source->buffer + source->position, chunk_size);
+
+        source->position += chunk_size;
+        bytes            += chunk_size;
+        bytes_size       -= chunk_size;
+    }
+
+    return SAIL_OK;
+}
+
 void png_private_my_read_fn(png_structp png_ptr, png_bytep bytes, png_size_t bytes_size) {
 
     if (png_ptr == NULL) {
         return;
     }
 
-    struct sail_io *io = (struct sail_io *)png_get_io_ptr(png_ptr);
+    struct png_private_source *source = (struct png_private_source *)png_get_io_ptr(png_ptr);
 
-    sail_status_t err = io->strict_read(io->stream, bytes, bytes_size);
+    if (source->data != NULL) {
+        if (bytes_size > source->data_size - source->position) {
+            png_error(png_ptr, "Failed to read from the I/O stream");
+        }
 
-    if (err != SAIL_OK) {
+        memcpy(bytes, source->data + source->position, bytes_size);
+        source->position += bytes_size;
+    } else if (read_buffered(source, bytes, bytes_size) != SAIL_OK) {
         png_error(png_ptr, "Failed to read from the I/O stream");
     }
 }
@@ -26,12 +26,44 @@
 #ifndef SAIL_PNG_IO_H
 #define SAIL_PNG_IO_H
 
+#include <stddef.h>
 #include <stdio.h>
 
 #include <png.h>
 
+#include "error.h"
+
 #include "export.h"
 
+struct sail_io;
+
+/*
+ * Data source for libpng. Memory-backed streams are read in place. Other streams
+ * are read ahead into a buffer, so libpng doesn't call the I/O stream for every chunk header.
+ */
+struct png_private_source {
+    struct sail_io *io;
+
+    /* Contents of memory-backed streams or NULL. */
+    const unsigned char *data;
+    size_t data_size;
+
+    /* Read-ahead buffer for other streams. */
+    unsigned char *buffer;
+    size_t buffer_length;
+
+    /* Position of the next byte to read in the contents or in the buffer. */
+    size_t position;
+};
+
+SAIL_HIDDEN sail_status_t png_private_init_source(struct png_private_source *source, struct sail_io *io);
+
+SAIL_HIDDEN void png_private_destroy_source(struct png_private_source *source);
+
+/* Moves the I/O stream to the first byte not consumed by libpng. */
+SAIL_HIDDEN sail_status_t png_private_sync_source(struct png_private_source *source);
+
+/* libpng read callback. The I/O pointer is a png_private_source. */
 SAIL_HIDDEN void png_private_my_read_fn(png_structp png_ptr, png_bytep bytes, png_size_t bytes_size);
 
 SAIL_HIDDEN void png_private_my_write_fn(png_structp png_ptr, png_bytep bytes, png_size_t bytes_size);
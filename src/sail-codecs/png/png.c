@@ -31,11 +31,13 @@
 #include <string.h>
 
 #include <png.h>
+#include <zlib.h>
 
 #include "sail-common.h"
 
 #include "helpers.h"
 #include "io.h"
+#include "deflate.h"
 
 /*
  * Codec-specific data types.
@@ -45,6 +47,21 @@ static const double COMPRESSION_MIN     = 1;
 static const double COMPRESSION_MAX     = 9;
 static const double COMPRESSION_DEFAULT = 6;
 
+/* Filters and zlib strategies tried by SAIL_ENCODE_PRESET_SMALLEST. */
+static const struct {
+    int filters;
+    int strategy;
+} SMALLEST_CANDIDATES[] = {
+    { PNG_ALL_FILTERS,  Z_FILTERED },
+    { PNG_ALL_FILTERS,  Z_DEFAULT_STRATEGY },
+    { PNG_FILTER_NONE,  Z_DEFAULT_STRATEGY },
+    { PNG_FILTER_SUB,   Z_FILTERED },
+    { PNG_FILTER_UP,    Z_FILTERED },
+    { PNG_FILTER_PAETH, Z_FILTERED },
+};
+
+#define SMALLEST_CANDIDATES_COUNT (sizeof(SMALLEST_CANDIDATES) / sizeof(SMALLEST_CANDIDATES[0]))
+
 /*
  * Codec-specific state.
  */
@@ -61,8 +78,18 @@ struct png_state {
     struct sail_read_options *read_options;
     struct sail_write_options *write_options;
     bool frame_written;
+    bool source_data_written;
+    /* Compression parameters of the written frame. */
+    struct png_private_compression compression;
+    /* The image data has been compressed and written by deflate.c instead of libpng. */
+    bool idat_written;
     int frames;
     int current_frame;
+    /* Whole native frame to refine interlaced passes in before converting it scan line by scan line. */
+    void *interlaced_frame;
+    /* Row pointers into the frame for png_read_image(). */
+    png_bytep *row_pointers;
+    struct png_private_source source;
 
     /* APNG-specific. */
 #ifdef PNG_APNG_SUPPORTED
@@ -93,19 +120,25 @@ static sail_status_t alloc_png_state(struct png_state **png_state) {
     SAIL_TRY(sail_malloc(sizeof(struct png_state), &ptr));
     *png_state = ptr;
 
-    (*png_state)->png_ptr           = NULL;
-    (*png_state)->info_ptr          = NULL;
-    (*png_state)->color_type        = 0;
-    (*png_state)->bit_depth         = 0;
-    (*png_state)->interlace_type    = 0;
-    (*png_state)->first_image       = NULL;
-    (*png_state)->interlaced_passes = 0;
-    (*png_state)->libpng_error      = false;
-    (*png_state)->read_options      = NULL;
-    (*png_state)->write_options     = NULL;
-    (*png_state)->frame_written     = false;
-    (*png_state)->frames            = 0;
-    (*png_state)->current_frame     = 0;
+    (*png_state)->png_ptr             = NULL;
+    (*png_state)->info_ptr            = NULL;
+    (*png_state)->color_type          = 0;
+    (*png_state)->bit_depth           = 0;
+    (*png_state)->interlace_type      = 0;
+    (*png_state)->first_image         = NULL;
+    (*png_state)->interlaced_passes   = 0;
+    (*png_state)->libpng_error        = false;
+    (*png_state)->read_options        = NULL;
+    (*png_state)->write_options       = NULL;
+    (*png_state)->frame_written       = false;
+    (*png_state)->source_data_written = false;
+    (*png_state)->idat_written        = false;
+    (*png_state)->frames              = 0;
+    (*png_state)->current_frame       = 0;
+    (*png_state)->interlaced_frame    = NULL;
+    (*png_state)->row_pointers        = NULL;
+    (*png_state)->source.io           = NULL;
+    (*png_state)->source.buffer       = NULL;
 
     /* APNG-specific. */
 #ifdef PNG_APNG_SUPPORTED
@@ -139,6 +172,11 @@ static void destroy_png_state(struct png_state *png_state) {
     sail_destroy_read_options(png_state->read_options);
     sail_destroy_write_options(png_state->write_options);
 
+    sail_free(png_state->interlaced_frame);
+    sail_free(png_state->row_pointers);
+
+    png_private_destroy_source(&png_state->source);
+
 #ifdef PNG_APNG_SUPPORTED
     sail_free(png_state->temp_scanline);
     sail_free(png_state->scanline_for_skipping);
@@ -153,6 +191,192 @@ static void destroy_png_state(struct png_state *png_state) {
     sail_free(png_state);
 }
 
+/*
+ * png_read_image() reads the whole frame including interlaced passes at once, so it's used only
+ * when nothing must happen between scan lines.
+ */
+static bool can_read_whole_image(const struct png_state *png_state) {
+
+#ifdef PNG_APNG_SUPPORTED
+    if (png_state->is_apng) {
+        return false;
+    }
+#endif
+
+    const struct sail_read_options *read_options = png_state->read_options;
+
+    return read_options->scan_line_converter == NULL &&
+            read_options->cancel_flag == NULL &&
+            read_options->deadline == 0 &&
+            read_options->progress == NULL;
+}
+
+static sail_status_t read_whole_image(struct png_state *png_state, struct sail_image *image) {
+
+    SAIL_CHECK_PTR(image->pixels);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(png_bytep) * image->height, &ptr));
+    png_state->row_pointers = ptr;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        png_state->row_pointers[row] = (png_bytep)image->pixels + (size_t)row * image->bytes_per_line;
+    }
+
+    png_read_image(png_state->png_ptr, png_state->row_pointers);
+
+    sail_free(png_state->row_pointers);
+    png_state->row_pointers = NULL;
+
+    return SAIL_OK;
+}
+
+static int row_filters_to_png_filters(int row_filters) {
+
+    int filters = 0;
+
+    if (row_filters & SAIL_ROW_FILTER_NONE) {
+        filters |= PNG_FILTER_NONE;
+    }
+    if (row_filters & SAIL_ROW_FILTER_SUB) {
+        filters |= PNG_FILTER_SUB;
+    }
+    if (row_filters & SAIL_ROW_FILTER_UP) {
+        filters |= PNG_FILTER_UP;
+    }
+    if (row_filters & SAIL_ROW_FILTER_AVERAGE) {
+        filters |= PNG_FILTER_AVG;
+    }
+    if (row_filters & SAIL_ROW_FILTER_PAETH) {
+        filters |= PNG_FILTER_PAETH;
+    }
+
+    return filters;
+}
+
+static int zlib_strategy_to_zlib(enum SailZlibStrategy zlib_strategy, int filters) {
+
+    switch (zlib_strategy) {
+        case SAIL_ZLIB_STRATEGY_GENERIC:      return Z_DEFAULT_STRATEGY;
+        case SAIL_ZLIB_STRATEGY_FILTERED:     return Z_FILTERED;
+        case SAIL_ZLIB_STRATEGY_HUFFMAN_ONLY: return Z_HUFFMAN_ONLY;
+        case SAIL_ZLIB_STRATEGY_RLE:          return Z_RLE;
+        case SAIL_ZLIB_STRATEGY_FIXED:        return Z_FIXED;
+
+        default: {
+            /* The same strategy libpng picks by default. */
+            return (filters == PNG_FILTER_NONE) ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+        }
+    }
+}
+
+/*
+ * Computes filters and zlib parameters from the encode preset and the compression level.
+ * Explicitly set filters and zlib parameters override the preset.
+ */
+static void compression_from_write_options(const struct sail_write_options *write_options, int color_type, int bit_depth,
+                                           struct png_private_compression *compression) {
+
+    /* The same filters libpng picks by default. */
+    compression->filters     = (color_type == PNG_COLOR_TYPE_PALETTE || bit_depth < 8) ? PNG_FILTER_NONE : PNG_ALL_FILTERS;
+    compression->level       = (int)((write_options->compression_level < COMPRESSION_MIN ||
+                                        write_options->compression_level > COMPRESSION_MAX)
+                                        ? COMPRESSION_DEFAULT
+                                        : write_options->compression_level);
+    compression->window_bits = 15;
+    compression->mem_level   = 8;
+
+    enum SailZlibStrategy zlib_strategy = SAIL_ZLIB_STRATEGY_DEFAULT;
+
+    switch (write_options->encode_preset) {
+        case SAIL_ENCODE_PRESET_FASTEST: {
+            compression->filters = PNG_FILTER_NONE;
+            compression->level   = 1;
+
+            /*
+             * Run-length matching finds runs of repeated bytes only, so it suits images with single-byte pixels.
+             * Flat areas of multi-byte pixels compress much better with regular matching which is as fast at level 1.
+             */
+            if (color_type == PNG_COLOR_TYPE_PALETTE) {
+                zlib_strategy = SAIL_ZLIB_STRATEGY_RLE;
+            } else {
+                zlib_strategy = SAIL_ZLIB_STRATEGY_GENERIC;
+            }
+            break;
+        }
+        case SAIL_ENCODE_PRESET_BALANCED: {
+            compression->filters = PNG_FILTER_SUB | PNG_FILTER_UP;
+            compression->level   = 3;
+            break;
+        }
+        case SAIL_ENCODE_PRESET_SMALLEST: {
+            compression->filters   = PNG_ALL_FILTERS;
+            compression->level     = 9;
+            compression->mem_level = 9;
+            break;
+        }
+
+        default: {
+            break;
+        }
+    }
+
+    if (write_options->row_filters != 0) {
+        compression->filters = row_filters_to_png_filters(write_options->row_filters);
+    }
+
+    if (write_options->zlib_strategy != SAIL_ZLIB_STRATEGY_DEFAULT) {
+        zlib_strategy = write_options->zlib_strategy;
+    }
+
+    compression->strategy = zlib_strategy_to_zlib(zlib_strategy, compression->filters);
+
+    /* zlib doesn't support 256-byte windows in raw deflate streams. */
+    if (write_options->zlib_window_bits >= 8 && write_options->zlib_window_bits <= 15) {
+        compression->window_bits = (write_options->zlib_window_bits == 8) ? 9 : (int)write_options->zlib_window_bits;
+    }
+
+    if (write_options->zlib_mem_level >= 1 && write_options->zlib_mem_level <= 9) {
+        compression->mem_level = (int)write_options->zlib_mem_level;
+    }
+}
+
+/*
+ * Builds the compressions tried by SAIL_ENCODE_PRESET_SMALLEST. Explicitly set filters and zlib strategy
+ * replace the tried ones.
+ */
+static unsigned smallest_candidates(const struct sail_write_options *write_options, const struct png_private_compression *compression,
+                                    struct png_private_compression candidates[SMALLEST_CANDIDATES_COUNT]) {
+
+    unsigned candidates_count = 0;
+
+    for (unsigned i = 0; i < SMALLEST_CANDIDATES_COUNT; i++) {
+        struct png_private_compression candidate = *compression;
+
+        if (write_options->row_filters == 0) {
+            candidate.filters = SMALLEST_CANDIDATES[i].filters;
+        }
+        if (write_options->zlib_strategy == SAIL_ZLIB_STRATEGY_DEFAULT) {
+            candidate.strategy = SMALLEST_CANDIDATES[i].strategy;
+        }
+
+        bool duplicate = false;
+
+        for (unsigned j = 0; j < candidates_count; j++) {
+            if (candidates[j].filters == candidate.filters && candidates[j].strategy == candidate.strategy) {
+                duplicate = true;
+                break;
+            }
+        }
+
+        if (!duplicate) {
+            candidates[candidates_count++] = candidate;
+        }
+    }
+
+    return candidates_count;
+}
+
 /*
  * Decoding functions.
  */
@@ -175,7 +399,14 @@ SAIL_EXPORT sail_status_t sail_codec_read_init_v6_png(struct sail_io *io, const
     SAIL_TRY(sail_copy_read_options(read_options, &png_state->read_options));
 
     /* Initialize PNG. */
-    if ((png_state->png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, png_private_my_error_fn, png_private_my_warning_fn)) == NULL) {
+#ifdef PNG_USER_MEM_SUPPORTED
+    png_state->png_ptr = png_create_read_struct_2(PNG_LIBPNG_VER_STRING, NULL, png_private_my_error_fn, png_private_my_warning_fn,
+                                                  NULL, png_private_my_malloc_fn, png_private_my_free_fn);
+#else
+    png_state->png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, png_private_my_error_fn, png_private_my_warning_fn);
+#endif
+
+    if (png_state->png_ptr == NULL) {
         png_state->libpng_error = true;
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
@@ -191,7 +422,27 @@ SAIL_EXPORT sail_status_t sail_codec_read_init_v6_png(struct sail_io *io, const
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    png_set_read_fn(png_state->png_ptr, io, png_private_my_read_fn);
+    SAIL_TRY(png_private_init_source(&png_state->source, io));
+    png_set_read_fn(png_state->png_ptr, &png_state->source, png_private_my_read_fn);
+
+    /* Trade checksum verification for speed. */
+    switch (png_state->read_options->decode_quality) {
+        case SAIL_DECODE_QUALITY_BALANCED: {
+            png_set_crc_action(png_state->png_ptr, PNG_CRC_DEFAULT, PNG_CRC_QUIET_USE);
+            break;
+        }
+        case SAIL_DECODE_QUALITY_FASTEST: {
+            png_set_crc_action(png_state->png_ptr, PNG_CRC_QUIET_USE, PNG_CRC_QUIET_USE);
+#if defined PNG_SET_OPTION_SUPPORTED && defined PNG_IGNORE_ADLER32
+            png_set_option(png_state->png_ptr, PNG_IGNORE_ADLER32, PNG_OPTION_ON);
+#endif
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
     png_read_info(png_state->png_ptr, png_state->info_ptr);
 
     SAIL_TRY(sail_alloc_image(&png_state->first_image));
@@ -257,6 +508,9 @@ SAIL_EXPORT sail_status_t sail_codec_read_init_v6_png(struct sail_io *io, const
         SAIL_TRY(png_private_fetch_meta_data(png_state->png_ptr, png_state->info_ptr, &png_state->first_image->meta_data_node));
     }
 
+    /* Fetch orientation. */
+    png_private_fetch_orientation(png_state->png_ptr, png_state->info_ptr, png_state->first_image);
+
     /* Fetch ICC profile. */
     if (png_state->read_options->io_options & SAIL_IO_OPTION_ICCP) {
         SAIL_TRY(png_private_fetch_iccp(png_state->png_ptr, png_state->info_ptr, &png_state->first_image->iccp));
@@ -385,11 +639,43 @@ SAIL_EXPORT sail_status_t sail_codec_read_frame_v6_png(void *state, struct sail_
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+    if (can_read_whole_image(png_state)) {
+        SAIL_TRY(read_whole_image(png_state, image));
+        return SAIL_OK;
+    }
+
+    /* Every interlaced pass goes through all the scan lines. */
+    const unsigned rows_total = image->height * (unsigned)png_state->interlaced_passes;
+
+    /*
+     * Interlaced passes refine the same scan lines, so the scan line converter gets them
+     * from a whole native frame after the last pass.
+     */
+    const bool convert_interlaced = png_state->interlaced_passes > 1
+                                        && png_state->read_options != NULL
+                                        && png_state->read_options->scan_line_converter != NULL;
+
+    if (convert_interlaced) {
+        size_t frame_size;
+        SAIL_TRY(sail_multiply_sizes(image->bytes_per_line, image->height, &frame_size));
+
+        sail_free(png_state->interlaced_frame);
+        png_state->interlaced_frame = NULL;
+        SAIL_TRY(sail_malloc(frame_size, &png_state->interlaced_frame));
+    }
+
     for (int current_pass = 0; current_pass < png_state->interlaced_passes; current_pass++) {
     #ifdef PNG_APNG_SUPPORTED
         if (png_state->is_apng) {
             for (unsigned row = 0; row < image->height; row++) {
-                unsigned char *scanline = (unsigned char *)image->pixels + row * image->bytes_per_line;
+                SAIL_TRY(sail_check_read_cancelled(png_state->read_options));
+
+                unsigned char *scanline;
+                if (convert_interlaced) {
+                    scanline = (unsigned char *)png_state->interlaced_frame + row * image->bytes_per_line;
+                } else {
+                    SAIL_TRY(sail_scan_line_buffer(png_state->read_options, image, row, (void **)&scanline));
+                }
 
                 memcpy(scanline, png_state->prev[row], (size_t)png_state->first_image->width * png_state->bytes_per_pixel);
 
@@ -422,19 +708,65 @@ SAIL_EXPORT sail_status_t sail_codec_read_frame_v6_png(void *state, struct sail_
                     } else { /* PNG_DISPOSE_OP_PREVIOUS */
                     }
                 }
+
+                if (!convert_interlaced) {
+                    SAIL_TRY(sail_scan_line_decoded(png_state->read_options, image, row, scanline));
+                }
+
+                sail_report_read_progress(png_state->read_options, (unsigned)current_pass * image->height + row + 1, rows_total);
             }
         } else {
             for (unsigned row = 0; row < image->height; row++) {
-                png_read_row(png_state->png_ptr, (unsigned char *)image->pixels + row * image->bytes_per_line, NULL);
+                SAIL_TRY(sail_check_read_cancelled(png_state->read_options));
+
+                void *scanline;
+                if (convert_interlaced) {
+                    scanline = (unsigned char *)png_state->interlaced_frame + row * image->bytes_per_line;
+                } else {
+                    SAIL_TRY(sail_scan_line_buffer(png_state->read_options, image, row, &scanline));
+                }
+
+                png_read_row(png_state->png_ptr, (png_bytep)scanline, NULL);
+
+                if (!convert_interlaced) {
+                    SAIL_TRY(sail_scan_line_decoded(png_state->read_options, image, row, scanline));
+                }
+
+                sail_report_read_progress(png_state->read_options, (unsigned)current_pass * image->height + row + 1, rows_total);
             }
         }
     #else
         for (unsigned row = 0; row < image->height; row++) {
-            png_read_row(png_state->png_ptr, (unsigned char *)image->pixels + row * image->bytes_per_line, NULL);
+            SAIL_TRY(sail_check_read_cancelled(png_state->read_options));
+
+            void *scanline;
+            if (convert_interlaced) {
+                scanline = (unsigned char *)png_state->interlaced_frame + row * image->bytes_per_line;
+            } else {
+                SAIL_TRY(sail_scan_line_buffer(png_state->read_options, image, row, &scanline));
+            }
+
+            png_read_row(png_state->png_ptr, (png_bytep)scanline, NULL);
+
+            if (!convert_interlaced) {
+                SAIL_TRY(sail_scan_line_decoded(png_state->read_options, image, row, scanline));
+            }
+
+            sail_report_read_progress(png_state->read_options, (unsigned)current_pass * image->height + row + 1, rows_total);
         }
     #endif
     }
 
+    if (convert_interlaced) {
+        for (unsigned row = 0; row < image->height; row++) {
+            SAIL_TRY(sail_scan_line_decoded(png_state->read_options, image, row,
+                                            (unsigned char *)png_state->interlaced_frame + row * image->bytes_per_line));
+        }
+
+        sail_free(png_state->interlaced_frame);
+        png_state->interlaced_frame = NULL;
+    }
+
     return SAIL_OK;
 }
 
@@ -447,6 +779,12 @@ SAIL_EXPORT sail_status_t sail_codec_read_finish_v6_png(void **state, struct sai
 
     *state = NULL;
 
+    /* Leave the I/O stream right after the data consumed by libpng. */
+    if (png_state->source.io != NULL) {
+        SAIL_TRY_OR_EXECUTE(png_private_sync_source(&png_state->source),
+                            /* on error */ SAIL_LOG_WARNING("PNG: Failed to move the I/O stream to the end of the consumed data"));
+    }
+
     if (png_state->png_ptr != NULL) {
         if (setjmp(png_jmpbuf(png_state->png_ptr))) {
             destroy_png_state(png_state);
@@ -489,7 +827,14 @@ SAIL_EXPORT sail_status_t sail_codec_write_init_v6_png(struct sail_io *io, const
     }
 
     /* Initialize PNG. */
-    if ((png_state->png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, png_private_my_error_fn, png_private_my_warning_fn)) == NULL) {
+#ifdef PNG_USER_MEM_SUPPORTED
+    png_state->png_ptr = png_create_write_struct_2(PNG_LIBPNG_VER_STRING, NULL, png_private_my_error_fn, png_private_my_warning_fn,
+                                                   NULL, png_private_my_malloc_fn, png_private_my_free_fn);
+#else
+    png_state->png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, png_private_my_error_fn, png_private_my_warning_fn);
+#endif
+
+    if (png_state->png_ptr == NULL) {
         png_state->libpng_error = true;
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
@@ -524,6 +869,14 @@ SAIL_EXPORT sail_status_t sail_codec_write_seek_next_frame_v6_png(void *state, s
 
     png_state->frame_written = true;
 
+    /* Write the source data unchanged instead of compressing the pixels. */
+    if (png_state->write_options->io_options & SAIL_IO_OPTION_SOURCE_DATA && png_private_can_write_source_data(image)) {
+        SAIL_TRY(png_private_write_source_data(io, image, png_state->write_options->io_options));
+        png_state->source_data_written = true;
+        SAIL_LOG_DEBUG("PNG: Source data has been written");
+        return SAIL_OK;
+    }
+
     /* Error handling setup. */
     if (setjmp(png_jmpbuf(png_state->png_ptr))) {
         png_state->libpng_error = true;
@@ -590,12 +943,13 @@ SAIL_EXPORT sail_status_t sail_codec_write_seek_next_frame_v6_png(void *state, s
     png_set_gAMA(png_state->png_ptr, png_state->info_ptr, image->gamma);
 
     /* Set compression. */
-    const double compression = (png_state->write_options->compression_level < COMPRESSION_MIN ||
-                                png_state->write_options->compression_level > COMPRESSION_MAX)
-                                ? COMPRESSION_DEFAULT
-                                : png_state->write_options->compression_level;
+    compression_from_write_options(png_state->write_options, color_type, bit_depth, &png_state->compression);
 
-    png_set_compression_level(png_state->png_ptr, (int)compression);
+    png_set_filter(png_state->png_ptr, PNG_FILTER_TYPE_BASE, png_state->compression.filters);
+    png_set_compression_level(png_state->png_ptr, png_state->compression.level);
+    png_set_compression_strategy(png_state->png_ptr, png_state->compression.strategy);
+    png_set_compression_window_bits(png_state->png_ptr, png_state->compression.window_bits);
+    png_set_compression_mem_level(png_state->png_ptr, png_state->compression.mem_level);
 
     png_write_info(png_state->png_ptr, png_state->info_ptr);
 
@@ -636,15 +990,41 @@ SAIL_EXPORT sail_status_t sail_codec_write_frame_v6_png(void *state, struct sail
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+    /* Not an error. */
+    if (png_state->source_data_written) {
+        return SAIL_OK;
+    }
+
     /* Error handling setup. */
     if (setjmp(png_jmpbuf(png_state->png_ptr))) {
         png_state->libpng_error = true;
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+    if (png_state->write_options->encode_preset == SAIL_ENCODE_PRESET_SMALLEST) {
+        struct png_private_compression candidates[SMALLEST_CANDIDATES_COUNT];
+        const unsigned candidates_count = smallest_candidates(png_state->write_options, &png_state->compression, candidates);
+
+        SAIL_TRY(png_private_write_frame_smallest(png_state->png_ptr, image, png_state->write_options,
+                                                  candidates, candidates_count, &png_state->idat_written));
+    } else {
+        SAIL_TRY(png_private_write_frame_parallel(png_state->png_ptr, image, png_state->write_options,
+                                                  &png_state->compression, &png_state->idat_written));
+    }
+
+    /* Not an error. */
+    if (png_state->idat_written) {
+        return SAIL_OK;
+    }
+
+    /* Every interlaced pass goes through all the scan lines. */
+    const unsigned rows_total = image->height * (unsigned)png_state->interlaced_passes;
+
     for (int current_pass = 0; current_pass < png_state->interlaced_passes; current_pass++) {
         for (unsigned row = 0; row < image->height; row++) {
+            SAIL_TRY(sail_check_write_cancelled(png_state->write_options));
             png_write_row(png_state->png_ptr, (const unsigned char *)image->pixels + row * image->bytes_per_line);
+            sail_report_write_progress(png_state->write_options, (unsigned)current_pass * image->height + row + 1, rows_total);
         }
     }
 
@@ -664,13 +1044,19 @@ SAIL_EXPORT sail_status_t sail_codec_write_finish_v6_png(void **state, struct sa
     /* Error handling setup. */
     if (png_state->png_ptr != NULL) {
         if (setjmp(png_jmpbuf(png_state->png_ptr))) {
+            png_destroy_write_struct(&png_state->png_ptr, &png_state->info_ptr);
             destroy_png_state(png_state);
             SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
         }
     }
 
-    if (png_state->png_ptr != NULL && !png_state->libpng_error) {
-        png_write_end(png_state->png_ptr, png_state->info_ptr);
+    if (png_state->png_ptr != NULL && !png_state->libpng_error && !png_state->source_data_written) {
+        /* libpng doesn't know about the IDAT chunks written around it. */
+        if (png_state->idat_written) {
+            png_write_chunk(png_state->png_ptr, (png_const_bytep)"IEND", NULL, 0);
+        } else {
+            png_write_end(png_state->png_ptr, png_state->info_ptr);
+        }
     }
 
     if (png_state->png_ptr != NULL) {
@@ -105,6 +105,10 @@ SAIL_EXPORT sail_status_t sail_codec_read_init_v6_qoi(struct sail_io *io, const
     SAIL_TRY(sail_copy_read_options(read_options, &qoi_state->read_options));
 
     /* Cache the entire file as the QOI API requires. */
+    size_t image_data_size;
+    SAIL_TRY(sail_io_size(io, &image_data_size));
+    SAIL_TRY(sail_check_read_limits(qoi_state->read_options, 0, 0, image_data_size));
+
     SAIL_TRY(sail_io_contents_to_data(io, &qoi_state->image_data, &qoi_state->image_data_size));
 
     return SAIL_OK;
@@ -124,6 +128,15 @@ SAIL_EXPORT sail_status_t sail_codec_read_seek_next_frame_v6_qoi(void *state, st
 
     qoi_state->frame_read = true;
 
+    /* qoi_decode() allocates the whole image. Check the header dimensions before that. */
+    if (qoi_state->image_data_size >= QOI_HEADER_SIZE) {
+        const unsigned char *header = qoi_state->image_data;
+        const unsigned width  = ((unsigned)header[4] << 24) | ((unsigned)header[5] << 16) | ((unsigned)header[6] << 8) | header[7];
+        const unsigned height = ((unsigned)header[8] << 24) | ((unsigned)header[9] << 16) | ((unsigned)header[10] << 8) | header[11];
+
+        SAIL_TRY(sail_check_read_limits(qoi_state->read_options, width, height, (size_t)width * height * 4)); /* 4 = RGBA at most */
+    }
+
     /* Decode the image. */
     /* TODO Remove (int) when QOI supports size_t. */
     qoi_state->pixels = qoi_decode(qoi_state->image_data, (int)qoi_state->image_data_size, &qoi_state->qoi_desc, 0);
@@ -244,19 +257,40 @@ SAIL_EXPORT sail_status_t sail_codec_write_seek_next_frame_v6_qoi(void *state, s
         }
     }
 
+    /* QOI encodes tightly packed pixels only. Pack padded rows and views first. */
+    const size_t bytes_per_line = (size_t)image->width * channels;
+    const void *pixels = image->pixels;
+    void *packed_pixels = NULL;
+
+    if (image->bytes_per_line != bytes_per_line) {
+        SAIL_TRY(sail_malloc(bytes_per_line * image->height, &packed_pixels));
+
+        for (unsigned row = 0; row < image->height; row++) {
+            memcpy((unsigned char *)packed_pixels + bytes_per_line * row,
+                   (const unsigned char *)image->pixels + image->bytes_per_line * row,
+                   bytes_per_line);
+        }
+
+        pixels = packed_pixels;
+    }
+
     int written;
-    qoi_state->pixels = qoi_encode(image->pixels, &(qoi_desc){
+    qoi_state->pixels = qoi_encode(pixels, &(qoi_desc){
     	                    .width      = image->width,
                     	    .height     = image->height,
                         	.channels   = channels,
                         	.colorspace = QOI_SRGB
                         }, &written);
 
+    sail_free(packed_pixels);
+
     if (qoi_state->pixels == NULL) {
         SAIL_LOG_ERROR("QOI: Encoding failed without any details");
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+    qoi_state->image_data_size = (size_t)written;
+
     return SAIL_OK;
 }
 
@@ -268,9 +302,7 @@ SAIL_EXPORT sail_status_t sail_codec_write_frame_v6_qoi(void *state, struct sail
 
     struct qoi_state *qoi_state = (struct qoi_state *)state;
 
-    const size_t pixels_size = (size_t)image->bytes_per_line * image->height;
-
-    SAIL_TRY(io->strict_write(io->stream, qoi_state->pixels, pixels_size));
+    SAIL_TRY(io->strict_write(io->stream, qoi_state->pixels, qoi_state->image_data_size));
 
     return SAIL_OK;
 }
@@ -0,0 +1,255 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "sail-common.h"
+
+/*
+ * Codec-specific state.
+ */
+struct sailraw_state {
+    struct sail_read_options *read_options;
+    struct sail_write_options *write_options;
+
+    bool frame_read;
+    bool frame_written;
+};
+
+static sail_status_t alloc_sailraw_state(struct sailraw_state **sailraw_state) {
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sailraw_state), &ptr));
+    *sailraw_state = ptr;
+
+    (*sailraw_state)->read_options  = NULL;
+    (*sailraw_state)->write_options = NULL;
+
+    (*sailraw_state)->frame_read    = false;
+    (*sailraw_state)->frame_written = false;
+
+    return SAIL_OK;
+}
+
+static void destroy_sailraw_state(struct sailraw_state *sailraw_state) {
+
+    if (sailraw_state == NULL) {
+        return;
+    }
+
+    sail_destroy_read_options(sailraw_state->read_options);
+    sail_destroy_write_options(sailraw_state->write_options);
+
+    sail_free(sailraw_state);
+}
+
+/*
+ * Decoding functions.
+ */
+
+SAIL_EXPORT sail_status_t sail_codec_read_init_v6_sailraw(struct sail_io *io, const struct sail_read_options *read_options, void **state) {
+
+    SAIL_CHECK_PTR(state);
+    *state = NULL;
+
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_CHECK_PTR(read_options);
+
+    /* Allocate a new state. */
+    struct sailraw_state *sailraw_state;
+    SAIL_TRY(alloc_sailraw_state(&sailraw_state));
+    *state = sailraw_state;
+
+    /* Deep copy read options. */
+    SAIL_TRY(sail_copy_read_options(read_options, &sailraw_state->read_options));
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_read_seek_next_frame_v6_sailraw(void *state, struct sail_io *io, struct sail_image **image) {
+
+    SAIL_CHECK_PTR(state);
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_CHECK_PTR(image);
+
+    struct sailraw_state *sailraw_state = (struct sailraw_state *)state;
+
+    if (sailraw_state->frame_read) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    sailraw_state->frame_read = true;
+
+    /* The I/O object is positioned at the pixels after this call. */
+    struct sail_image *image_local;
+    size_t pixels_offset;
+    SAIL_TRY(sail_read_raw_image_skeleton(io, sailraw_state->read_options, &image_local, &pixels_offset));
+
+    if (!(sailraw_state->read_options->io_options & SAIL_IO_OPTION_META_DATA)) {
+        sail_destroy_meta_data_node_chain(image_local->meta_data_node);
+        image_local->meta_data_node = NULL;
+    }
+
+    if (!(sailraw_state->read_options->io_options & SAIL_IO_OPTION_ICCP)) {
+        sail_destroy_iccp(image_local->iccp);
+        image_local->iccp = NULL;
+    }
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_read_frame_v6_sailraw(void *state, struct sail_io *io, struct sail_image *image) {
+
+    SAIL_CHECK_PTR(state);
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_TRY(sail_check_image_skeleton_valid(image));
+
+    const struct sailraw_state *sailraw_state = (struct sailraw_state *)state;
+
+    /* Pixels are stored exactly as in memory, so read them in chunks to report progress and check cancellation. */
+    const unsigned rows_per_chunk = 64;
+
+    for (unsigned row = 0; row < image->height; row += rows_per_chunk) {
+        SAIL_TRY(sail_check_read_cancelled(sailraw_state->read_options));
+
+        const unsigned rows = (image->height - row < rows_per_chunk) ? image->height - row : rows_per_chunk;
+
+        SAIL_TRY(io->strict_read(io->stream,
+                                    (unsigned char *)image->pixels + (size_t)row * image->bytes_per_line,
+                                    (size_t)rows * image->bytes_per_line));
+
+        sail_report_read_progress(sailraw_state->read_options, row + rows, image->height);
+    }
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_read_finish_v6_sailraw(void **state, struct sail_io *io) {
+
+    SAIL_CHECK_PTR(state);
+    SAIL_TRY(sail_check_io_valid(io));
+
+    struct sailraw_state *sailraw_state = (struct sailraw_state *)(*state);
+
+    *state = NULL;
+
+    destroy_sailraw_state(sailraw_state);
+
+    return SAIL_OK;
+}
+
+/*
+ * Encoding functions.
+ */
+
+SAIL_EXPORT sail_status_t sail_codec_write_init_v6_sailraw(struct sail_io *io, const struct sail_write_options *write_options, void **state) {
+
+    SAIL_CHECK_PTR(state);
+    *state = NULL;
+
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_CHECK_PTR(write_options);
+
+    struct sailraw_state *sailraw_state;
+    SAIL_TRY(alloc_sailraw_state(&sailraw_state));
+
+    *state = sailraw_state;
+
+    /* Deep copy write options. */
+    SAIL_TRY(sail_copy_write_options(write_options, &sailraw_state->write_options));
+
+    /* Sanity check. */
+    if (sailraw_state->write_options->compression != SAIL_COMPRESSION_NONE) {
+        SAIL_LOG_ERROR("SAILRAW: Only NONE compression is allowed for writing");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+    }
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_write_seek_next_frame_v6_sailraw(void *state, struct sail_io *io, const struct sail_image *image) {
+
+    SAIL_CHECK_PTR(state);
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_TRY(sail_check_image_valid(image));
+
+    struct sailraw_state *sailraw_state = (struct sailraw_state *)state;
+
+    if (sailraw_state->frame_written) {
+        SAIL_LOG_ERROR("SAILRAW: Only single frame can be written");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    sailraw_state->frame_written = true;
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_write_frame_v6_sailraw(void *state, struct sail_io *io, const struct sail_image *image) {
+
+    SAIL_CHECK_PTR(state);
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_TRY(sail_check_image_valid(image));
+
+    const struct sailraw_state *sailraw_state = (struct sailraw_state *)state;
+
+    SAIL_TRY(sail_check_write_cancelled(sailraw_state->write_options));
+
+    /* Shallow copy to drop the data not requested by the write options. */
+    struct sail_image image_to_write = *image;
+
+    if (!(sailraw_state->write_options->io_options & SAIL_IO_OPTION_META_DATA)) {
+        image_to_write.meta_data_node = NULL;
+    }
+
+    if (!(sailraw_state->write_options->io_options & SAIL_IO_OPTION_ICCP)) {
+        image_to_write.iccp = NULL;
+    }
+
+    SAIL_TRY(sail_write_raw_image(io, &image_to_write));
+
+    sail_report_write_progress(sailraw_state->write_options, image->height, image->height);
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_write_finish_v6_sailraw(void **state, struct sail_io *io) {
+
+    SAIL_CHECK_PTR(state);
+    SAIL_TRY(sail_check_io_valid(io));
+
+    struct sailraw_state *sailraw_state = (struct sailraw_state *)(*state);
+
+    /* Subsequent calls to finish() will expectedly fail in the above line. */
+    *state = NULL;
+
+    destroy_sailraw_state(sailraw_state);
+
+    return SAIL_OK;
+}
@@ -225,8 +225,16 @@ SAIL_EXPORT sail_status_t sail_codec_read_frame_v6_tga(void *state, struct sail_
             const unsigned pixels_num = image->width * image->height;
 
             unsigned char *pixels = image->pixels;
+            unsigned next_cancellation_check = 0;
 
             for (unsigned i = 0; i < pixels_num;) {
+                /* Check for cancellation and report progress once per scan line. */
+                if (i >= next_cancellation_check) {
+                    SAIL_TRY(sail_check_read_cancelled(tga_state->read_options));
+                    sail_report_read_progress(tga_state->read_options, i / image->width, image->height);
+                    next_cancellation_check = i + image->width;
+                }
+
                 unsigned char marker;
                 SAIL_TRY(io->strict_read(io->stream, &marker, 1));
 
@@ -260,6 +268,8 @@ SAIL_EXPORT sail_status_t sail_codec_read_frame_v6_tga(void *state, struct sail_
         sail_flip_horizontally(image);
     }
 
+    sail_report_read_progress(tga_state->read_options, image->height, image->height);
+
     return SAIL_OK;
 }
 
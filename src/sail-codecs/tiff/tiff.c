@@ -82,6 +82,22 @@ static void destroy_tiff_state(struct tiff_state *tiff_state) {
     sail_free(tiff_state);
 }
 
+static bool is_bottom_orientation(uint16_t orientation) {
+
+    return orientation == ORIENTATION_BOTRIGHT || orientation == ORIENTATION_BOTLEFT ||
+            orientation == ORIENTATION_RIGHTBOT || orientation == ORIENTATION_LEFTBOT;
+}
+
+/* Returns true if libtiff flips the stored rows vertically to get the requested orientation. */
+static bool flips_vertically(const TIFFRGBAImage *image) {
+
+    if (image->orientation < ORIENTATION_TOPLEFT || image->orientation > ORIENTATION_LEFTBOT) {
+        return false;
+    }
+
+    return is_bottom_orientation(image->orientation) != is_bottom_orientation(image->req_orientation);
+}
+
 /*
  * Decoding functions.
  */
@@ -162,7 +178,20 @@ SAIL_EXPORT sail_status_t sail_codec_read_seek_next_frame_v6_tiff(void *state, s
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    tiff_state->image.req_orientation = ORIENTATION_TOPLEFT;
+    /* TIFF orientations match the EXIF ones. */
+    const enum SailOrientation orientation = (tiff_state->image.orientation >= ORIENTATION_TOPLEFT && tiff_state->image.orientation <= ORIENTATION_LEFTBOT)
+                                                ? (enum SailOrientation)tiff_state->image.orientation
+                                                : SAIL_ORIENTATION_NORMAL;
+    sail_set_source_orientation(image_local, orientation);
+
+    if (tiff_state->read_options->io_options & SAIL_IO_OPTION_APPLY_ORIENTATION) {
+        /* Decode the stored pixels as is. SAIL orients them afterwards. */
+        tiff_state->image.req_orientation = tiff_state->image.orientation;
+    } else {
+        /* libtiff flips the pixels into the top-left orientation, but never transposes them. */
+        tiff_state->image.req_orientation = ORIENTATION_TOPLEFT;
+        image_local->properties &= ~sail_orientation_flip_properties(orientation);
+    }
 
     /* Fill the image properties. */
     if (!TIFFGetField(tiff_state->tiff, TIFFTAG_IMAGEWIDTH,  &image_local->width) || !TIFFGetField(tiff_state->tiff, TIFFTAG_IMAGELENGTH, &image_local->height)) {
@@ -222,8 +251,49 @@ SAIL_EXPORT sail_status_t sail_codec_read_frame_v6_tiff(void *state, struct sail
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    if (!TIFFRGBAImageGet(&tiff_state->image, image->pixels, image->width, image->height)) {
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    /* Skip the frame. The next directory is selected by index. */
+    if (image->pixels == NULL) {
+        TIFFRGBAImageEnd(&tiff_state->image);
+        return SAIL_OK;
+    }
+
+    /* Decode strip by strip, or tile row by tile row, to report progress and check cancellation in between. */
+    uint32_t rows_per_chunk = 0;
+
+    if (TIFFIsTiled(tiff_state->tiff)) {
+        TIFFGetField(tiff_state->tiff, TIFFTAG_TILELENGTH, &rows_per_chunk);
+    } else {
+        TIFFGetFieldDefaulted(tiff_state->tiff, TIFFTAG_ROWSPERSTRIP, &rows_per_chunk);
+    }
+
+    if (rows_per_chunk == 0 || rows_per_chunk > image->height) {
+        rows_per_chunk = image->height;
+    }
+
+    /* libtiff flips the rows within every chunk, so flipped chunks are placed in the reverse order. */
+    const bool flip_vertically = flips_vertically(&tiff_state->image);
+
+    for (unsigned row = 0; row < image->height; row += rows_per_chunk) {
+        /* Release the decoder buffers while the TIFF object is still alive. */
+        SAIL_TRY_OR_CLEANUP(sail_check_read_cancelled(tiff_state->read_options),
+                            /* cleanup */ TIFFRGBAImageEnd(&tiff_state->image));
+
+        const unsigned rows       = (rows_per_chunk < image->height - row) ? rows_per_chunk : image->height - row;
+        const unsigned target_row = flip_vertically ? image->height - row - rows : row;
+
+        /* Like TIFFReadRGBAStrip(), but keeps the requested orientation. */
+        tiff_state->image.row_offset = (int)row;
+        tiff_state->image.col_offset = 0;
+
+        if (!TIFFRGBAImageGet(&tiff_state->image,
+                              (uint32_t *)((unsigned char *)image->pixels + (size_t)target_row * image->bytes_per_line),
+                              image->width,
+                              rows)) {
+            TIFFRGBAImageEnd(&tiff_state->image);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        sail_report_read_progress(tiff_state->read_options, row + rows, image->height);
     }
 
     TIFFRGBAImageEnd(&tiff_state->image);
@@ -356,9 +426,13 @@ SAIL_EXPORT sail_status_t sail_codec_write_frame_v6_tiff(void *state, struct sai
     }
 
     for (unsigned row = 0; row < image->height; row++) {
+        SAIL_TRY(sail_check_write_cancelled(tiff_state->write_options));
+
         if (TIFFWriteScanline(tiff_state->tiff, (unsigned char *)image->pixels + row * image->bytes_per_line, tiff_state->line++, 0) < 0) {
             SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
         }
+
+        sail_report_write_progress(tiff_state->write_options, row + 1, image->height);
     }
 
     if (!TIFFWriteDirectory(tiff_state->tiff)) {
@@ -155,6 +155,11 @@ SAIL_EXPORT sail_status_t sail_codec_read_frame_v6_wal(void *state, struct sail_
     SAIL_TRY(sail_check_io_valid(io));
     SAIL_TRY(sail_check_image_skeleton_valid(image));
 
+    /* Skip the frame. The next frame is found with the offsets table. */
+    if (image->pixels == NULL) {
+        return SAIL_OK;
+    }
+
     SAIL_TRY(io->strict_read(io->stream, image->pixels, (size_t)image->bytes_per_line * image->height));
 
     return SAIL_OK;
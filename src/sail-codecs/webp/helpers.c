@@ -29,7 +29,7 @@
 
 #include "helpers.h"
 
-void webp_private_fill_color(uint8_t *pixels, unsigned bytes_per_line, unsigned bytes_per_pixel,
+void webp_private_fill_color(uint8_t *pixels, size_t bytes_per_line, unsigned bytes_per_pixel,
                                 uint32_t color, unsigned x, unsigned y, unsigned width, unsigned height) {
 
     uint8_t *scanline = pixels + y * bytes_per_line + x * bytes_per_pixel;
@@ -141,3 +141,69 @@ sail_status_t webp_private_fetch_meta_data(WebPDemuxer *webp_demux, struct sail_
 
     return SAIL_OK;
 }
+
+void webp_private_fetch_orientation(WebPDemuxer *webp_demux, struct sail_image *image) {
+
+    const uint32_t webp_flags = WebPDemuxGetI(webp_demux, WEBP_FF_FORMAT_FLAGS);
+
+    if ((webp_flags & EXIF_FLAG) == 0) {
+        return;
+    }
+
+    WebPChunkIterator chunk_iterator;
+
+    if (WebPDemuxGetChunk(webp_demux, "EXIF", 1, &chunk_iterator)) {
+        enum SailOrientation orientation;
+
+        if (sail_exif_orientation(chunk_iterator.chunk.bytes, chunk_iterator.chunk.size, &orientation)) {
+            SAIL_LOG_TRACE("WEBP: EXIF orientation %d", orientation);
+            sail_set_source_orientation(image, orientation);
+        }
+
+        WebPDemuxReleaseChunkIterator(&chunk_iterator);
+    }
+}
+
+sail_status_t webp_private_decode_rgba_into(const uint8_t *data, size_t data_size,
+                                            uint8_t *output, size_t output_size, unsigned stride,
+                                            enum SailDecodeQuality decode_quality) {
+
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(output);
+
+    WebPDecoderConfig config;
+
+    if (!WebPInitDecoderConfig(&config)) {
+        SAIL_LOG_ERROR("WEBP: Failed to initialize decoder config");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    /* Trade quality for speed. */
+    switch (decode_quality) {
+        case SAIL_DECODE_QUALITY_BALANCED: {
+            config.options.no_fancy_upsampling = 1;
+            break;
+        }
+        case SAIL_DECODE_QUALITY_FASTEST: {
+            config.options.no_fancy_upsampling = 1;
+            config.options.bypass_filtering    = 1;
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    config.output.colorspace         = MODE_RGBA;
+    config.output.is_external_memory = 1;
+    config.output.u.RGBA.rgba        = output;
+    config.output.u.RGBA.stride      = (int)stride;
+    config.output.u.RGBA.size        = output_size;
+
+    if (WebPDecode(data, data_size, &config) != VP8_STATUS_OK) {
+        SAIL_LOG_ERROR("WEBP: Failed to decode image");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    return SAIL_OK;
+}
@@ -28,13 +28,18 @@
 
 #include <stdint.h>
 
+#include <webp/decode.h>
 #include <webp/demux.h>
 
 #include "common.h"
 #include "error.h"
 #include "export.h"
 
-SAIL_HIDDEN void webp_private_fill_color(uint8_t *pixels, unsigned bytes_per_line, unsigned bytes_per_pixel,
+struct sail_iccp;
+struct sail_image;
+struct sail_meta_data_node;
+
+SAIL_HIDDEN void webp_private_fill_color(uint8_t *pixels, size_t bytes_per_line, unsigned bytes_per_pixel,
                                             uint32_t color, unsigned x, unsigned y, unsigned width, unsigned height);
 
 SAIL_HIDDEN sail_status_t webp_private_blend_over(void *dst_raw, unsigned dst_offset, const void *src_raw,
@@ -44,4 +49,10 @@ SAIL_HIDDEN sail_status_t webp_private_fetch_iccp(WebPDemuxer *webp_demux, struc
 
 SAIL_HIDDEN sail_status_t webp_private_fetch_meta_data(WebPDemuxer *webp_demux, struct sail_meta_data_node **last_meta_data_node);
 
+SAIL_HIDDEN void webp_private_fetch_orientation(WebPDemuxer *webp_demux, struct sail_image *image);
+
+SAIL_HIDDEN sail_status_t webp_private_decode_rgba_into(const uint8_t *data, size_t data_size,
+                                                        uint8_t *output, size_t output_size, unsigned stride,
+                                                        enum SailDecodeQuality decode_quality);
+
 #endif
@@ -139,6 +139,9 @@ SAIL_EXPORT sail_status_t sail_codec_read_init_v6_webp(struct sail_io *io, const
 
     SAIL_TRY(io->seek(io->stream, 0, SEEK_SET));
 
+    /* The size comes from the RIFF header. Check it before allocating. */
+    SAIL_TRY(sail_check_read_limits(webp_state->read_options, 0, 0, webp_state->image_data_size));
+
     void *ptr;
     SAIL_TRY(sail_malloc(webp_state->image_data_size, &ptr));
     webp_state->image_data = ptr;
@@ -171,6 +174,13 @@ SAIL_EXPORT sail_status_t sail_codec_read_init_v6_webp(struct sail_io *io, const
     image_local->pixel_format = SAIL_PIXEL_FORMAT_BPP32_RGBA;
     SAIL_TRY_OR_CLEANUP(sail_bytes_per_line(image_local->width, image_local->pixel_format, &image_local->bytes_per_line),
                         /* cleanup */ sail_destroy_image(image_local));
+
+    /* The canvas is allocated with the first frame. Check its size early. */
+    SAIL_TRY_OR_CLEANUP(sail_check_read_limits(webp_state->read_options,
+                                                image_local->width,
+                                                image_local->height,
+                                                (size_t)image_local->bytes_per_line * image_local->height),
+                        /* cleanup */ sail_destroy_image(image_local));
     webp_state->bytes_per_pixel = image_local->bytes_per_line / image_local->width;
 
     /* Fetch ICCP. */
@@ -185,6 +195,9 @@ SAIL_EXPORT sail_status_t sail_codec_read_init_v6_webp(struct sail_io *io, const
                             /* cleanup */ sail_destroy_image(image_local));
     }
 
+    /* Fetch orientation. */
+    webp_private_fetch_orientation(webp_state->webp_demux, image_local);
+
     webp_state->canvas_image = image_local;
 
     return SAIL_OK;
@@ -271,26 +284,25 @@ SAIL_EXPORT sail_status_t sail_codec_read_frame_v6_webp(void *state, struct sail
 
     switch (webp_state->frame_blend_method) {
         case WEBP_MUX_NO_BLEND: {
-            if (WebPDecodeRGBAInto(webp_state->webp_iterator->fragment.bytes,
-                                    webp_state->webp_iterator->fragment.size,
-                                    (uint8_t *)webp_state->canvas_image->pixels + webp_state->canvas_image->bytes_per_line * webp_state->frame_y +
-                                        webp_state->frame_x * webp_state->bytes_per_pixel,
-                                    (size_t)webp_state->canvas_image->bytes_per_line * webp_state->canvas_image->height,
-                                    webp_state->canvas_image->bytes_per_line) == NULL) {
-                SAIL_LOG_ERROR("WEBP: Failed to decode image");
-                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
-            }
+            /* The frame is decoded right into the canvas. Its buffer ends where the canvas ends. */
+            const size_t frame_offset = (size_t)webp_state->canvas_image->bytes_per_line * webp_state->frame_y +
+                                            webp_state->frame_x * webp_state->bytes_per_pixel;
+
+            SAIL_TRY(webp_private_decode_rgba_into(webp_state->webp_iterator->fragment.bytes,
+                                                   webp_state->webp_iterator->fragment.size,
+                                                   (uint8_t *)webp_state->canvas_image->pixels + frame_offset,
+                                                   (size_t)webp_state->canvas_image->bytes_per_line * webp_state->canvas_image->height - frame_offset,
+                                                   webp_state->canvas_image->bytes_per_line,
+                                                   webp_state->read_options->decode_quality));
             break;
         }
         case WEBP_MUX_BLEND: {
-            if (WebPDecodeRGBAInto(webp_state->webp_iterator->fragment.bytes,
-                                    webp_state->webp_iterator->fragment.size,
-                                    image->pixels,
-                                    (size_t)image->bytes_per_line * image->height,
-                                    webp_state->frame_width * webp_state->bytes_per_pixel) == NULL) {
-                SAIL_LOG_ERROR("WEBP: Failed to decode image");
-                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
-            }
+            SAIL_TRY(webp_private_decode_rgba_into(webp_state->webp_iterator->fragment.bytes,
+                                                   webp_state->webp_iterator->fragment.size,
+                                                   image->pixels,
+                                                   (size_t)image->bytes_per_line * image->height,
+                                                   webp_state->frame_width * webp_state->bytes_per_pixel,
+                                                   webp_state->read_options->decode_quality));
 
             uint8_t *dst_scanline = (uint8_t *)webp_state->canvas_image->pixels + webp_state->frame_y * image->bytes_per_line + webp_state->frame_x * webp_state->bytes_per_pixel;
             uint8_t *src_scanline = image->pixels;
@@ -40,6 +40,23 @@ static MunitResult test_able_to_load(const MunitParameter params[], void *user_d
     return MUNIT_OK;
 }
 
+static MunitResult test_able_to_load_from_io(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    sail::io_file io_file(path);
+    sail::image_input image_input;
+    munit_assert(image_input.start(io_file) == SAIL_OK);
+
+    sail::image image;
+    munit_assert(image_input.next_frame(&image) == SAIL_OK);
+    munit_assert(image.is_valid());
+    munit_assert(image_input.stop() == SAIL_OK);
+
+    return MUNIT_OK;
+}
+
 static MunitParameterEnum test_params[] = {
     { (char *)"path", (char **)SAIL_TEST_IMAGES },
     { NULL, NULL },
@@ -47,6 +64,7 @@ static MunitParameterEnum test_params[] = {
 
 static MunitTest test_suite_tests[] = {
     { (char *)"/able-to-load", test_able_to_load, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/able-to-load-from-io", test_able_to_load_from_io, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
 
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
@@ -24,6 +24,7 @@
 */
 
 #include <utility>
+#include <vector>
 
 #include "sail-c++.h"
 
@@ -69,8 +70,80 @@ static MunitResult test_write_options(const MunitParameter params[], void *user_
     return MUNIT_OK;
 }
 
+static MunitResult test_cancel(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const sail::codec_info codec_info = sail::codec_info::from_extension("png");
+
+    if (!codec_info.is_valid()) {
+        return MUNIT_SKIP;
+    }
+
+    std::vector<unsigned char> pixels(64 * 64 * 3, 0x80);
+    const sail::image image(pixels.data(), SAIL_PIXEL_FORMAT_BPP24_RGB, 64, 64);
+
+    // The cancellation flag must reach the codec through the C write options
+    const volatile int cancel_flag = 1;
+
+    sail::write_options write_options;
+    munit_assert(codec_info.write_features().to_write_options(&write_options) == SAIL_OK);
+    write_options.with_cancel_flag(&cancel_flag);
+
+    std::vector<unsigned char> buffer(64 * 1024);
+
+    sail::image_output image_output;
+    munit_assert(image_output.start(buffer.data(), buffer.size(), codec_info, write_options) == SAIL_OK);
+    munit_assert(image_output.next_frame(image) == SAIL_ERROR_CANCELLED);
+    image_output.stop();
+
+    return MUNIT_OK;
+}
+
+static void on_progress(void *user_data, unsigned rows_done, unsigned rows_total) {
+
+    (void)rows_done;
+    (void)rows_total;
+
+    (*static_cast<unsigned *>(user_data))++;
+}
+
+static MunitResult test_progress(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const sail::codec_info codec_info = sail::codec_info::from_extension("png");
+
+    if (!codec_info.is_valid()) {
+        return MUNIT_SKIP;
+    }
+
+    std::vector<unsigned char> pixels(64 * 64 * 3, 0x80);
+    const sail::image image(pixels.data(), SAIL_PIXEL_FORMAT_BPP24_RGB, 64, 64);
+
+    // The progress callback must reach the codec through the C write options
+    unsigned progress_calls = 0;
+
+    sail::write_options write_options;
+    munit_assert(codec_info.write_features().to_write_options(&write_options) == SAIL_OK);
+    write_options.with_progress(on_progress, &progress_calls);
+
+    std::vector<unsigned char> buffer(64 * 1024);
+
+    sail::image_output image_output;
+    munit_assert(image_output.start(buffer.data(), buffer.size(), codec_info, write_options) == SAIL_OK);
+    munit_assert(image_output.next_frame(image) == SAIL_OK);
+    munit_assert(image_output.stop() == SAIL_OK);
+
+    munit_assert_uint(progress_calls, ==, 64);
+
+    return MUNIT_OK;
+}
+
 static MunitTest test_suite_tests[] = {
     { (char *)"/write-options", test_write_options, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/cancel",        test_cancel,        NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/progress",      test_progress,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
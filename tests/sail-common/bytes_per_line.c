@@ -31,7 +31,7 @@ static MunitResult test_indexed(const MunitParameter params[], void *user_data)
     (void)params;
     (void)user_data;
 
-    unsigned result;
+    size_t result;
 
     /* 1-bit indexed. */
     munit_assert(sail_bytes_per_line(7, SAIL_PIXEL_FORMAT_BPP1_INDEXED, &result) == SAIL_OK);
@@ -77,7 +77,7 @@ static MunitResult test_grayscale(const MunitParameter params[], void *user_data
     (void)params;
     (void)user_data;
 
-    unsigned result;
+    size_t result;
 
     /* 1-bit grayscale. */
     munit_assert(sail_bytes_per_line(7, SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE, &result) == SAIL_OK);
@@ -130,7 +130,7 @@ static MunitResult test_grayscale_alpha(const MunitParameter params[], void *use
     (void)params;
     (void)user_data;
 
-    unsigned result;
+    size_t result;
 
     /* 4-bit grayscale-alpha. */
     munit_assert(sail_bytes_per_line(9, SAIL_PIXEL_FORMAT_BPP4_GRAYSCALE_ALPHA, &result) == SAIL_OK);
@@ -170,7 +170,7 @@ static MunitResult test_rgb_555_565(const MunitParameter params[], void *user_da
     (void)params;
     (void)user_data;
 
-    unsigned result;
+    size_t result;
 
     /* RGB-555. */
     munit_assert(sail_bytes_per_line(10, SAIL_PIXEL_FORMAT_BPP16_RGB555, &result) == SAIL_OK);
@@ -207,7 +207,7 @@ static MunitResult test_rgb(const MunitParameter params[], void *user_data) {
     (void)params;
     (void)user_data;
 
-    unsigned result;
+    size_t result;
 
     /* 24-bit RGB. */
     munit_assert(sail_bytes_per_line(10, SAIL_PIXEL_FORMAT_BPP24_RGB, &result) == SAIL_OK);
@@ -230,7 +230,7 @@ static MunitResult test_rgba(const MunitParameter params[], void *user_data) {
     (void)params;
     (void)user_data;
 
-    unsigned result;
+    size_t result;
 
     /* 32-bit RGBA. */
     munit_assert(sail_bytes_per_line(10, SAIL_PIXEL_FORMAT_BPP32_RGBA, &result) == SAIL_OK);
@@ -253,7 +253,7 @@ static MunitResult test_cmyk(const MunitParameter params[], void *user_data) {
     (void)params;
     (void)user_data;
 
-    unsigned result;
+    size_t result;
 
     /* 32-bit CMYK. */
     munit_assert(sail_bytes_per_line(10, SAIL_PIXEL_FORMAT_BPP32_CMYK, &result) == SAIL_OK);
@@ -276,7 +276,7 @@ static MunitResult test_ycbcr(const MunitParameter params[], void *user_data) {
     (void)params;
     (void)user_data;
 
-    unsigned result;
+    size_t result;
 
     /* 24-bit YCbCr. */
     munit_assert(sail_bytes_per_line(10, SAIL_PIXEL_FORMAT_BPP24_YCBCR, &result) == SAIL_OK);
@@ -292,7 +292,7 @@ static MunitResult test_ycck(const MunitParameter params[], void *user_data) {
     (void)params;
     (void)user_data;
 
-    unsigned result;
+    size_t result;
 
     /* 32-bit YCbCr. */
     munit_assert(sail_bytes_per_line(10, SAIL_PIXEL_FORMAT_BPP32_YCCK, &result) == SAIL_OK);
@@ -308,7 +308,7 @@ static MunitResult test_cie_lab(const MunitParameter params[], void *user_data)
     (void)params;
     (void)user_data;
 
-    unsigned result;
+    size_t result;
 
     /* 24-bit CIE-LAB. */
     munit_assert(sail_bytes_per_line(10, SAIL_PIXEL_FORMAT_BPP24_CIE_LAB, &result) == SAIL_OK);
@@ -327,6 +327,35 @@ static MunitResult test_cie_lab(const MunitParameter params[], void *user_data)
     return MUNIT_OK;
 }
 
+static MunitResult test_large(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    size_t result;
+
+#if SIZE_MAX > UINT32_MAX
+    /* More than 4 GiB per line. */
+    munit_assert(sail_bytes_per_line(UINT32_MAX, SAIL_PIXEL_FORMAT_BPP64_RGBA, &result) == SAIL_OK);
+    munit_assert(result == (size_t)UINT32_MAX * 8);
+
+    /* More than 4 GiB per image. */
+    struct sail_image image;
+    image.height         = 100000;
+    image.bytes_per_line = 100000 * 4;
+    munit_assert(sail_bytes_per_image(&image, &result) == SAIL_OK);
+    munit_assert(result == (size_t)100000 * 100000 * 4);
+#else
+    munit_assert(sail_bytes_per_line(UINT32_MAX, SAIL_PIXEL_FORMAT_BPP64_RGBA, &result) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+#endif
+
+    /* Overflow. */
+    munit_assert(sail_multiply_sizes(SIZE_MAX / 2 + 1, 2, &result) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    munit_assert(sail_multiply_sizes(SIZE_MAX, 1, &result) == SAIL_OK);
+    munit_assert(sail_multiply_sizes(0, SIZE_MAX, &result) == SAIL_OK);
+
+    return MUNIT_OK;
+}
+
 static MunitTest test_suite_tests[] = {
     { (char *)"/indexed",         test_indexed,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/grayscale",       test_grayscale,       NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
@@ -338,6 +367,7 @@ static MunitTest test_suite_tests[] = {
     { (char *)"/ycbcr",           test_ycbcr,           NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/ycck",            test_ycck,            NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/cie-lab",         test_cie_lab,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/large",           test_large,           NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
@@ -0,0 +1,385 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "sail-common.h"
+
+#include "munit.h"
+
+#include "sail-comparators.h"
+
+static struct sail_image *create_test_image(void) {
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = 16;
+    image->height         = 8;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP8_INDEXED;
+    image->bytes_per_line = 16;
+    image->delay          = 100;
+
+    const size_t pixels_size = (size_t)image->height * image->bytes_per_line;
+    munit_assert(sail_malloc(pixels_size, &image->pixels) == SAIL_OK);
+    memset(image->pixels, 3, pixels_size);
+
+    munit_assert(sail_alloc_resolution_from_data(SAIL_RESOLUTION_UNIT_INCH, 72, 96, &image->resolution) == SAIL_OK);
+
+    munit_assert(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, 5, &image->palette) == SAIL_OK);
+    memset(image->palette->data, 7, 5 * 3);
+
+    const unsigned char exif[] = { 1, 2, 3, 4, 5, 6, 7 };
+    munit_assert(sail_alloc_meta_data_node(&image->meta_data_node) == SAIL_OK);
+    munit_assert(sail_alloc_meta_data_from_known_string(SAIL_META_DATA_COMMENT, "Holidays", &image->meta_data_node->meta_data) == SAIL_OK);
+    munit_assert(sail_alloc_meta_data_node(&image->meta_data_node->next) == SAIL_OK);
+    munit_assert(sail_alloc_meta_data_from_unknown_string("My Data", "Data", &image->meta_data_node->next->meta_data) == SAIL_OK);
+    munit_assert(sail_alloc_meta_data_node(&image->meta_data_node->next->next) == SAIL_OK);
+    munit_assert(sail_alloc_meta_data_from_known_data(SAIL_META_DATA_EXIF, exif, sizeof(exif), &image->meta_data_node->next->next->meta_data) == SAIL_OK);
+
+    const unsigned char iccp[] = { 9, 8, 7 };
+    munit_assert(sail_alloc_iccp_from_data(iccp, sizeof(iccp), &image->iccp) == SAIL_OK);
+
+    munit_assert(sail_alloc_source_image(&image->source_image) == SAIL_OK);
+    image->source_image->pixel_format = SAIL_PIXEL_FORMAT_BPP4_INDEXED;
+    image->source_image->compression  = SAIL_COMPRESSION_RLE;
+
+    const unsigned char source_data[] = { 0xA, 0xB, 0xC, 0xD, 0xE };
+    munit_assert(sail_malloc(sizeof(source_data), &image->source_image->data) == SAIL_OK);
+    memcpy(image->source_image->data, source_data, sizeof(source_data));
+    image->source_image->data_size = sizeof(source_data);
+
+    return image;
+}
+
+static void assert_image_compacted(const struct sail_image *image) {
+
+    munit_assert_not_null(image->arena);
+
+    const uintptr_t arena = (uintptr_t)image->arena;
+
+    munit_assert((uintptr_t)image->resolution > arena);
+    munit_assert((uintptr_t)image->palette > arena);
+    munit_assert((uintptr_t)image->palette->data > arena);
+    munit_assert((uintptr_t)image->iccp->data > arena);
+    munit_assert((uintptr_t)image->source_image > arena);
+    munit_assert((uintptr_t)image->source_image->data > arena);
+
+    /* The original compressed data must outlive the heap copy it was taken from. */
+    const unsigned char source_data[] = { 0xA, 0xB, 0xC, 0xD, 0xE };
+    munit_assert_size(image->source_image->data_size, ==, sizeof(source_data));
+    munit_assert_memory_equal(sizeof(source_data), image->source_image->data, source_data);
+
+    /* Meta data nodes are placed into a flat array. */
+    const struct sail_meta_data_node *node = image->meta_data_node;
+    munit_assert(node->next == node + 1);
+    munit_assert(node->next->next == node + 2);
+    munit_assert_null(node->next->next->next);
+}
+
+static MunitResult test_alloc_image(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+    munit_assert_not_null(image);
+    munit_assert_null(image->pixels);
+    munit_assert_null(image->resolution);
+    munit_assert_null(image->palette);
+    munit_assert_null(image->meta_data_node);
+    munit_assert_null(image->iccp);
+    munit_assert_null(image->source_image);
+    munit_assert_null(image->arena);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_compact_image(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = create_test_image();
+
+    struct sail_image *image_copy = NULL;
+    munit_assert(sail_copy_image(image, &image_copy) == SAIL_OK);
+    munit_assert_null(image_copy->arena);
+
+    munit_assert(sail_compact_image(image) == SAIL_OK);
+    assert_image_compacted(image);
+    munit_assert(sail_compare_images(image, image_copy) == SAIL_OK);
+
+    /* Compacting again reallocates the arena. */
+    munit_assert(sail_compact_image(image) == SAIL_OK);
+    assert_image_compacted(image);
+    munit_assert(sail_compare_images(image, image_copy) == SAIL_OK);
+
+    sail_destroy_image(image_copy);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_copy_compacted_image(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = create_test_image();
+    munit_assert(sail_compact_image(image) == SAIL_OK);
+
+    struct sail_image *image_copy = NULL;
+    munit_assert(sail_copy_image(image, &image_copy) == SAIL_OK);
+    munit_assert(image_copy->arena != image->arena);
+    assert_image_compacted(image_copy);
+    munit_assert(sail_compare_images(image, image_copy) == SAIL_OK);
+
+    struct sail_image *image_skeleton = NULL;
+    munit_assert(sail_copy_image_skeleton(image, &image_skeleton) == SAIL_OK);
+    munit_assert_not_null(image_skeleton->arena);
+    munit_assert_null(image_skeleton->pixels);
+    munit_assert_null(image_skeleton->palette);
+    munit_assert(sail_compare_meta_data_node_chains(image->meta_data_node, image_skeleton->meta_data_node) == SAIL_OK);
+
+    sail_destroy_image(image_skeleton);
+    sail_destroy_image(image_copy);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_replace_compacted_data(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = create_test_image();
+    munit_assert(sail_compact_image(image) == SAIL_OK);
+
+    /* Replaced objects are released with the arena, new objects are destroyed individually. */
+    munit_assert(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP32_RGBA, 2, &image->palette) == SAIL_OK);
+    munit_assert(sail_alloc_meta_data_node(&image->meta_data_node->next->next->next) == SAIL_OK);
+    munit_assert(sail_alloc_meta_data_from_known_string(SAIL_META_DATA_AUTHOR, "Me", &image->meta_data_node->next->next->next->meta_data) == SAIL_OK);
+    munit_assert(sail_alloc_meta_data_from_known_string(SAIL_META_DATA_TITLE, "Title", &image->meta_data_node->meta_data) == SAIL_OK);
+
+    struct sail_image *image_copy = NULL;
+    munit_assert(sail_copy_image(image, &image_copy) == SAIL_OK);
+    munit_assert(sail_compare_images(image, image_copy) == SAIL_OK);
+
+    sail_destroy_image(image_copy);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_flip_horizontally(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+    image->width          = 3;
+    image->height         = 2;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image->bytes_per_line = 12;
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * image->height, &image->pixels) == SAIL_OK);
+
+    /* Padding bytes at the end of every scan line must stay in place. */
+    static const unsigned char PIXELS[] = {
+        1, 2, 3,  4, 5, 6,  7, 8, 9,  0xEE, 0xEE, 0xEE,
+        10, 11, 12,  13, 14, 15,  16, 17, 18,  0xEE, 0xEE, 0xEE,
+    };
+    static const unsigned char FLIPPED[] = {
+        7, 8, 9,  4, 5, 6,  1, 2, 3,  0xEE, 0xEE, 0xEE,
+        16, 17, 18,  13, 14, 15,  10, 11, 12,  0xEE, 0xEE, 0xEE,
+    };
+    memcpy(image->pixels, PIXELS, sizeof(PIXELS));
+
+    munit_assert(sail_flip_horizontally(image) == SAIL_OK);
+    munit_assert_memory_equal(sizeof(FLIPPED), image->pixels, FLIPPED);
+    munit_assert(image->properties & SAIL_IMAGE_PROPERTY_FLIPPED_HORIZONTALLY);
+
+    /* Pixels smaller than a byte are not supported. */
+    image->pixel_format = SAIL_PIXEL_FORMAT_BPP4_INDEXED;
+    munit_assert(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, 16, &image->palette) == SAIL_OK);
+    munit_assert(sail_flip_horizontally(image) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_ref_image(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = create_test_image();
+    munit_assert_ulong(image->references, ==, 1);
+
+    munit_assert(sail_image_ref(image) == SAIL_OK);
+    munit_assert_ulong(image->references, ==, 2);
+
+    /* The first release keeps the image alive. */
+    sail_image_unref(image);
+    munit_assert_ulong(image->references, ==, 1);
+    munit_assert_not_null(image->pixels);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_view_image(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = create_test_image();
+
+    for (unsigned row = 0; row < image->height; row++) {
+        for (unsigned column = 0; column < image->width; column++) {
+            ((unsigned char *)image->pixels)[image->bytes_per_line * row + column] = (unsigned char)(row * 16 + column);
+        }
+    }
+
+    struct sail_image *view = NULL;
+    munit_assert(sail_image_view(image, 4, 2, 8, 5, &view) == SAIL_OK);
+    munit_assert_ptr_equal(view->parent, image);
+    munit_assert_ulong(image->references, ==, 2);
+    munit_assert_uint(view->width, ==, 8);
+    munit_assert_uint(view->height, ==, 5);
+    munit_assert_size(view->bytes_per_line, ==, image->bytes_per_line);
+    munit_assert_ptr_equal(view->pixels, (unsigned char *)image->pixels + image->bytes_per_line * 2 + 4);
+    munit_assert_not_null(view->palette);
+
+    /* Copies of views own tightly packed pixels. */
+    struct sail_image *view_copy = NULL;
+    munit_assert(sail_copy_image(view, &view_copy) == SAIL_OK);
+    munit_assert_null(view_copy->parent);
+    munit_assert_size(view_copy->bytes_per_line, ==, 8);
+    munit_assert(sail_compare_images(view, view_copy) == SAIL_OK);
+    munit_assert_uint8(((unsigned char *)view_copy->pixels)[8], ==, 3 * 16 + 4);
+
+    /* The parent stays alive until the view is destroyed. */
+    sail_destroy_image(image);
+    munit_assert_ulong(image->references, ==, 1);
+    munit_assert(sail_compare_images(view, view_copy) == SAIL_OK);
+
+    sail_destroy_image(view_copy);
+    sail_destroy_image(view);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_view_image_bounds(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = create_test_image();
+    struct sail_image *view = NULL;
+
+    munit_assert(sail_image_view(image, 10, 0, 7, 1, &view) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    munit_assert(sail_image_view(image, 0, 8, 1, 1, &view) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    munit_assert(sail_image_view(image, 0, 0, 0, 1, &view) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    munit_assert_null(view);
+
+    /* Sub-byte views must start at a byte boundary. */
+    image->pixel_format = SAIL_PIXEL_FORMAT_BPP4_INDEXED;
+    munit_assert(sail_image_view(image, 3, 0, 2, 2, &view) == SAIL_ERROR_INVALID_ARGUMENT);
+    munit_assert(sail_image_view(image, 4, 0, 2, 2, &view) == SAIL_OK);
+    munit_assert_ptr_equal(view->pixels, (unsigned char *)image->pixels + 2);
+
+    sail_destroy_image(view);
+    munit_assert_ulong(image->references, ==, 1);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_flip_view(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = create_test_image();
+    image->pixel_format = SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE;
+    image->width        = 8;
+    memset(image->pixels, 0, (size_t)image->height * image->bytes_per_line);
+
+    struct sail_image *view = NULL;
+    munit_assert(sail_image_view(image, 1, 1, 3, 2, &view) == SAIL_OK);
+
+    unsigned char *pixels = view->pixels;
+    pixels[0] = 1;
+    pixels[view->bytes_per_line + 4] = 2;
+
+    munit_assert(sail_flip_vertically(view) == SAIL_OK);
+    munit_assert_uint8(pixels[4], ==, 2);
+    munit_assert_uint8(pixels[view->bytes_per_line], ==, 1);
+
+    munit_assert(sail_flip_horizontally(view) == SAIL_OK);
+    munit_assert_uint8(pixels[0], ==, 2);
+    munit_assert_uint8(pixels[view->bytes_per_line + 4], ==, 1);
+
+    /* Pixels outside of the view are untouched. */
+    const unsigned char *image_pixels = image->pixels;
+    unsigned non_zero = 0;
+
+    for (size_t i = 0; i < (size_t)image->height * image->bytes_per_line; i++) {
+        non_zero += image_pixels[i] != 0;
+    }
+
+    munit_assert_uint(non_zero, ==, 2);
+
+    sail_destroy_image(view);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/alloc", test_alloc_image, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/compact", test_compact_image, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/copy-compacted", test_copy_compacted_image, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/replace-compacted", test_replace_compacted_data, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/flip-horizontally", test_flip_horizontally, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/ref", test_ref_image, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/view", test_view_image, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/view-bounds", test_view_image_bounds, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/flip-view", test_flip_view, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/image",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -473,6 +473,10 @@ static MunitResult test_codec_feature_to_string(const MunitParameter params[], v
     munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_META_DATA),   "META-DATA");
     munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_INTERLACED),  "INTERLACED");
     munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_ICCP),        "ICCP");
+    munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_SKIP_FRAMES), "SKIP-FRAMES");
+    munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_SCAN_LINES),  "SCAN-LINES");
+    munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_SOURCE_DATA), "SOURCE-DATA");
+    munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_LOSSLESS_TRANSFORM), "LOSSLESS-TRANSFORM");
 
     return MUNIT_OK;
 }
@@ -491,6 +495,10 @@ static MunitResult test_codec_feature_from_string(const MunitParameter params[],
     munit_assert(sail_codec_feature_from_string("META-DATA")   == SAIL_CODEC_FEATURE_META_DATA);
     munit_assert(sail_codec_feature_from_string("INTERLACED")  == SAIL_CODEC_FEATURE_INTERLACED);
     munit_assert(sail_codec_feature_from_string("ICCP")        == SAIL_CODEC_FEATURE_ICCP);
+    munit_assert(sail_codec_feature_from_string("SKIP-FRAMES") == SAIL_CODEC_FEATURE_SKIP_FRAMES);
+    munit_assert(sail_codec_feature_from_string("SCAN-LINES")  == SAIL_CODEC_FEATURE_SCAN_LINES);
+    munit_assert(sail_codec_feature_from_string("SOURCE-DATA") == SAIL_CODEC_FEATURE_SOURCE_DATA);
+    munit_assert(sail_codec_feature_from_string("LOSSLESS-TRANSFORM") == SAIL_CODEC_FEATURE_LOSSLESS_TRANSFORM);
 
     return MUNIT_OK;
 }
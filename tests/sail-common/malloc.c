@@ -23,6 +23,8 @@
     SOFTWARE.
 */
 
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "sail-common.h"
@@ -93,10 +95,106 @@ static MunitResult test_realloc(const MunitParameter params[], void *user_data)
     return MUNIT_OK;
 }
 
+static MunitResult test_aligned_alloc(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    void *ptr = NULL;
+    munit_assert(sail_aligned_alloc(3, 1024, &ptr) == SAIL_ERROR_INVALID_ARGUMENT);
+
+    munit_assert(sail_aligned_alloc(128, 1024, &ptr) == SAIL_OK);
+    munit_assert_not_null(ptr);
+#ifndef _WIN32
+    munit_assert((uintptr_t)ptr % 128 == 0);
+#endif
+    memset(ptr, 0, 1024);
+    sail_free(ptr);
+
+    munit_assert(sail_pixels_alignment() == SAIL_DEFAULT_PIXELS_ALIGNMENT);
+    munit_assert(sail_set_pixels_alignment(100) == SAIL_ERROR_INVALID_ARGUMENT);
+    munit_assert(sail_set_pixels_alignment(256) == SAIL_OK);
+    munit_assert(sail_pixels_alignment() == 256);
+
+    munit_assert(sail_malloc_pixels(1024, &ptr) == SAIL_OK);
+    munit_assert_not_null(ptr);
+#ifndef _WIN32
+    munit_assert((uintptr_t)ptr % 256 == 0);
+#endif
+    sail_free(ptr);
+
+    munit_assert(sail_set_pixels_alignment(SAIL_DEFAULT_PIXELS_ALIGNMENT) == SAIL_OK);
+
+    return MUNIT_OK;
+}
+
+struct allocation_counters {
+    int mallocs;
+    int reallocs;
+    int callocs;
+    int frees;
+    int aligned_allocs;
+};
+
+static void *counting_malloc(void *user_data, size_t size) {
+    ((struct allocation_counters *)user_data)->mallocs++;
+    return malloc(size);
+}
+
+static void *counting_realloc(void *user_data, void *ptr, size_t size) {
+    ((struct allocation_counters *)user_data)->reallocs++;
+    return realloc(ptr, size);
+}
+
+static void *counting_calloc(void *user_data, size_t nmemb, size_t size) {
+    ((struct allocation_counters *)user_data)->callocs++;
+    return calloc(nmemb, size);
+}
+
+static void counting_free(void *user_data, void *ptr) {
+    ((struct allocation_counters *)user_data)->frees++;
+    free(ptr);
+}
+
+static MunitResult test_memory_functions(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct allocation_counters counters = { 0, 0, 0, 0, 0 };
+
+    munit_assert(sail_set_memory_functions(NULL, counting_realloc, counting_calloc, counting_free, NULL, &counters) == SAIL_ERROR_NULL_PTR);
+    munit_assert(sail_set_memory_functions(counting_malloc, counting_realloc, counting_calloc, counting_free, NULL, &counters) == SAIL_OK);
+
+    void *ptr = NULL;
+    munit_assert(sail_malloc(16, &ptr) == SAIL_OK);
+    munit_assert(sail_realloc(32, &ptr) == SAIL_OK);
+    sail_free(ptr);
+
+    munit_assert(sail_calloc(4, 4, &ptr) == SAIL_OK);
+    sail_free(ptr);
+
+    /* No aligned allocator, falls back to malloc. */
+    munit_assert(sail_malloc_pixels(64, &ptr) == SAIL_OK);
+    sail_free(ptr);
+
+    /* NULL is not passed to the free function. */
+    sail_free(NULL);
+
+    sail_reset_memory_functions();
+
+    munit_assert(counters.mallocs  == 2);
+    munit_assert(counters.reallocs == 1);
+    munit_assert(counters.callocs  == 1);
+    munit_assert(counters.frees    == 3);
+
+    return MUNIT_OK;
+}
+
 static MunitTest test_suite_tests[] = {
-    { (char *)"/malloc",  test_malloc,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/calloc",  test_calloc,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/realloc", test_realloc, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/malloc",           test_malloc,           NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/calloc",           test_calloc,           NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/realloc",          test_realloc,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/aligned-alloc",    test_aligned_alloc,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/memory-functions", test_memory_functions, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
@@ -0,0 +1,134 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "sail-common.h"
+
+#include "munit.h"
+
+static MunitResult test_global_limits(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_read_limits read_limits;
+    munit_assert(sail_global_read_limits(&read_limits) == SAIL_OK);
+    munit_assert(read_limits.max_width == 0);
+    munit_assert(read_limits.max_height == 0);
+    munit_assert(read_limits.max_pixels == 0);
+    munit_assert(read_limits.max_bytes == 0);
+    munit_assert(read_limits.max_frames == 0);
+    munit_assert(read_limits.max_meta_data_bytes == 0);
+
+    read_limits.max_width = 100;
+    sail_set_global_read_limits(&read_limits);
+
+    struct sail_read_limits read_limits_global;
+    munit_assert(sail_global_read_limits(&read_limits_global) == SAIL_OK);
+    munit_assert(read_limits_global.max_width == 100);
+
+    sail_set_global_read_limits(NULL);
+    munit_assert(sail_global_read_limits(&read_limits_global) == SAIL_OK);
+    munit_assert(read_limits_global.max_width == 0);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_effective_limits(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_read_limits read_limits_global = { 0 };
+    read_limits_global.max_width  = 100;
+    read_limits_global.max_height = 100;
+    sail_set_global_read_limits(&read_limits_global);
+
+    struct sail_read_options *read_options = NULL;
+    munit_assert(sail_alloc_read_options(&read_options) == SAIL_OK);
+    read_options->limits.max_width  = 50;
+    read_options->limits.max_height = 200;
+    read_options->limits.max_frames = 10;
+
+    /* The stricter limit wins. */
+    struct sail_read_limits read_limits;
+    munit_assert(sail_effective_read_limits(read_options, &read_limits) == SAIL_OK);
+    munit_assert(read_limits.max_width == 50);
+    munit_assert(read_limits.max_height == 100);
+    munit_assert(read_limits.max_frames == 10);
+    munit_assert(read_limits.max_bytes == 0);
+
+    munit_assert(sail_effective_read_limits(NULL, &read_limits) == SAIL_OK);
+    munit_assert(read_limits.max_width == 100);
+    munit_assert(read_limits.max_frames == 0);
+
+    sail_destroy_read_options(read_options);
+    sail_set_global_read_limits(NULL);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_check_limits(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_read_options *read_options = NULL;
+    munit_assert(sail_alloc_read_options(&read_options) == SAIL_OK);
+
+    /* No limits. */
+    munit_assert(sail_check_read_limits(read_options, 65535, 65535, (size_t)65535 * 65535 * 4) == SAIL_OK);
+
+    read_options->limits.max_width  = 100;
+    read_options->limits.max_height = 200;
+    read_options->limits.max_pixels = 10000;
+    read_options->limits.max_bytes  = 40000;
+
+    munit_assert(sail_check_read_limits(read_options, 100, 100, 40000) == SAIL_OK);
+    munit_assert(sail_check_read_limits(read_options, 101, 1, 0) == SAIL_ERROR_LIMIT_EXCEEDED);
+    munit_assert(sail_check_read_limits(read_options, 1, 201, 0) == SAIL_ERROR_LIMIT_EXCEEDED);
+    munit_assert(sail_check_read_limits(read_options, 100, 101, 0) == SAIL_ERROR_LIMIT_EXCEEDED);
+    munit_assert(sail_check_read_limits(read_options, 0, 0, 40001) == SAIL_ERROR_LIMIT_EXCEEDED);
+
+    sail_destroy_read_options(read_options);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/check", test_check_limits, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/effective", test_effective_limits, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/global", test_global_limits, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/read-limits",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
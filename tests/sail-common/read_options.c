@@ -35,6 +35,9 @@ static MunitResult test_alloc_options(const MunitParameter params[], void *user_
     munit_assert(sail_alloc_read_options(&read_options) == SAIL_OK);
     munit_assert_not_null(read_options);
     munit_assert(read_options->io_options == 0);
+    munit_assert(read_options->cancel_flag == NULL);
+    munit_assert(read_options->deadline == 0);
+    munit_assert(read_options->decode_quality == SAIL_DECODE_QUALITY_BEST);
 
     sail_destroy_read_options(read_options);
 
@@ -48,13 +51,15 @@ static MunitResult test_copy_options(const MunitParameter params[], void *user_d
     struct sail_read_options *read_options = NULL;
     munit_assert(sail_alloc_read_options(&read_options) == SAIL_OK);
 
-    read_options->io_options = SAIL_IO_OPTION_ICCP;
+    read_options->io_options     = SAIL_IO_OPTION_ICCP;
+    read_options->decode_quality = SAIL_DECODE_QUALITY_FASTEST;
 
     struct sail_read_options *read_options_copy = NULL;
     munit_assert(sail_copy_read_options(read_options, &read_options_copy) == SAIL_OK);
     munit_assert_not_null(read_options_copy);
 
     munit_assert(read_options_copy->io_options == read_options->io_options);
+    munit_assert(read_options_copy->decode_quality == read_options->decode_quality);
 
     sail_destroy_read_options(read_options_copy);
     sail_destroy_read_options(read_options);
@@ -81,8 +86,38 @@ static MunitResult test_options_from_features(const MunitParameter params[], voi
     return MUNIT_OK;
 }
 
+static MunitResult test_check_cancelled(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    munit_assert(sail_check_read_cancelled(NULL) == SAIL_OK);
+
+    struct sail_read_options *read_options = NULL;
+    munit_assert(sail_alloc_read_options(&read_options) == SAIL_OK);
+    munit_assert(sail_check_read_cancelled(read_options) == SAIL_OK);
+
+    volatile int cancel_flag = 0;
+    read_options->cancel_flag = &cancel_flag;
+    munit_assert(sail_check_read_cancelled(read_options) == SAIL_OK);
+
+    cancel_flag = 1;
+    munit_assert(sail_check_read_cancelled(read_options) == SAIL_ERROR_CANCELLED);
+
+    read_options->cancel_flag = NULL;
+    read_options->deadline = sail_now() + 60000;
+    munit_assert(sail_check_read_cancelled(read_options) == SAIL_OK);
+
+    read_options->deadline = 1;
+    munit_assert(sail_check_read_cancelled(read_options) == SAIL_ERROR_CANCELLED);
+
+    sail_destroy_read_options(read_options);
+
+    return MUNIT_OK;
+}
+
 static MunitTest test_suite_tests[] = {
     { (char *)"/alloc", test_alloc_options, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/check-cancelled", test_check_cancelled, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/copy", test_copy_options, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/from-features", test_options_from_features, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
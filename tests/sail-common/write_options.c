@@ -37,6 +37,21 @@ static MunitResult test_alloc_options(const MunitParameter params[], void *user_
     munit_assert(write_options->io_options == 0);
     munit_assert(write_options->compression == SAIL_COMPRESSION_UNSUPPORTED);
     munit_assert(write_options->compression_level == 0);
+    munit_assert(write_options->cancel_flag == NULL);
+    munit_assert(write_options->deadline == 0);
+    munit_assert(write_options->lossless_transform == SAIL_LOSSLESS_TRANSFORM_NONE);
+    munit_assert(write_options->chroma_subsampling == SAIL_CHROMA_SUBSAMPLING_UNKNOWN);
+    munit_assert(!write_options->optimize_coding);
+    munit_assert(!write_options->progressive);
+    munit_assert(write_options->restart_interval == 0);
+    munit_assert(write_options->dct_method == SAIL_DCT_METHOD_DEFAULT);
+    munit_assert(!write_options->arithmetic_coding);
+    munit_assert(write_options->threads == 0);
+    munit_assert(write_options->encode_preset == SAIL_ENCODE_PRESET_DEFAULT);
+    munit_assert(write_options->row_filters == 0);
+    munit_assert(write_options->zlib_strategy == SAIL_ZLIB_STRATEGY_DEFAULT);
+    munit_assert(write_options->zlib_window_bits == 0);
+    munit_assert(write_options->zlib_mem_level == 0);
 
     sail_destroy_write_options(write_options);
 
@@ -53,6 +68,9 @@ static MunitResult test_copy_options(const MunitParameter params[], void *user_d
     write_options->io_options        = SAIL_IO_OPTION_ICCP;
     write_options->compression       = SAIL_COMPRESSION_JPEG;
     write_options->compression_level = 55;
+    write_options->lossless_transform = SAIL_LOSSLESS_TRANSFORM_CROP;
+    write_options->crop_x            = 16;
+    write_options->crop_height       = 32;
 
     struct sail_write_options *write_options_copy = NULL;
     munit_assert(sail_copy_write_options(write_options, &write_options_copy) == SAIL_OK);
@@ -61,6 +79,9 @@ static MunitResult test_copy_options(const MunitParameter params[], void *user_d
     munit_assert(write_options_copy->io_options == write_options->io_options);
     munit_assert(write_options_copy->compression == write_options->compression);
     munit_assert(write_options_copy->compression_level == write_options->compression_level);
+    munit_assert(write_options_copy->lossless_transform == write_options->lossless_transform);
+    munit_assert(write_options_copy->crop_x == write_options->crop_x);
+    munit_assert(write_options_copy->crop_height == write_options->crop_height);
 
     sail_destroy_write_options(write_options_copy);
     sail_destroy_write_options(write_options);
@@ -94,8 +115,38 @@ static MunitResult test_options_from_features(const MunitParameter params[], voi
     return MUNIT_OK;
 }
 
+static MunitResult test_check_cancelled(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    munit_assert(sail_check_write_cancelled(NULL) == SAIL_OK);
+
+    struct sail_write_options *write_options = NULL;
+    munit_assert(sail_alloc_write_options(&write_options) == SAIL_OK);
+    munit_assert(sail_check_write_cancelled(write_options) == SAIL_OK);
+
+    volatile int cancel_flag = 0;
+    write_options->cancel_flag = &cancel_flag;
+    munit_assert(sail_check_write_cancelled(write_options) == SAIL_OK);
+
+    cancel_flag = 1;
+    munit_assert(sail_check_write_cancelled(write_options) == SAIL_ERROR_CANCELLED);
+
+    write_options->cancel_flag = NULL;
+    write_options->deadline = sail_now() + 60000;
+    munit_assert(sail_check_write_cancelled(write_options) == SAIL_OK);
+
+    write_options->deadline = 1;
+    munit_assert(sail_check_write_cancelled(write_options) == SAIL_ERROR_CANCELLED);
+
+    sail_destroy_write_options(write_options);
+
+    return MUNIT_OK;
+}
+
 static MunitTest test_suite_tests[] = {
     { (char *)"/alloc", test_alloc_options, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/check-cancelled", test_check_cancelled, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/copy", test_copy_options, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/from-features", test_options_from_features, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
@@ -23,6 +23,8 @@
     SOFTWARE.
 */
 
+#include <string.h>
+
 #include "sail-common.h"
 
 #include "sail-comparators.h"
@@ -57,7 +59,7 @@ sail_status_t sail_compare_palettes(const struct sail_palette *palette1, const s
 
     munit_assert_not_null(palette1->data);
     munit_assert_not_null(palette2->data);
-    unsigned palette_size;
+    size_t palette_size;
     munit_assert(sail_bytes_per_line(palette1->color_count, palette1->pixel_format, &palette_size) == SAIL_OK);
     munit_assert_memory_equal(palette_size, palette1->data, palette2->data);
 
@@ -153,6 +155,13 @@ sail_status_t sail_compare_source_images(const struct sail_source_image *source_
     munit_assert(source_image1->pixel_format == source_image2->pixel_format);
     munit_assert(source_image1->properties == source_image2->properties);
     munit_assert(source_image1->compression == source_image2->compression);
+    munit_assert(source_image1->data_size == source_image2->data_size);
+
+    if (source_image1->data == NULL || source_image2->data == NULL) {
+        munit_assert(source_image1->data == source_image2->data);
+    } else {
+        munit_assert_memory_equal(source_image1->data_size, source_image1->data, source_image2->data);
+    }
 
     return SAIL_OK;
 }
@@ -169,12 +178,27 @@ sail_status_t sail_compare_images(const struct sail_image *image1, const struct
     munit_assert(image1->height > 0);
     munit_assert(image1->height == image2->height);
     munit_assert(image1->bytes_per_line > 0);
-    munit_assert(image1->bytes_per_line == image2->bytes_per_line);
+    munit_assert(image2->bytes_per_line > 0);
 
     munit_assert_not_null(image1->pixels);
     munit_assert_not_null(image2->pixels);
-    const unsigned pixels_size = image1->height * image1->bytes_per_line;
-    munit_assert_memory_equal(pixels_size, image1->pixels, image2->pixels);
+
+    /* Views have the parent stride. Compare them row by row. */
+    if (image1->parent == NULL && image2->parent == NULL) {
+        munit_assert(image1->bytes_per_line == image2->bytes_per_line);
+
+        const size_t pixels_size = (size_t)image1->height * image1->bytes_per_line;
+        munit_assert_memory_equal(pixels_size, image1->pixels, image2->pixels);
+    } else {
+        size_t row_size;
+        munit_assert(sail_bytes_per_line(image1->width, image1->pixel_format, &row_size) == SAIL_OK);
+
+        for (unsigned row = 0; row < image1->height; row++) {
+            munit_assert_memory_equal(row_size,
+                                      (const unsigned char *)image1->pixels + image1->bytes_per_line * row,
+                                      (const unsigned char *)image2->pixels + image2->bytes_per_line * row);
+        }
+    }
 
     if (image1->resolution == NULL) {
         munit_assert_null(image2->resolution);
@@ -215,3 +239,58 @@ sail_status_t sail_compare_images(const struct sail_image *image1, const struct
 
     return SAIL_OK;
 }
+
+const char* sail_test_image_with_extension(const char * const *test_images, const char *extension) {
+
+    for (const char * const *test_image = test_images; *test_image != NULL; test_image++) {
+        if (strstr(*test_image, extension) != NULL) {
+            return *test_image;
+        }
+    }
+
+    return NULL;
+}
+
+sail_status_t sail_test_insert_exif_orientation(const void *data, size_t data_size, enum SailOrientation orientation,
+                                                bool big_endian, void **result, size_t *result_size) {
+
+    const unsigned char big_endian_segment[] = {
+        0xFF, 0xE1, 0, 34,
+        'E', 'x', 'i', 'f', 0, 0,
+        /* TIFF header, IFD0 at 8. */
+        'M', 'M', 0, 42, 0, 0, 0, 8,
+        /* IFD0: 1 entry. */
+        0, 1,
+        /* Orientation, SHORT, 1, value. */
+        0x01, 0x12, 0, 3, 0, 0, 0, 1, 0, (unsigned char)orientation, 0, 0,
+        /* No more IFDs. */
+        0, 0, 0, 0,
+    };
+
+    const unsigned char little_endian_segment[] = {
+        0xFF, 0xE1, 0, 34,
+        'E', 'x', 'i', 'f', 0, 0,
+        /* TIFF header, IFD0 at 8. */
+        'I', 'I', 42, 0, 8, 0, 0, 0,
+        /* IFD0: 1 entry. */
+        1, 0,
+        /* Orientation, SHORT, 1, value. */
+        0x12, 0x01, 3, 0, 1, 0, 0, 0, (unsigned char)orientation, 0, 0, 0,
+        /* No more IFDs. */
+        0, 0, 0, 0,
+    };
+
+    const unsigned char *segment = big_endian ? big_endian_segment : little_endian_segment;
+    const size_t segment_size = sizeof(big_endian_segment);
+
+    *result_size = data_size + segment_size;
+    SAIL_TRY(sail_malloc(*result_size, result));
+
+    unsigned char *output = *result;
+
+    memcpy(output, data, 2);
+    memcpy(output + 2, segment, segment_size);
+    memcpy(output + 2 + segment_size, (const unsigned char *)data + 2, data_size - 2);
+
+    return SAIL_OK;
+}
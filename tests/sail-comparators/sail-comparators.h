@@ -26,6 +26,10 @@
 #ifndef SAIL_COMPARATORS_H
 #define SAIL_COMPARATORS_H
 
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "common.h"
 #include "error.h"
 #include "export.h"
 
@@ -45,4 +49,15 @@ SAIL_EXPORT sail_status_t sail_compare_source_images(const struct sail_source_im
 
 SAIL_EXPORT sail_status_t sail_compare_images(const struct sail_image *image1, const struct sail_image *image2);
 
+/* Returns the first test image with the specified extension from the NULL-terminated list, or NULL. */
+SAIL_EXPORT const char* sail_test_image_with_extension(const char * const *test_images, const char *extension);
+
+/*
+ * Inserts an APP1 segment right after SOI of the JPEG data. The segment holds EXIF data
+ * in the big-endian or little-endian byte order with the orientation in IFD0.
+ * The assigned data MUST be freed later with sail_free().
+ */
+SAIL_EXPORT sail_status_t sail_test_insert_exif_orientation(const void *data, size_t data_size, enum SailOrientation orientation,
+                                                            bool big_endian, void **result, size_t *result_size);
+
 #endif
@@ -58,7 +58,7 @@ static sail_status_t read_hex(FILE *fptr, size_t data_length, uint8_t **value) {
     SAIL_TRY(sail_malloc(data_length, &ptr));
     uint8_t *value_local = ptr;
 
-    for (unsigned i = 0; i < data_length; i++) {
+    for (size_t i = 0; i < data_length; i++) {
         skip_whitespaces(fptr);
 
         unsigned v;
@@ -68,7 +68,7 @@ static sail_status_t read_hex(FILE *fptr, size_t data_length, uint8_t **value) {
         if (fscanf(fptr, "%2x%*[ \r\n]", &v) != 1) {
 #endif
             sail_free(value_local);
-            SAIL_LOG_ERROR("DUMP: Failed to read hex element at index %u", i);
+            SAIL_LOG_ERROR("DUMP: Failed to read hex element at index %lu", (unsigned long)i);
             SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
         }
 
@@ -87,11 +87,11 @@ static sail_status_t print_hex(uint8_t *data, size_t data_length) {
     }
 
     if (data == NULL) {
-        SAIL_LOG_ERROR("DUMP: Data length is %u but data is NULL", data_length);
+        SAIL_LOG_ERROR("DUMP: Data length is %lu but data is NULL", (unsigned long)data_length);
         SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
     }
 
-    for (unsigned i = 0; i < data_length; i++) {
+    for (size_t i = 0; i < data_length; i++) {
         printf("%02x ", *(data + i));
     }
 
@@ -106,16 +106,18 @@ static sail_status_t read_image(FILE *fptr, struct sail_image *image) {
      * 124 124 62(bpl) BPP4-INDEXED 0(properties)
      */
     char pixel_format[64];
+    unsigned long bytes_per_line;
 
 #ifdef _MSC_VER
-    if (fscanf_s(fptr, "%u %u %u %s %d", &image->width, &image->height, &image->bytes_per_line, pixel_format, (unsigned)sizeof(pixel_format), &image->properties) != 5) {
+    if (fscanf_s(fptr, "%u %u %lu %s %d", &image->width, &image->height, &bytes_per_line, pixel_format, (unsigned)sizeof(pixel_format), &image->properties) != 5) {
 #else
-    if (fscanf(fptr, "%u %u %u %s %d", &image->width, &image->height, &image->bytes_per_line, pixel_format, &image->properties) != 5) {
+    if (fscanf(fptr, "%u %u %lu %s %d", &image->width, &image->height, &bytes_per_line, pixel_format, &image->properties) != 5) {
 #endif
         SAIL_LOG_ERROR("DUMP: Failed to read IMAGE properties");
         SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
     }
 
+    image->bytes_per_line = bytes_per_line;
     image->pixel_format = sail_pixel_format_from_string(pixel_format);
 
     if (image->pixel_format == SAIL_PIXEL_FORMAT_UNKNOWN) {
@@ -123,8 +125,8 @@ static sail_status_t read_image(FILE *fptr, struct sail_image *image) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
     }
 
-    SAIL_LOG_DEBUG("DUMP: Image properties: %ux%u bytes_per_line(%u), pixel_format(%s), properties(%d)",
-                    image->width, image->height, image->bytes_per_line, sail_pixel_format_to_string(image->pixel_format), image->properties);
+    SAIL_LOG_DEBUG("DUMP: Image properties: %ux%u bytes_per_line(%lu), pixel_format(%s), properties(%d)",
+                    image->width, image->height, (unsigned long)image->bytes_per_line, sail_pixel_format_to_string(image->pixel_format), image->properties);
 
     return SAIL_OK;
 }
@@ -386,14 +388,14 @@ static sail_status_t read_pixels(FILE *fptr, struct sail_image *image) {
     /*
      * 00 11 22...
      */
-    const unsigned data_length = image->bytes_per_line * image->height;
+    const size_t data_length = image->bytes_per_line * image->height;
 
     uint8_t *value;
     SAIL_TRY(read_hex(fptr, data_length, &value));
 
     image->pixels = value;
 
-    SAIL_LOG_DEBUG("DUMP: Pixels properties: data_length(%u)", data_length);
+    SAIL_LOG_DEBUG("DUMP: Pixels properties: data_length(%lu)", (unsigned long)data_length);
 
     return SAIL_OK;
 }
@@ -485,7 +487,7 @@ sail_status_t sail_dump(const struct sail_image *image) {
     /*  To print dots in floats. */
     setlocale(LC_NUMERIC, "C");
 
-    printf("IMAGE\n%u %u %u %s %d\n\n", image->width, image->height, image->bytes_per_line, sail_pixel_format_to_string(image->pixel_format), image->properties);
+    printf("IMAGE\n%u %u %lu %s %d\n\n", image->width, image->height, (unsigned long)image->bytes_per_line, sail_pixel_format_to_string(image->pixel_format), image->properties);
 
     if (image->source_image != NULL) {
         printf("SOURCE-IMAGE\n%s %d %s\n\n", sail_pixel_format_to_string(image->source_image->pixel_format), image->properties,
@@ -554,17 +556,17 @@ sail_status_t sail_dump(const struct sail_image *image) {
     }
 
     if (image->palette != NULL) {
-        unsigned palette_size;
+        size_t palette_size;
         SAIL_TRY(sail_bytes_per_line(image->palette->color_count, image->palette->pixel_format, &palette_size));
 
-        printf("PALETTE\n%s %u %u\n", sail_pixel_format_to_string(image->palette->pixel_format), image->palette->color_count, palette_size);
+        printf("PALETTE\n%s %u %lu\n", sail_pixel_format_to_string(image->palette->pixel_format), image->palette->color_count, (unsigned long)palette_size);
         SAIL_TRY(print_hex(image->palette->data, palette_size));
         printf("\n");
     }
 
     {
         printf("PIXELS\n");
-        const unsigned pixels_size = image->bytes_per_line * image->height;
+        const size_t pixels_size = image->bytes_per_line * image->height;
         SAIL_TRY(print_hex(image->pixels, pixels_size));
         printf("\n");
     }
@@ -0,0 +1,251 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sail.h"
+#include "sail-manip.h"
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static sail_status_t read_converted(const void *buffer, size_t buffer_length, const struct sail_codec_info *codec_info,
+                                    struct sail_scan_line_converter *scan_line_converter, int io_options, struct sail_image **image) {
+
+    struct sail_read_options *read_options;
+    SAIL_TRY(sail_alloc_read_options_from_features(codec_info->read_features, &read_options));
+    read_options->scan_line_converter = scan_line_converter;
+    read_options->io_options |= io_options;
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_reading_memory_with_options(buffer, buffer_length, codec_info, read_options, &state),
+                        /* cleanup */ sail_destroy_read_options(read_options));
+
+    sail_destroy_read_options(read_options);
+
+    SAIL_TRY_OR_CLEANUP(sail_read_next_frame(state, image),
+                        /* cleanup */ sail_stop_reading(state));
+
+    SAIL_TRY(sail_stop_reading(state));
+
+    return SAIL_OK;
+}
+
+static void test_convert_buffer(const void *buffer, size_t buffer_length, const struct sail_codec_info *codec_info) {
+
+    const enum SailPixelFormat output_pixel_formats[] = {
+        SAIL_PIXEL_FORMAT_BPP24_RGB,
+        SAIL_PIXEL_FORMAT_BPP32_BGRA,
+        SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+    };
+
+    struct sail_image *image;
+    munit_assert(sail_load_image_from_memory(buffer, buffer_length, &image) == SAIL_OK);
+
+    for (size_t i = 0; i < sizeof(output_pixel_formats) / sizeof(output_pixel_formats[0]); i++) {
+        struct sail_image *image_expected;
+        munit_assert(sail_convert_image(image, output_pixel_formats[i], &image_expected) == SAIL_OK);
+
+        struct sail_scan_line_converter *scan_line_converter;
+        munit_assert(sail_alloc_scan_line_converter(output_pixel_formats[i], NULL, &scan_line_converter) == SAIL_OK);
+
+        struct sail_image *image_converted;
+        munit_assert(read_converted(buffer, buffer_length, codec_info, scan_line_converter, 0, &image_converted) == SAIL_OK);
+
+        munit_assert(image_converted->pixel_format == output_pixel_formats[i]);
+        munit_assert_null(image_converted->palette);
+        munit_assert(sail_compare_images(image_converted, image_expected) == SAIL_OK);
+
+        sail_destroy_image(image_converted);
+        sail_destroy_scan_line_converter(scan_line_converter);
+        sail_destroy_image(image_expected);
+    }
+
+    sail_destroy_image(image);
+}
+
+static MunitResult test_convert(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(path, &data, &data_size) == SAIL_OK);
+
+    test_convert_buffer(data, data_size, codec_info);
+
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_convert_interlaced(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("png", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image;
+    munit_assert(sail_load_image_from_file(SAIL_TEST_IMAGES[0], &image) == SAIL_OK);
+
+    struct sail_write_options *write_options;
+    munit_assert(sail_alloc_write_options_from_features(codec_info->write_features, &write_options) == SAIL_OK);
+    write_options->io_options |= SAIL_IO_OPTION_INTERLACED;
+
+    const size_t buffer_length = 1024 * 1024;
+    void *buffer;
+    munit_assert(sail_malloc(buffer_length, &buffer) == SAIL_OK);
+
+    void *state = NULL;
+    size_t written;
+    munit_assert(sail_start_writing_memory_with_options(buffer, buffer_length, codec_info, write_options, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_writing_with_written(state, &written) == SAIL_OK);
+
+    test_convert_buffer(buffer, written, codec_info);
+
+    sail_free(buffer);
+    sail_destroy_write_options(write_options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+/* Inserts EXIF data with the 90 degrees rotation right after JPEG SOI. */
+static sail_status_t insert_exif_rotation(const void *data, size_t data_size, void **result, size_t *result_size) {
+
+    static const unsigned char segment[] = {
+        0xFF, 0xE1, 0, 34,
+        'E', 'x', 'i', 'f', 0, 0,
+        'I', 'I', 42, 0, 8, 0, 0, 0,
+        1, 0,
+        0x12, 0x01, 3, 0, 1, 0, 0, 0, SAIL_ORIENTATION_ROTATE_90, 0, 0, 0,
+        0, 0, 0, 0,
+    };
+
+    *result_size = data_size + sizeof(segment);
+    SAIL_TRY(sail_malloc(*result_size, result));
+
+    memcpy(*result, data, 2);
+    memcpy((unsigned char *)*result + 2, segment, sizeof(segment));
+    memcpy((unsigned char *)*result + 2 + sizeof(segment), (const unsigned char *)data + 2, data_size - 2);
+
+    return SAIL_OK;
+}
+
+static MunitResult test_convert_oriented(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("jpg", &codec_info) == SAIL_OK);
+
+    const char *path = NULL;
+    for (const char * const *test_image = SAIL_TEST_IMAGES; *test_image != NULL; test_image++) {
+        if (strstr(*test_image, ".jpg") != NULL) {
+            path = *test_image;
+        }
+    }
+    munit_assert_not_null(path);
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(path, &data, &data_size) == SAIL_OK);
+
+    void *rotated_data;
+    size_t rotated_data_size;
+    munit_assert(insert_exif_rotation(data, data_size, &rotated_data, &rotated_data_size) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_load_image_from_memory(data, data_size, &image) == SAIL_OK);
+
+    struct sail_image *image_expected;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_BGRA, &image_expected) == SAIL_OK);
+
+    struct sail_scan_line_converter *scan_line_converter;
+    munit_assert(sail_alloc_scan_line_converter(SAIL_PIXEL_FORMAT_BPP32_BGRA, NULL, &scan_line_converter) == SAIL_OK);
+
+    struct sail_image *image_converted;
+    munit_assert(read_converted(rotated_data, rotated_data_size, codec_info, scan_line_converter,
+                                SAIL_IO_OPTION_APPLY_ORIENTATION, &image_converted) == SAIL_OK);
+
+    /* Rotated by 90 degrees clockwise. */
+    munit_assert(image_converted->pixel_format == SAIL_PIXEL_FORMAT_BPP32_BGRA);
+    munit_assert_uint(image_converted->width, ==, image_expected->height);
+    munit_assert_uint(image_converted->height, ==, image_expected->width);
+
+    for (unsigned y = 0; y < image_converted->height; y++) {
+        for (unsigned x = 0; x < image_converted->width; x++) {
+            munit_assert_memory_equal(4,
+                                      (const unsigned char *)image_converted->pixels + image_converted->bytes_per_line * y + x * 4,
+                                      (const unsigned char *)image_expected->pixels + image_expected->bytes_per_line * (image_expected->height - 1 - x) + y * 4);
+        }
+    }
+
+    sail_destroy_image(image_converted);
+    sail_destroy_scan_line_converter(scan_line_converter);
+    sail_destroy_image(image_expected);
+    sail_destroy_image(image);
+    sail_free(rotated_data);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/convert",            test_convert,            NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/convert-interlaced", test_convert_interlaced, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/convert-oriented",   test_convert_oriented,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/scan-line-converter",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,217 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#include <stdlib.h>
+
+#include "sail.h"
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static sail_status_t load_image(const void *data, size_t data_size, int io_options, struct sail_image **image) {
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_by_magic_number_from_memory(data, data_size, &codec_info));
+
+    struct sail_read_options *read_options;
+    SAIL_TRY(sail_alloc_read_options_from_features(codec_info->read_features, &read_options));
+    read_options->io_options |= io_options;
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_reading_memory_with_options(data, data_size, codec_info, read_options, &state),
+                        /* cleanup */ sail_destroy_read_options(read_options));
+
+    sail_destroy_read_options(read_options);
+
+    SAIL_TRY_OR_CLEANUP(sail_read_next_frame(state, image),
+                        /* cleanup */ sail_stop_reading(state));
+
+    SAIL_TRY(sail_stop_reading(state));
+
+    return SAIL_OK;
+}
+
+/* Maps a pixel of the displayed image to the stored image. */
+static void map_pixel(enum SailOrientation orientation, unsigned width, unsigned height,
+                      unsigned x, unsigned y, unsigned *source_x, unsigned *source_y) {
+
+    switch (orientation) {
+        case SAIL_ORIENTATION_FLIP_HORIZONTALLY: *source_x = width - 1 - x;  *source_y = y;              break;
+        case SAIL_ORIENTATION_ROTATE_180:        *source_x = width - 1 - x;  *source_y = height - 1 - y; break;
+        case SAIL_ORIENTATION_FLIP_VERTICALLY:   *source_x = x;              *source_y = height - 1 - y; break;
+        case SAIL_ORIENTATION_TRANSPOSE:         *source_x = y;              *source_y = x;              break;
+        case SAIL_ORIENTATION_ROTATE_90:         *source_x = y;              *source_y = height - 1 - x; break;
+        case SAIL_ORIENTATION_TRANSVERSE:        *source_x = width - 1 - y;  *source_y = height - 1 - x; break;
+        case SAIL_ORIENTATION_ROTATE_270:        *source_x = width - 1 - y;  *source_y = x;              break;
+        default:                                 *source_x = x;              *source_y = y;              break;
+    }
+}
+
+static void assert_oriented(const struct sail_image *source, const struct sail_image *image, enum SailOrientation orientation) {
+
+    const bool transposed = orientation >= SAIL_ORIENTATION_TRANSPOSE;
+
+    munit_assert_uint(image->width,  ==, transposed ? source->height : source->width);
+    munit_assert_uint(image->height, ==, transposed ? source->width  : source->height);
+    munit_assert(image->pixel_format == source->pixel_format);
+
+    unsigned bits_per_pixel;
+    munit_assert(sail_bits_per_pixel(image->pixel_format, &bits_per_pixel) == SAIL_OK);
+    const unsigned bytes_per_pixel = bits_per_pixel / 8;
+
+    for (unsigned y = 0; y < image->height; y++) {
+        for (unsigned x = 0; x < image->width; x++) {
+            unsigned source_x;
+            unsigned source_y;
+            map_pixel(orientation, source->width, source->height, x, y, &source_x, &source_y);
+
+            munit_assert_memory_equal(bytes_per_pixel,
+                                      (const unsigned char *)image->pixels + image->bytes_per_line * y + (size_t)x * bytes_per_pixel,
+                                      (const unsigned char *)source->pixels + source->bytes_per_line * source_y + (size_t)source_x * bytes_per_pixel);
+        }
+    }
+}
+
+static MunitResult test_source_orientation(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(sail_test_image_with_extension(SAIL_TEST_IMAGES, ".jpg"), &data, &data_size) == SAIL_OK);
+
+    struct sail_image *expected;
+    munit_assert(sail_load_image_from_memory(data, data_size, &expected) == SAIL_OK);
+    munit_assert(expected->source_image->orientation == SAIL_ORIENTATION_NORMAL);
+
+    for (int orientation = SAIL_ORIENTATION_NORMAL; orientation <= SAIL_ORIENTATION_ROTATE_270; orientation++) {
+        void *oriented_data;
+        size_t oriented_data_size;
+        munit_assert(sail_test_insert_exif_orientation(data, data_size, orientation, true, &oriented_data, &oriented_data_size) == SAIL_OK);
+
+        struct sail_image *image;
+        munit_assert(load_image(oriented_data, oriented_data_size, 0, &image) == SAIL_OK);
+
+        const int flip_properties = sail_orientation_flip_properties(orientation);
+
+        /* Frames are decoded as stored. */
+        munit_assert(image->source_image->orientation == (enum SailOrientation)orientation);
+        munit_assert_int(image->properties & flip_properties, ==, flip_properties);
+        munit_assert_int(image->source_image->properties & flip_properties, ==, flip_properties);
+        assert_oriented(expected, image, SAIL_ORIENTATION_NORMAL);
+
+        sail_destroy_image(image);
+        sail_free(oriented_data);
+    }
+
+    sail_destroy_image(expected);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_apply_orientation(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(sail_test_image_with_extension(SAIL_TEST_IMAGES, ".jpg"), &data, &data_size) == SAIL_OK);
+
+    struct sail_image *expected;
+    munit_assert(sail_load_image_from_memory(data, data_size, &expected) == SAIL_OK);
+
+    for (int orientation = SAIL_ORIENTATION_NORMAL; orientation <= SAIL_ORIENTATION_ROTATE_270; orientation++) {
+        void *oriented_data;
+        size_t oriented_data_size;
+        munit_assert(sail_test_insert_exif_orientation(data, data_size, orientation, true, &oriented_data, &oriented_data_size) == SAIL_OK);
+
+        struct sail_image *image;
+        munit_assert(load_image(oriented_data, oriented_data_size, SAIL_IO_OPTION_APPLY_ORIENTATION, &image) == SAIL_OK);
+
+        munit_assert(image->source_image->orientation == (enum SailOrientation)orientation);
+        munit_assert_int(image->properties & (SAIL_IMAGE_PROPERTY_FLIPPED_HORIZONTALLY | SAIL_IMAGE_PROPERTY_FLIPPED_VERTICALLY), ==, 0);
+        assert_oriented(expected, image, orientation);
+
+        sail_destroy_image(image);
+        sail_free(oriented_data);
+    }
+
+    sail_destroy_image(expected);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_apply_orientation_without_exif(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    for (const char * const *test_image = SAIL_TEST_IMAGES; *test_image != NULL; test_image++) {
+        void *data;
+        size_t data_size;
+        munit_assert(sail_file_contents_to_data(*test_image, &data, &data_size) == SAIL_OK);
+
+        struct sail_image *expected;
+        munit_assert(sail_load_image_from_memory(data, data_size, &expected) == SAIL_OK);
+
+        struct sail_image *image;
+        munit_assert(load_image(data, data_size, SAIL_IO_OPTION_APPLY_ORIENTATION, &image) == SAIL_OK);
+
+        munit_assert_uint(image->width, ==, expected->width);
+        munit_assert_uint(image->height, ==, expected->height);
+        munit_assert(image->pixel_format == expected->pixel_format);
+        munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, image->pixels, expected->pixels);
+        munit_assert((image->palette == NULL) == (expected->palette == NULL));
+
+        sail_destroy_image(image);
+        sail_destroy_image(expected);
+        sail_free(data);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/source-orientation",             test_source_orientation,             NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/apply-orientation",              test_apply_orientation,              NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/apply-orientation-without-exif", test_apply_orientation_without_exif, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/apply-orientation",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
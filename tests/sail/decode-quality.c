@@ -0,0 +1,395 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sail.h"
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static const char *QUALITIES[] = { "best", "balanced", "fastest", NULL };
+
+static const char *BLEND_METHODS[] = { "blend", "no-blend", NULL };
+
+static enum SailDecodeQuality decode_quality_from_string(const char *str) {
+
+    if (strcmp(str, "balanced") == 0) {
+        return SAIL_DECODE_QUALITY_BALANCED;
+    } else if (strcmp(str, "fastest") == 0) {
+        return SAIL_DECODE_QUALITY_FASTEST;
+    } else {
+        return SAIL_DECODE_QUALITY_BEST;
+    }
+}
+
+static sail_status_t read_with_quality(const void *buffer, size_t buffer_length, const struct sail_codec_info *codec_info,
+                                       enum SailDecodeQuality decode_quality, struct sail_image **image) {
+
+    struct sail_read_options *read_options;
+    SAIL_TRY(sail_alloc_read_options_from_features(codec_info->read_features, &read_options));
+    read_options->decode_quality = decode_quality;
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_reading_memory_with_options(buffer, buffer_length, codec_info, read_options, &state),
+                        /* cleanup */ sail_destroy_read_options(read_options));
+
+    sail_destroy_read_options(read_options);
+
+    SAIL_TRY_OR_CLEANUP(sail_read_next_frame(state, image),
+                        /* cleanup */ sail_stop_reading(state));
+
+    SAIL_TRY(sail_stop_reading(state));
+
+    return SAIL_OK;
+}
+
+static MunitResult test_lossless(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+    const enum SailDecodeQuality decode_quality = decode_quality_from_string(munit_parameters_get(params, "quality"));
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    /* Lossy codecs are tested separately. */
+    if (strcmp(codec_info->name, "JPEG") == 0) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image_best = NULL;
+    munit_assert(sail_load_image_from_file(path, &image_best) == SAIL_OK);
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(path, &data, &data_size) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(read_with_quality(data, data_size, codec_info, decode_quality, &image) == SAIL_OK);
+
+    /* Lossless codecs decode the same pixels regardless of the quality. */
+    munit_assert(sail_compare_images(image, image_best) == SAIL_OK);
+
+    sail_destroy_image(image);
+    sail_free(data);
+    sail_destroy_image(image_best);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_jpeg(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const enum SailDecodeQuality decode_quality = decode_quality_from_string(munit_parameters_get(params, "quality"));
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("jpg", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    /* Encode a gradient. */
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+    image->width          = 64;
+    image->height         = 32;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image->bytes_per_line = image->width * 3;
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * image->height, &image->pixels) == SAIL_OK);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        unsigned char *scan_line = (unsigned char *)image->pixels + row * image->bytes_per_line;
+
+        for (unsigned column = 0; column < image->width; column++) {
+            scan_line[column * 3 + 0] = (unsigned char)(column * 4);
+            scan_line[column * 3 + 1] = (unsigned char)(row * 8);
+            scan_line[column * 3 + 2] = (unsigned char)((column + row) * 2);
+        }
+    }
+
+    const size_t buffer_length = 64 * 1024;
+    void *buffer;
+    munit_assert(sail_malloc(buffer_length, &buffer) == SAIL_OK);
+
+    void *state = NULL;
+    munit_assert(sail_start_writing_memory(buffer, buffer_length, codec_info, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+
+    size_t written;
+    munit_assert(sail_stop_writing_with_written(state, &written) == SAIL_OK);
+
+    struct sail_image *image_read = NULL;
+    munit_assert(read_with_quality(buffer, written, codec_info, decode_quality, &image_read) == SAIL_OK);
+
+    munit_assert(image_read->width == image->width);
+    munit_assert(image_read->height == image->height);
+    munit_assert(image_read->pixel_format == image->pixel_format);
+
+    /* Faster decoding stays close to the original on smooth images. */
+    const unsigned char *pixels      = image->pixels;
+    const unsigned char *pixels_read = image_read->pixels;
+
+    for (size_t i = 0; i < (size_t)image->bytes_per_line * image->height; i++) {
+        munit_assert_int(abs(pixels[i] - pixels_read[i]), <=, 24);
+    }
+
+    sail_destroy_image(image_read);
+    sail_free(buffer);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static int clamp_channel(double value) {
+
+    return value < 0 ? 0 : (value > 255 ? 255 : (int)value);
+}
+
+static MunitResult test_avif(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const enum SailDecodeQuality decode_quality = decode_quality_from_string(munit_parameters_get(params, "quality"));
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("avif", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(sail_test_image_with_extension(SAIL_TEST_OPTIONAL_CODEC_IMAGES, "/gradient.avif"),
+                                            &data, &data_size) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(read_with_quality(data, data_size, codec_info, decode_quality, &image) == SAIL_OK);
+
+    munit_assert_uint(image->width, ==, 16);
+    munit_assert_uint(image->height, ==, 16);
+    munit_assert(image->pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA);
+
+    /*
+     * The image is a lossless 4:2:0 BT.601 full range gradient: Y = 16 + x * 8 + y * 4,
+     * U = 128 + (x / 2 - 4) * 8, V = 128 + (y / 2 - 4) * 8. Every quality stays close to it
+     * regardless of the chroma upsampling.
+     */
+    for (unsigned row = 0; row < image->height; row++) {
+        const unsigned char *scan_line = (const unsigned char *)image->pixels + row * image->bytes_per_line;
+
+        for (unsigned column = 0; column < image->width; column++) {
+            const double y = 16 + column * 8 + row * 4;
+            const double u = ((int)column / 2 - 4) * 8;
+            const double v = ((int)row / 2 - 4) * 8;
+
+            munit_assert_int(abs(scan_line[column * 4 + 0] - clamp_channel(y + 1.402 * v)), <=, 8);
+            munit_assert_int(abs(scan_line[column * 4 + 1] - clamp_channel(y - 0.344136 * u - 0.714136 * v)), <=, 8);
+            munit_assert_int(abs(scan_line[column * 4 + 2] - clamp_channel(y + 1.772 * u)), <=, 8);
+            munit_assert_uint8(scan_line[column * 4 + 3], ==, 255);
+        }
+    }
+
+    sail_destroy_image(image);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_jpeg2000(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const enum SailDecodeQuality decode_quality = decode_quality_from_string(munit_parameters_get(params, "quality"));
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("j2k", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(sail_test_image_with_extension(SAIL_TEST_OPTIONAL_CODEC_IMAGES, "/gray.j2k"),
+                                            &data, &data_size) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(read_with_quality(data, data_size, codec_info, decode_quality, &image) == SAIL_OK);
+
+    munit_assert_uint(image->width, ==, 8);
+    munit_assert_uint(image->height, ==, 8);
+    munit_assert(image->pixel_format == SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE);
+
+    /* The codestream has two quality layers of empty packets, so all the samples are the DC level shift. */
+    for (unsigned row = 0; row < image->height; row++) {
+        const unsigned char *scan_line = (const unsigned char *)image->pixels + row * image->bytes_per_line;
+
+        for (unsigned column = 0; column < image->width; column++) {
+            munit_assert_uint8(scan_line[column], ==, 128);
+        }
+    }
+
+    sail_destroy_image(image);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+/* Frames of the animated WebP test images. Every frame is lossless and filled with one color. */
+static const struct {
+    unsigned x;
+    unsigned y;
+    unsigned width;
+    unsigned height;
+    unsigned char rgba[4];
+} WEBP_FRAMES[] = {
+    { 0, 0, 8, 8, { 255, 0,   0,   255 } },
+    { 2, 2, 4, 4, { 0,   0,   255, 128 } },
+    { 4, 0, 4, 4, { 0,   255, 0,   0   } },
+};
+
+enum { WEBP_CANVAS_SIZE = 8 };
+
+/* Draws the frame over the canvas the same way the codec does. */
+static void webp_draw_frame(unsigned char *canvas, unsigned frame, bool blend) {
+
+    for (unsigned row = WEBP_FRAMES[frame].y; row < WEBP_FRAMES[frame].y + WEBP_FRAMES[frame].height; row++) {
+        for (unsigned column = WEBP_FRAMES[frame].x; column < WEBP_FRAMES[frame].x + WEBP_FRAMES[frame].width; column++) {
+            unsigned char *dst = canvas + (row * WEBP_CANVAS_SIZE + column) * 4;
+            const unsigned char *src = WEBP_FRAMES[frame].rgba;
+
+            if (!blend) {
+                memcpy(dst, src, 4);
+                continue;
+            }
+
+            const double src_a = src[3] / 255.0;
+            const double dst_a = dst[3] / 255.0;
+
+            for (unsigned i = 0; i < 3; i++) {
+                dst[i] = (unsigned char)(src_a * src[i] + (1 - src_a) * dst_a * dst[i]);
+            }
+
+            dst[3] = (unsigned char)((src_a + (1 - src_a) * dst_a) * 255);
+        }
+    }
+}
+
+static MunitResult test_webp_animated(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const enum SailDecodeQuality decode_quality = decode_quality_from_string(munit_parameters_get(params, "quality"));
+    const bool blend = strcmp(munit_parameters_get(params, "blend"), "blend") == 0;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("webp", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(sail_test_image_with_extension(SAIL_TEST_OPTIONAL_CODEC_IMAGES,
+                                                                           blend ? "/animated-blend.webp" : "/animated-no-blend.webp"),
+                                            &data, &data_size) == SAIL_OK);
+
+    struct sail_read_options *read_options;
+    munit_assert(sail_alloc_read_options_from_features(codec_info->read_features, &read_options) == SAIL_OK);
+    read_options->decode_quality = decode_quality;
+
+    void *state = NULL;
+    munit_assert(sail_start_reading_memory_with_options(data, data_size, codec_info, read_options, &state) == SAIL_OK);
+    sail_destroy_read_options(read_options);
+
+    /* The canvas starts with the transparent black background. */
+    unsigned char canvas[WEBP_CANVAS_SIZE * WEBP_CANVAS_SIZE * 4] = { 0 };
+
+    for (unsigned frame = 0; frame < sizeof(WEBP_FRAMES) / sizeof(WEBP_FRAMES[0]); frame++) {
+        struct sail_image *image = NULL;
+        munit_assert(sail_read_next_frame(state, &image) == SAIL_OK);
+
+        munit_assert_uint(image->width, ==, WEBP_CANVAS_SIZE);
+        munit_assert_uint(image->height, ==, WEBP_CANVAS_SIZE);
+        munit_assert(image->pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA);
+        munit_assert_int(image->delay, ==, 100);
+
+        webp_draw_frame(canvas, frame, blend);
+
+        for (unsigned row = 0; row < WEBP_CANVAS_SIZE; row++) {
+            const unsigned char *scan_line = (const unsigned char *)image->pixels + row * image->bytes_per_line;
+
+            for (unsigned i = 0; i < WEBP_CANVAS_SIZE * 4; i++) {
+                munit_assert_int(abs(scan_line[i] - canvas[row * WEBP_CANVAS_SIZE * 4 + i]), <=, 1);
+            }
+        }
+
+        sail_destroy_image(image);
+    }
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_read_next_frame(state, &image) == SAIL_ERROR_NO_MORE_FRAMES);
+
+    munit_assert(sail_stop_reading(state) == SAIL_OK);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path",    (char **)SAIL_TEST_IMAGES },
+    { (char *)"quality", (char **)QUALITIES },
+    { NULL, NULL },
+};
+
+static MunitParameterEnum test_quality_params[] = {
+    { (char *)"quality", (char **)QUALITIES },
+    { NULL, NULL },
+};
+
+static MunitParameterEnum test_webp_animated_params[] = {
+    { (char *)"quality", (char **)QUALITIES },
+    { (char *)"blend",   (char **)BLEND_METHODS },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/jpeg",          test_jpeg,          NULL, NULL, MUNIT_TEST_OPTION_NONE, test_quality_params },
+    { (char *)"/lossless",      test_lossless,      NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/avif",          test_avif,          NULL, NULL, MUNIT_TEST_OPTION_NONE, test_quality_params },
+    { (char *)"/jpeg2000",      test_jpeg2000,      NULL, NULL, MUNIT_TEST_OPTION_NONE, test_quality_params },
+    { (char *)"/webp-animated", test_webp_animated, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_webp_animated_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/decode-quality",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
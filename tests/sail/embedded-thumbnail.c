@@ -0,0 +1,347 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#include <stdlib.h>
+#include <string.h>
+
+#include "sail.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static const char* test_image_with_extension(const char *extension) {
+
+    for (const char * const *test_image = SAIL_TEST_IMAGES; *test_image != NULL; test_image++) {
+        if (strstr(*test_image, extension) != NULL) {
+            return *test_image;
+        }
+    }
+
+    return NULL;
+}
+
+/* Inserts the APPn segment with the specified payload right after SOI. */
+static sail_status_t insert_segment(const void *data, size_t data_size, unsigned char marker,
+                                    const void *payload, size_t payload_size,
+                                    void **result, size_t *result_size) {
+
+    const size_t segment_size = payload_size + 2;
+
+    *result_size = data_size + 2 + segment_size;
+    SAIL_TRY(sail_malloc(*result_size, result));
+
+    unsigned char *output = *result;
+
+    memcpy(output, data, 2);
+    output[2] = 0xFF;
+    output[3] = marker;
+    output[4] = (unsigned char)(segment_size >> 8);
+    output[5] = (unsigned char)(segment_size & 0xFF);
+    memcpy(output + 6, payload, payload_size);
+    memcpy(output + 6 + payload_size, (const unsigned char *)data + 2, data_size - 2);
+
+    return SAIL_OK;
+}
+
+static sail_status_t save_grayscale_jpeg(unsigned width, unsigned height, void **result, size_t *result_size) {
+
+    struct sail_image *image;
+    SAIL_TRY(sail_alloc_image(&image));
+
+    image->width          = width;
+    image->height         = height;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE;
+    image->bytes_per_line = width;
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)width * height, &image->pixels),
+                        /* cleanup */ sail_destroy_image(image));
+
+    for (unsigned row = 0; row < height; row++) {
+        memset((unsigned char *)image->pixels + row * width, (int)(row * 255 / height), width);
+    }
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY_OR_CLEANUP(sail_codec_info_from_extension("jpg", &codec_info),
+                        /* cleanup */ sail_destroy_image(image));
+
+    const size_t buffer_length = 64 * 1024;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(buffer_length, result),
+                        /* cleanup */ sail_destroy_image(image));
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_writing_memory(*result, buffer_length, codec_info, &state),
+                        /* cleanup */ sail_stop_writing(state),
+                                      sail_free(*result),
+                                      sail_destroy_image(image));
+    SAIL_TRY_OR_CLEANUP(sail_write_next_frame(state, image),
+                        /* cleanup */ sail_stop_writing(state),
+                                      sail_free(*result),
+                                      sail_destroy_image(image));
+    SAIL_TRY_OR_CLEANUP(sail_stop_writing_with_written(state, result_size),
+                        /* cleanup */ sail_free(*result),
+                                      sail_destroy_image(image));
+
+    sail_destroy_image(image);
+
+    return SAIL_OK;
+}
+
+/* Builds little-endian EXIF data with an empty IFD0 and the IFD1 pointing to the thumbnail. */
+static size_t build_exif(const void *thumbnail, size_t thumbnail_size, unsigned char *exif) {
+
+    static const unsigned char header[] = {
+        'E', 'x', 'i', 'f', 0, 0,
+        /* TIFF header, IFD0 at 8. */
+        'I', 'I', 42, 0, 8, 0, 0, 0,
+        /* IFD0: no entries, IFD1 at 14. */
+        0, 0, 14, 0, 0, 0,
+        /* IFD1: 2 entries. */
+        2, 0,
+        /* JPEGInterchangeFormat, LONG, 1, offset 44. */
+        0x01, 0x02, 4, 0, 1, 0, 0, 0, 44, 0, 0, 0,
+        /* JPEGInterchangeFormatLength, LONG, 1, length. */
+        0x02, 0x02, 4, 0, 1, 0, 0, 0, 0, 0, 0, 0,
+        /* No more IFDs. */
+        0, 0, 0, 0,
+    };
+
+    memcpy(exif, header, sizeof(header));
+
+    exif[6 + 36] = (unsigned char)(thumbnail_size & 0xFF);
+    exif[6 + 37] = (unsigned char)(thumbnail_size >> 8);
+
+    memcpy(exif + sizeof(header), thumbnail, thumbnail_size);
+
+    return sizeof(header) + thumbnail_size;
+}
+
+static MunitResult test_exif(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(test_image_with_extension(".jpg"), &data, &data_size) == SAIL_OK);
+
+    void *thumbnail_data;
+    size_t thumbnail_data_size;
+    munit_assert(save_grayscale_jpeg(16, 12, &thumbnail_data, &thumbnail_data_size) == SAIL_OK);
+
+    unsigned char *exif = malloc(thumbnail_data_size + 64);
+    const size_t exif_size = build_exif(thumbnail_data, thumbnail_data_size, exif);
+
+    void *image_data;
+    size_t image_data_size;
+    munit_assert(insert_segment(data, data_size, 0xE1, exif, exif_size, &image_data, &image_data_size) == SAIL_OK);
+
+    /* The EXIF parser. */
+    const void *thumbnail_ptr;
+    size_t thumbnail_size;
+    munit_assert_true(sail_exif_thumbnail(exif, exif_size, &thumbnail_ptr, &thumbnail_size));
+    munit_assert_size(thumbnail_size, ==, thumbnail_data_size);
+    munit_assert_memory_equal(thumbnail_size, thumbnail_ptr, thumbnail_data);
+    munit_assert_false(sail_exif_thumbnail(exif, exif_size - 1, &thumbnail_ptr, &thumbnail_size));
+
+    struct sail_image *expected;
+    munit_assert(sail_load_image_from_memory(thumbnail_data, thumbnail_data_size, &expected) == SAIL_OK);
+
+    struct sail_image *thumbnail;
+    munit_assert(sail_load_embedded_thumbnail_from_memory(image_data, image_data_size, &thumbnail) == SAIL_OK);
+
+    munit_assert_uint(thumbnail->width, ==, 16);
+    munit_assert_uint(thumbnail->height, ==, 12);
+    munit_assert(thumbnail->pixel_format == expected->pixel_format);
+    munit_assert_memory_equal((size_t)thumbnail->bytes_per_line * thumbnail->height, thumbnail->pixels, expected->pixels);
+
+    sail_destroy_image(thumbnail);
+    sail_destroy_image(expected);
+    sail_free(image_data);
+    free(exif);
+    sail_free(thumbnail_data);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_jfxx(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(test_image_with_extension(".jpg"), &data, &data_size) == SAIL_OK);
+
+    /* JFXX with an RGB thumbnail. */
+    enum { WIDTH = 5, HEIGHT = 3 };
+    unsigned char jfxx[8 + WIDTH * HEIGHT * 3] = { 'J', 'F', 'X', 'X', 0, 0x13, WIDTH, HEIGHT };
+
+    for (unsigned i = 8; i < sizeof(jfxx); i++) {
+        jfxx[i] = (unsigned char)(i * 7);
+    }
+
+    void *image_data;
+    size_t image_data_size;
+    munit_assert(insert_segment(data, data_size, 0xE0, jfxx, sizeof(jfxx), &image_data, &image_data_size) == SAIL_OK);
+
+    struct sail_image *thumbnail;
+    munit_assert(sail_load_embedded_thumbnail_from_memory(image_data, image_data_size, &thumbnail) == SAIL_OK);
+
+    munit_assert_uint(thumbnail->width, ==, WIDTH);
+    munit_assert_uint(thumbnail->height, ==, HEIGHT);
+    munit_assert(thumbnail->pixel_format == SAIL_PIXEL_FORMAT_BPP24_RGB);
+
+    for (unsigned row = 0; row < HEIGHT; row++) {
+        munit_assert_memory_equal(WIDTH * 3,
+                                  (const unsigned char *)thumbnail->pixels + row * thumbnail->bytes_per_line,
+                                  jfxx + 8 + row * WIDTH * 3);
+    }
+
+    sail_destroy_image(thumbnail);
+    sail_free(image_data);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_broken_fallback(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(test_image_with_extension(".jpg"), &data, &data_size) == SAIL_OK);
+
+    /* Valid JFXX with an RGB thumbnail. */
+    enum { WIDTH = 4, HEIGHT = 2 };
+    unsigned char jfxx[8 + WIDTH * HEIGHT * 3] = { 'J', 'F', 'X', 'X', 0, 0x13, WIDTH, HEIGHT };
+
+    for (unsigned i = 8; i < sizeof(jfxx); i++) {
+        jfxx[i] = (unsigned char)(i * 11);
+    }
+
+    /* Broken JPEG stream thumbnails. */
+    static const unsigned char broken[] = { 0xFF, 0xD8, 0xFF, 0xDB, 0x00, 0x43, 0x00, 0x01, 0x02, 0x03 };
+
+    unsigned char exif[64 + sizeof(broken)];
+    const size_t exif_size = build_exif(broken, sizeof(broken), exif);
+
+    unsigned char jfxx_jpeg[6 + sizeof(broken)] = { 'J', 'F', 'X', 'X', 0, 0x10 };
+    memcpy(jfxx_jpeg + 6, broken, sizeof(broken));
+
+    /* The largest possible segment, so the thumbnails don't fit into the first chunk read. */
+    enum { PADDING_SIZE = 65533 };
+    unsigned char *padding = calloc(1, PADDING_SIZE);
+
+    /* Segments are inserted after SOI, so they end up in the reversed order. */
+    const struct {
+        unsigned char marker;
+        const void *payload;
+        size_t payload_size;
+    } segments[] = {
+        { 0xE0, jfxx,      sizeof(jfxx)      },
+        { 0xE1, exif,      exif_size         },
+        { 0xE0, jfxx_jpeg, sizeof(jfxx_jpeg) },
+        { 0xE2, padding,   PADDING_SIZE      },
+    };
+    const size_t segments_count = sizeof(segments) / sizeof(segments[0]);
+
+    /* Broken thumbnails fall back to the JFIF thumbnail, and are not found without it. */
+    for (size_t first = 0; first < 2; first++) {
+        void *image_data = data;
+        size_t image_data_size = data_size;
+
+        for (size_t i = first; i < segments_count; i++) {
+            void *result;
+            size_t result_size;
+            munit_assert(insert_segment(image_data, image_data_size, segments[i].marker,
+                                        segments[i].payload, segments[i].payload_size, &result, &result_size) == SAIL_OK);
+            if (image_data != data) {
+                sail_free(image_data);
+            }
+            image_data      = result;
+            image_data_size = result_size;
+        }
+
+        struct sail_image *thumbnail;
+
+        if (first > 0) {
+            munit_assert(sail_load_embedded_thumbnail_from_memory(image_data, image_data_size, &thumbnail) == SAIL_ERROR_THUMBNAIL_NOT_FOUND);
+            sail_free(image_data);
+            continue;
+        }
+
+        munit_assert(sail_load_embedded_thumbnail_from_memory(image_data, image_data_size, &thumbnail) == SAIL_OK);
+
+        munit_assert_uint(thumbnail->width, ==, WIDTH);
+        munit_assert_uint(thumbnail->height, ==, HEIGHT);
+        munit_assert(thumbnail->pixel_format == SAIL_PIXEL_FORMAT_BPP24_RGB);
+
+        for (unsigned row = 0; row < HEIGHT; row++) {
+            munit_assert_memory_equal(WIDTH * 3,
+                                      (const unsigned char *)thumbnail->pixels + row * thumbnail->bytes_per_line,
+                                      jfxx + 8 + row * WIDTH * 3);
+        }
+
+        sail_destroy_image(thumbnail);
+        sail_free(image_data);
+    }
+
+    free(padding);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_not_found(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *thumbnail;
+    munit_assert(sail_load_embedded_thumbnail_from_file(test_image_with_extension(".jpg"), &thumbnail) == SAIL_ERROR_THUMBNAIL_NOT_FOUND);
+    munit_assert(sail_load_embedded_thumbnail_from_file(test_image_with_extension(".png"), &thumbnail) == SAIL_ERROR_THUMBNAIL_NOT_FOUND);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/exif",            test_exif,            NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/jfxx",            test_jfxx,            NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/broken-fallback", test_broken_fallback, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/not-found",       test_not_found,       NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/embedded-thumbnail",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
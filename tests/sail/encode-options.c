@@ -0,0 +1,292 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sail.h"
+
+#include "munit.h"
+
+static const char *CHROMA_SUBSAMPLINGS[] = { "444", "422", "420", NULL };
+
+static const char *JPEG_CODINGS[] = { "default", "optimize", "progressive", "restart", "ifast", "float", "arithmetic", NULL };
+
+static enum SailChromaSubsampling chroma_subsampling_from_string(const char *str) {
+
+    if (strcmp(str, "444") == 0) {
+        return SAIL_CHROMA_SUBSAMPLING_444;
+    } else if (strcmp(str, "422") == 0) {
+        return SAIL_CHROMA_SUBSAMPLING_422;
+    } else {
+        return SAIL_CHROMA_SUBSAMPLING_420;
+    }
+}
+
+static struct sail_image* gradient(void) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+    image->width          = 64;
+    image->height         = 48;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image->bytes_per_line = image->width * 3;
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * image->height, &image->pixels) == SAIL_OK);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        unsigned char *scan_line = (unsigned char *)image->pixels + row * image->bytes_per_line;
+
+        for (unsigned column = 0; column < image->width; column++) {
+            scan_line[column * 3 + 0] = (unsigned char)(column * 4);
+            scan_line[column * 3 + 1] = (unsigned char)(row * 5);
+            scan_line[column * 3 + 2] = (unsigned char)((column + row) * 2);
+        }
+    }
+
+    return image;
+}
+
+static sail_status_t write_with_options(const struct sail_image *image, const struct sail_codec_info *codec_info,
+                                        const struct sail_write_options *write_options,
+                                        void *buffer, size_t buffer_length, size_t *written) {
+
+    void *state = NULL;
+    SAIL_TRY(sail_start_writing_memory_with_options(buffer, buffer_length, codec_info, write_options, &state));
+
+    SAIL_TRY_OR_CLEANUP(sail_write_next_frame(state, image),
+                        /* cleanup */ sail_stop_writing(state));
+
+    SAIL_TRY(sail_stop_writing_with_written(state, written));
+
+    return SAIL_OK;
+}
+
+static unsigned count_markers(const unsigned char *data, size_t data_size, unsigned char marker) {
+
+    unsigned count = 0;
+
+    for (size_t i = 0; i + 1 < data_size; i++) {
+        if (data[i] == 0xFF && data[i + 1] == marker) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+static void assert_close(const struct sail_image *image, const struct sail_image *image_read) {
+
+    munit_assert_uint(image_read->width, ==, image->width);
+    munit_assert_uint(image_read->height, ==, image->height);
+    munit_assert(image_read->pixel_format == image->pixel_format);
+
+    const unsigned char *pixels      = image->pixels;
+    const unsigned char *pixels_read = image_read->pixels;
+
+    for (size_t i = 0; i < (size_t)image->bytes_per_line * image->height; i++) {
+        munit_assert_int(abs(pixels[i] - pixels_read[i]), <=, 24);
+    }
+}
+
+static MunitResult test_jpeg_chroma_subsampling(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const enum SailChromaSubsampling chroma_subsampling = chroma_subsampling_from_string(munit_parameters_get(params, "chroma-subsampling"));
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("jpg", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image = gradient();
+
+    struct sail_write_options *write_options;
+    munit_assert(sail_alloc_write_options_from_features(codec_info->write_features, &write_options) == SAIL_OK);
+    write_options->chroma_subsampling = chroma_subsampling;
+
+    const size_t buffer_length = 64 * 1024;
+    void *buffer;
+    munit_assert(sail_malloc(buffer_length, &buffer) == SAIL_OK);
+
+    size_t written;
+    munit_assert(write_with_options(image, codec_info, write_options, buffer, buffer_length, &written) == SAIL_OK);
+
+    struct sail_image *image_read = NULL;
+    munit_assert(sail_load_image_from_memory(buffer, written, &image_read) == SAIL_OK);
+
+    munit_assert(image_read->source_image->chroma_subsampling == chroma_subsampling);
+    assert_close(image, image_read);
+
+    sail_destroy_image(image_read);
+    sail_free(buffer);
+    sail_destroy_write_options(write_options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_jpeg_coding(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *coding = munit_parameters_get(params, "coding");
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("jpg", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image = gradient();
+
+    struct sail_write_options *write_options;
+    munit_assert(sail_alloc_write_options_from_features(codec_info->write_features, &write_options) == SAIL_OK);
+    write_options->chroma_subsampling = SAIL_CHROMA_SUBSAMPLING_420;
+
+    if (strcmp(coding, "optimize") == 0) {
+        write_options->optimize_coding = true;
+    } else if (strcmp(coding, "progressive") == 0) {
+        write_options->progressive = true;
+    } else if (strcmp(coding, "restart") == 0) {
+        write_options->restart_interval = 1;
+    } else if (strcmp(coding, "ifast") == 0) {
+        write_options->dct_method = SAIL_DCT_METHOD_IFAST;
+    } else if (strcmp(coding, "float") == 0) {
+        write_options->dct_method = SAIL_DCT_METHOD_FLOAT;
+    } else if (strcmp(coding, "arithmetic") == 0) {
+        write_options->arithmetic_coding = true;
+    }
+
+    const size_t buffer_length = 64 * 1024;
+    void *buffer;
+    munit_assert(sail_malloc(buffer_length, &buffer) == SAIL_OK);
+
+    size_t written;
+    const sail_status_t status = write_with_options(image, codec_info, write_options, buffer, buffer_length, &written);
+
+    /* The JPEG library may be built without arithmetic coding. */
+    if (write_options->arithmetic_coding && status == SAIL_ERROR_UNSUPPORTED_COMPRESSION) {
+        sail_free(buffer);
+        sail_destroy_write_options(write_options);
+        sail_destroy_image(image);
+        return MUNIT_SKIP;
+    }
+
+    munit_assert(status == SAIL_OK);
+
+    const unsigned char *data = buffer;
+
+    if (write_options->progressive) {
+        munit_assert_uint(count_markers(data, written, 0xC2), ==, 1);
+        munit_assert_uint(count_markers(data, written, 0xDA), >, 1);
+    } else if (write_options->arithmetic_coding) {
+        munit_assert_uint(count_markers(data, written, 0xC9), ==, 1);
+    } else {
+        munit_assert_uint(count_markers(data, written, 0xDA), ==, 1);
+    }
+
+    if (write_options->restart_interval > 0) {
+        munit_assert_uint(count_markers(data, written, 0xDD), ==, 1);
+        munit_assert_uint(count_markers(data, written, 0xD0), >, 0);
+    } else {
+        munit_assert_uint(count_markers(data, written, 0xDD), ==, 0);
+    }
+
+    struct sail_image *image_read = NULL;
+    munit_assert(sail_load_image_from_memory(buffer, written, &image_read) == SAIL_OK);
+
+    assert_close(image, image_read);
+
+    sail_destroy_image(image_read);
+    sail_free(buffer);
+    sail_destroy_write_options(write_options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_jpeg_optimize_coding(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("jpg", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image = gradient();
+
+    struct sail_write_options *write_options;
+    munit_assert(sail_alloc_write_options_from_features(codec_info->write_features, &write_options) == SAIL_OK);
+
+    const size_t buffer_length = 64 * 1024;
+    void *buffer;
+    munit_assert(sail_malloc(buffer_length, &buffer) == SAIL_OK);
+
+    size_t written_standard;
+    munit_assert(write_with_options(image, codec_info, write_options, buffer, buffer_length, &written_standard) == SAIL_OK);
+
+    write_options->optimize_coding = true;
+
+    size_t written_optimized;
+    munit_assert(write_with_options(image, codec_info, write_options, buffer, buffer_length, &written_optimized) == SAIL_OK);
+
+    /* Optimal Huffman tables make files smaller. */
+    munit_assert_size(written_optimized, <, written_standard);
+
+    sail_free(buffer);
+    sail_destroy_write_options(write_options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_chroma_subsampling_params[] = {
+    { (char *)"chroma-subsampling", (char **)CHROMA_SUBSAMPLINGS },
+    { NULL, NULL },
+};
+
+static MunitParameterEnum test_coding_params[] = {
+    { (char *)"coding", (char **)JPEG_CODINGS },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/jpeg-chroma-subsampling", test_jpeg_chroma_subsampling, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_chroma_subsampling_params },
+    { (char *)"/jpeg-coding",             test_jpeg_coding,             NULL, NULL, MUNIT_TEST_OPTION_NONE, test_coding_params },
+    { (char *)"/jpeg-optimize-coding",    test_jpeg_optimize_coding,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/encode-options",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,162 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <unistd.h>
+
+#include "sail.h"
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static MunitResult test_alloc_and_map(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(sail_load_image_from_file(path, &image) == SAIL_OK);
+
+    struct sail_image *image_shm;
+    int fd = -1;
+    munit_assert(sail_alloc_image_shm(image, &image_shm, &fd) == SAIL_OK);
+    munit_assert(fd >= 0);
+    munit_assert((uintptr_t)image_shm->pixels % SAIL_RAW_IMAGE_PIXELS_ALIGNMENT == 0);
+    munit_assert(sail_compare_images(image, image_shm) == SAIL_OK);
+
+    /* Map the same object the way another process would do. */
+    struct sail_image *image_mapped;
+    munit_assert(sail_map_image_shm(fd, &image_mapped) == SAIL_OK);
+    munit_assert_ptr_not_equal(image_mapped->pixels, image_shm->pixels);
+    munit_assert(sail_compare_images(image, image_mapped) == SAIL_OK);
+
+    /* The pixels are shared. */
+    unsigned char *pixels_shm = image_shm->pixels;
+    const unsigned char *pixels_mapped = image_mapped->pixels;
+    pixels_shm[0] = (unsigned char)~pixels_shm[0];
+    munit_assert_uint8(pixels_mapped[0], ==, pixels_shm[0]);
+
+    /* The images stay valid after closing the descriptor. */
+    close(fd);
+    pixels_shm[0] = (unsigned char)~pixels_shm[0];
+    munit_assert(sail_compare_images(image, image_mapped) == SAIL_OK);
+
+    sail_destroy_image_shm(image_mapped);
+    sail_destroy_image_shm(image_shm);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_alloc_without_pixels(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+    (void)params;
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width        = 17;
+    image->height       = 5;
+    image->pixel_format = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    munit_assert(sail_bytes_per_line(image->width, image->pixel_format, &image->bytes_per_line) == SAIL_OK);
+
+    struct sail_image *image_shm;
+    int fd = -1;
+    munit_assert(sail_alloc_image_shm(image, &image_shm, &fd) == SAIL_OK);
+    munit_assert_not_null(image_shm->pixels);
+    munit_assert_uint(image_shm->width, ==, 17);
+    munit_assert_uint(image_shm->height, ==, 5);
+
+    const unsigned char *pixels = image_shm->pixels;
+    for (size_t i = 0; i < image_shm->bytes_per_line * image_shm->height; i++) {
+        munit_assert_uint8(pixels[i], ==, 0);
+    }
+
+    close(fd);
+    sail_destroy_image_shm(image_shm);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_view(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(sail_load_image_from_file(path, &image) == SAIL_OK);
+
+    struct sail_image *image_shm;
+    int fd = -1;
+    munit_assert(sail_alloc_image_shm(image, &image_shm, &fd) == SAIL_OK);
+    close(fd);
+
+    struct sail_image *view_shm;
+    munit_assert(sail_image_view(image_shm, 0, 1, image->width, image->height / 2, &view_shm) == SAIL_OK);
+
+    struct sail_image *view;
+    munit_assert(sail_image_view(image, 0, 1, image->width, image->height / 2, &view) == SAIL_OK);
+
+    /* The view keeps the shared pixels mapped. */
+    sail_destroy_image_shm(image_shm);
+    munit_assert(sail_compare_images(view, view_shm) == SAIL_OK);
+
+    sail_destroy_image(view_shm);
+    sail_destroy_image(view);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/alloc-and-map",        test_alloc_and_map,        NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/alloc-without-pixels", test_alloc_without_pixels, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/view",                 test_view,                 NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/image-shm",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
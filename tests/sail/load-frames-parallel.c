@@ -0,0 +1,131 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021-2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sail.h"
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static MunitResult test_load_frames_parallel(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(sail_load_image_from_file(path, &image) == SAIL_OK);
+
+    struct sail_image **frames = NULL;
+    size_t frames_count = 0;
+    munit_assert(sail_load_all_frames_parallel(path, 4, &frames, &frames_count) == SAIL_OK);
+    munit_assert_not_null(frames);
+    munit_assert(frames_count == 1);
+
+    munit_assert(sail_compare_images(image, frames[0]) == SAIL_OK);
+
+    for (size_t i = 0; i < frames_count; i++) {
+        sail_destroy_image(frames[i]);
+    }
+
+    sail_free(frames);
+    sail_destroy_image(image);
+
+    munit_assert(sail_load_all_frames_parallel(path, 0, &frames, &frames_count) == SAIL_ERROR_INVALID_ARGUMENT);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_load_frames_parallel_multi_frame(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+    const unsigned threads = (unsigned)atoi(munit_parameters_get(params, "threads"));
+
+    struct sail_image **frames = NULL;
+    size_t frames_count = 0;
+    munit_assert(sail_load_all_frames_parallel(path, threads, &frames, &frames_count) == SAIL_OK);
+    munit_assert_not_null(frames);
+    munit_assert(frames_count > 1);
+
+    /* Every frame must match the frame read sequentially. */
+    void *state = NULL;
+    munit_assert(sail_start_reading_file(path, NULL, &state) == SAIL_OK);
+
+    for (size_t i = 0; i < frames_count; i++) {
+        struct sail_image *image;
+        munit_assert(sail_read_next_frame(state, &image) == SAIL_OK);
+        munit_assert(sail_compare_images(image, frames[i]) == SAIL_OK);
+        sail_destroy_image(image);
+    }
+
+    struct sail_image *image;
+    munit_assert(sail_read_next_frame(state, &image) == SAIL_ERROR_NO_MORE_FRAMES);
+    munit_assert(sail_stop_reading(state) == SAIL_OK);
+
+    for (size_t i = 0; i < frames_count; i++) {
+        sail_destroy_image(frames[i]);
+    }
+
+    sail_free(frames);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static char *threads_params[] = { (char *)"2", (char *)"3", (char *)"8", NULL };
+
+static MunitParameterEnum test_multi_frame_params[] = {
+    { (char *)"path",    (char **)SAIL_TEST_MULTI_FRAME_IMAGES },
+    { (char *)"threads", threads_params },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/load-frames-parallel",             test_load_frames_parallel,             NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/load-frames-parallel-multi-frame", test_load_frames_parallel_multi_frame, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_multi_frame_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/load-frames-parallel",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,399 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdlib.h>
+
+#include "sail.h"
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static sail_status_t transform_data(const void *data, size_t data_size, const struct sail_write_options *write_options,
+                                    void **result, size_t *result_size) {
+
+    const size_t buffer_length = data_size * 2 + 64 * 1024;
+    void *buffer;
+    SAIL_TRY(sail_malloc(buffer_length, &buffer));
+
+    struct sail_io *input;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_io_read_memory(data, data_size, &input),
+                        /* cleanup */ sail_free(buffer));
+
+    struct sail_io *output;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_io_read_write_memory(buffer, buffer_length, &output),
+                        /* cleanup */ sail_destroy_io(input),
+                                      sail_free(buffer));
+
+    SAIL_TRY_OR_CLEANUP(sail_transform_io_lossless(input, output, write_options),
+                        /* cleanup */ sail_destroy_io(output),
+                                      sail_destroy_io(input),
+                                      sail_free(buffer));
+
+    SAIL_TRY_OR_CLEANUP(output->tell(output->stream, result_size),
+                        /* cleanup */ sail_destroy_io(output),
+                                      sail_destroy_io(input),
+                                      sail_free(buffer));
+
+    sail_destroy_io(output);
+    sail_destroy_io(input);
+
+    *result = buffer;
+
+    return SAIL_OK;
+}
+
+static sail_status_t transform_data_twice(const void *data, size_t data_size, enum SailLosslessTransform lossless_transform,
+                                          void **result, size_t *result_size) {
+
+    struct sail_write_options *write_options;
+    SAIL_TRY(sail_alloc_write_options(&write_options));
+    write_options->lossless_transform = lossless_transform;
+
+    void *once;
+    size_t once_size;
+    SAIL_TRY_OR_CLEANUP(transform_data(data, data_size, write_options, &once, &once_size),
+                        /* cleanup */ sail_destroy_write_options(write_options));
+
+    SAIL_TRY_OR_CLEANUP(transform_data(once, once_size, write_options, result, result_size),
+                        /* cleanup */ sail_free(once),
+                                      sail_destroy_write_options(write_options));
+
+    sail_free(once);
+    sail_destroy_write_options(write_options);
+
+    return SAIL_OK;
+}
+
+/* Maps a pixel of the transformed image to the source image. */
+static void map_pixel(enum SailLosslessTransform lossless_transform, unsigned width, unsigned height,
+                      unsigned x, unsigned y, unsigned *source_x, unsigned *source_y) {
+
+    switch (lossless_transform) {
+        case SAIL_LOSSLESS_TRANSFORM_FLIP_HORIZONTALLY: *source_x = width - 1 - x;  *source_y = y;              break;
+        case SAIL_LOSSLESS_TRANSFORM_FLIP_VERTICALLY:   *source_x = x;              *source_y = height - 1 - y; break;
+        case SAIL_LOSSLESS_TRANSFORM_TRANSPOSE:         *source_x = y;              *source_y = x;              break;
+        case SAIL_LOSSLESS_TRANSFORM_ROTATE_90:         *source_x = y;              *source_y = width - 1 - x;  break;
+        case SAIL_LOSSLESS_TRANSFORM_ROTATE_180:        *source_x = width - 1 - x;  *source_y = height - 1 - y; break;
+        case SAIL_LOSSLESS_TRANSFORM_ROTATE_270:        *source_x = height - 1 - y; *source_y = x;              break;
+        default:                                        *source_x = x;              *source_y = y;              break;
+    }
+}
+
+/*
+ * Returns the mean difference of the transformed pixels from the source ones. It's not zero
+ * as chroma upsampling at the block edges depends on the neighbor blocks.
+ */
+static double mean_difference(const struct sail_image *image, const struct sail_image *image_transformed,
+                              enum SailLosslessTransform lossless_transform, unsigned offset_x, unsigned offset_y) {
+
+    munit_assert(image->pixel_format == image_transformed->pixel_format);
+
+    unsigned bits_per_pixel;
+    munit_assert(sail_bits_per_pixel(image->pixel_format, &bits_per_pixel) == SAIL_OK);
+    const unsigned bytes_per_pixel = bits_per_pixel / 8;
+
+    double difference = 0;
+
+    for (unsigned y = 0; y < image_transformed->height; y++) {
+        const unsigned char *row = (const unsigned char *)image_transformed->pixels + y * image_transformed->bytes_per_line;
+
+        for (unsigned x = 0; x < image_transformed->width; x++) {
+            unsigned source_x;
+            unsigned source_y;
+            map_pixel(lossless_transform, image_transformed->width, image_transformed->height, x, y, &source_x, &source_y);
+
+            const unsigned char *source_pixel = (const unsigned char *)image->pixels
+                                                    + (source_y + offset_y) * image->bytes_per_line
+                                                    + (source_x + offset_x) * bytes_per_pixel;
+
+            for (unsigned i = 0; i < bytes_per_pixel; i++) {
+                difference += abs(row[x * bytes_per_pixel + i] - source_pixel[i]);
+            }
+        }
+    }
+
+    return difference / ((double)image_transformed->width * image_transformed->height * bytes_per_pixel);
+}
+
+static MunitResult test_transform(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const char *path = sail_test_image_with_extension(SAIL_TEST_IMAGES, ".jpg");
+    munit_assert_not_null(path);
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(path, &data, &data_size) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_load_image_from_memory(data, data_size, &image) == SAIL_OK);
+
+    /* The test image is 4:2:0, so the MCU is 16x16 and the bottom MCU row is partial. */
+    const unsigned trimmed_height = image->height / 16 * 16;
+    munit_assert_uint(image->width % 16, ==, 0);
+    munit_assert_uint(trimmed_height, <, image->height);
+
+    static const enum SailLosslessTransform TRANSFORMS[] = {
+        SAIL_LOSSLESS_TRANSFORM_FLIP_HORIZONTALLY,
+        SAIL_LOSSLESS_TRANSFORM_FLIP_VERTICALLY,
+        SAIL_LOSSLESS_TRANSFORM_TRANSPOSE,
+        SAIL_LOSSLESS_TRANSFORM_ROTATE_90,
+        SAIL_LOSSLESS_TRANSFORM_ROTATE_180,
+        SAIL_LOSSLESS_TRANSFORM_ROTATE_270,
+    };
+
+    struct sail_write_options *write_options;
+    munit_assert(sail_alloc_write_options(&write_options) == SAIL_OK);
+
+    for (size_t i = 0; i < sizeof(TRANSFORMS) / sizeof(TRANSFORMS[0]); i++) {
+        write_options->lossless_transform = TRANSFORMS[i];
+
+        void *result;
+        size_t result_size;
+        munit_assert(transform_data(data, data_size, write_options, &result, &result_size) == SAIL_OK);
+
+        struct sail_image *image_transformed;
+        munit_assert(sail_load_image_from_memory(result, result_size, &image_transformed) == SAIL_OK);
+
+        const bool transposed = TRANSFORMS[i] == SAIL_LOSSLESS_TRANSFORM_TRANSPOSE
+                                    || TRANSFORMS[i] == SAIL_LOSSLESS_TRANSFORM_ROTATE_90
+                                    || TRANSFORMS[i] == SAIL_LOSSLESS_TRANSFORM_ROTATE_270;
+        const bool trimmed = TRANSFORMS[i] == SAIL_LOSSLESS_TRANSFORM_FLIP_VERTICALLY
+                                || TRANSFORMS[i] == SAIL_LOSSLESS_TRANSFORM_ROTATE_90
+                                || TRANSFORMS[i] == SAIL_LOSSLESS_TRANSFORM_ROTATE_180;
+        const unsigned height = trimmed ? trimmed_height : image->height;
+
+        munit_assert_uint(image_transformed->width,  ==, transposed ? height : image->width);
+        munit_assert_uint(image_transformed->height, ==, transposed ? image->width : height);
+
+        const double difference = mean_difference(image, image_transformed, TRANSFORMS[i], 0, 0);
+        munit_assert_double(difference, <, 2);
+
+        sail_destroy_image(image_transformed);
+        sail_free(result);
+    }
+
+    sail_destroy_write_options(write_options);
+    sail_destroy_image(image);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_transform_twice(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const char *path = sail_test_image_with_extension(SAIL_TEST_IMAGES, ".jpg");
+    munit_assert_not_null(path);
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(path, &data, &data_size) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_load_image_from_memory(data, data_size, &image) == SAIL_OK);
+
+    /* Involutions without trimming restore the exact coefficients. */
+    static const enum SailLosslessTransform TRANSFORMS[] = {
+        SAIL_LOSSLESS_TRANSFORM_FLIP_HORIZONTALLY,
+        SAIL_LOSSLESS_TRANSFORM_TRANSPOSE,
+    };
+
+    for (size_t i = 0; i < sizeof(TRANSFORMS) / sizeof(TRANSFORMS[0]); i++) {
+        void *result;
+        size_t result_size;
+        munit_assert(transform_data_twice(data, data_size, TRANSFORMS[i], &result, &result_size) == SAIL_OK);
+
+        struct sail_image *image_transformed;
+        munit_assert(sail_load_image_from_memory(result, result_size, &image_transformed) == SAIL_OK);
+        munit_assert_uint(image_transformed->width,  ==, image->width);
+        munit_assert_uint(image_transformed->height, ==, image->height);
+        munit_assert(image_transformed->pixel_format == image->pixel_format);
+        munit_assert_memory_equal(image->bytes_per_line * image->height, image_transformed->pixels, image->pixels);
+
+        sail_destroy_image(image_transformed);
+        sail_free(result);
+    }
+
+    sail_destroy_image(image);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_crop(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const char *path = sail_test_image_with_extension(SAIL_TEST_IMAGES, ".jpg");
+    munit_assert_not_null(path);
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(path, &data, &data_size) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_load_image_from_memory(data, data_size, &image) == SAIL_OK);
+
+    struct sail_write_options *write_options;
+    munit_assert(sail_alloc_write_options(&write_options) == SAIL_OK);
+
+    /* The left and top edges are aligned down to the MCU size. */
+    write_options->lossless_transform = SAIL_LOSSLESS_TRANSFORM_CROP;
+    write_options->crop_x             = 20;
+    write_options->crop_y             = 40;
+    write_options->crop_width         = 50;
+    write_options->crop_height        = 1000;
+
+    void *result;
+    size_t result_size;
+    munit_assert(transform_data(data, data_size, write_options, &result, &result_size) == SAIL_OK);
+
+    struct sail_image *image_transformed;
+    munit_assert(sail_load_image_from_memory(result, result_size, &image_transformed) == SAIL_OK);
+    munit_assert_uint(image_transformed->width,  ==, 20 + 50 - 16);
+    munit_assert_uint(image_transformed->height, ==, image->height - 32);
+
+    const double difference = mean_difference(image, image_transformed, SAIL_LOSSLESS_TRANSFORM_CROP, 16, 32);
+    munit_assert_double(difference, <, 2);
+
+    sail_destroy_image(image_transformed);
+    sail_free(result);
+
+    /* Rectangles outside of the image are rejected. */
+    write_options->crop_x = image->width;
+    munit_assert(transform_data(data, data_size, write_options, &result, &result_size) == SAIL_ERROR_INVALID_ARGUMENT);
+
+    sail_destroy_write_options(write_options);
+    sail_destroy_image(image);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_reset_orientation(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const char *path = sail_test_image_with_extension(SAIL_TEST_IMAGES, ".jpg");
+    munit_assert_not_null(path);
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(path, &data, &data_size) == SAIL_OK);
+
+    void *oriented_data;
+    size_t oriented_data_size;
+    munit_assert(sail_test_insert_exif_orientation(data, data_size, SAIL_ORIENTATION_ROTATE_90, false, &oriented_data, &oriented_data_size) == SAIL_OK);
+
+    struct sail_write_options *write_options;
+    munit_assert(sail_alloc_write_options(&write_options) == SAIL_OK);
+
+    void *result;
+    size_t result_size;
+    struct sail_image *image_transformed;
+
+    /* Rotating the stored image makes the EXIF orientation obsolete. */
+    write_options->lossless_transform = SAIL_LOSSLESS_TRANSFORM_ROTATE_90;
+    munit_assert(transform_data(oriented_data, oriented_data_size, write_options, &result, &result_size) == SAIL_OK);
+    munit_assert(sail_load_image_from_memory(result, result_size, &image_transformed) == SAIL_OK);
+    munit_assert(image_transformed->source_image->orientation == SAIL_ORIENTATION_NORMAL);
+    sail_destroy_image(image_transformed);
+    sail_free(result);
+
+    /* Cropping keeps it. */
+    write_options->lossless_transform = SAIL_LOSSLESS_TRANSFORM_CROP;
+    write_options->crop_width         = 16;
+    write_options->crop_height        = 16;
+    munit_assert(transform_data(oriented_data, oriented_data_size, write_options, &result, &result_size) == SAIL_OK);
+    munit_assert(sail_load_image_from_memory(result, result_size, &image_transformed) == SAIL_OK);
+    munit_assert(image_transformed->source_image->orientation == SAIL_ORIENTATION_ROTATE_90);
+    sail_destroy_image(image_transformed);
+    sail_free(result);
+
+    sail_destroy_write_options(write_options);
+    sail_free(oriented_data);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_unsupported_codec(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    for (const char * const *test_image = SAIL_TEST_IMAGES; *test_image != NULL; test_image++) {
+        const struct sail_codec_info *codec_info;
+        munit_assert(sail_codec_info_from_path(*test_image, &codec_info) == SAIL_OK);
+
+        if (codec_info->write_features->features & SAIL_CODEC_FEATURE_LOSSLESS_TRANSFORM) {
+            continue;
+        }
+
+        void *data;
+        size_t data_size;
+        munit_assert(sail_file_contents_to_data(*test_image, &data, &data_size) == SAIL_OK);
+
+        struct sail_write_options *write_options;
+        munit_assert(sail_alloc_write_options(&write_options) == SAIL_OK);
+        write_options->lossless_transform = SAIL_LOSSLESS_TRANSFORM_ROTATE_90;
+
+        void *result;
+        size_t result_size;
+        munit_assert(transform_data(data, data_size, write_options, &result, &result_size) == SAIL_ERROR_UNSUPPORTED_CODEC_FEATURE);
+
+        sail_destroy_write_options(write_options);
+        sail_free(data);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/crop",              test_crop,              NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/reset-orientation", test_reset_orientation, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/transform",         test_transform,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/transform-twice",   test_transform_twice,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/unsupported-codec", test_unsupported_codec, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/lossless-transform",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
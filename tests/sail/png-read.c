@@ -0,0 +1,177 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sail.h"
+
+#include "munit.h"
+
+static const char *INTERLACING[] = { "none", "adam7", NULL };
+
+static const char *READ_PATHS[] = { "whole-image", "scan-lines", NULL };
+
+static const char *SOURCES[] = { "memory", "buffered", NULL };
+
+static void on_progress(void *user_data, unsigned rows_done, unsigned rows_total) {
+
+    (void)rows_done;
+    (void)rows_total;
+
+    (*(unsigned *)user_data)++;
+}
+
+/* Noise doesn't compress, so the encoded image is bigger than the read-ahead buffer. */
+static struct sail_image* noise(unsigned width, unsigned height) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+    image->width          = width;
+    image->height         = height;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP32_RGBA;
+    image->bytes_per_line = image->width * 4;
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * image->height, &image->pixels) == SAIL_OK);
+
+    unsigned char *pixels = image->pixels;
+    uint32_t seed = 12345;
+
+    for (size_t i = 0; i < (size_t)image->bytes_per_line * image->height; i++) {
+        seed = seed * 1103515245 + 12345;
+        pixels[i] = (unsigned char)(seed >> 16);
+    }
+
+    return image;
+}
+
+static void* encode(const struct sail_image *image, const struct sail_codec_info *codec_info, bool interlaced, size_t *written) {
+
+    struct sail_write_options *write_options;
+    munit_assert(sail_alloc_write_options_from_features(codec_info->write_features, &write_options) == SAIL_OK);
+
+    if (interlaced) {
+        write_options->io_options |= SAIL_IO_OPTION_INTERLACED;
+    }
+
+    const size_t buffer_length = (size_t)image->bytes_per_line * image->height * 2;
+    void *buffer;
+    munit_assert(sail_malloc(buffer_length, &buffer) == SAIL_OK);
+
+    void *state = NULL;
+    munit_assert(sail_start_writing_memory_with_options(buffer, buffer_length, codec_info, write_options, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_writing_with_written(state, written) == SAIL_OK);
+
+    sail_destroy_write_options(write_options);
+
+    return buffer;
+}
+
+static MunitResult test_read(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const bool interlaced = strcmp(munit_parameters_get(params, "interlacing"), "adam7") == 0;
+    const bool scan_lines = strcmp(munit_parameters_get(params, "read-path"), "scan-lines") == 0;
+    const bool buffered   = strcmp(munit_parameters_get(params, "source"), "buffered") == 0;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("png", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image = noise(211, 173);
+
+    size_t data_size;
+    void *data = encode(image, codec_info, interlaced, &data_size);
+    munit_assert_size(data_size, >, 65536);
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_memory(data, data_size, &io) == SAIL_OK);
+
+    /* Streams without contents are read through the read-ahead buffer. */
+    if (buffered) {
+        io->contents = NULL;
+    }
+
+    struct sail_read_options *read_options;
+    munit_assert(sail_alloc_read_options_from_features(codec_info->read_features, &read_options) == SAIL_OK);
+
+    /* Progress is reported between scan lines, so libpng can't read the whole image at once. */
+    unsigned progress_calls = 0;
+
+    if (scan_lines) {
+        read_options->progress           = on_progress;
+        read_options->progress_user_data = &progress_calls;
+    }
+
+    void *state = NULL;
+    munit_assert(sail_start_reading_io_with_options(io, codec_info, read_options, &state) == SAIL_OK);
+
+    struct sail_image *image_read = NULL;
+    munit_assert(sail_read_next_frame(state, &image_read) == SAIL_OK);
+    munit_assert(sail_stop_reading(state) == SAIL_OK);
+
+    munit_assert_uint(image_read->width, ==, image->width);
+    munit_assert_uint(image_read->height, ==, image->height);
+    munit_assert(image_read->pixel_format == image->pixel_format);
+    munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, image_read->pixels, image->pixels);
+
+    if (scan_lines) {
+        munit_assert_uint(progress_calls, >=, image->height);
+    }
+
+    sail_destroy_image(image_read);
+    sail_destroy_read_options(read_options);
+    sail_destroy_io(io);
+    sail_free(data);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"interlacing", (char **)INTERLACING },
+    { (char *)"read-path",   (char **)READ_PATHS },
+    { (char *)"source",      (char **)SOURCES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/read", test_read, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/png-read",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
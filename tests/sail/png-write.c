@@ -0,0 +1,479 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sail.h"
+
+#include "munit.h"
+
+static const char *PIXEL_FORMATS[] = { "BPP32-RGBA", "BPP24-BGR", "BPP64-ABGR", "BPP8-INDEXED", "BPP4-INDEXED", NULL };
+
+static const char *THREADS[] = { "2", "4", "7", NULL };
+
+static const char *PRESETS[] = { "fastest", "balanced", "smallest", NULL };
+
+static const char *ROW_FILTERS[] = { "none", "sub", "up", "average", "paeth", "all", NULL };
+
+static const char *ZLIB_STRATEGIES[] = { "generic", "filtered", "huffman-only", "rle", "fixed", NULL };
+
+static const char *PRESET_THREADS[] = { "1", "4", NULL };
+
+/* Noisy gradient that compresses well only with filtering. */
+static struct sail_image* gradient(enum SailPixelFormat pixel_format, unsigned width, unsigned height) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+    image->width        = width;
+    image->height       = height;
+    image->pixel_format = pixel_format;
+    munit_assert(sail_bytes_per_line(image->width, image->pixel_format, &image->bytes_per_line) == SAIL_OK);
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * image->height, &image->pixels) == SAIL_OK);
+
+    unsigned char *pixels = image->pixels;
+    uint32_t seed = 12345;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        for (unsigned column = 0; column < image->bytes_per_line; column++) {
+            seed = seed * 1103515245 + 12345;
+            pixels[(size_t)row * image->bytes_per_line + column] = (unsigned char)(row + column / 3 + ((seed >> 16) & 3));
+        }
+    }
+
+    if (pixel_format == SAIL_PIXEL_FORMAT_BPP8_INDEXED || pixel_format == SAIL_PIXEL_FORMAT_BPP4_INDEXED) {
+        const unsigned color_count = (pixel_format == SAIL_PIXEL_FORMAT_BPP8_INDEXED) ? 256 : 16;
+        munit_assert(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, color_count, &image->palette) == SAIL_OK);
+
+        unsigned char *palette = image->palette->data;
+
+        for (unsigned i = 0; i < color_count * 3; i++) {
+            palette[i] = (unsigned char)i;
+        }
+    }
+
+    return image;
+}
+
+/* Flat rectangles with text-like details, like screenshots of user interfaces. */
+static struct sail_image* screenshot(unsigned width, unsigned height) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+    image->width          = width;
+    image->height         = height;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP32_RGBA;
+    image->bytes_per_line = image->width * 4;
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * image->height, &image->pixels) == SAIL_OK);
+
+    unsigned char *pixels = image->pixels;
+    uint32_t seed = 12345;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        for (unsigned column = 0; column < image->width; column++) {
+            unsigned char *pixel = pixels + (size_t)row * image->bytes_per_line + column * 4;
+
+            const bool panel = (column / 128 + row / 96) % 2 == 0;
+            seed = seed * 1103515245 + 12345;
+            const bool glyph = (row % 24) >= 8 && (row % 24) < 18 && ((seed >> 16) & 7) == 0;
+
+            pixel[0] = glyph ? 20 : (panel ? 240 : 200);
+            pixel[1] = glyph ? 20 : (panel ? 240 : 210 + (unsigned char)(row / 64));
+            pixel[2] = glyph ? 30 : (panel ? 245 : 230);
+            pixel[3] = 255;
+        }
+    }
+
+    return image;
+}
+
+static void* encode_with_options(const struct sail_image *image, const struct sail_codec_info *codec_info,
+                                 const struct sail_write_options *write_options, size_t *written) {
+
+    const size_t buffer_length = (size_t)image->bytes_per_line * image->height * 2 + 4096;
+    void *buffer;
+    munit_assert(sail_malloc(buffer_length, &buffer) == SAIL_OK);
+
+    void *state = NULL;
+    munit_assert(sail_start_writing_memory_with_options(buffer, buffer_length, codec_info, write_options, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_writing_with_written(state, written) == SAIL_OK);
+
+    return buffer;
+}
+
+static void* encode(const struct sail_image *image, const struct sail_codec_info *codec_info, unsigned threads, size_t *written) {
+
+    struct sail_write_options *write_options;
+    munit_assert(sail_alloc_write_options_from_features(codec_info->write_features, &write_options) == SAIL_OK);
+    write_options->threads = threads;
+
+    void *buffer = encode_with_options(image, codec_info, write_options, written);
+
+    sail_destroy_write_options(write_options);
+
+    return buffer;
+}
+
+static struct sail_image* decode(const void *data, size_t data_size) {
+
+    void *state = NULL;
+    munit_assert(sail_start_reading_memory(data, data_size, NULL, &state) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_read_next_frame(state, &image) == SAIL_OK);
+    /* libpng verifies the Adler-32 of the image data here. */
+    munit_assert(sail_stop_reading(state) == SAIL_OK);
+
+    return image;
+}
+
+static unsigned count_idat_chunks(const unsigned char *data, size_t data_size) {
+
+    unsigned count = 0;
+
+    /* Skip the signature. */
+    for (size_t offset = 8; offset + 8 <= data_size;) {
+        const size_t length = ((size_t)data[offset] << 24) | ((size_t)data[offset + 1] << 16) | ((size_t)data[offset + 2] << 8) | data[offset + 3];
+
+        if (memcmp(data + offset + 4, "IDAT", 4) == 0) {
+            count++;
+        }
+
+        offset += length + 12;
+    }
+
+    return count;
+}
+
+static MunitResult test_parallel(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const enum SailPixelFormat pixel_format = sail_pixel_format_from_string(munit_parameters_get(params, "pixel-format"));
+    const unsigned threads = (unsigned)atoi(munit_parameters_get(params, "threads"));
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("png", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image = gradient(pixel_format, 1024, 601);
+
+    size_t sequential_size;
+    void *sequential_data = encode(image, codec_info, 1, &sequential_size);
+    size_t parallel_size;
+    void *parallel_data = encode(image, codec_info, threads, &parallel_size);
+
+    /* Every thread writes its own IDAT chunk. Small frames use fewer threads. */
+    const unsigned idat_chunks = count_idat_chunks(parallel_data, parallel_size);
+    munit_assert_uint(idat_chunks, >=, 2);
+    munit_assert_uint(idat_chunks, <=, threads);
+
+    /* Segments restart the Huffman coding but keep the dictionary, so they cost little. */
+    munit_assert_size(parallel_size, <, sequential_size + sequential_size / 10);
+
+    struct sail_image *sequential_image = decode(sequential_data, sequential_size);
+    struct sail_image *parallel_image = decode(parallel_data, parallel_size);
+
+    munit_assert_uint(parallel_image->width, ==, image->width);
+    munit_assert_uint(parallel_image->height, ==, image->height);
+    munit_assert(parallel_image->pixel_format == sequential_image->pixel_format);
+    munit_assert_uint(parallel_image->bytes_per_line, ==, sequential_image->bytes_per_line);
+    munit_assert_memory_equal((size_t)parallel_image->bytes_per_line * parallel_image->height,
+                              parallel_image->pixels, sequential_image->pixels);
+
+    if (parallel_image->pixel_format == image->pixel_format) {
+        munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, parallel_image->pixels, image->pixels);
+    }
+
+    sail_destroy_image(parallel_image);
+    sail_destroy_image(sequential_image);
+    sail_free(parallel_data);
+    sail_free(sequential_data);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_small(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("png", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    /* Too small to split. */
+    struct sail_image *image = gradient(SAIL_PIXEL_FORMAT_BPP32_RGBA, 64, 64);
+
+    size_t data_size;
+    void *data = encode(image, codec_info, 4, &data_size);
+
+    munit_assert_uint(count_idat_chunks(data, data_size), ==, 1);
+
+    struct sail_image *image_read = decode(data, data_size);
+    munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, image_read->pixels, image->pixels);
+
+    sail_destroy_image(image_read);
+    sail_free(data);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static void assert_round_trip(const struct sail_image *image, const void *data, size_t data_size) {
+
+    struct sail_image *image_read = decode(data, data_size);
+
+    munit_assert_uint(image_read->width, ==, image->width);
+    munit_assert_uint(image_read->height, ==, image->height);
+    munit_assert(image_read->pixel_format == image->pixel_format);
+    munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, image_read->pixels, image->pixels);
+
+    sail_destroy_image(image_read);
+}
+
+static enum SailEncodePreset preset_from_string(const char *str) {
+
+    if (strcmp(str, "fastest") == 0) {
+        return SAIL_ENCODE_PRESET_FASTEST;
+    } else if (strcmp(str, "balanced") == 0) {
+        return SAIL_ENCODE_PRESET_BALANCED;
+    } else if (strcmp(str, "smallest") == 0) {
+        return SAIL_ENCODE_PRESET_SMALLEST;
+    } else {
+        return SAIL_ENCODE_PRESET_DEFAULT;
+    }
+}
+
+static MunitResult test_presets(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const enum SailEncodePreset preset = preset_from_string(munit_parameters_get(params, "preset"));
+    const unsigned threads = (unsigned)atoi(munit_parameters_get(params, "threads"));
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("png", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image = screenshot(512, 384);
+
+    struct sail_write_options *write_options;
+    munit_assert(sail_alloc_write_options_from_features(codec_info->write_features, &write_options) == SAIL_OK);
+    write_options->threads = threads;
+
+    size_t default_size;
+    void *default_data = encode_with_options(image, codec_info, write_options, &default_size);
+
+    write_options->encode_preset = preset;
+
+    size_t data_size;
+    void *data = encode_with_options(image, codec_info, write_options, &data_size);
+
+    assert_round_trip(image, data, data_size);
+
+    switch (preset) {
+        case SAIL_ENCODE_PRESET_FASTEST: {
+            /* Flat areas compress well even without filters. */
+            munit_assert_size(data_size, <, default_size * 3);
+            break;
+        }
+        case SAIL_ENCODE_PRESET_BALANCED: {
+            munit_assert_size(data_size, <, default_size + default_size / 2);
+            break;
+        }
+        case SAIL_ENCODE_PRESET_SMALLEST: {
+            munit_assert_size(data_size, <=, default_size);
+            break;
+        }
+
+        default: {
+            break;
+        }
+    }
+
+    sail_free(data);
+    sail_free(default_data);
+    sail_destroy_write_options(write_options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static int row_filters_from_string(const char *str) {
+
+    if (strcmp(str, "none") == 0) {
+        return SAIL_ROW_FILTER_NONE;
+    } else if (strcmp(str, "sub") == 0) {
+        return SAIL_ROW_FILTER_SUB;
+    } else if (strcmp(str, "up") == 0) {
+        return SAIL_ROW_FILTER_UP;
+    } else if (strcmp(str, "average") == 0) {
+        return SAIL_ROW_FILTER_AVERAGE;
+    } else if (strcmp(str, "paeth") == 0) {
+        return SAIL_ROW_FILTER_PAETH;
+    } else {
+        return SAIL_ROW_FILTER_ALL;
+    }
+}
+
+static MunitResult test_row_filters(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const int row_filters = row_filters_from_string(munit_parameters_get(params, "row-filters"));
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("png", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image = gradient(SAIL_PIXEL_FORMAT_BPP24_RGB, 1024, 601);
+
+    struct sail_write_options *write_options;
+    munit_assert(sail_alloc_write_options_from_features(codec_info->write_features, &write_options) == SAIL_OK);
+    write_options->row_filters = row_filters;
+
+    /* libpng and the parallel compression apply the same filters. */
+    size_t sequential_size;
+    void *sequential_data = encode_with_options(image, codec_info, write_options, &sequential_size);
+
+    write_options->threads = 4;
+
+    size_t parallel_size;
+    void *parallel_data = encode_with_options(image, codec_info, write_options, &parallel_size);
+
+    assert_round_trip(image, sequential_data, sequential_size);
+    assert_round_trip(image, parallel_data, parallel_size);
+
+    munit_assert_size(parallel_size, <, sequential_size + sequential_size / 10);
+
+    sail_free(parallel_data);
+    sail_free(sequential_data);
+    sail_destroy_write_options(write_options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static enum SailZlibStrategy zlib_strategy_from_string(const char *str) {
+
+    if (strcmp(str, "generic") == 0) {
+        return SAIL_ZLIB_STRATEGY_GENERIC;
+    } else if (strcmp(str, "filtered") == 0) {
+        return SAIL_ZLIB_STRATEGY_FILTERED;
+    } else if (strcmp(str, "huffman-only") == 0) {
+        return SAIL_ZLIB_STRATEGY_HUFFMAN_ONLY;
+    } else if (strcmp(str, "rle") == 0) {
+        return SAIL_ZLIB_STRATEGY_RLE;
+    } else if (strcmp(str, "fixed") == 0) {
+        return SAIL_ZLIB_STRATEGY_FIXED;
+    } else {
+        return SAIL_ZLIB_STRATEGY_DEFAULT;
+    }
+}
+
+static MunitResult test_zlib_options(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const enum SailZlibStrategy zlib_strategy = zlib_strategy_from_string(munit_parameters_get(params, "zlib-strategy"));
+    const unsigned threads = (unsigned)atoi(munit_parameters_get(params, "threads"));
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("png", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image = screenshot(512, 384);
+
+    struct sail_write_options *write_options;
+    munit_assert(sail_alloc_write_options_from_features(codec_info->write_features, &write_options) == SAIL_OK);
+    write_options->threads       = threads;
+    write_options->zlib_strategy = zlib_strategy;
+
+    size_t data_size;
+    void *data = encode_with_options(image, codec_info, write_options, &data_size);
+    assert_round_trip(image, data, data_size);
+    sail_free(data);
+
+    /* Small windows and little memory still produce valid streams. */
+    write_options->zlib_window_bits = 9;
+    write_options->zlib_mem_level   = 1;
+
+    data = encode_with_options(image, codec_info, write_options, &data_size);
+    assert_round_trip(image, data, data_size);
+    sail_free(data);
+
+    sail_destroy_write_options(write_options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"pixel-format", (char **)PIXEL_FORMATS },
+    { (char *)"threads",      (char **)THREADS },
+    { NULL, NULL },
+};
+
+static MunitParameterEnum test_preset_params[] = {
+    { (char *)"preset",  (char **)PRESETS },
+    { (char *)"threads", (char **)PRESET_THREADS },
+    { NULL, NULL },
+};
+
+static MunitParameterEnum test_row_filters_params[] = {
+    { (char *)"row-filters", (char **)ROW_FILTERS },
+    { NULL, NULL },
+};
+
+static MunitParameterEnum test_zlib_options_params[] = {
+    { (char *)"zlib-strategy", (char **)ZLIB_STRATEGIES },
+    { (char *)"threads",       (char **)PRESET_THREADS },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/parallel",     test_parallel,     NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/presets",      test_presets,      NULL, NULL, MUNIT_TEST_OPTION_NONE, test_preset_params },
+    { (char *)"/row-filters",  test_row_filters,  NULL, NULL, MUNIT_TEST_OPTION_NONE, test_row_filters_params },
+    { (char *)"/small",        test_small,        NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/zlib-options", test_zlib_options, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_zlib_options_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/png-write",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
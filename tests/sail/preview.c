@@ -0,0 +1,176 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#include <string.h>
+
+#include "sail.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+struct preview_data {
+    unsigned calls;
+    unsigned last_scan;
+    unsigned width;
+    unsigned height;
+    enum SailPixelFormat pixel_format;
+};
+
+static void on_preview(void *user_data, const struct sail_image *image, unsigned scan) {
+
+    struct preview_data *preview_data = user_data;
+
+    munit_assert_not_null(image->pixels);
+    munit_assert_uint(scan, >, preview_data->last_scan);
+
+    preview_data->calls++;
+    preview_data->last_scan    = scan;
+    preview_data->width        = image->width;
+    preview_data->height       = image->height;
+    preview_data->pixel_format = image->pixel_format;
+}
+
+static const char* test_image(const char *name) {
+
+    for (const char * const *test_image = SAIL_TEST_IMAGES; *test_image != NULL; test_image++) {
+        if (strstr(*test_image, name) != NULL) {
+            return *test_image;
+        }
+    }
+
+    return NULL;
+}
+
+static sail_status_t load_with_preview(const char *path, int io_options, struct preview_data *preview_data, struct sail_image **image) {
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_path(path, &codec_info));
+
+    struct sail_read_options *read_options;
+    SAIL_TRY(sail_alloc_read_options_from_features(codec_info->read_features, &read_options));
+    read_options->io_options        |= io_options;
+    read_options->preview            = on_preview;
+    read_options->preview_user_data  = preview_data;
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_reading_file_with_options(path, codec_info, read_options, &state),
+                        /* cleanup */ sail_destroy_read_options(read_options));
+
+    sail_destroy_read_options(read_options);
+
+    SAIL_TRY_OR_CLEANUP(sail_read_next_frame(state, image),
+                        /* cleanup */ sail_stop_reading(state));
+
+    SAIL_TRY(sail_stop_reading(state));
+
+    return SAIL_OK;
+}
+
+static void test_progressive(int io_options) {
+
+    const char *path = test_image("progressive.jpg");
+    munit_assert_not_null(path);
+
+    struct sail_image *expected;
+    munit_assert(sail_load_image_from_file(path, &expected) == SAIL_OK);
+
+    struct preview_data preview_data = { 0 };
+
+    struct sail_image *image;
+    munit_assert(load_with_preview(path, io_options, &preview_data, &image) == SAIL_OK);
+
+    /* Every scan but the last one is reported. */
+    munit_assert_uint(preview_data.calls, >, 1);
+    munit_assert_uint(preview_data.width, ==, image->width);
+    munit_assert_uint(preview_data.height, ==, image->height);
+    munit_assert(preview_data.pixel_format == image->pixel_format);
+
+    /* The last output pass is the same as the regular decoding. */
+    munit_assert_uint(image->width, ==, expected->width);
+    munit_assert_uint(image->height, ==, expected->height);
+    munit_assert(image->pixel_format == expected->pixel_format);
+    munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, image->pixels, expected->pixels);
+
+    sail_destroy_image(image);
+    sail_destroy_image(expected);
+}
+
+static MunitResult test_preview_progressive(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    test_progressive(0);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_preview_progressive_oriented(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    /* Previews are reported through the scan line converter. */
+    test_progressive(SAIL_IO_OPTION_APPLY_ORIENTATION);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_preview_baseline(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const char *path = test_image("restart-markers.jpg");
+    munit_assert_not_null(path);
+
+    struct preview_data preview_data = { 0 };
+
+    struct sail_image *image;
+    munit_assert(load_with_preview(path, 0, &preview_data, &image) == SAIL_OK);
+
+    munit_assert_uint(preview_data.calls, ==, 0);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/progressive",          test_preview_progressive,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/progressive-oriented", test_preview_progressive_oriented, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/baseline",             test_preview_baseline,             NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/preview",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,319 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021-2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#include <stdio.h>
+#include <string.h>
+
+#include "sail.h"
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+struct progress_data {
+    unsigned calls;
+    unsigned rows_done;
+    unsigned rows_total;
+};
+
+static void on_progress(void *user_data, unsigned rows_done, unsigned rows_total) {
+
+    struct progress_data *progress_data = user_data;
+
+    munit_assert(rows_done <= rows_total);
+    munit_assert(rows_done >= progress_data->rows_done);
+
+    progress_data->calls++;
+    progress_data->rows_done  = rows_done;
+    progress_data->rows_total = rows_total;
+}
+
+static MunitResult test_read_progress(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_read_options *read_options = NULL;
+    munit_assert(sail_alloc_read_options_from_features(codec_info->read_features, &read_options) == SAIL_OK);
+
+    struct progress_data progress_data = { 0, 0, 0 };
+    read_options->progress           = on_progress;
+    read_options->progress_user_data = &progress_data;
+
+    void *state = NULL;
+    munit_assert(sail_start_reading_file_with_options(path, codec_info, read_options, &state) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_read_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_reading(state) == SAIL_OK);
+
+    munit_assert(progress_data.calls > 0);
+    munit_assert(progress_data.rows_total > 0);
+    munit_assert(progress_data.rows_done == progress_data.rows_total);
+
+    sail_destroy_image(image);
+    sail_destroy_read_options(read_options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_read_cancelled(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_read_options *read_options = NULL;
+    munit_assert(sail_alloc_read_options_from_features(codec_info->read_features, &read_options) == SAIL_OK);
+
+    volatile int cancel_flag = 1;
+    read_options->cancel_flag = &cancel_flag;
+
+    void *state = NULL;
+    munit_assert(sail_start_reading_file_with_options(path, codec_info, read_options, &state) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_read_next_frame(state, &image) == SAIL_ERROR_CANCELLED);
+    munit_assert_null(image);
+    munit_assert(sail_stop_reading(state) == SAIL_OK);
+
+    sail_destroy_read_options(read_options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_write_cancelled(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *extension = munit_parameters_get(params, "extension");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension(extension, &codec_info) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+    image->width          = 64;
+    image->height         = 48;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image->bytes_per_line = image->width * 3;
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * image->height, &image->pixels) == SAIL_OK);
+    memset(image->pixels, 0x80, (size_t)image->bytes_per_line * image->height);
+
+    struct sail_write_options *write_options = NULL;
+    munit_assert(sail_alloc_write_options_from_features(codec_info->write_features, &write_options) == SAIL_OK);
+
+    volatile int cancel_flag = 1;
+    write_options->cancel_flag = &cancel_flag;
+
+    const size_t buffer_length = 64 * 1024;
+    void *buffer;
+    munit_assert(sail_malloc(buffer_length, &buffer) == SAIL_OK);
+
+    void *state = NULL;
+    munit_assert(sail_start_writing_memory_with_options(buffer, buffer_length, codec_info, write_options, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_ERROR_CANCELLED);
+
+    /* The file is incomplete, so codecs may fail to finish it. They must not leak anything anyway. */
+    sail_stop_writing(state);
+
+    sail_free(buffer);
+    sail_destroy_write_options(write_options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+/* Progress of the TIFF test images. The codec reports it per strip or per tile row. */
+struct chunk_progress_data {
+    unsigned calls;
+    unsigned rows_done[8];
+    unsigned rows_total;
+    volatile int *cancel_flag;
+};
+
+static void on_chunk_progress(void *user_data, unsigned rows_done, unsigned rows_total) {
+
+    struct chunk_progress_data *progress_data = user_data;
+
+    munit_assert_uint(progress_data->calls, <, sizeof(progress_data->rows_done) / sizeof(progress_data->rows_done[0]));
+
+    progress_data->rows_done[progress_data->calls++] = rows_done;
+    progress_data->rows_total = rows_total;
+
+    /* Cancel after the first chunk. */
+    if (progress_data->cancel_flag != NULL) {
+        *progress_data->cancel_flag = 1;
+    }
+}
+
+/*
+ * The TIFF test images are 8-bit RGB. The strip images are 12x10 with 3 rows per strip. One of
+ * them is stored bottom-up. The tiled image is 20x40 with PackBits compressed 16x16 tiles.
+ */
+static sail_status_t start_reading_tiff(const char *layout, struct chunk_progress_data *progress_data,
+                                        unsigned *rows_per_chunk, void **state) {
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_extension("tiff", &codec_info));
+
+    char name[64];
+    snprintf(name, sizeof(name), "/%s.tiff", layout);
+
+    const char *path = sail_test_image_with_extension(SAIL_TEST_OPTIONAL_CODEC_IMAGES, name);
+    munit_assert_not_null(path);
+
+    *rows_per_chunk = (strcmp(layout, "tiles") == 0) ? 16 : 3;
+
+    struct sail_read_options *read_options;
+    SAIL_TRY(sail_alloc_read_options_from_features(codec_info->read_features, &read_options));
+
+    read_options->progress           = on_chunk_progress;
+    read_options->progress_user_data = progress_data;
+    read_options->cancel_flag        = progress_data->cancel_flag;
+
+    SAIL_TRY_OR_CLEANUP(sail_start_reading_file_with_options(path, codec_info, read_options, state),
+                        /* cleanup */ sail_destroy_read_options(read_options));
+
+    sail_destroy_read_options(read_options);
+
+    return SAIL_OK;
+}
+
+static MunitResult test_tiff_read_progress(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("tiff", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct chunk_progress_data progress_data = { 0, { 0 }, 0, NULL };
+    unsigned rows_per_chunk;
+    void *state = NULL;
+    munit_assert(start_reading_tiff(munit_parameters_get(params, "layout"), &progress_data, &rows_per_chunk, &state) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_read_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_reading(state) == SAIL_OK);
+
+    munit_assert(image->pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA);
+
+    /* Every pixel is unique, so misplaced or flipped strips and tiles are detected. */
+    for (unsigned row = 0; row < image->height; row++) {
+        const unsigned char *scan_line = (const unsigned char *)image->pixels + row * image->bytes_per_line;
+
+        for (unsigned column = 0; column < image->width; column++) {
+            munit_assert_uint8(scan_line[column * 4 + 0], ==, (unsigned char)(column * 20 + 10));
+            munit_assert_uint8(scan_line[column * 4 + 1], ==, (unsigned char)(row * 12 + 5));
+            munit_assert_uint8(scan_line[column * 4 + 2], ==, (unsigned char)(column * 7 + row * 13));
+            munit_assert_uint8(scan_line[column * 4 + 3], ==, 255);
+        }
+    }
+
+    /* Progress is reported once per chunk. */
+    munit_assert_uint(progress_data.calls, ==, (image->height + rows_per_chunk - 1) / rows_per_chunk);
+    munit_assert_uint(progress_data.rows_total, ==, image->height);
+
+    for (unsigned call = 0; call < progress_data.calls; call++) {
+        const unsigned rows_done = (call + 1) * rows_per_chunk;
+        munit_assert_uint(progress_data.rows_done[call], ==, rows_done < image->height ? rows_done : image->height);
+    }
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_tiff_read_cancelled(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("tiff", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    /* The flag is raised by the progress callback after the first chunk. */
+    volatile int cancel_flag = 0;
+    struct chunk_progress_data progress_data = { 0, { 0 }, 0, &cancel_flag };
+    unsigned rows_per_chunk;
+    void *state = NULL;
+    munit_assert(start_reading_tiff(munit_parameters_get(params, "layout"), &progress_data, &rows_per_chunk, &state) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_read_next_frame(state, &image) == SAIL_ERROR_CANCELLED);
+    munit_assert_null(image);
+    munit_assert(sail_stop_reading(state) == SAIL_OK);
+
+    munit_assert_uint(progress_data.calls, ==, 1);
+    munit_assert_uint(progress_data.rows_done[0], ==, rows_per_chunk);
+
+    return MUNIT_OK;
+}
+
+static char *TIFF_LAYOUTS[] = { (char *)"strips", (char *)"strips-bottom-left", (char *)"tiles", NULL };
+
+static char *WRITE_EXTENSIONS[] = { (char *)"jpg", (char *)"png", NULL };
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitParameterEnum test_write_params[] = {
+    { (char *)"extension", WRITE_EXTENSIONS },
+    { NULL, NULL },
+};
+
+static MunitParameterEnum test_tiff_params[] = {
+    { (char *)"layout", TIFF_LAYOUTS },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/read-cancelled",      test_read_cancelled,      NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/read-progress",       test_read_progress,       NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/tiff-read-cancelled", test_tiff_read_cancelled, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_tiff_params },
+    { (char *)"/tiff-read-progress",  test_tiff_read_progress,  NULL, NULL, MUNIT_TEST_OPTION_NONE, test_tiff_params },
+    { (char *)"/write-cancelled",     test_write_cancelled,     NULL, NULL, MUNIT_TEST_OPTION_NONE, test_write_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/progress",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
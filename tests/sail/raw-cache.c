@@ -0,0 +1,227 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sail.h"
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+#define RAW_CACHE_PATH "raw-cache-test.sailraw"
+
+static sail_status_t load_image_with_extras(const char *path, struct sail_image **image) {
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_load_image_from_file(path, &image_local));
+
+    /* Add meta data and an ICC profile to cover all the sections. */
+    sail_destroy_meta_data_node_chain(image_local->meta_data_node);
+    image_local->meta_data_node = NULL;
+
+    SAIL_TRY_OR_CLEANUP(sail_alloc_meta_data_node(&image_local->meta_data_node),
+                        /* cleanup */ sail_destroy_image(image_local));
+    SAIL_TRY_OR_CLEANUP(sail_alloc_meta_data_from_unknown_string("Cache-Key", "test", &image_local->meta_data_node->meta_data),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    sail_destroy_iccp(image_local->iccp);
+    const unsigned char iccp_data[] = { 1, 2, 3, 4, 5 };
+    SAIL_TRY_OR_CLEANUP(sail_alloc_iccp_from_data(iccp_data, sizeof(iccp_data), &image_local->iccp),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+static MunitResult test_read(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(load_image_with_extras(path, &image) == SAIL_OK);
+
+    munit_assert(sail_save_image_into_file(RAW_CACHE_PATH, image) == SAIL_OK);
+
+    struct sail_image *image_raw;
+    munit_assert(sail_load_image_from_file(RAW_CACHE_PATH, &image_raw) == SAIL_OK);
+    munit_assert(sail_compare_images(image, image_raw) == SAIL_OK);
+
+    sail_destroy_image(image_raw);
+    sail_destroy_image(image);
+    remove(RAW_CACHE_PATH);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_map(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(load_image_with_extras(path, &image) == SAIL_OK);
+
+    munit_assert(sail_save_image_into_file(RAW_CACHE_PATH, image) == SAIL_OK);
+
+    const struct sail_image *image_mapped;
+    void *state = NULL;
+    munit_assert(sail_map_raw_file(RAW_CACHE_PATH, &image_mapped, &state) == SAIL_OK);
+    munit_assert_not_null(state);
+
+    /* Pixels point into the page-aligned mapping. */
+    munit_assert((uintptr_t)image_mapped->pixels % SAIL_RAW_IMAGE_PIXELS_ALIGNMENT == 0);
+    munit_assert(sail_compare_images(image, image_mapped) == SAIL_OK);
+
+    sail_unmap_raw_file(state);
+    sail_destroy_image(image);
+    remove(RAW_CACHE_PATH);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_map_view(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(sail_load_image_from_file(path, &image) == SAIL_OK);
+    munit_assert(sail_save_image_into_file(RAW_CACHE_PATH, image) == SAIL_OK);
+
+    const struct sail_image *image_mapped;
+    void *state = NULL;
+    munit_assert(sail_map_raw_file(RAW_CACHE_PATH, &image_mapped, &state) == SAIL_OK);
+
+    struct sail_image *view_mapped;
+    munit_assert(sail_image_view((struct sail_image *)image_mapped, 0, 1, image->width, image->height / 2, &view_mapped) == SAIL_OK);
+
+    struct sail_image *view;
+    munit_assert(sail_image_view(image, 0, 1, image->width, image->height / 2, &view) == SAIL_OK);
+
+    /* The view keeps the file mapped. */
+    sail_unmap_raw_file(state);
+    munit_assert(sail_compare_images(view, view_mapped) == SAIL_OK);
+
+    sail_destroy_image(view_mapped);
+    sail_destroy_image(view);
+    sail_destroy_image(image);
+    remove(RAW_CACHE_PATH);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_truncated(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(sail_load_image_from_file(path, &image) == SAIL_OK);
+    munit_assert(sail_save_image_into_file(RAW_CACHE_PATH, image) == SAIL_OK);
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(RAW_CACHE_PATH, &data, &data_size) == SAIL_OK);
+
+    /* Cut the last pixel byte. */
+    FILE *fptr = fopen(RAW_CACHE_PATH, "wb");
+    munit_assert_not_null(fptr);
+    munit_assert(fwrite(data, 1, data_size - 1, fptr) == data_size - 1);
+    fclose(fptr);
+
+    const struct sail_image *image_mapped;
+    void *state = NULL;
+    munit_assert(sail_map_raw_file(RAW_CACHE_PATH, &image_mapped, &state) == SAIL_ERROR_BROKEN_IMAGE);
+
+    struct sail_image *image_raw = NULL;
+    munit_assert(sail_load_image_from_file(RAW_CACHE_PATH, &image_raw) != SAIL_OK);
+    munit_assert_null(image_raw);
+
+    sail_free(data);
+    sail_destroy_image(image);
+    remove(RAW_CACHE_PATH);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_save_view(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(sail_load_image_from_file(path, &image) == SAIL_OK);
+
+    /* Views are saved with tightly packed pixels. */
+    struct sail_image *view;
+    munit_assert(sail_image_view(image, 2, 1, image->width / 2, image->height / 2, &view) == SAIL_OK);
+    munit_assert(sail_save_image_into_file(RAW_CACHE_PATH, view) == SAIL_OK);
+
+    struct sail_image *image_raw;
+    munit_assert(sail_load_image_from_file(RAW_CACHE_PATH, &image_raw) == SAIL_OK);
+    munit_assert(image_raw->bytes_per_line < view->bytes_per_line);
+    munit_assert(sail_compare_images(view, image_raw) == SAIL_OK);
+
+    sail_destroy_image(image_raw);
+    sail_destroy_image(view);
+    sail_destroy_image(image);
+    remove(RAW_CACHE_PATH);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/read",      test_read,      NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/map",       test_map,       NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/map-view",  test_map_view,  NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/truncated", test_truncated, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/save-view", test_save_view, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/raw-cache",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,197 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sail.h"
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static const char *THREADS[] = { "2", "3", "8", NULL };
+
+/* Number of frames decoded in parallel. Counted with the trace message of the parallel JPEG decoder. */
+static unsigned parallel_frames;
+
+static void count_parallel_frames(enum SailLogLevel level, const char *file, int line, const char *format, va_list args) {
+    (void)file;
+    (void)line;
+    (void)args;
+
+    if (level == SAIL_LOG_LEVEL_TRACE && strstr(format, "restart intervals in") != NULL) {
+        parallel_frames++;
+    }
+}
+
+/* Only JPEG images with restart markers are decoded in parallel. */
+static bool decodable_in_parallel(const char *path) {
+
+    return strstr(path, "restart-markers.jpg") != NULL;
+}
+
+static void *setup_logger(const MunitParameter params[], void *user_data) {
+    (void)params;
+
+    parallel_frames = 0;
+    sail_set_log_barrier(SAIL_LOG_LEVEL_TRACE);
+    sail_set_logger(count_parallel_frames);
+
+    return user_data;
+}
+
+static void tear_down_logger(void *fixture) {
+    (void)fixture;
+
+    sail_set_logger(NULL);
+    sail_set_log_barrier(SAIL_LOG_LEVEL_DEBUG);
+}
+
+static sail_status_t read_file_with_threads(const char *path, unsigned threads, struct sail_image **image) {
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_path(path, &codec_info));
+
+    struct sail_read_options *read_options;
+    SAIL_TRY(sail_alloc_read_options_from_features(codec_info->read_features, &read_options));
+    read_options->threads = threads;
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_reading_file_with_options(path, codec_info, read_options, &state),
+                        /* cleanup */ sail_destroy_read_options(read_options));
+
+    sail_destroy_read_options(read_options);
+
+    SAIL_TRY_OR_CLEANUP(sail_read_next_frame(state, image),
+                        /* cleanup */ sail_stop_reading(state));
+
+    SAIL_TRY(sail_stop_reading(state));
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_memory_with_threads(const char *path, unsigned threads, struct sail_image **image) {
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_path(path, &codec_info));
+
+    void *data;
+    size_t data_size;
+    SAIL_TRY(sail_file_contents_to_data(path, &data, &data_size));
+
+    struct sail_read_options *read_options;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_read_options_from_features(codec_info->read_features, &read_options),
+                        /* cleanup */ sail_free(data));
+    read_options->threads = threads;
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_reading_memory_with_options(data, data_size, codec_info, read_options, &state),
+                        /* cleanup */ sail_destroy_read_options(read_options),
+                                      sail_free(data));
+
+    sail_destroy_read_options(read_options);
+
+    SAIL_TRY_OR_CLEANUP(sail_read_next_frame(state, image),
+                        /* cleanup */ sail_stop_reading(state),
+                                      sail_free(data));
+
+    SAIL_TRY_OR_CLEANUP(sail_stop_reading(state),
+                        /* cleanup */ sail_free(data));
+
+    sail_free(data);
+
+    return SAIL_OK;
+}
+
+static MunitResult test_read_file(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+    const unsigned threads = (unsigned)atoi(munit_parameters_get(params, "threads"));
+
+    struct sail_image *image = NULL;
+    munit_assert(read_file_with_threads(path, 1, &image) == SAIL_OK);
+    munit_assert_uint(parallel_frames, ==, 0);
+
+    /* Parallel decoding produces exactly the same pixels. */
+    struct sail_image *image_parallel = NULL;
+    munit_assert(read_file_with_threads(path, threads, &image_parallel) == SAIL_OK);
+    munit_assert_uint(parallel_frames, ==, decodable_in_parallel(path) ? 1 : 0);
+    munit_assert(sail_compare_images(image_parallel, image) == SAIL_OK);
+
+    sail_destroy_image(image_parallel);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_read_memory(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+    const unsigned threads = (unsigned)atoi(munit_parameters_get(params, "threads"));
+
+    struct sail_image *image = NULL;
+    munit_assert(read_memory_with_threads(path, 1, &image) == SAIL_OK);
+    munit_assert_uint(parallel_frames, ==, 0);
+
+    struct sail_image *image_parallel = NULL;
+    munit_assert(read_memory_with_threads(path, threads, &image_parallel) == SAIL_OK);
+    munit_assert_uint(parallel_frames, ==, decodable_in_parallel(path) ? 1 : 0);
+    munit_assert(sail_compare_images(image_parallel, image) == SAIL_OK);
+
+    sail_destroy_image(image_parallel);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path",    (char **)SAIL_TEST_IMAGES },
+    { (char *)"threads", (char **)THREADS },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/read-file",   test_read_file,   setup_logger, tear_down_logger, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/read-memory", test_read_memory, setup_logger, tear_down_logger, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/read-threads",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
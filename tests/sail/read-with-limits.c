@@ -0,0 +1,170 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sail.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static sail_status_t read_with_limits(const char *path, const struct sail_read_limits *read_limits, unsigned frames_to_read) {
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_path(path, &codec_info));
+
+    struct sail_read_options *read_options;
+    SAIL_TRY(sail_alloc_read_options_from_features(codec_info->read_features, &read_options));
+    read_options->limits = *read_limits;
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_reading_file_with_options(path, codec_info, read_options, &state),
+                        /* cleanup */ sail_destroy_read_options(read_options));
+
+    sail_status_t status = SAIL_OK;
+
+    for (unsigned i = 0; i < frames_to_read && status == SAIL_OK; i++) {
+        struct sail_image *image = NULL;
+        status = sail_read_next_frame(state, &image);
+        sail_destroy_image(image);
+    }
+
+    sail_stop_reading(state);
+    sail_destroy_read_options(read_options);
+
+    return status;
+}
+
+static MunitResult test_dimensions(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(sail_probe_file(path, &image, NULL) == SAIL_OK);
+
+    struct sail_read_limits read_limits = { 0 };
+
+    read_limits.max_width = image->width;
+    munit_assert(read_with_limits(path, &read_limits, 1) == SAIL_OK);
+    read_limits.max_width = image->width - 1;
+    munit_assert(read_with_limits(path, &read_limits, 1) == SAIL_ERROR_LIMIT_EXCEEDED);
+    read_limits.max_width = 0;
+
+    read_limits.max_height = image->height - 1;
+    munit_assert(read_with_limits(path, &read_limits, 1) == SAIL_ERROR_LIMIT_EXCEEDED);
+    read_limits.max_height = 0;
+
+    read_limits.max_pixels = (uint64_t)image->width * image->height - 1;
+    munit_assert(read_with_limits(path, &read_limits, 1) == SAIL_ERROR_LIMIT_EXCEEDED);
+    read_limits.max_pixels = 0;
+
+    read_limits.max_bytes = (size_t)image->bytes_per_line * image->height - 1;
+    munit_assert(read_with_limits(path, &read_limits, 1) == SAIL_ERROR_LIMIT_EXCEEDED);
+
+    /* Global limits apply too. */
+    struct sail_read_limits read_limits_global = { 0 };
+    read_limits_global.max_width = image->width - 1;
+    sail_set_global_read_limits(&read_limits_global);
+
+    read_limits.max_bytes = 0;
+    munit_assert(read_with_limits(path, &read_limits, 1) == SAIL_ERROR_LIMIT_EXCEEDED);
+
+    sail_set_global_read_limits(NULL);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_frames(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_read_limits read_limits = { 0 };
+    read_limits.max_frames = 1;
+
+    /* Test images have a single frame. */
+    munit_assert(read_with_limits(path, &read_limits, 1) == SAIL_OK);
+    munit_assert(read_with_limits(path, &read_limits, 2) == SAIL_ERROR_LIMIT_EXCEEDED);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_jpeg_header(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    for (const char * const *test_image = SAIL_TEST_IMAGES; *test_image != NULL; test_image++) {
+        if (strstr(*test_image, ".jpg") == NULL) {
+            continue;
+        }
+
+        struct sail_image *image;
+        munit_assert(sail_probe_file(*test_image, &image, NULL) == SAIL_OK);
+
+        struct sail_read_options *read_options;
+        munit_assert(sail_alloc_read_options(&read_options) == SAIL_OK);
+        read_options->limits.max_height = image->height - 1;
+
+        /* The dimensions are checked before the decoder allocates its buffers, i.e. when reading starts. */
+        void *state = NULL;
+        munit_assert(sail_start_reading_file_with_options(*test_image, NULL, read_options, &state) == SAIL_ERROR_LIMIT_EXCEEDED);
+        munit_assert_null(state);
+
+        sail_destroy_read_options(read_options);
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/dimensions",  test_dimensions,  NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/frames",      test_frames,      NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/jpeg-header", test_jpeg_header, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/read-with-limits",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
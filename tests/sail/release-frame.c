@@ -0,0 +1,120 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021-2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include "sail.h"
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static MunitResult test_reuse(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    void *state = NULL;
+    munit_assert(sail_start_reading_file(path, NULL, &state) == SAIL_OK);
+
+    struct sail_image *image1 = NULL;
+    munit_assert(sail_read_next_frame(state, &image1) == SAIL_OK);
+
+    struct sail_image *image_copy = NULL;
+    munit_assert(sail_copy_image(image1, &image_copy) == SAIL_OK);
+
+    const void *pixels = image1->pixels;
+    munit_assert(sail_release_frame(state, image1) == SAIL_OK);
+
+    /* Test images have a single frame. Seeking back to it reads a frame of the same size. */
+    struct sail_image *image2 = NULL;
+    munit_assert(sail_seek_to_frame(state, 0) == SAIL_OK);
+    munit_assert(sail_read_next_frame(state, &image2) == SAIL_OK);
+
+    munit_assert_ptr_equal(image2->pixels, pixels);
+    munit_assert(sail_compare_images(image2, image_copy) == SAIL_OK);
+
+    munit_assert(sail_release_frame(state, image2) == SAIL_OK);
+    munit_assert(sail_stop_reading(state) == SAIL_OK);
+
+    sail_destroy_image(image_copy);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_mismatched_size(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    void *state = NULL;
+    munit_assert(sail_start_reading_file(path, NULL, &state) == SAIL_OK);
+
+    struct sail_image *image1 = NULL;
+    munit_assert(sail_read_next_frame(state, &image1) == SAIL_OK);
+
+    /* Pretend the frame is one line high to return a buffer smaller than the next frame needs. */
+    const void *pixels = image1->pixels;
+    image1->height = 1;
+    munit_assert(sail_release_frame(state, image1) == SAIL_OK);
+
+    struct sail_image *image2 = NULL;
+    munit_assert(sail_seek_to_frame(state, 0) == SAIL_OK);
+    munit_assert(sail_read_next_frame(state, &image2) == SAIL_OK);
+
+    /* The small buffer is not reused. It's freed in sail_stop_reading(). */
+    if (image2->height > 1) {
+        munit_assert_ptr_not_equal(image2->pixels, pixels);
+    }
+
+    sail_destroy_image(image2);
+    munit_assert(sail_stop_reading(state) == SAIL_OK);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/mismatched-size", test_mismatched_size, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/reuse",           test_reuse,           NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/release-frame",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
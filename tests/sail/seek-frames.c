@@ -0,0 +1,144 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021-2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdio.h>
+
+#include "sail.h"
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static MunitResult test_seek_frames(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    void *state = NULL;
+    munit_assert(sail_start_reading_file(path, NULL, &state) == SAIL_OK);
+
+    struct sail_image *image1 = NULL;
+    munit_assert(sail_seek_to_frame(state, 0) == SAIL_OK);
+    munit_assert(sail_read_next_frame(state, &image1) == SAIL_OK);
+
+    /* Seeking backward restarts reading. */
+    struct sail_image *image2 = NULL;
+    munit_assert(sail_seek_to_frame(state, 0) == SAIL_OK);
+    munit_assert(sail_read_next_frame(state, &image2) == SAIL_OK);
+
+    munit_assert(sail_compare_images(image1, image2) == SAIL_OK);
+
+    /* Test images have a single frame. */
+    munit_assert(sail_seek_to_frame(state, 0) == SAIL_OK);
+    munit_assert(sail_skip_next_frame(state) == SAIL_OK);
+    munit_assert(sail_skip_next_frame(state) == SAIL_ERROR_NO_MORE_FRAMES);
+
+    munit_assert(sail_stop_reading(state) == SAIL_OK);
+
+    sail_destroy_image(image2);
+    sail_destroy_image(image1);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_seek_frames_multi_frame(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    /* Read the first three frames sequentially. */
+    struct sail_image *expected[3] = { NULL, NULL, NULL };
+
+    void *state = NULL;
+    munit_assert(sail_start_reading_file(path, NULL, &state) == SAIL_OK);
+
+    for (unsigned i = 0; i < 3; i++) {
+        munit_assert(sail_read_next_frame(state, &expected[i]) == SAIL_OK);
+    }
+
+    munit_assert(sail_stop_reading(state) == SAIL_OK);
+
+    /* Seeking forward skips frames 0 and 1 without decoding them. */
+    munit_assert(sail_start_reading_file(path, NULL, &state) == SAIL_OK);
+
+    struct sail_image *image2 = NULL;
+    munit_assert(sail_seek_to_frame(state, 2) == SAIL_OK);
+    munit_assert(sail_read_next_frame(state, &image2) == SAIL_OK);
+    munit_assert(sail_compare_images(expected[2], image2) == SAIL_OK);
+
+    /* Seeking backward restarts reading. */
+    struct sail_image *image0 = NULL;
+    munit_assert(sail_seek_to_frame(state, 0) == SAIL_OK);
+    munit_assert(sail_read_next_frame(state, &image0) == SAIL_OK);
+    munit_assert(sail_compare_images(expected[0], image0) == SAIL_OK);
+
+    /* Reading continues after the sought frame. */
+    struct sail_image *image1 = NULL;
+    munit_assert(sail_read_next_frame(state, &image1) == SAIL_OK);
+    munit_assert(sail_compare_images(expected[1], image1) == SAIL_OK);
+
+    munit_assert(sail_stop_reading(state) == SAIL_OK);
+
+    sail_destroy_image(image1);
+    sail_destroy_image(image0);
+    sail_destroy_image(image2);
+
+    for (unsigned i = 0; i < 3; i++) {
+        sail_destroy_image(expected[i]);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitParameterEnum test_multi_frame_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_MULTI_FRAME_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/seek-frames",             test_seek_frames,             NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/seek-frames-multi-frame", test_seek_frames_multi_frame, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_multi_frame_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/seek-frames",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,261 @@
+/*  This file is part of SAIL (https://github.com/smoked-herring/sail)
+
+    Copyright (c) 2021 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sail.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+#define COMMENT "Passthrough"
+
+/* Returns the offset of the specified signature in the image data. */
+static size_t find_signature(const unsigned char *data, size_t data_size, const char *signature) {
+
+    const size_t signature_length = strlen(signature);
+
+    for (size_t i = 0; i + signature_length <= data_size; i++) {
+        if (memcmp(data + i, signature, signature_length) == 0) {
+            return i;
+        }
+    }
+
+    return data_size;
+}
+
+/* Returns the offset of the compressed pixel data, a JPEG scan or PNG IDAT chunk, in the image data. */
+static size_t pixel_data_offset(const unsigned char *data, size_t data_size) {
+
+    if (data_size > 2 && data[0] == 0xFF && data[1] == 0xD8) {
+        return find_signature(data, data_size, "\xFF\xDA");
+    }
+
+    /* Chunk length precedes its type. */
+    return find_signature(data, data_size, "IDAT") - 4;
+}
+
+static sail_status_t read_with_source_data(const void *buffer, size_t buffer_length, const struct sail_codec_info *codec_info,
+                                           struct sail_image **image) {
+
+    struct sail_read_options *read_options;
+    SAIL_TRY(sail_alloc_read_options_from_features(codec_info->read_features, &read_options));
+    read_options->io_options |= SAIL_IO_OPTION_SOURCE_DATA;
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_reading_memory_with_options(buffer, buffer_length, codec_info, read_options, &state),
+                        /* cleanup */ sail_destroy_read_options(read_options));
+
+    sail_destroy_read_options(read_options);
+
+    SAIL_TRY_OR_CLEANUP(sail_read_next_frame(state, image),
+                        /* cleanup */ sail_stop_reading(state));
+
+    SAIL_TRY(sail_stop_reading(state));
+
+    return SAIL_OK;
+}
+
+static sail_status_t write_with_options(const struct sail_image *image, const struct sail_codec_info *codec_info, int io_options,
+                                        void *buffer, size_t buffer_length, size_t *written) {
+
+    struct sail_write_options *write_options;
+    SAIL_TRY(sail_alloc_write_options_from_features(codec_info->write_features, &write_options));
+    write_options->io_options = io_options;
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_writing_memory_with_options(buffer, buffer_length, codec_info, write_options, &state),
+                        /* cleanup */ sail_destroy_write_options(write_options));
+
+    sail_destroy_write_options(write_options);
+
+    SAIL_TRY_OR_CLEANUP(sail_write_next_frame(state, image),
+                        /* cleanup */ sail_stop_writing(state));
+
+    SAIL_TRY(sail_stop_writing_with_written(state, written));
+
+    return SAIL_OK;
+}
+
+static void test_passthrough(const void *data, size_t data_size, const struct sail_codec_info *codec_info) {
+
+    struct sail_image *image;
+    munit_assert(read_with_source_data(data, data_size, codec_info, &image) == SAIL_OK);
+
+    munit_assert_not_null(image->source_image->data);
+    munit_assert_size(image->source_image->data_size, ==, data_size);
+    munit_assert_memory_equal(data_size, image->source_image->data, data);
+
+    /* Replace the meta data. */
+    sail_destroy_meta_data_node_chain(image->meta_data_node);
+    munit_assert(sail_alloc_meta_data_node(&image->meta_data_node) == SAIL_OK);
+    munit_assert(sail_alloc_meta_data_from_known_string(SAIL_META_DATA_COMMENT, COMMENT, &image->meta_data_node->meta_data) == SAIL_OK);
+
+    const size_t buffer_length = data_size + 64 * 1024;
+    void *buffer;
+    munit_assert(sail_malloc(buffer_length, &buffer) == SAIL_OK);
+
+    /* The compressed pixel data is written unchanged, the meta data is replaced. */
+    {
+        size_t written;
+        munit_assert(write_with_options(image, codec_info, SAIL_IO_OPTION_SOURCE_DATA | SAIL_IO_OPTION_META_DATA | SAIL_IO_OPTION_ICCP,
+                                        buffer, buffer_length, &written) == SAIL_OK);
+
+        const size_t tail_size = data_size - pixel_data_offset(data, data_size);
+        munit_assert_size(tail_size, >, 0);
+        munit_assert_size(written, >=, tail_size);
+        munit_assert_memory_equal(tail_size, (const unsigned char *)buffer + written - tail_size, (const unsigned char *)data + data_size - tail_size);
+
+        struct sail_image *image_written;
+        munit_assert(sail_load_image_from_memory(buffer, written, &image_written) == SAIL_OK);
+
+        munit_assert_not_null(image_written->meta_data_node);
+        munit_assert_null(image_written->meta_data_node->next);
+        munit_assert_string_equal(image_written->meta_data_node->meta_data->value, COMMENT);
+
+        if (image->iccp == NULL) {
+            munit_assert_null(image_written->iccp);
+        } else {
+            munit_assert_not_null(image_written->iccp);
+            munit_assert_size(image_written->iccp->data_length, ==, image->iccp->data_length);
+            munit_assert_memory_equal(image->iccp->data_length, image_written->iccp->data, image->iccp->data);
+        }
+
+        munit_assert(image_written->pixel_format == image->pixel_format);
+        munit_assert_memory_equal(image->bytes_per_line * image->height, image_written->pixels, image->pixels);
+
+        sail_destroy_image(image_written);
+    }
+
+    /* Meta data and ICC profiles are stripped when not requested. */
+    {
+        size_t written;
+        munit_assert(write_with_options(image, codec_info, SAIL_IO_OPTION_SOURCE_DATA, buffer, buffer_length, &written) == SAIL_OK);
+
+        struct sail_image *image_written;
+        munit_assert(sail_load_image_from_memory(buffer, written, &image_written) == SAIL_OK);
+        munit_assert_null(image_written->meta_data_node);
+        munit_assert_null(image_written->iccp);
+        munit_assert_memory_equal(image->bytes_per_line * image->height, image_written->pixels, image->pixels);
+        sail_destroy_image(image_written);
+    }
+
+    sail_free(buffer);
+    sail_destroy_image(image);
+}
+
+static MunitResult test_png(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("png", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    const char *path = NULL;
+
+    for (const char * const *test_image = SAIL_TEST_IMAGES; *test_image != NULL; test_image++) {
+        if (strstr(*test_image, ".png") != NULL) {
+            path = *test_image;
+        }
+    }
+
+    munit_assert_not_null(path);
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_file_contents_to_data(path, &data, &data_size) == SAIL_OK);
+
+    test_passthrough(data, data_size, codec_info);
+
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_jpeg(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("jpg", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    /* Encode a gradient. */
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+    image->width          = 32;
+    image->height         = 16;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image->bytes_per_line = image->width * 3;
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * image->height, &image->pixels) == SAIL_OK);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        unsigned char *scan_line = (unsigned char *)image->pixels + row * image->bytes_per_line;
+
+        for (unsigned column = 0; column < image->width; column++) {
+            scan_line[column * 3 + 0] = (unsigned char)(column * 8);
+            scan_line[column * 3 + 1] = (unsigned char)(row * 16);
+            scan_line[column * 3 + 2] = (unsigned char)((column + row) * 4);
+        }
+    }
+
+    const size_t buffer_length = 64 * 1024;
+    void *buffer;
+    munit_assert(sail_malloc(buffer_length, &buffer) == SAIL_OK);
+
+    size_t written;
+    munit_assert(write_with_options(image, codec_info, 0, buffer, buffer_length, &written) == SAIL_OK);
+
+    test_passthrough(buffer, written, codec_info);
+
+    sail_free(buffer);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/png",  test_png,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/jpeg", test_jpeg, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/source-data",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}